@@ -11,14 +11,16 @@
  * - Pin A0 (PA0) is configured as input with pull-down resistor.
  * - Pin A1 (PA1) is configured as input with pull-up resistor.
  * - PA5 and PA6 are configured as output pins for LED indication.
+ * - USART2 (PA2) carries the LOG() diagnostic stream (see binary_Log).
  *
  * Interrupts:
  * - EXTI0 (line 0) is triggered on a rising edge from PA0.
  * - EXTI1 (line 1) is triggered on a rising edge from PA1.
  *
  * Functionality:
- * - When PA0 is triggered, PA6 blinks 5 times.
- * - When PA1 is triggered, PA5 blinks 5 times.
+ * - When PA0 is triggered, PA6 toggles and the event is logged.
+ * - When PA1 is triggered, PA5 toggles and the event is logged.
+ * - The ISRs no longer block in delay loops; the main loop drains the log.
  *
  * Registers Used:
  * - RCC (Clock Control)
@@ -29,7 +31,8 @@
  *
  * Usage:
  * - Connect buttons or external signals to PA0 and PA1.
- * - Observe LED blinking behavior on PA6 and PA5 respectively.
+ * - Observe LED toggling on PA6 and PA5 respectively.
+ * - Decode the USART2 stream with binary_Log/log_Decoder.py.
  *
  ******************************************************************************
  */
@@ -40,6 +43,9 @@
   Date : 1/01/2025
   File : external_Interrupt_In_A0pin_A1pin
  ******************************************************************************/
+#include <uart.h>
+#include <log.h>
+
 volatile unsigned int *RCC_CR         = (volatile unsigned int *)0x40023800;
 volatile unsigned int *RCC_CFGR       = (volatile unsigned int *)0x40023808;
 
@@ -61,7 +67,6 @@ void rcc_Config(void);
 void choose_Port(void);
 void gpio_Moder(void);
 void exti_Config(void);
-void delay(int ms);
 void EXTI1_IRQHandler(void);
 
 int main()
@@ -70,6 +75,13 @@ int main()
     choose_Port();
     gpio_Moder();
     exti_Config();
+    uart_Init(UART_CONSOLE, 115200);
+    log_Init();
+    LOG("EXTI A0/A1 example ready");
+    while(1)
+    {
+        log_Drain(UART_CONSOLE);
+    }
 }
 
 void rcc_Config()
@@ -125,26 +137,12 @@ void exti_Config()
     *NVIC_ISER0 |= (1 << 6);
 }
 
-void delay(int ms)
-{
-    for (int i = 0; i < ms * 4000; i++)
-    {
-        __asm("NOP");
-    }
-}
-
 void EXTI0_IRQHandler()
 {
     if (*EXTI_PR & (1 << 0))
     {
-        for (int i = 0; i < 5; i++)
-        {
-            *GPIOA_ODR &= ~(1 << 6);
-            delay(100);
-            *GPIOA_ODR |= (1 << 6);  // Turn on LED
-            delay(100);
-        }
-        *GPIOA_ODR &= ~(1 << 6);
+        *GPIOA_ODR ^= (1 << 6);  // Toggle LED
+        LOG("EXTI0: rising edge on PA0, PR 0x%x", *EXTI_PR);
         *EXTI_PR |= (1 << 0);
     }
 }
@@ -153,14 +151,8 @@ void EXTI1_IRQHandler()
 {
     if (*EXTI_PR & (1 << 1))
     {
-        for (int i = 0; i < 5; i++)
-        {
-            *GPIOA_ODR &= ~(1 << 5);
-            delay(100);
-            *GPIOA_ODR |= (1 << 5);  // Turn on LED
-            delay(100);
-        }
-        *GPIOA_ODR &= ~(1 << 5);
+        *GPIOA_ODR ^= (1 << 5);  // Toggle LED
+        LOG("EXTI1: rising edge on PA1, PR 0x%x", *EXTI_PR);
         *EXTI_PR |= (1 << 1);
     }
 }
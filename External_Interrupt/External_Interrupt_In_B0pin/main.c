@@ -7,8 +7,9 @@
  * Description   :
  *     This project demonstrates the use of an external interrupt on GPIO pin
  *     PB0 of an STM32F4 microcontroller. When a rising edge is detected on PB0,
- *     an interrupt is triggered (EXTI0_IRQHandler), which toggles an LED
- *     connected to PA5 five times with a delay.
+ *     an interrupt is triggered (EXTI0_IRQHandler), which records the event
+ *     with LOG() (binary_Log) instead of blinking the LED on PA5. The main
+ *     loop keeps PA5 on and drains the log over USART2 (PA2).
  *
  * Hardware Setup:
  *     - An LED is connected to PA5.
@@ -20,7 +21,7 @@
  *     - PA5 is configured as output.
  *     - PB0 is configured as input with a pull-down resistor.
  *     - External interrupt on PB0 (EXTI0) is set up to trigger on a rising edge.
- *     - In the ISR, the LED on PA5 toggles ON and OFF five times.
+ *     - In the ISR, the edge and the PB0 input state are logged, no blocking delay.
  *
  * Register Usage:
  *     - RCC_CR, RCC_CFGR       : System clock configuration
@@ -47,6 +48,9 @@
   Date : 1/01/2025
   File : external_Interrupt_In_B0pin
  ******************************************************************************/
+#include <uart.h>
+#include <log.h>
+
 volatile unsigned int *RCC_CR      		= (volatile unsigned int *)0x40023800;
 volatile unsigned int *RCC_CFGR    		= (volatile unsigned int *)0x40023808;
 volatile unsigned int *RCC_AHB1ENR 		= (volatile unsigned int *)0x40023830;
@@ -70,7 +74,6 @@ void rcc_Config(void);
 void port(void);
 void gpio_moder(void);
 void exti_config(void);
-void delay(int ms);
 void EXTI0_IRQHandler(void);
 
 int main()
@@ -79,9 +82,13 @@ int main()
 	port();
 	gpio_moder();
 	exti_config();
+	uart_Init(UART_CONSOLE, 115200);
+	log_Init();
+	LOG("EXTI PB0 example ready");
 	while(1)
 	{
 		*GPIOA_ODR |=  (1<<5);
+		log_Drain(UART_CONSOLE);
 	}
 }
 
@@ -127,25 +134,11 @@ void exti_config()
 	*NVIC_ISER0 |= (1<<6);
 
 }
-void delay(int ms)
-{
-	for(int i=0; i<ms*4000; i++)
-	{
-		__asm("NOP");
-	}
-}
-
 void EXTI0_IRQHandler()
 {
 	if(*EXTI_PR & (1<<0))
 	{
-		for(int i=0; i<5; i++)
-		{
-			*GPIOA_ODR &= ~(1<<5);
-			delay(100);
-			*GPIOA_ODR |=  (1<<5);
-			delay(100);
-		}
+		LOG("EXTI0: rising edge on PB0, IDR 0x%x", *GPIOB_IDR);
 		*EXTI_PR |= (1<<0);
 	}
 }
@@ -0,0 +1,32 @@
+/* generated by board_Gen.py from falling_edge.board, do not edit */
+#include <arm.h>
+#include "board.h"
+
+void board_Init(void)
+{
+	/* clock: HSE 25 MHz as SYSCLK */
+	RCC->CR |= (1<<16);							/* HSEON */
+	while(!(RCC->CR & (1<<17)));
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (1<<0);	/* SW = HSE */
+	while(((RCC->CFGR >> 2) & 0x3) != 1);
+	RCC->AHB1ENR |= 0x00000001;		/* GPIOA */
+	RCC->APB2ENR |= 0x00004000;		/* SYSCFG */
+
+	/* GPIOA: PA0 BUTTON, PA5 LED */
+	GPIOA->BSRR = 0x00200000;
+	GPIOA->OTYPER = (GPIOA->OTYPER & ~0x00000020U) | 0x00000000U;
+	GPIOA->OSPEEDR = (GPIOA->OSPEEDR & ~0x00000C00U) | 0x00000000U;
+	GPIOA->PUPDR = (GPIOA->PUPDR & ~0x00000C03U) | 0x00000001U;
+	GPIOA->MODER = (GPIOA->MODER & ~0x00000C03U) | 0x00000400U;
+
+	/* EXTI: line 0 PA0 */
+	SYSCFG->EXTICR[0] = (SYSCFG->EXTICR[0] & ~0x000FU) | 0x0000U;
+	EXTI->RTSR = (EXTI->RTSR & ~0x0001U) | 0x0000U;
+	EXTI->FTSR = (EXTI->FTSR & ~0x0001U) | 0x0001U;
+	EXTI->PR = 0x0001U;							/* drop edges seen before the setup */
+	EXTI->IMR |= 0x0001U;
+
+	/* NVIC */
+	NVIC->IP[6] = (5<<4);						/* EXTI0 */
+	NVIC->ISER[0] = 0x00000040;
+}
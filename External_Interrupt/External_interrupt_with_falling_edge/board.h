@@ -0,0 +1,26 @@
+/* generated by board_Gen.py from falling_edge.board, do not edit */
+
+#ifndef BOARD_H_
+#define BOARD_H_
+
+#define BOARD_SYSCLK		25000000
+
+#define BUTTON_PORT		GPIOA
+#define BUTTON_PIN		0
+#define LED_PORT		GPIOA
+#define LED_PIN		5
+
+/* pins claimed by this board, drivers included */
+#define BOARD_GPIOA_PINS	0x002D
+
+/* DMA streams: request, channel */
+#define USART2_RX_DMA		(&DMA1->S[5])	/* channel 4, set up by the driver */
+#define USART2_RX_DMA_CHANNEL	4
+#define USART2_RX_DMA_IRQ	16
+#define USART2_TX_DMA		(&DMA1->S[6])	/* channel 4, set up by the driver */
+#define USART2_TX_DMA_CHANNEL	4
+#define USART2_TX_DMA_IRQ	17
+
+void board_Init(void);
+
+#endif /* BOARD_H_ */
@@ -7,8 +7,8 @@
  * Description   :
  *     This project demonstrates how to configure an external interrupt on 
  *     STM32F4 using **rising edge trigger** on pin **PA0** (e.g., button release).
- *     When the interrupt is triggered, the interrupt handler blinks an LED 
- *     connected to **PA5** five times.
+ *     When the interrupt is triggered, the interrupt handler records the event
+ *     with LOG() (binary_Log); the LED on **PA5** stays on as a power indicator.
  *
  * Hardware Setup:
  *     - PA0: Input with pull-down or button tied to logic low by default.
@@ -21,7 +21,7 @@
  *     - PA5 is configured as output, PA0 as input with pull-down.
  *     - EXTI line 0 is mapped to PA0.
  *     - Interrupts are enabled for rising edge on EXTI line 0.
- *     - ISR (EXTI0_IRQHandler) blinks the LED 5 times on interrupt.
+ *     - ISR (EXTI0_IRQHandler) logs the edge; main loop drains the log to USART2 (PA2).
  *
  * Register Usage:
  *     - RCC_CR, RCC_CFGR       : Clock control (HSE and system clock).
@@ -48,6 +48,9 @@
   Date : 30/12/2024
   File : external_Interrupt_A0_Pin
  ******************************************************************************/
+#include <uart.h>
+#include <log.h>
+
 volatile unsigned int *RCC_CR         = (volatile unsigned int *)0x40023800;
 volatile unsigned int *RCC_CFGR       = (volatile unsigned int *)0x40023808;
 
@@ -70,7 +73,6 @@ void rcc_Config(void);
 void choose_Port(void);
 void gpio_Moder(void);
 void exti_Config(void);
-void delay(int ms);
 void EXTI0_IRQHandler(void);
 
 int main()
@@ -79,9 +81,13 @@ int main()
 	choose_Port();
 	gpio_Moder();
 	exti_Config();
+	uart_Init(UART_CONSOLE, 115200);
+	log_Init();
+	LOG("EXTI PA0 rising edge example ready");
 	while(1)
 	{
 		*GPIOA_ODR |= (1<<5);
+		log_Drain(UART_CONSOLE);
 	}
 }
 
@@ -126,24 +132,11 @@ void exti_Config()
 	*NVIC_ISER0 |= (1<<6);
 }
 
-void delay(int ms)
-{
-	for(int i=0;i<ms*4000;i++)
-	{
-		__asm("NOP");
-	}
-}
 void EXTI0_IRQHandler()
 {
 	if(*EXTI_PR & (1<<0))
 	{
-		for(int i=0; i<5; i++)
-		{
-			*GPIOA_ODR &= ~(1<<5);
-			delay(100);
-			*GPIOA_ODR |= (1<<5);
-			delay(100);
-		}
+		LOG("EXTI0: rising edge on PA0, PR 0x%x", *EXTI_PR);
 	   *EXTI_PR |= (1<<0);
 	}
 }
@@ -13,7 +13,10 @@
  * a lighting or indication effect.
  * 
  * The main loop continuously turns on each LED (PA8 to PA1) one by one with delays.
- * On interrupt (triggered by the IR sensor), it performs another LED sequence and then resets.
+ * On interrupt (triggered by the IR sensor), the detection is recorded with LOG() (binary_Log)
+ * and the LEDs are reset. The log is drained over USART1 (PA9) because PA2/PA3 drive LEDs.
+ * The LEDs are switched through GPIOA_BSRR, one store each: a read-modify-write of
+ * GPIOA_ODR in the main loop could write back LEDs that the ISR had just reset.
  * 
  * @peripherals used:
  * - GPIOA (PA0 input with pull-up for EXTI, PA1 to PA8 as outputs)
@@ -22,7 +25,7 @@
  * 
  * @registers used:
  * - RCC_CR, RCC_CFGR, RCC_AHB1ENR, RCC_APB2ENR
- * - GPIOA_MODER, GPIOA_ODR, GPIOA_PUPDR
+ * - GPIOA_MODER, GPIOA_ODR, GPIOA_BSRR, GPIOA_PUPDR
  * - SYSCFG_EXTICR1, EXTI_IMR, EXTI_RTSR, EXTI_PR, NVIC_ISER0
  * 
  * @notes:
@@ -43,6 +46,9 @@
   Date : 31/12/2024
   File : interfacing_Ir_Sensor_By_External_Interrupt
  ******************************************************************************/
+#include <uart.h>
+#include <log.h>
+
 volatile unsigned int *RCC_CR         = (volatile unsigned int *)0x40023800;
 volatile unsigned int *RCC_CFGR       = (volatile unsigned int *)0x40023808;
 
@@ -51,6 +57,7 @@ volatile unsigned int *RCC_APB2ENR    = (volatile unsigned int *)0x40023844;
 
 volatile unsigned int *GPIOA_MODER    = (volatile unsigned int *)0x40020000;
 volatile unsigned int *GPIOA_ODR      = (volatile unsigned int *)0x40020014;
+volatile unsigned int *GPIOA_BSRR     = (volatile unsigned int *)0x40020018;
 volatile unsigned int *GPIOA_PUPDR    = (volatile unsigned int *)0x4002000C;
 
 //interrupt register......
@@ -75,26 +82,29 @@ int main()
 	choose_Port();
 	gpio_Moder();
 	exti_Config();
+	uart_Init(UART_1, 115200);
+	log_Init();
+	LOG("IR sensor EXTI example ready");
 	while(1)
 	{
-		*GPIOA_ODR |= (1<<8);
+		*GPIOA_BSRR = (1<<8);
 		delay(300);
-		*GPIOA_ODR |= (1<<7);
+		*GPIOA_BSRR = (1<<7);
 		delay(300);
-		*GPIOA_ODR |= (1<<6);
+		*GPIOA_BSRR = (1<<6);
 		delay(300);
-		*GPIOA_ODR |= (1<<5);
+		*GPIOA_BSRR = (1<<5);
 		delay(300);
-		*GPIOA_ODR |= (1<<4);
+		*GPIOA_BSRR = (1<<4);
 		delay(300);
-		*GPIOA_ODR |= (1<<3);
+		*GPIOA_BSRR = (1<<3);
 		delay(300);
-		*GPIOA_ODR |= (1<<2);
+		*GPIOA_BSRR = (1<<2);
 		delay(300);
-		*GPIOA_ODR |= (1<<1);
+		*GPIOA_BSRR = (1<<1);
 		delay(300);
 		off();
-
+		log_Drain(UART_1);
 	}
 }
 
@@ -147,14 +157,7 @@ void exti_Config()
 
 void off()
 {
-	*GPIOA_ODR &= ~(1<<1);
-	*GPIOA_ODR &= ~(1<<2);
-	*GPIOA_ODR &= ~(1<<3);
-	*GPIOA_ODR &= ~(1<<4);
-	*GPIOA_ODR &= ~(1<<5);
-	*GPIOA_ODR &= ~(1<<6);
-	*GPIOA_ODR &= ~(1<<7);
-	*GPIOA_ODR &= ~(1<<8);
+	*GPIOA_BSRR = (0x1FE<<16);	/* PA1..PA8 low in one store */
 }
 
 void delay(int ms)
@@ -168,27 +171,8 @@ void EXTI0_IRQHandler()
 {
 	if(*EXTI_PR & (1<<0))
 	{
-		for(int i=0; i<1; i++)
-		{
-			off();
-			*GPIOA_ODR |= (1<<1);
-			delay(500);
-			*GPIOA_ODR |= (1<<2);
-			delay(500);
-			*GPIOA_ODR |= (1<<3);
-			delay(500);
-			*GPIOA_ODR |= (1<<4);
-			delay(500);
-			*GPIOA_ODR |= (1<<5);
-			delay(500);
-			*GPIOA_ODR |= (1<<6);
-			delay(500);
-			*GPIOA_ODR |= (1<<7);
-			delay(500);
-			*GPIOA_ODR |= (1<<8);
-			delay(1000);
-			off();
-		}
-	   *EXTI_PR |= (1<<0);
+		LOG("IR: object detected on PA0, ODR 0x%x", *GPIOA_ODR);
+		off();
+	   *EXTI_PR = (1<<0);		//W1C: clears this line only
 	}
 }
@@ -8,25 +8,31 @@
  *
  * @details
  * This program configures three external interrupts on GPIOA pins PA0, PA1, and PA15.
- * Each interrupt triggers an ISR that blinks an LED connected to PA6, PA5, or PA7 respectively.
+ * Each interrupt triggers an ISR that toggles an LED connected to PA6, PA5, or PA7 respectively
+ * and logs the event through the deferred binary logger (binary_Log) on USART2.
  *
  * GPIO Pin usage:
- *  - PA0  : EXTI0 input interrupt (blinks LED on PA6)
- *  - PA1  : EXTI1 input interrupt (blinks LED on PA5)
- *  - PA15 : EXTI15 input interrupt (blinks LED on PA7)
+ *  - PA0  : EXTI0 input interrupt (toggles LED on PA6)
+ *  - PA1  : EXTI1 input interrupt (toggles LED on PA5)
+ *  - PA15 : EXTI15 input interrupt (toggles LED on PA7)
  *  - PA5, PA6, PA7 : Output pins to drive LEDs
+ *  - PA2  : USART2 TX, LOG() stream
  *
  * Core functionalities:
  *  - RCC clock configuration for GPIOA and SYSCFG peripherals
- *  - GPIO mode and pull-up/down resistor setup
+ *  - GPIO mode and pull-up/down resistor setup from a pin table (gpio_Table),
+ *    one masked write per register instead of one RMW per bit
  *  - SYSCFG external interrupt configuration for pin mapping
  *  - EXTI interrupt mask and trigger selection (rising edge)
  *  - NVIC interrupt enabling for EXTI lines 0, 1, and 15
- *  - Interrupt service routines for each EXTI line with LED blinking logic
+ *  - Interrupt service routines for each EXTI line with LED toggle and LOG() record
  *
  * Note:
  *  - External triggers (e.g., buttons) must be connected to PA0, PA1, and PA15 pins.
- *  - Delay function uses a simple loop with NOP instructions for timing.
+ *  - The ISRs do not block; the main loop drains the log to USART2 and the
+ *    stream is decoded on the host with binary_Log/log_Decoder.py.
+ *  - The LEDs are toggled through BSRR, which changes only the one pin, so
+ *    an ISR at another priority (or main) writing GPIOA cannot lose a toggle.
  ******************************************************************************
  */
 
@@ -37,6 +43,9 @@
   Date : 3/01/2025
   File : three_external_Interrupt
  ******************************************************************************/
+#include <uart.h>
+#include <log.h>
+#include <pins.h>
  
 volatile unsigned int *RCC_CR         = (volatile unsigned int *)0x40023800;
 volatile unsigned int *RCC_CFGR       = (volatile unsigned int *)0x40023808;
@@ -44,9 +53,8 @@ volatile unsigned int *RCC_CFGR       = (volatile unsigned int *)0x40023808;
 volatile unsigned int *RCC_AHB1ENR    = (volatile unsigned int *)0x40023830;
 volatile unsigned int *RCC_APB2ENR    = (volatile unsigned int *)0x40023844;
 
-volatile unsigned int *GPIOA_MODER    = (volatile unsigned int *)0x40020000;
 volatile unsigned int *GPIOA_ODR      = (volatile unsigned int *)0x40020014;
-volatile unsigned int *GPIOA_PUPDR    = (volatile unsigned int *)0x4002000C;
+volatile unsigned int *GPIOA_BSRR     = (volatile unsigned int *)0x40020018;
 
 volatile unsigned int *EXTI_IMR       = (volatile unsigned int *)0x40013C00;
 volatile unsigned int *EXTI_RTSR      = (volatile unsigned int *)0x40013C08;
@@ -57,11 +65,21 @@ volatile unsigned int *SYSCFG_EXTICR4 = (volatile unsigned int *)0x40013814;
 volatile unsigned int *NVIC_ISER0     = (volatile unsigned int *)0xE000E100;
 volatile unsigned int *NVIC_ISER1     = (volatile unsigned int *)0xE000E104;
 
+/* LEDs PA5..PA7; buttons PA0 (pull-down), PA1 (pull-up), PA15 (pull-down) */
+static const struct pin_cfg exti_pins[] =
+{
+    { PORT_A, 0,  PIN_IN,  PIN_PP, PIN_LOW, PIN_DOWN,   0, 0 },
+    { PORT_A, 1,  PIN_IN,  PIN_PP, PIN_LOW, PIN_UP,     0, 0 },
+    { PORT_A, 5,  PIN_OUT, PIN_PP, PIN_LOW, PIN_NOPULL, 0, 0 },
+    { PORT_A, 6,  PIN_OUT, PIN_PP, PIN_LOW, PIN_NOPULL, 0, 0 },
+    { PORT_A, 7,  PIN_OUT, PIN_PP, PIN_LOW, PIN_NOPULL, 0, 0 },
+    { PORT_A, 15, PIN_IN,  PIN_PP, PIN_LOW, PIN_DOWN,   0, 0 },
+};
+
 void rcc_Config(void);
 void choose_Port(void);
-void gpio_Moder(void);
+int gpio_Moder(void);
 void exti_Config(void);
-void delay(int ms);
 void EXTI1_IRQHandler(void);
 void EXTI15_10_IRQHandler (void);
 void EXTI0_IRQHandler(void);
@@ -70,8 +88,25 @@ int main()
 {
     rcc_Config();
     choose_Port();
-    gpio_Moder();
+    if(gpio_Moder() != 0)
+    {
+        /* bad pin table: leave the pins at reset and the EXTI lines masked */
+        uart_Init(UART_CONSOLE, 115200);
+        log_Init();
+        LOG("three EXTI example: pin table rejected");
+        while(1)
+        {
+            log_Drain(UART_CONSOLE);
+        }
+    }
     exti_Config();
+    uart_Init(UART_CONSOLE, 115200);
+    log_Init();
+    LOG("three EXTI example ready");
+    while(1)
+    {
+        log_Drain(UART_CONSOLE);
+    }
 }
 
 void rcc_Config()
@@ -88,34 +123,9 @@ void choose_Port()
     *RCC_APB2ENR |= (1 << 14);
 }
 
-void gpio_Moder()
+int gpio_Moder()
 {
-    *GPIOA_MODER |= (1 << 10);
-    *GPIOA_MODER &= ~(1 << 11);
-
-    *GPIOA_MODER |= (1 << 12);
-    *GPIOA_MODER &= ~(1 << 13);
-
-    *GPIOA_MODER |= (1<<14);
-    *GPIOA_MODER &= ~(1<<15);
-
-    *GPIOA_MODER &= ~(1 << 2);
-    *GPIOA_MODER &= ~(1 << 3);
-
-    *GPIOA_MODER &= ~(1 << 0);
-    *GPIOA_MODER &= ~(1 << 1);
-
-    *GPIOA_MODER &= ~(1<<30);
-    *GPIOA_MODER &= ~(1<<31);
-
-    *GPIOA_PUPDR |= (1<<1);
-    *GPIOA_PUPDR &= ~(1<<0);//PULL DOWN
-
-    *GPIOA_PUPDR |= (1 << 2);
-    *GPIOA_PUPDR &= ~(1 << 3);//PULL UP
-
-    *GPIOA_PUPDR |= (1<<31);
-    *GPIOA_PUPDR &= ~(1<<30);// PULL DOWN
+    return pins_Config(exti_pins, sizeof(exti_pins) / sizeof(exti_pins[0]));
 }
 
 void exti_Config()
@@ -140,27 +150,13 @@ void exti_Config()
 
 }
 
-void delay(int ms)
-{
-    for (int i = 0; i < ms * 4000; i++)
-    {
-        __asm("NOP");
-    }
-}
-
 void EXTI0_IRQHandler()
 {
     if (*EXTI_PR & (1 << 0))
     {
-        for (int i = 0; i < 5; i++)
-        {
-            *GPIOA_ODR &= ~(1 << 6);
-            delay(100);
-            *GPIOA_ODR |= (1 << 6);  // Turn on LED
-            delay(100);
-        }
-        *GPIOA_ODR &= ~(1 << 6);
-        *EXTI_PR |= (1 << 0);
+        *GPIOA_BSRR = (*GPIOA_ODR & (1 << 6)) ? (1 << (6 + 16)) : (1 << 6);  // Toggle LED, this pin only
+        LOG("EXTI0: rising edge on PA0, PR 0x%x", *EXTI_PR);
+        *EXTI_PR = (1 << 0);   // W1C: clears this line only
     }
 }
 
@@ -168,29 +164,17 @@ void EXTI1_IRQHandler()
 {
     if (*EXTI_PR & (1 << 1))
     {
-        for (int i = 0; i < 5; i++)
-        {
-            *GPIOA_ODR &= ~(1 << 5);
-            delay(100);
-            *GPIOA_ODR |= (1 << 5);  // Turn on LED
-            delay(100);
-        }
-        *GPIOA_ODR &= ~(1 << 5);
-        *EXTI_PR |= (1 << 1);
+        *GPIOA_BSRR = (*GPIOA_ODR & (1 << 5)) ? (1 << (5 + 16)) : (1 << 5);  // Toggle LED, this pin only
+        LOG("EXTI1: rising edge on PA1, PR 0x%x", *EXTI_PR);
+        *EXTI_PR = (1 << 1);   // W1C: clears this line only
     }
 }
 void EXTI15_10_IRQHandler ()
 {
     if (*EXTI_PR & (1 << 15))
     {
-        for (int i = 0; i < 5; i++)
-        {
-            *GPIOA_ODR &= ~(1 << 7);
-            delay(100);
-            *GPIOA_ODR |= (1 << 7); // Turn on LED
-            delay(100);
-        }
-        *GPIOA_ODR &= ~(1 << 7);
-        *EXTI_PR |= (1 << 15);
+        *GPIOA_BSRR = (*GPIOA_ODR & (1 << 7)) ? (1 << (7 + 16)) : (1 << 7);  // Toggle LED, this pin only
+        LOG("EXTI15: rising edge on PA15, PR 0x%x", *EXTI_PR);
+        *EXTI_PR = (1 << 15);   // W1C: clears this line only
     }
 }
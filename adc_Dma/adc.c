@@ -0,0 +1,263 @@
+/**
+ ******************************************************************************
+ * @file    adc.c
+ * @author  Monish Kumar.k
+ * @date    20/02/2025
+ * @brief   ADC1 scan conversions triggered by TIM3, stored by DMA2 Stream0 in
+ *          double-buffer mode, with block averaging and analog watchdog.
+ *
+ * @details
+ *  - TIM3 update -> TRGO (MMS = 010) -> ADC1 EXTSEL = 1000, rising edge.
+ *    One trigger converts the whole SQR sequence (SCAN = 1).
+ *  - DDS = 1 keeps DMA requests going after each transfer; the DMA stream
+ *    runs in circular double-buffer mode (DBM) between adc_buf[0] and [1].
+ *  - The transfer-complete interrupt hands over the block that was just
+ *    filled (the one CT does not point at) and averages every channel.
+ *  - ADC overrun (OVR) stops DMA requests; the ADC interrupt restarts the
+ *    stream so the scan order never gets out of step with the buffer.
+ *  - Analog watchdog (AWDSGL) on one channel with a moving window gives one
+ *    interrupt per crossing in each direction.
+ ******************************************************************************
+ */
+#include <arm.h>
+#include <rcc.h>
+#include "adc.h"
+
+#define ADC_IRQ			18
+#define DMA2_S0_IRQ		56
+#define ADC_DMA			(&DMA2->S[0])
+
+static unsigned short adc_buf[2][ADC_BLOCK_SAMPLES];
+static struct adc_config adc_cfg;
+static unsigned int adc_block_scans;		//complete scans per block
+static volatile unsigned int adc_avg[ADC_MAX_CHANNELS];
+static volatile unsigned int adc_scans;
+static volatile unsigned int adc_ovr;
+static int awd_above;
+
+static const unsigned short adc_smp_cycles[8] = { 3, 15, 28, 56, 84, 112, 144, 480 };
+
+static void adc_Gpio_Analog(int ch)
+{
+	volatile struct gpio *port;
+	int pin;
+
+	if(ch < 8)
+	{
+		port = GPIOA;
+		pin  = ch;
+		RCC->AHB1ENR |= (1<<0);
+	}
+	else if(ch < 10)
+	{
+		port = GPIOB;
+		pin  = ch - 8;
+		RCC->AHB1ENR |= (1<<1);
+	}
+	else if(ch < 16)
+	{
+		port = GPIOC;
+		pin  = ch - 10;
+		RCC->AHB1ENR |= (1<<2);
+	}
+	else
+	{
+		return;			//internal channel, no pin
+	}
+	port->MODER |= (0x3 << (pin*2));		//analog
+	port->PUPDR &= ~(0x3 << (pin*2));
+}
+
+static void adc_Dma_Arm()
+{
+	volatile struct dma_stream *s = ADC_DMA;
+
+	s->CR &= ~(1<<0);
+	while(s->CR & (1<<0));
+	DMA2->LIFCR = 0x3D;
+	s->PAR  = (unsigned int)&ADC1->DR;
+	s->M0AR = (unsigned int)adc_buf[0];
+	s->M1AR = (unsigned int)adc_buf[1];
+	s->NDTR = adc_block_scans * adc_cfg.n_channels;
+	s->FCR  = 0;
+	s->CR   = (0<<25) | (1<<18) | (2<<16) | (1<<13) | (1<<11) | (1<<10) | (1<<8) | (1<<4) | (1<<2);
+			//CH0, DBM, PL high, MSIZE/PSIZE 16 bit, MINC, CIRC, TCIE, TEIE
+}
+
+int adc_Init(const struct adc_config *cfg)
+{
+	unsigned int n = cfg->n_channels, bits, res, scan_cycles, ticks, psc;
+
+	switch(cfg->resolution)
+	{
+	case 12: res = 0; break;
+	case 10: res = 1; break;
+	case 8:  res = 2; break;
+	case 6:  res = 3; break;
+	default: return -1;
+	}
+	if(n == 0 || n > ADC_MAX_CHANNELS || cfg->sample_time > 7 || cfg->sample_rate == 0)
+		return -1;
+
+	/* one scan takes n * (sampling + resolution) ADC clocks, ADCCLK = PCLK2 / 4 */
+	bits = cfg->resolution;
+	scan_cycles = n * (adc_smp_cycles[cfg->sample_time] + bits);
+	if((unsigned long long)cfg->sample_rate * scan_cycles > rcc_Get_Pclk(2) / 4)
+		return -1;
+	ticks = rcc_Get_Tim_Clock(1) / cfg->sample_rate;
+	if(ticks < 2)
+		return -1;
+
+	adc_cfg = *cfg;
+	adc_block_scans = ADC_BLOCK_SAMPLES / n;
+	awd_above = 0;
+
+	RCC->APB2ENR |= (1<<8);			//ADC1
+	RCC->APB1ENR |= (1<<1);			//TIM3
+	RCC->AHB1ENR |= (1<<22);		//DMA2
+	for(unsigned int i = 0; i < n; i++)
+	{
+		adc_Gpio_Analog(cfg->channels[i]);
+	}
+
+	ADC1->CR2 = 0;
+	ADC_COMMON->CCR = (ADC_COMMON->CCR & ~(0x3<<16)) | (1<<16);	//ADCPRE = PCLK2 / 4
+
+	ADC1->CR1 = (res << 24) | (1<<26) | (1<<8);		//RES, OVRIE, SCAN
+	ADC1->SMPR1 = 0;
+	ADC1->SMPR2 = 0;
+	ADC1->SQR1 = (n - 1) << 20;
+	ADC1->SQR2 = 0;
+	ADC1->SQR3 = 0;
+	for(unsigned int i = 0; i < n; i++)
+	{
+		unsigned int ch = cfg->channels[i];
+
+		if(ch < 10)
+			ADC1->SMPR2 |= cfg->sample_time << (ch*3);
+		else
+			ADC1->SMPR1 |= cfg->sample_time << ((ch-10)*3);
+
+		if(i < 6)
+			ADC1->SQR3 |= ch << (i*5);
+		else if(i < 12)
+			ADC1->SQR2 |= ch << ((i-6)*5);
+		else
+			ADC1->SQR1 |= ch << ((i-12)*5);
+	}
+
+	if(cfg->awd_channel != ADC_AWD_OFF)
+	{
+		ADC1->HTR = cfg->awd_high;
+		ADC1->LTR = 0;
+		ADC1->CR1 |= (1<<23) | (1<<9) | (1<<6) | (cfg->awd_channel & 0x1F);	//AWDEN, AWDSGL, AWDIE
+	}
+
+	ADC1->CR2 = (1<<28) | (8<<24) | (1<<9) | (1<<8);	//EXTEN rising, TIM3 TRGO, DDS, DMA
+	adc_Dma_Arm();
+
+	psc = (ticks - 1) >> 16;
+	TIM3->CR1 = 0;
+	TIM3->PSC = psc;
+	TIM3->ARR = ticks / (psc + 1) - 1;
+	TIM3->CR2 = (2<<4);				//MMS: update event is TRGO
+	TIM3->EGR = (1<<0);				//load PSC
+	TIM3->SR  = 0;
+
+	NVIC->IP[ADC_IRQ] = (4<<4);
+	NVIC->IP[DMA2_S0_IRQ] = (4<<4);
+	NVIC->ISER[ADC_IRQ >> 5] = (1 << (ADC_IRQ & 31));
+	NVIC->ISER[DMA2_S0_IRQ >> 5] = (1 << (DMA2_S0_IRQ & 31));
+
+	ADC1->CR2 |= (1<<0);			//ADON
+	return 0;
+}
+
+void adc_Start()
+{
+	adc_scans = 0;
+	ADC_DMA->CR |= (1<<0);
+	TIM3->CNT = 0;
+	TIM3->CR1 |= (1<<0);
+}
+
+void adc_Stop()
+{
+	TIM3->CR1 &= ~(1<<0);
+	ADC_DMA->CR &= ~(1<<0);
+}
+
+unsigned int adc_Get_Average(int index)
+{
+	return adc_avg[index];
+}
+
+unsigned int adc_Scan_Count()
+{
+	return adc_scans;
+}
+
+unsigned int adc_Overruns()
+{
+	return adc_ovr;
+}
+
+void DMA2_Stream0_IRQHandler()
+{
+	unsigned int flags = DMA2->LISR & 0x3D;
+	const unsigned short *block;
+	unsigned int n = adc_cfg.n_channels, scans = adc_block_scans;
+
+	DMA2->LIFCR = flags;
+	if(!(flags & (1<<5)))		//only TCIF is interesting here
+		return;
+
+	/* CT points at the block DMA is filling now, the other one is done */
+	block = (ADC_DMA->CR & (1<<19)) ? adc_buf[0] : adc_buf[1];
+
+	for(unsigned int c = 0; c < n; c++)
+	{
+		unsigned int sum = 0;
+		for(unsigned int s = 0; s < scans; s++)
+		{
+			sum += block[s*n + c];
+		}
+		adc_avg[c] = sum / scans;
+	}
+	adc_scans += scans;
+
+	if(adc_cfg.block_cb)
+		adc_cfg.block_cb(block, scans);
+}
+
+void ADC_IRQHandler()
+{
+	unsigned int sr = ADC1->SR;
+
+	if(sr & (1<<5))				//OVR: DMA has stopped, re-align the buffer
+	{
+		adc_ovr++;
+		ADC1->CR2 &= ~(1<<8);
+		ADC1->SR = ~(1<<5);
+		adc_Dma_Arm();
+		ADC_DMA->CR |= (1<<0);
+		ADC1->CR2 |= (1<<8);
+	}
+	if(sr & (1<<0))				//AWD: move the window to the other side
+	{
+		ADC1->SR = ~(1<<0);
+		awd_above = !awd_above;
+		if(awd_above)
+		{
+			ADC1->LTR = adc_cfg.awd_low;
+			ADC1->HTR = 0xFFF;
+		}
+		else
+		{
+			ADC1->LTR = 0;
+			ADC1->HTR = adc_cfg.awd_high;
+		}
+		if(adc_cfg.awd_cb)
+			adc_cfg.awd_cb(awd_above);
+	}
+}
@@ -0,0 +1,55 @@
+/*
+ * adc.h
+ *
+ *  Created on: Feb 20, 2025
+ *      Author: moni
+ *
+ *  ADC1 timer-triggered scan acquisition into a DMA double buffer.
+ *
+ *  TIM3 TRGO starts one scan of the channel list per sample period. DMA2
+ *  Stream0 (channel 0) writes the results into two blocks in double-buffer
+ *  mode; when a block is full the callback gets it while DMA fills the other.
+ *
+ *  The F401 ADC has no hardware oversampler, so averaging is done once per
+ *  block in the DMA interrupt: every channel is averaged over the block and
+ *  the result is published through adc_Get_Average().
+ *
+ *  The analog watchdog is run as a comparator with hysteresis: after a
+ *  crossing the window is moved so the next interrupt only comes when the
+ *  signal crosses back, so a level beyond the threshold does not keep
+ *  interrupting.
+ */
+
+#ifndef ADC_H_
+#define ADC_H_
+
+#define ADC_MAX_CHANNELS	16
+#define ADC_BLOCK_SAMPLES	256		//samples per block, per half of the double buffer
+
+#define ADC_AWD_OFF			0xFF
+
+typedef void (*adc_block_callback)(const unsigned short *samples, unsigned int scans);
+typedef void (*adc_awd_callback)(int above);
+
+struct adc_config
+{
+	unsigned int sample_rate;		//scans per second
+	unsigned char resolution;		//12, 10, 8 or 6 bits
+	unsigned char sample_time;		//SMPx code 0..7 = 3,15,28,56,84,112,144,480 cycles
+	unsigned char n_channels;
+	unsigned char channels[ADC_MAX_CHANNELS];
+	unsigned char awd_channel;		//ADC_AWD_OFF to disable
+	unsigned short awd_high;		//crossing upwards reports above = 1
+	unsigned short awd_low;			//crossing back below reports above = 0
+	adc_block_callback block_cb;
+	adc_awd_callback awd_cb;
+};
+
+int  adc_Init(const struct adc_config *cfg);
+void adc_Start(void);
+void adc_Stop(void);
+unsigned int adc_Get_Average(int index);
+unsigned int adc_Scan_Count(void);
+unsigned int adc_Overruns(void);
+
+#endif /* ADC_H_ */
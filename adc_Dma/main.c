@@ -0,0 +1,174 @@
+/**
+ ******************************************************************************
+ * @file    adc_Dma.c
+ * @author  Monish Kumar.k
+ * @date    20/02/2025
+ * @brief   Analog PIR / IR sensor acquisition with ADC1 scan + DMA and a
+ *          samples-per-second benchmark.
+ *
+ * @details
+ * The PIR and IR sensor outputs are read as analog levels instead of digital
+ * pins, so the signal strength is visible and the thresholds can be tuned:
+ *
+ *  - PA0 / ADC1_IN0 : PIR sensor output
+ *  - PA1 / ADC1_IN1 : IR sensor output (analog out of the module)
+ *  - PC13           : LED, driven only by the analog watchdog interrupt
+ *
+ * The watchdog watches IN0: the LED turns on when the PIR level rises above
+ * PIR_HIGH and off again once it falls below PIR_LOW. The main loop never
+ * polls the ADC.
+ *
+ * Benchmark:
+ *  - Runs the same two channel scan at increasing trigger rates for
+ *    BENCH_MS each, then reports the measured samples/s, overruns and the
+ *    share of CPU cycles spent in the DMA interrupt.
+ *  - Results are logged with LOG() (binary_Log) on USART2 and kept in bench[].
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 20/02/2025
+  File : adc_Dma
+ ******************************************************************************/
+#include <arm.h>
+#include <rcc.h>
+#include <uart.h>
+#include <log.h>
+#include "adc.h"
+
+#define PIR_HIGH		2600
+#define PIR_LOW			2200
+#define BENCH_MS		200
+
+struct bench_result
+{
+	unsigned int rate;
+	unsigned int samples_per_s;
+	unsigned int overruns;
+	unsigned int isr_permille;
+};
+
+static const unsigned int bench_rates[] = { 1000, 10000, 100000, 250000, 500000 };
+volatile struct bench_result bench[sizeof(bench_rates) / sizeof(bench_rates[0])];
+
+void rcc_Config(void);
+void gpio_Moder(void);
+void pir_Awd(int above);
+void bench_Run(void);
+struct adc_config sensor_Config(unsigned int rate);
+
+int main(void)
+{
+	struct adc_config cfg;
+
+	rcc_Config();
+	gpio_Moder();
+	uart_Init(UART_CONSOLE, 921600);
+	log_Init();
+
+	bench_Run();
+
+	cfg = sensor_Config(1000);
+	cfg.awd_cb = pir_Awd;
+	adc_Init(&cfg);
+	adc_Start();
+	while(1)
+	{
+		log_Drain(UART_CONSOLE);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* APB1 /2 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+void gpio_Moder()
+{
+	RCC->AHB1ENR |= (1<<2);
+	GPIOC->MODER = (GPIOC->MODER & ~(0x3<<26)) | (1<<26);	/* PC13 output */
+	GPIOC->BSRR = (1<<13);									/* LED off (active low) */
+}
+
+struct adc_config sensor_Config(unsigned int rate)
+{
+	struct adc_config cfg = { 0 };
+
+	cfg.sample_rate = rate;
+	cfg.resolution  = 12;
+	cfg.sample_time = 1;			/* 15 cycles, sensor outputs are low impedance */
+	cfg.n_channels  = 2;
+	cfg.channels[0] = 0;
+	cfg.channels[1] = 1;
+	cfg.awd_channel = 0;
+	cfg.awd_high    = PIR_HIGH;
+	cfg.awd_low     = PIR_LOW;
+	return cfg;
+}
+
+void pir_Awd(int above)
+{
+	GPIOC->BSRR = above ? (1<<(13+16)) : (1<<13);
+	LOG("PIR above threshold %u, avg IN0 %u IN1 %u", above, adc_Get_Average(0), adc_Get_Average(1));
+}
+
+void bench_Run()
+{
+	struct adc_config cfg;
+	unsigned int ms_cycles = rcc_Get_Sysclk() / 1000;
+
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);		/* CYCCNTENA */
+
+	for(unsigned int i = 0; i < sizeof(bench_rates) / sizeof(bench_rates[0]); i++)
+	{
+		unsigned int start, busy, idle = 0, t;
+		unsigned int ovr = adc_Overruns();
+
+		bench[i].rate = bench_rates[i];
+		cfg = sensor_Config(bench_rates[i]);
+		cfg.awd_channel = ADC_AWD_OFF;
+		if(adc_Init(&cfg) != 0)
+		{
+			LOG("rate %u not reachable", bench_rates[i]);
+			continue;
+		}
+
+		/* idle-loop counting: cycles the main loop did not get went to the ISR */
+		adc_Start();
+		start = DWT->CYCCNT;
+		t = start;
+		while(DWT->CYCCNT - start < BENCH_MS * ms_cycles)
+		{
+			unsigned int now = DWT->CYCCNT;
+			if(now - t < 64)
+			{
+				idle += now - t;
+			}
+			t = now;
+		}
+		adc_Stop();
+		busy = BENCH_MS * ms_cycles - idle;
+
+		bench[i].samples_per_s = adc_Scan_Count() * cfg.n_channels * (1000 / BENCH_MS);
+		bench[i].overruns = adc_Overruns() - ovr;
+		bench[i].isr_permille = (unsigned int)((unsigned long long)busy * 1000 / (BENCH_MS * ms_cycles));
+		LOG("rate %u: %u samples/s, %u overruns, isr load %u/1000", bench[i].rate,
+			bench[i].samples_per_s, bench[i].overruns, bench[i].isr_permille);
+		log_Drain(UART_CONSOLE);
+	}
+}
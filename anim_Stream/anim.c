@@ -0,0 +1,104 @@
+/**
+ ******************************************************************************
+ * @file    anim.c
+ * @author  Monish Kumar.k
+ * @date    27/03/2025
+ * @brief   Streaming decoder for delta / zero-byte-mask compressed animations
+ *          with a one-frame-ahead double buffer.
+ ******************************************************************************
+ */
+#include "anim.h"
+
+unsigned int anim_Decode(const unsigned char **pos, unsigned long long *frame)
+{
+	const unsigned char *s = *pos;
+	unsigned int v = 0, shift = 0, mask, same;
+	unsigned long long delta = 0;
+
+	do
+	{
+		v |= (unsigned int)(*s & 0x7F) << shift;
+		shift += 7;
+	} while(*s++ & 0x80);
+	same = v & 1;
+
+	mask = *s++;
+	if(same)
+	{
+		/* bit y of the mask -> 0x01 in byte y, then one multiply puts b in every lane */
+		unsigned int lo = ((mask & 0x0F) * 0x00204081u) & 0x01010101u;
+		unsigned int hi = ((mask >> 4) * 0x00204081u) & 0x01010101u;
+
+		delta = ((((unsigned long long)hi) << 32) | lo) * *s++;
+	}
+	else
+	{
+		for(unsigned int y = 0; y < 8; y++)
+		{
+			if(mask & (1u << y))
+				delta |= (unsigned long long)*s++ << (y*8);
+		}
+	}
+	*frame ^= delta;
+	*pos = s;
+	return v >> 1;
+}
+
+static void decode_Next(struct anim_player *p, unsigned int slot)
+{
+	unsigned long long f = p->frame[slot ^ 1];
+
+	if(p->index == p->a->frames)		//wrap: first frame is a delta against 0
+	{
+		p->pos = p->a->data;
+		p->index = 0;
+		f = 0;
+	}
+	p->ms[slot] = anim_Decode(&p->pos, &f);
+	p->frame[slot] = f;
+	p->index++;
+}
+
+void anim_Start(struct anim_player *p, const struct anim *a, anim_output out)
+{
+	p->a = a;
+	p->out = out;
+	p->pos = a->data;
+	p->index = 0;
+	p->late = 0;
+	p->frame[1] = 0;
+	decode_Next(p, 0);
+	p->cur = 0;
+	p->remaining = (int)p->ms[0];
+	out(p->frame[0]);
+	decode_Next(p, 1);
+	__asm volatile("" ::: "memory");		//frame[] and ms[] are complete before the interrupt sees ready
+	p->ready = 1;
+}
+
+/* interrupt side: O(1), never decodes */
+void anim_Update(struct anim_player *p, unsigned int elapsed_ms)
+{
+	p->remaining -= (int)elapsed_ms;
+	if(p->remaining > 0)
+		return;
+	if(!p->ready)
+	{
+		p->late++;
+		return;
+	}
+	p->cur ^= 1;
+	p->remaining += (int)p->ms[p->cur];
+	p->ready = 0;
+	p->out(p->frame[p->cur]);
+}
+
+/* background side: fill the back frame once it has been taken */
+void anim_Decode_Ahead(struct anim_player *p)
+{
+	if(p->ready)
+		return;
+	decode_Next(p, p->cur ^ 1);
+	__asm volatile("" ::: "memory");		//as in anim_Start(): no frame[]/ms[] store after ready = 1
+	p->ready = 1;
+}
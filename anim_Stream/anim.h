@@ -0,0 +1,62 @@
+/*
+ * anim.h
+ *
+ *  Created on: Mar 27, 2025
+ *      Author: moni
+ *
+ *  Compressed 8x8 / 8-LED animations streamed from flash.
+ *
+ *  A frame is a 64-bit bitmap in the led_Matrix layout (row y in byte y);
+ *  single LED rows such as PA0..PA7 just use byte 0. Each frame record,
+ *  produced by anim_Encode.py, is:
+ *
+ *      varint   (duration_ms << 1) | same
+ *      byte     mask: bit y set when byte y differs from the previous frame
+ *      bytes    XOR delta of the differing bytes, in order of y; when
+ *               'same' is set all of them are equal and stored once
+ *
+ *  The first frame is a delta against 0. With the 64..8191 ms durations of
+ *  anims.txt the varint takes 2 bytes, so a column sweep frame (all rows
+ *  change by the same byte) is 4 bytes and an unchanged frame (pure delay)
+ *  3 bytes; below 64 ms both are one byte shorter. anim_Encode.py --check
+ *  prints the totals: 4.0 bytes per frame against 10 raw.
+ *
+ *  Playback keeps two frames: the one shown and the next, already
+ *  decoded. anim_Update() only swaps and is cheap enough for an interrupt;
+ *  anim_Decode_Ahead() refills the back frame from the main loop.
+ */
+
+#ifndef ANIM_H_
+#define ANIM_H_
+
+struct anim
+{
+	const unsigned char *data;
+	unsigned int size;				//bytes
+	unsigned int frames;
+};
+
+typedef void (*anim_output)(unsigned long long frame);
+
+struct anim_player
+{
+	const struct anim *a;
+	const unsigned char *pos;		//next record to decode
+	unsigned int index;				//frames decoded so far
+	unsigned long long frame[2];	//shown, next
+	unsigned int ms[2];				//durations of both
+	volatile unsigned int cur;
+	volatile unsigned int ready;	//back frame is decoded
+	int remaining;					//ms left for the shown frame
+	unsigned int late;				//swaps that found the back frame not ready
+	anim_output out;
+};
+
+void anim_Start(struct anim_player *p, const struct anim *a, anim_output out);
+void anim_Update(struct anim_player *p, unsigned int elapsed_ms);
+void anim_Decode_Ahead(struct anim_player *p);
+
+/* decodes the record at *pos into *frame (delta applied), returns its duration */
+unsigned int anim_Decode(const unsigned char **pos, unsigned long long *frame);
+
+#endif /* ANIM_H_ */
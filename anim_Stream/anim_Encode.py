@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""
+anim_Encode.py - host side encoder for the compressed animations (anim.h).
+
+Input is a text file with one or more animations:
+
+    anim pattern_0              # starts a new animation, name is a C identifier
+    100 0101010101010101        # duration in ms, frame as 64-bit hex
+    100 rows 03                 # 'rows XX' = byte XX in all eight rows
+    500 same                    # frame unchanged, only the delay
+
+Output is a C file with one byte array and one struct anim per animation.
+
+Usage:
+    anim_Encode.py anims.txt -o anims.c
+    anim_Encode.py anims.txt --check        # decode again and compare
+
+Author: Monish Kumar.k
+Date  : 27/03/2025
+"""
+
+import argparse
+import sys
+
+
+def varint(v):
+    out = bytearray()
+    while True:
+        b = v & 0x7F
+        v >>= 7
+        if v:
+            out.append(b | 0x80)
+        else:
+            out.append(b)
+            return out
+
+
+def encode_frame(prev, cur, ms):
+    delta = prev ^ cur
+    lanes = [(delta >> (8 * y)) & 0xFF for y in range(8)]
+    mask = 0
+    for y in range(8):
+        if lanes[y]:
+            mask |= 1 << y
+    used = [b for b in lanes if b]
+    same = 1 if len(used) > 1 and all(b == used[0] for b in used) else 0
+    out = varint((ms << 1) | same)
+    out.append(mask)
+    out += bytes(used[:1] if same else used)
+    return out
+
+
+def decode(data, frames):
+    pos, f, out = 0, 0, []
+    for _ in range(frames):
+        v, shift = 0, 0
+        while True:
+            b = data[pos]
+            pos += 1
+            v |= (b & 0x7F) << shift
+            shift += 7
+            if not b & 0x80:
+                break
+        mask = data[pos]
+        pos += 1
+        delta = 0
+        if v & 1:
+            b = data[pos]
+            pos += 1
+            for y in range(8):
+                if mask >> y & 1:
+                    delta |= b << (8 * y)
+        else:
+            for y in range(8):
+                if mask >> y & 1:
+                    delta |= data[pos] << (8 * y)
+                    pos += 1
+        f ^= delta
+        out.append((v >> 1, f))
+    return out
+
+
+def parse(path):
+    anims, cur = [], None
+    with open(path) as fh:
+        for n, line in enumerate(fh, 1):
+            line = line.split("#", 1)[0].split()
+            if not line:
+                continue
+            if line[0] == "anim":
+                cur = (line[1], [])
+                anims.append(cur)
+                continue
+            if cur is None:
+                sys.exit("%s:%d: frame before 'anim'" % (path, n))
+            ms = int(line[0], 0)
+            if line[1] == "same":
+                frame = cur[1][-1][1] if cur[1] else 0
+            elif line[1] == "rows":
+                frame = int(line[2], 16) * 0x0101010101010101
+            else:
+                frame = int(line[1], 16)
+            if not 0 < ms < 1 << 30 or frame >> 64:
+                sys.exit("%s:%d: bad duration or frame" % (path, n))
+            cur[1].append((ms, frame))
+    return anims
+
+
+def main():
+    ap = argparse.ArgumentParser(description="encode LED animations for anim.h")
+    ap.add_argument("input")
+    ap.add_argument("-o", "--output", help="C file to write (default stdout)")
+    ap.add_argument("--check", action="store_true", help="decode and compare, print sizes")
+    args = ap.parse_args()
+
+    anims = parse(args.input)
+    text = ["/* generated by anim_Encode.py from %s, do not edit */" % args.input,
+            '#include "anim.h"', ""]
+    for name, frames in anims:
+        data, prev = bytearray(), 0
+        for ms, f in frames:
+            data += encode_frame(prev, f, ms)
+            prev = f
+        if decode(data, len(frames)) != frames:
+            sys.exit("%s: decode mismatch" % name)
+        if args.check:
+            print("%-20s %3d frames %4d bytes (%.1f per frame, raw %d)" %
+                  (name, len(frames), len(data), len(data) / len(frames), len(frames) * 10))
+        text.append("static const unsigned char %s_data[%d] =\n{" % (name, len(data)))
+        for i in range(0, len(data), 12):
+            text.append("\t" + " ".join("0x%02X," % b for b in data[i:i + 12]))
+        text.append("};\n")
+        text.append("const struct anim %s = { %s_data, %d, %d };\n" % (name, name, len(data), len(frames)))
+
+    if args.check:
+        return
+    out = "\n".join(text)
+    if args.output:
+        with open(args.output, "w") as fh:
+            fh.write(out)
+    else:
+        sys.stdout.write(out)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,51 @@
+/* generated by anim_Encode.py from anims.txt, do not edit */
+#include "anim.h"
+
+static const unsigned char patterns_data[68] =
+{
+	0xC9, 0x01, 0xFF, 0x01, 0xC9, 0x01, 0xFF, 0x02, 0xC9, 0x01, 0xFF, 0x04,
+	0xC9, 0x01, 0xFF, 0x08, 0xC9, 0x01, 0xFF, 0x10, 0xC9, 0x01, 0xFF, 0x20,
+	0xC9, 0x01, 0xFF, 0x40, 0xE9, 0x07, 0xFF, 0x80, 0xC9, 0x01, 0xFF, 0xFE,
+	0xC9, 0x01, 0xFF, 0x03, 0xC9, 0x01, 0xFF, 0x06, 0xC9, 0x01, 0xFF, 0x0C,
+	0xC9, 0x01, 0xFF, 0x18, 0xC9, 0x01, 0xFF, 0x30, 0xC9, 0x01, 0xFF, 0x60,
+	0xC9, 0x01, 0xFF, 0xC0, 0xC9, 0x01, 0xFF, 0x80,
+};
+
+const struct anim patterns = { patterns_data, 68, 17 };
+
+static const unsigned char pattern0_data[32] =
+{
+	0xC9, 0x01, 0xFF, 0x01, 0xC9, 0x01, 0xFF, 0x02, 0xC9, 0x01, 0xFF, 0x04,
+	0xC9, 0x01, 0xFF, 0x08, 0xC9, 0x01, 0xFF, 0x10, 0xC9, 0x01, 0xFF, 0x20,
+	0xC9, 0x01, 0xFF, 0x40, 0xC9, 0x01, 0xFF, 0x80,
+};
+
+const struct anim pattern0 = { pattern0_data, 32, 8 };
+
+static const unsigned char pattern1_data[32] =
+{
+	0xC9, 0x01, 0xFF, 0x80, 0xC9, 0x01, 0xFF, 0x40, 0xC9, 0x01, 0xFF, 0x20,
+	0xC9, 0x01, 0xFF, 0x10, 0xC9, 0x01, 0xFF, 0x08, 0xC9, 0x01, 0xFF, 0x04,
+	0xC9, 0x01, 0xFF, 0x02, 0xC9, 0x01, 0xFF, 0x01,
+};
+
+const struct anim pattern1 = { pattern1_data, 32, 8 };
+
+static const unsigned char led_column_data[68] =
+{
+	0xC8, 0x01, 0x01, 0x01, 0xC8, 0x01, 0x01, 0x03, 0xC8, 0x01, 0x01, 0x06,
+	0xC8, 0x01, 0x01, 0x0C, 0xC8, 0x01, 0x01, 0x18, 0xC8, 0x01, 0x01, 0x30,
+	0xC8, 0x01, 0x01, 0x60, 0xC8, 0x01, 0x01, 0xC0, 0xC8, 0x01, 0x01, 0x80,
+	0xF8, 0x0A, 0x01, 0xAA, 0xF8, 0x0A, 0x01, 0xAA, 0xF8, 0x0A, 0x01, 0x55,
+	0xF8, 0x0A, 0x01, 0x55, 0xF8, 0x0A, 0x01, 0x0F, 0xF8, 0x0A, 0x01, 0x0F,
+	0xF8, 0x0A, 0x01, 0xF0, 0xF8, 0x0A, 0x01, 0xF0,
+};
+
+const struct anim led_column = { led_column_data, 68, 17 };
+
+static const unsigned char blink_c13_data[8] =
+{
+	0xD0, 0x0F, 0x01, 0x01, 0xD0, 0x0F, 0x01, 0x01,
+};
+
+const struct anim blink_c13 = { blink_c13_data, 8, 2 };
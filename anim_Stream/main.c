@@ -0,0 +1,160 @@
+/**
+ ******************************************************************************
+ * @file    anim_Stream.c
+ * @author  Monish Kumar.k
+ * @date    27/03/2025
+ * @brief   The 8x8_Led_Display patterns and the PC13 blink played from
+ *          compressed animations, with a decode benchmark.
+ *
+ * @details
+ * Hardware Connections: as led_Matrix (rows PA0..PA7, columns PB0, PB1,
+ * PB2, PB5..PB9), LED on PC13 (active low), USART1 TX on PA9 for the log.
+ *
+ * pattern_0()/pattern_1(), pattern0()/pattern1(), led_Blink_C13() of
+ * led_Blinking_Column and led_Blink_C13() of default_C13 are now the
+ * animations in anims.txt (4 bytes of flash per frame, see anim_Encode.py).
+ * Both players advance from the TIM4 frame hook (8 ms per refresh frame)
+ * and decode their next frame in the main loop.
+ *
+ * Benchmark:
+ *  - anim_Decode() over every frame of every animation, average and worst
+ *    cycles per frame, plus bytes of flash per frame.
+ *  Results are logged with LOG() on USART1 and kept in bench[].
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 27/03/2025
+  File : anim_Stream
+ ******************************************************************************/
+#include <arm.h>
+#include <uart.h>
+#include <log.h>
+#include <matrix.h>
+#include "anim.h"
+
+#define LOG_PORT		UART_1
+#define FRAME_MS		(1000 / MATRIX_REFRESH_HZ)
+#define BENCH_LOOPS		16
+
+extern const struct anim patterns, pattern0, pattern1, led_column, blink_c13;
+
+struct bench_result
+{
+	unsigned int avg_cycles;
+	unsigned int max_cycles;
+	unsigned int bytes_per_frame_x10;
+};
+
+static const struct anim *const bench_anims[] = { &patterns, &pattern0, &pattern1, &led_column, &blink_c13 };
+volatile struct bench_result bench[sizeof(bench_anims) / sizeof(bench_anims[0])];
+
+static struct matrix led;
+static struct anim_player matrix_player, c13_player;
+
+void rcc_Config(void);
+void gpio_Moder(void);
+void matrix_Out(unsigned long long frame);
+void c13_Out(unsigned long long frame);
+void anim_Frame(void);
+void bench_Run(void);
+
+int main(void)
+{
+	rcc_Config();
+	gpio_Moder();
+	uart_Init(LOG_PORT, 921600);
+	log_Init();
+
+	bench_Run();
+
+	matrix_Init(&led, &matrix_direct, 1);
+	anim_Start(&matrix_player, &patterns, matrix_Out);
+	anim_Start(&c13_player, &blink_c13, c13_Out);
+	matrix_Scan_Hook(anim_Frame);
+	while(1)
+	{
+		anim_Decode_Ahead(&matrix_player);
+		anim_Decode_Ahead(&c13_player);
+		log_Drain(LOG_PORT);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* APB1 /2 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+void gpio_Moder()
+{
+	RCC->AHB1ENR |= (1<<2);
+	GPIOC->MODER = (GPIOC->MODER & ~(0x3<<26)) | (1<<26);	/* PC13 output */
+	GPIOC->BSRR = (1<<13);									/* LED off (active low) */
+}
+
+void matrix_Out(unsigned long long frame)
+{
+	led.fb[0] = frame;
+	matrix_Show(&led);
+}
+
+void c13_Out(unsigned long long frame)
+{
+	GPIOC->BSRR = (frame & 1) ? (1<<(13+16)) : (1<<13);
+}
+
+/* TIM4 frame hook */
+void anim_Frame()
+{
+	anim_Update(&matrix_player, FRAME_MS);
+	anim_Update(&c13_player, FRAME_MS);
+}
+
+void bench_Run()
+{
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);		/* CYCCNTENA */
+
+	for(unsigned int i = 0; i < sizeof(bench_anims) / sizeof(bench_anims[0]); i++)
+	{
+		const struct anim *a = bench_anims[i];
+		unsigned int total = 0, worst = 0;
+
+		for(unsigned int loop = 0; loop < BENCH_LOOPS; loop++)
+		{
+			const unsigned char *pos = a->data;
+			unsigned long long f = 0;
+
+			for(unsigned int n = 0; n < a->frames; n++)
+			{
+				unsigned int start = DWT->CYCCNT, c;
+
+				anim_Decode(&pos, &f);
+				c = DWT->CYCCNT - start;
+				total += c;
+				if(c > worst)
+					worst = c;
+			}
+		}
+		bench[i].avg_cycles = total / (BENCH_LOOPS * a->frames);
+		bench[i].max_cycles = worst;
+		bench[i].bytes_per_frame_x10 = a->size * 10 / a->frames;
+		LOG("anim %u: %u frames, %u/10 bytes/frame, decode %u cycles average, %u worst", i,
+			a->frames, bench[i].bytes_per_frame_x10, bench[i].avg_cycles, bench[i].max_cycles);
+		log_Drain(LOG_PORT);
+	}
+}
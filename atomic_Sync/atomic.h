@@ -0,0 +1,230 @@
+/*
+ * atomic.h
+ *
+ *  Created on: Apr 26, 2025
+ *      Author: moni
+ *
+ *  Data shared between ISRs and main() on the Cortex-M4.
+ *
+ *  Lock-free (LDREX/STREX):
+ *   - atomic_Cas(p, &expected, desired) : 1 and *p = desired if *p was
+ *     expected, else 0 and expected = *p
+ *   - atomic_Fetch_Add / _Or / _And     : old value returned
+ *  Exception entry and return clear the exclusive monitor, so a STREX that
+ *  was interrupted fails and the loop retries: an ISR between LDREX and
+ *  STREX can never have its own update overwritten. Use them on RAM only,
+ *  not on peripheral registers.
+ *
+ *  atomic_Flag_Set / _Clear: one bit through the bit-band alias (bitband.h),
+ *  a single store, for flags in SRAM or in a peripheral register that is
+ *  not rc_w0 / rc_w1. GPIO outputs have BSRR, use that instead.
+ *
+ *  Critical sections:
+ *   - crit_Enter(prio) masks the interrupts of priority prio and lower
+ *     (BASEPRI_MAX, it only ever raises the mask, so they nest) and leaves
+ *     the more urgent ones running. prio must be 1..15; crit_Exit(saved).
+ *   - crit_Enter_All() / crit_Exit_All(saved): PRIMASK, everything but
+ *     NMI and HardFault.
+ *
+ *  Sequence lock for multi-word state (64-bit uptime, a struct): the
+ *  writer bumps seq to odd, writes, bumps it to even; a reader copies and
+ *  retries when seq was odd or has changed. The writer must not be
+ *  preempted by a reader that retries (on one core it would spin forever):
+ *  write from the ISR, read from main() or from lower-priority ISRs.
+ *
+ *  On any other target (a host build) the same functions map onto the GCC
+ *  __atomic builtins with sequentially consistent ordering, and the critical
+ *  sections do nothing; that is the portable version for host tests.
+ */
+
+#ifndef ATOMIC_H_
+#define ATOMIC_H_
+
+#if defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_7M__)
+
+#include <bitband.h>
+
+static inline unsigned int atomic_Ldrex(volatile unsigned int *p)
+{
+	unsigned int v;
+	__asm volatile("ldrex %0, [%1]" : "=r"(v) : "r"(p) : "memory");
+	return v;
+}
+
+/* 0 when the store was done */
+static inline unsigned int atomic_Strex(volatile unsigned int *p, unsigned int v)
+{
+	unsigned int fail;
+	__asm volatile("strex %0, %2, [%1]" : "=&r"(fail) : "r"(p), "r"(v) : "memory");
+	return fail;
+}
+
+static inline void atomic_Dmb(void)
+{
+	__asm volatile("dmb" : : : "memory");
+}
+
+static inline int atomic_Cas(volatile unsigned int *p, unsigned int *expected, unsigned int desired)
+{
+	unsigned int old;
+
+	do
+	{
+		old = atomic_Ldrex(p);
+		if(old != *expected)
+		{
+			__asm volatile("clrex" : : : "memory");
+			*expected = old;
+			return 0;
+		}
+	} while(atomic_Strex(p, desired));
+	return 1;
+}
+
+static inline unsigned int atomic_Fetch_Add(volatile unsigned int *p, unsigned int v)
+{
+	unsigned int old;
+
+	do
+	{
+		old = atomic_Ldrex(p);
+	} while(atomic_Strex(p, old + v));
+	return old;
+}
+
+static inline unsigned int atomic_Fetch_Or(volatile unsigned int *p, unsigned int v)
+{
+	unsigned int old;
+
+	do
+	{
+		old = atomic_Ldrex(p);
+	} while(atomic_Strex(p, old | v));
+	return old;
+}
+
+static inline unsigned int atomic_Fetch_And(volatile unsigned int *p, unsigned int v)
+{
+	unsigned int old;
+
+	do
+	{
+		old = atomic_Ldrex(p);
+	} while(atomic_Strex(p, old & v));
+	return old;
+}
+
+static inline void atomic_Flag_Set(volatile unsigned int *p, unsigned int bit)
+{
+	BITBAND(p, bit) = 1;
+}
+
+static inline void atomic_Flag_Clear(volatile unsigned int *p, unsigned int bit)
+{
+	BITBAND(p, bit) = 0;
+}
+
+static inline unsigned int crit_Enter(unsigned int prio)
+{
+	unsigned int basepri;
+
+	__asm volatile("mrs %0, basepri" : "=r"(basepri) : : "memory");
+	__asm volatile("msr basepri_max, %0" : : "r"(prio << 4) : "memory");
+	return basepri;
+}
+
+static inline void crit_Exit(unsigned int basepri)
+{
+	__asm volatile("msr basepri, %0" : : "r"(basepri) : "memory");
+}
+
+static inline unsigned int crit_Enter_All(void)
+{
+	unsigned int primask;
+
+	__asm volatile("mrs %0, primask\n\tcpsid i" : "=r"(primask) : : "memory");
+	return primask;
+}
+
+static inline void crit_Exit_All(unsigned int primask)
+{
+	__asm volatile("msr primask, %0" : : "r"(primask) : "memory");
+}
+
+#else
+
+static inline void atomic_Dmb(void)
+{
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline int atomic_Cas(volatile unsigned int *p, unsigned int *expected, unsigned int desired)
+{
+	return __atomic_compare_exchange_n(p, expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline unsigned int atomic_Fetch_Add(volatile unsigned int *p, unsigned int v)
+{
+	return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST);
+}
+
+static inline unsigned int atomic_Fetch_Or(volatile unsigned int *p, unsigned int v)
+{
+	return __atomic_fetch_or(p, v, __ATOMIC_SEQ_CST);
+}
+
+static inline unsigned int atomic_Fetch_And(volatile unsigned int *p, unsigned int v)
+{
+	return __atomic_fetch_and(p, v, __ATOMIC_SEQ_CST);
+}
+
+static inline void atomic_Flag_Set(volatile unsigned int *p, unsigned int bit)
+{
+	__atomic_fetch_or(p, 1u << bit, __ATOMIC_SEQ_CST);
+}
+
+static inline void atomic_Flag_Clear(volatile unsigned int *p, unsigned int bit)
+{
+	__atomic_fetch_and(p, ~(1u << bit), __ATOMIC_SEQ_CST);
+}
+
+static inline unsigned int crit_Enter(unsigned int prio)	{ (void)prio; return 0; }
+static inline void crit_Exit(unsigned int basepri)			{ (void)basepri; }
+static inline unsigned int crit_Enter_All(void)				{ return 0; }
+static inline void crit_Exit_All(unsigned int primask)		{ (void)primask; }
+
+#endif
+
+struct seqlock
+{
+	volatile unsigned int seq;
+};
+
+static inline void seq_Write_Begin(struct seqlock *s)
+{
+	s->seq = s->seq + 1;
+	atomic_Dmb();
+}
+
+static inline void seq_Write_End(struct seqlock *s)
+{
+	atomic_Dmb();
+	s->seq = s->seq + 1;
+}
+
+static inline unsigned int seq_Read_Begin(struct seqlock *s)
+{
+	unsigned int seq = s->seq;
+
+	atomic_Dmb();
+	return seq;
+}
+
+/* 1: the copy made since seq_Read_Begin() may be torn, read again */
+static inline int seq_Retry(struct seqlock *s, unsigned int seq)
+{
+	atomic_Dmb();
+	return (seq & 1) || s->seq != seq;
+}
+
+#endif /* ATOMIC_H_ */
@@ -0,0 +1,243 @@
+/**
+ ******************************************************************************
+ * @file    atomic_Test.c
+ * @author  Monish Kumar.k
+ * @date    26/04/2025
+ * @brief   Host stress test of the portable (__atomic) atomic.h: a signal
+ *          handler plays the ISR and preempts the main-side operations.
+ *
+ * @details
+ * Build and run on the host (Linux x86-64):
+ *
+ *     gcc -O2 -o atomic_Test atomic_Test.c && ./atomic_Test
+ *
+ * isr() does what TIM2/TIM3 do in main.c: plain ++, atomic_Fetch_Add(),
+ * an atomic_Cas() increment loop, and a seqlock write of a 64-bit uptime
+ * that advances by STEP (so both words change at every write and a torn
+ * value is not a multiple of STEP).
+ *
+ * 1. Every preemption point. Each main-side operation is single-stepped
+ *    (x86 trap flag) and isr() runs at instruction 1, then 2, 3, ... until
+ *    the operation finishes first. Counted over all points:
+ *     - plain ++ must lose the ISR's update at some point,
+ *     - atomic_Fetch_Add() and the atomic_Cas() loop must lose none,
+ *     - a two-word read without the lock must be torn at some point,
+ *     - the same read under the seqlock must never return a torn value.
+ * 2. Timer. SIGALRM every 20 us for STRESS_S seconds while main() runs the
+ *    same operations in a loop: no update lost by the atomics, no torn
+ *    seqlock read; the plain ++ losses are printed.
+ * Exits non-zero on a failure.
+ ******************************************************************************
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/time.h>
+#include "atomic.h"
+
+#define STEP			0x100000001ULL		//uptime step: both words change
+#define STRESS_S		1
+
+static volatile unsigned int plain_count, atomic_count, cas_count, isr_runs;
+static volatile unsigned int uptime_lo, uptime_hi;
+static struct seqlock uptime_lock;
+static unsigned int failures;
+
+static void isr(void)
+{
+	unsigned long long t = ((unsigned long long)uptime_hi << 32 | uptime_lo) + STEP;
+	unsigned int old = cas_count;
+
+	plain_count++;
+	atomic_Fetch_Add(&atomic_count, 1);
+	while(!atomic_Cas(&cas_count, &old, old + 1))
+	{
+	}
+	seq_Write_Begin(&uptime_lock);
+	uptime_lo = (unsigned int)t;
+	uptime_hi = (unsigned int)(t >> 32);
+	seq_Write_End(&uptime_lock);
+	isr_runs++;
+}
+
+/* ---- the main-side operations ---- */
+
+enum { OP_PLAIN, OP_FETCH_ADD, OP_CAS, OP_READ_TORN, OP_READ_SEQ, OPS };
+
+static const char *const op_name[OPS] =
+{
+	"plain ++", "atomic_Fetch_Add", "atomic_Cas loop", "two-word read", "seqlock read"
+};
+
+static unsigned long long read_Plain(void)
+{
+	unsigned long long t = (unsigned long long)uptime_hi << 32;
+
+	return t | uptime_lo;
+}
+
+static unsigned long long read_Seq(void)
+{
+	unsigned long long t;
+	unsigned int seq;
+
+	do
+	{
+		seq = seq_Read_Begin(&uptime_lock);
+		t = (unsigned long long)uptime_hi << 32;
+		t |= uptime_lo;
+	} while(seq_Retry(&uptime_lock, seq));
+	return t;
+}
+
+static void cas_Add(void)
+{
+	unsigned int old = cas_count;
+
+	while(!atomic_Cas(&cas_count, &old, old + 1))
+	{
+	}
+}
+
+/* ---- single step: isr() after instruction n ---- */
+
+static volatile unsigned int step, step_isr;
+
+static void on_Trap(int sig, siginfo_t *si, void *ctx)
+{
+	(void)sig;
+	(void)si;
+	(void)ctx;
+	if(++step == step_isr)
+		isr();
+}
+
+static inline void step_On(void)
+{
+	__asm volatile("pushfq\n\torq $0x100, (%%rsp)\n\tpopfq" : : : "memory", "cc");
+}
+
+static inline void step_Off(void)
+{
+	__asm volatile("pushfq\n\tandq $~0x100, (%%rsp)\n\tpopfq" : : : "memory", "cc");
+}
+
+/* runs op once with isr() at instruction n; 0 when op finished before n */
+static int op_Step(int op, unsigned int n, unsigned long long *value)
+{
+	step = 0;
+	step_isr = n;
+	step_On();
+	switch(op)
+	{
+	case OP_PLAIN:		plain_count++;							break;
+	case OP_FETCH_ADD:	atomic_Fetch_Add(&atomic_count, 1);		break;
+	case OP_CAS:		cas_Add();								break;
+	case OP_READ_TORN:	*value = read_Plain();					break;
+	case OP_READ_SEQ:	*value = read_Seq();					break;
+	}
+	step_Off();
+	return step >= n;
+}
+
+static volatile unsigned int *op_Counter(int op)
+{
+	return (op == OP_PLAIN) ? &plain_count : (op == OP_FETCH_ADD) ? &atomic_count : &cas_count;
+}
+
+static void test_Every_Point(void)
+{
+	struct sigaction sa;
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_flags = SA_SIGINFO;
+	sa.sa_sigaction = on_Trap;
+	sigaction(SIGTRAP, &sa, NULL);
+
+	for(int op = 0; op < OPS; op++)
+	{
+		unsigned int points = 0, bad = 0;
+
+		for(unsigned int n = 1; ; n++)
+		{
+			unsigned long long value = 0;
+			unsigned int before = 0, runs = isr_runs;
+			int hit;
+
+			if(op <= OP_CAS)
+				before = *op_Counter(op);
+			hit = op_Step(op, n, &value);
+			if(!hit)
+				break;
+			points++;
+			if(op <= OP_CAS)
+				bad += (*op_Counter(op) != before + 1 + (isr_runs - runs));
+			else
+				bad += (value % STEP != 0);
+		}
+		printf("%-17s %3u preemption points, %3u %s\n", op_name[op], points, bad,
+			(op <= OP_CAS) ? "lost updates" : "torn values");
+		if(points == 0 || ((op == OP_PLAIN || op == OP_READ_TORN) ? bad == 0 : bad != 0))
+		{
+			failures++;
+			printf("FAIL %s: %s\n", op_name[op], (op == OP_PLAIN || op == OP_READ_TORN)
+				? "never broken, the test does not reach the window" : "broken by a preemption");
+		}
+	}
+}
+
+/* ---- timer ---- */
+
+static void on_Alarm(int sig)
+{
+	(void)sig;
+	isr();
+}
+
+static void test_Timer(void)
+{
+	struct sigaction sa;
+	struct itimerval it = { { 0, 20 }, { 0, 20 } }, off = { { 0, 0 }, { 0, 0 } };
+	unsigned int plain0 = plain_count, atomic0 = atomic_count, cas0 = cas_count, runs0 = isr_runs;
+	unsigned int adds = 0, torn = 0, reads = 0;
+	time_t end;
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = on_Alarm;
+	sigaction(SIGALRM, &sa, NULL);
+	setitimer(ITIMER_REAL, &it, NULL);
+	end = time(NULL) + STRESS_S + 1;
+	while(time(NULL) < end)
+	{
+		for(int k = 0; k < 100000; k++)
+		{
+			plain_count++;
+			atomic_Fetch_Add(&atomic_count, 1);
+			cas_Add();
+			adds++;
+			torn += (read_Seq() % STEP != 0);
+			reads++;
+		}
+	}
+	setitimer(ITIMER_REAL, &off, NULL);
+
+	unsigned int total = adds + (isr_runs - runs0);
+	printf("timer: %u main + %u isr increments: plain ++ lost %u, atomic_Fetch_Add %u, atomic_Cas %u; "
+		"%u seqlock reads, %u torn\n", adds, isr_runs - runs0, total - (plain_count - plain0),
+		total - (atomic_count - atomic0), total - (cas_count - cas0), reads, torn);
+	if(isr_runs == runs0 || atomic_count - atomic0 != total || cas_count - cas0 != total || torn)
+	{
+		failures++;
+		printf("FAIL timer: no interrupts, an atomic lost an update or a seqlock read was torn\n");
+	}
+}
+
+int main(void)
+{
+	test_Every_Point();
+	test_Timer();
+	printf("atomic: %u failures\n", failures);
+	return failures != 0;
+}
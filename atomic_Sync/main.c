@@ -0,0 +1,258 @@
+/**
+ ******************************************************************************
+ * @file    atomic_Sync.c
+ * @author  Monish Kumar.k
+ * @date    26/04/2025
+ * @brief   Cycle cost of the atomic.h primitives, and stress runs of them
+ *          against interrupts on the target.
+ *
+ * @details
+ * Hardware Connections: none needed; USART2 TX on PA2 for the log. Clock
+ * is 84 MHz.
+ *
+ * The EXTI examples changed GPIOA_ODR with a read-modify-write in main()
+ * while their ISRs wrote it too, so an edge in between was undone. They
+ * now write BSRR, one store per change; for data in RAM there is atomic.h.
+ *
+ *  - Cost: each primitive COST_N times in a loop, minus the empty loop,
+ *    in 1/100 cycle, with no interrupt running.
+ *  - Counter stress: TIM3 (priority 6, 100 kHz) and main() both add 1 to
+ *    a plain volatile counter (++) and to one with atomic_Fetch_Add() for
+ *    STRESS_MS; lost updates = ISR + main adds - final value.
+ *  - Uptime stress: TIM2 (priority 5, 100 kHz) adds UPTIME_STEP to a
+ *    64-bit uptime, so the low word carries every 16 ticks. main() reads
+ *    it as two words, and with the sequence lock; a torn value is one
+ *    that is not a multiple of UPTIME_STEP.
+ *  - BASEPRI: inside crit_Enter(6) for 1 ms TIM3 is held off and TIM2 is
+ *    not; the ticks of each are logged.
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 26/04/2025
+  File : atomic_Sync
+ ******************************************************************************/
+#include <arm.h>
+#include <rcc.h>
+#include <uart.h>
+#include <log.h>
+#include "atomic.h"
+
+#define LOG_PORT		UART_2
+#define TIM2_IRQ		28
+#define TIM3_IRQ		29
+#define COST_N			1000
+#define STRESS_MS		1000
+#define TICK_HZ			100000
+#define UPTIME_STEP		0x10000001ull
+
+static volatile unsigned int plain_count, atomic_count;
+static volatile unsigned int tim3_ticks, tim2_ticks;
+static volatile unsigned int flags;
+
+static struct seqlock uptime_lock;
+static volatile unsigned int uptime_lo, uptime_hi;
+
+void rcc_Config(void);
+void tick_Config(volatile struct timer *tim, unsigned int irq, unsigned int prio);
+void cost_Run(void);
+void counter_Stress(void);
+void uptime_Stress(void);
+void basepri_Check(void);
+
+int main(void)
+{
+	rcc_Config();
+	uart_Init(LOG_PORT, 921600);
+	log_Init();
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);
+
+	RCC->APB1ENR |= (1<<0) | (1<<1);
+	tick_Config(TIM2, TIM2_IRQ, 5);
+	tick_Config(TIM3, TIM3_IRQ, 6);
+
+	cost_Run();
+	counter_Stress();
+	uptime_Stress();
+	basepri_Check();
+	while(1)
+	{
+		log_Drain(LOG_PORT);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* APB1 /2 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+/* TICK_HZ update interrupt, stopped */
+void tick_Config(volatile struct timer *tim, unsigned int irq, unsigned int prio)
+{
+	tim->CR1 = 0;
+	tim->PSC = 0;
+	tim->ARR = rcc_Get_Tim_Clock(1) / TICK_HZ - 1;
+	tim->EGR = (1<<0);
+	tim->SR = 0;
+	tim->DIER = (1<<0);
+	NVIC->IP[irq] = (prio<<4);
+	NVIC->ISER[irq >> 5] = (1 << (irq & 31));
+}
+
+void TIM2_IRQHandler()
+{
+	unsigned long long t;
+
+	TIM2->SR = ~(1<<0);						//rc_w0
+	t = ((unsigned long long)uptime_hi << 32 | uptime_lo) + UPTIME_STEP;
+	seq_Write_Begin(&uptime_lock);
+	uptime_lo = (unsigned int)t;
+	uptime_hi = (unsigned int)(t >> 32);
+	seq_Write_End(&uptime_lock);
+	tim2_ticks++;
+}
+
+void TIM3_IRQHandler()
+{
+	TIM3->SR = ~(1<<0);						//rc_w0
+	plain_count++;
+	atomic_Fetch_Add(&atomic_count, 1);
+	tim3_ticks++;
+}
+
+/* cycles per call in 1/100, the empty loop taken off */
+#define COST(text, stmt)														\
+	do																			\
+	{																			\
+		unsigned int cost_start = DWT->CYCCNT;									\
+		for(unsigned int i = 0; i < COST_N; i++)								\
+		{																		\
+			stmt;																\
+			__asm volatile("" : : : "memory");									\
+		}																		\
+		LOG(text ": %u/100 cycles", (DWT->CYCCNT - cost_start - empty) * 100 / COST_N);	\
+		log_Drain(LOG_PORT);													\
+	} while(0)
+
+void cost_Run()
+{
+	static volatile unsigned int word;
+	unsigned int empty = 0, start, old, saved;
+	unsigned long long t;
+
+	start = DWT->CYCCNT;
+	for(unsigned int i = 0; i < COST_N; i++)
+	{
+		__asm volatile("" : : : "memory");
+	}
+	empty = DWT->CYCCNT - start;
+
+	COST("volatile ++", word++);
+	COST("atomic_Fetch_Add", atomic_Fetch_Add(&word, 1));
+	COST("atomic_Fetch_Or", atomic_Fetch_Or(&word, 4));
+	COST("atomic_Cas", old = word; atomic_Cas(&word, &old, old + 1));
+	COST("atomic_Flag_Set", atomic_Flag_Set(&flags, 3));
+	COST("crit_Enter + crit_Exit", saved = crit_Enter(6); crit_Exit(saved));
+	COST("crit_Enter_All + crit_Exit_All", saved = crit_Enter_All(); crit_Exit_All(saved));
+	COST("seq_Write_Begin + _End", seq_Write_Begin(&uptime_lock); seq_Write_End(&uptime_lock));
+	COST("seqlock read of 64 bits",
+		do { old = seq_Read_Begin(&uptime_lock); t = (unsigned long long)uptime_hi << 32 | uptime_lo; }
+		while(seq_Retry(&uptime_lock, old)));
+	(void)t;
+}
+
+void counter_Stress()
+{
+	unsigned int window = rcc_Get_Sysclk() / 1000 * STRESS_MS;
+	unsigned int adds = 0, start, ticks;
+
+	plain_count = 0;
+	atomic_count = 0;
+	tim3_ticks = 0;
+	TIM3->CNT = 0;
+	TIM3->CR1 = (1<<0);
+	start = DWT->CYCCNT;
+	while(DWT->CYCCNT - start < window)
+	{
+		plain_count++;
+		atomic_Fetch_Add(&atomic_count, 1);
+		adds++;
+	}
+	TIM3->CR1 = 0;
+	ticks = tim3_ticks;
+	LOG("counter: %u main + %u ISR adds, volatile ++ lost %u, atomic_Fetch_Add lost %u",
+		adds, ticks, adds + ticks - plain_count, adds + ticks - atomic_count);
+	log_Drain(LOG_PORT);
+}
+
+void uptime_Stress()
+{
+	unsigned int window = rcc_Get_Sysclk() / 1000 * STRESS_MS;
+	unsigned int reads = 0, torn_plain = 0, torn_seq = 0, retries = 0, start, seq;
+	unsigned long long t;
+
+	uptime_lo = 0;
+	uptime_hi = 0;
+	TIM2->CNT = 0;
+	TIM2->CR1 = (1<<0);
+	start = DWT->CYCCNT;
+	while(DWT->CYCCNT - start < window)
+	{
+		t = (unsigned long long)uptime_hi << 32;
+		t |= uptime_lo;
+		torn_plain += (t % UPTIME_STEP) != 0;
+
+		seq = seq_Read_Begin(&uptime_lock);
+		t = (unsigned long long)uptime_hi << 32;
+		t |= uptime_lo;
+		while(seq_Retry(&uptime_lock, seq))
+		{
+			retries++;
+			seq = seq_Read_Begin(&uptime_lock);
+			t = (unsigned long long)uptime_hi << 32;
+			t |= uptime_lo;
+		}
+		torn_seq += (t % UPTIME_STEP) != 0;
+		reads++;
+	}
+	TIM2->CR1 = 0;
+	LOG("uptime: %u reads, %u ticks, two words torn %u, seqlock torn %u with %u retries",
+		reads, tim2_ticks, torn_plain, torn_seq, retries);
+	log_Drain(LOG_PORT);
+}
+
+void basepri_Check()
+{
+	unsigned int ms = rcc_Get_Sysclk() / 1000;
+	unsigned int t2, t3, start, saved;
+
+	TIM2->CR1 = (1<<0);
+	TIM3->CR1 = (1<<0);
+	saved = crit_Enter(6);
+	t2 = tim2_ticks;
+	t3 = tim3_ticks;
+	start = DWT->CYCCNT;
+	while(DWT->CYCCNT - start < ms);
+	t2 = tim2_ticks - t2;
+	t3 = tim3_ticks - t3;
+	crit_Exit(saved);
+	TIM2->CR1 = 0;
+	TIM3->CR1 = 0;
+	LOG("crit_Enter(6), 1 ms: TIM2 (priority 5) %u ticks, TIM3 (priority 6) %u ticks", t2, t3);
+	log_Drain(LOG_PORT);
+}
@@ -0,0 +1,51 @@
+/**
+ ******************************************************************************
+ * @file    log.c
+ * @author  Monish Kumar.k
+ * @date    10/02/2025
+ * @brief   Ring buffer and background drain for the deferred binary logger.
+ *
+ * @details
+ * LOG() (see log.h) only stores words into log_ring. log_Drain() is called
+ * from the main loop and copies whole contiguous runs of words into the UART
+ * TX ring, which the DMA then sends without further CPU work. A run is only
+ * copied when it fits completely, so the byte stream never has holes.
+ *
+ * Stream format (little endian words):
+ *  - header    : (format string id << 4) | argument count
+ *  - timestamp : DWT->CYCCNT at the LOG() call
+ *  - arguments : one word each
+ ******************************************************************************
+ */
+#include <arm.h>
+#include "log.h"
+#include <uart.h>
+
+struct log_ring log_ring = { LOG_MAGIC, 0, 0, 0, { 0 } };
+
+void log_Init()
+{
+	DEMCR |= (1<<24);			//TRCENA
+	DWT->CTRL |= (1<<0);		//CYCCNTENA
+
+	log_ring.tail = log_ring.head;
+	log_ring.dropped = 0;
+}
+
+void log_Drain(int port)
+{
+	unsigned int tail = log_ring.tail;
+	unsigned int words = log_ring.head - tail;
+	unsigned int idx = tail & (LOG_WORDS - 1);
+	unsigned int space = uart_Tx_Free(port) / 4;
+
+	if(words > LOG_WORDS - idx)
+		words = LOG_WORDS - idx;		//stop at the end of the ring
+	if(words > space)
+		words = space;
+	if(words == 0)
+		return;
+
+	uart_Write(port, &log_ring.buf[idx], words * 4);
+	log_ring.tail = tail + words;
+}
@@ -0,0 +1,97 @@
+/*
+ * log.h
+ *
+ *  Created on: Feb 10, 2025
+ *      Author: moni
+ *
+ *  Deferred binary logging.
+ *
+ *  LOG("fmt %d %u", a, b) does not format anything on the target. It stores
+ *  one header word (format string id + argument count), one timestamp word
+ *  (DWT->CYCCNT) and the raw argument words into log_ring. The format string
+ *  itself is placed in the ".logstr" section, which is marked non-allocated
+ *  so it takes no flash; its offset inside that section is the id.
+ *  log_Decoder.py reads the section back from the ELF and rebuilds the text.
+ *
+ *  Only integer, char and pointer arguments are supported (%d %i %u %x %X
+ *  %o %c %p); every argument is stored as one 32-bit word.
+ *
+ *  The ring is drained in the background by log_Drain() over a UART, or read
+ *  directly by the debugger (dump sizeof(log_ring) bytes at &log_ring).
+ */
+
+#ifndef LOG_H_
+#define LOG_H_
+
+#include <arm.h>
+
+#define LOG_WORDS		256			//ring size in words, power of two
+#define LOG_MAX_ARGS	15
+#define LOG_MAGIC		0x474F4C42	//"BLOG", lets the decoder find a RAM dump
+
+/*
+ * The "@" starts an assembler comment on ARM, so the flags gcc appends to
+ * the .section directive are dropped and the section ends up without the
+ * ALLOC flag: it stays in the ELF for the decoder but is never loaded.
+ */
+#if defined(__arm__)
+#define LOG_SECTION		".logstr,\"\",%progbits @"
+#else
+#define LOG_SECTION		".logstr,\"\",@progbits #"		//host build of a test, '#' comments on x86
+#endif
+
+struct log_ring
+{
+	unsigned int magic;
+	volatile unsigned int head;		//free running, written by LOG()
+	volatile unsigned int tail;		//free running, written by the drain
+	volatile unsigned int dropped;	//records lost because the ring was full
+	unsigned int buf[LOG_WORDS];
+};
+
+extern struct log_ring log_ring;
+
+void log_Init(void);
+void log_Drain(int port);
+
+static inline void log_Put(unsigned int id, const unsigned int *args, unsigned int n)
+{
+	unsigned int primask, head;
+
+#if defined(__arm__)
+	__asm volatile("mrs %0, primask\n\tcpsid i" : "=r"(primask) : : "memory");
+#else
+	primask = 0;					//host build of a test: no interrupts to mask
+#endif
+	head = log_ring.head;
+	if(head - log_ring.tail + n + 2 > LOG_WORDS)
+	{
+		log_ring.dropped++;
+	}
+	else
+	{
+		log_ring.buf[head & (LOG_WORDS - 1)] = (id << 4) | n;
+		log_ring.buf[(head + 1) & (LOG_WORDS - 1)] = DWT->CYCCNT;
+		for(unsigned int i = 0; i < n; i++)
+		{
+			log_ring.buf[(head + 2 + i) & (LOG_WORDS - 1)] = args[i];
+		}
+		log_ring.head = head + n + 2;
+	}
+#if defined(__arm__)
+	__asm volatile("msr primask, %0" : : "r"(primask) : "memory");
+#else
+	(void)primask;
+#endif
+}
+
+#define LOG(fmt, ...)															\
+	do																			\
+	{																			\
+		static const char log_fmt_[] __attribute__((section(LOG_SECTION), used)) = fmt;	\
+		const unsigned int log_args_[] = { 0, ##__VA_ARGS__ };					\
+		_Static_assert(sizeof(log_args_) / 4 - 1 <= LOG_MAX_ARGS, "too many LOG arguments");	\
+		log_Put((unsigned int)log_fmt_, log_args_ + 1, sizeof(log_args_) / 4 - 1);	\
+	} while(0)
+
+#endif /* LOG_H_ */
@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""
+log_Decoder.py - host side decoder for the deferred binary logger (log.h).
+
+The target only sends (id, timestamp, raw argument words). The format strings
+live in the non-allocated ".logstr" section of the ELF; the id of a message is
+the offset of its string inside that section.
+
+Usage:
+    log_Decoder.py firmware.elf capture.bin          # raw UART capture
+    cat /dev/ttyUSB0 | log_Decoder.py firmware.elf - # live, from a serial port
+    log_Decoder.py firmware.elf --dump ring.bin      # debugger dump of log_ring
+
+A debugger dump is taken with e.g. OpenOCD:
+    dump_image ring.bin <&log_ring> <sizeof(log_ring)>
+
+Author: Monish Kumar.k
+Date  : 10/02/2025
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+LOG_MAGIC = 0x474F4C42
+SPEC = re.compile(r"%([-+ #0]*)(\d*)(?:\.(\d+))?(?:hh|h|ll|l|z|t)?([diouxXcp%])")
+
+
+def read_logstr(path):
+    """Return the raw contents of the .logstr section of an ELF32 file."""
+    with open(path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF" or elf[4] != 1:
+        sys.exit("%s: not an ELF32 file" % path)
+    shoff, = struct.unpack_from("<I", elf, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", elf, 0x2E)
+
+    def section(i):
+        return struct.unpack_from("<IIIIIIIIII", elf, shoff + i * shentsize)
+
+    names = section(shstrndx)
+    for i in range(shnum):
+        sh = section(i)
+        start = names[4] + sh[0]
+        name = elf[start:elf.index(b"\0", start)].decode()
+        if name == ".logstr":
+            return elf[sh[4]:sh[4] + sh[5]]
+    sys.exit("%s: no .logstr section, was LOG() used?" % path)
+
+
+class Decoder:
+    def __init__(self, strings, clock):
+        self.strings = strings
+        self.clock = clock
+        self.skipped = 0
+        self.cache = {}
+
+    def fmt(self, sid):
+        """Format string for an id, or None if the id is not a string start."""
+        if sid in self.cache:
+            return self.cache[sid]
+        s = None
+        if sid < len(self.strings) and (sid == 0 or self.strings[sid - 1] == 0):
+            end = self.strings.find(b"\0", sid)
+            if end > sid:
+                s = self.strings[sid:end].decode("utf-8", "replace")
+        self.cache[sid] = s
+        return s
+
+    @staticmethod
+    def nargs(fmt):
+        return sum(1 for m in SPEC.finditer(fmt) if m.group(4) != "%")
+
+    @staticmethod
+    def render(fmt, args):
+        it = iter(args)
+
+        def conv(m):
+            flags, width, prec, kind = m.groups()
+            if kind == "%":
+                return "%"
+            v = next(it)
+            spec = "%" + flags + width + ("." + prec if prec else "")
+            if kind in "di":
+                return (spec + "d") % (v - (1 << 32) if v & 0x80000000 else v)
+            if kind == "c":
+                return (spec + "c") % chr(v & 0xFF)
+            if kind == "p":
+                return "0x%08x" % v
+            return (spec + kind) % v
+
+        return SPEC.sub(conv, fmt)
+
+    def stamp(self, ts):
+        if self.clock:
+            return "%12.6f" % (ts / self.clock)
+        return "%10u" % ts
+
+    def feed(self, words):
+        """Decode as many records as possible, return the unused tail."""
+        i = 0
+        while i < len(words):
+            sid, n = words[i] >> 4, words[i] & 0xF
+            fmt = self.fmt(sid)
+            if fmt is None or self.nargs(fmt) != n:
+                self.skipped += 1          # lost sync, slide one word
+                i += 1
+                continue
+            if i + 2 + n > len(words):
+                break
+            print("%s  %s" % (self.stamp(words[i + 1]),
+                              self.render(fmt, words[i + 2:i + 2 + n])))
+            i += 2 + n
+        return words[i:]
+
+
+def words_of(data):
+    return list(struct.unpack("<%dI" % (len(data) // 4), data[:len(data) & ~3]))
+
+
+def decode_dump(dec, data):
+    magic, head, tail, dropped = struct.unpack_from("<IIII", data, 0)
+    if magic != LOG_MAGIC:
+        sys.exit("dump does not start with log_ring (bad magic 0x%08x)" % magic)
+    size = (len(data) - 16) // 4
+    buf = words_of(data[16:16 + size * 4])
+    pending = (head - tail) & 0xFFFFFFFF
+    dec.feed([buf[(tail + k) % size] for k in range(min(pending, size))])
+    if dropped:
+        print("-- %u records dropped on target" % dropped)
+
+
+def decode_stream(dec, f):
+    rest = b""
+    words = []
+    while True:
+        chunk = f.read1(4096)
+        if not chunk:
+            break
+        rest += chunk
+        cut = len(rest) & ~3
+        words = dec.feed(words + words_of(rest[:cut]))
+        rest = rest[cut:]
+        sys.stdout.flush()
+
+
+def main():
+    ap = argparse.ArgumentParser(description="decode deferred binary LOG() output")
+    ap.add_argument("elf", help="firmware ELF holding the .logstr section")
+    ap.add_argument("input", help="raw capture file, '-' for stdin, or a RAM dump with --dump")
+    ap.add_argument("--dump", action="store_true", help="input is a debugger dump of log_ring")
+    ap.add_argument("--clock", type=float, default=0, help="CPU clock in Hz, prints seconds")
+    args = ap.parse_args()
+
+    dec = Decoder(read_logstr(args.elf), args.clock)
+    if args.dump:
+        with open(args.input, "rb") as f:
+            decode_dump(dec, f.read())
+    elif args.input == "-":
+        decode_stream(dec, sys.stdin.buffer)
+    else:
+        with open(args.input, "rb") as f:
+            decode_stream(dec, f)
+    if dec.skipped:
+        print("-- %u words skipped while resynchronising" % dec.skipped, file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,93 @@
+/**
+ ******************************************************************************
+ * @file    binary_Log.c
+ * @author  Monish Kumar.k
+ * @date    10/02/2025
+ * @brief   Deferred binary logging demo and LOG() cost measurement.
+ *
+ * @details
+ * Logs a counter from the main loop and measures the cost of a LOG() call
+ * with 0, 2 and 4 arguments using DWT->CYCCNT. The records are drained over
+ * USART2 (PA2) at 921600 baud and turned back into text on the host with:
+ *
+ *     python3 log_Decoder.py binary_Log.elf - --clock 25000000 < /dev/ttyUSB0
+ *
+ * log_cost[] holds the measured cycles and can also be read with the debugger.
+ *
+ * Note:
+ *  - The project needs uart.c/uart.h from uart_Dma and arm.h, rcc.c/rcc.h
+ *    from manual_PWM on its source and include paths.
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 10/02/2025
+  File : binary_Log
+ ******************************************************************************/
+#include <arm.h>
+#include <rcc.h>
+#include <uart.h>
+#include "log.h"
+
+volatile unsigned int log_cost[3];
+
+void rcc_Config(void);
+void log_Measure(void);
+
+int main(void)
+{
+	unsigned int count = 0;
+
+	rcc_Config();
+	uart_Init(UART_CONSOLE, 921600);
+	log_Init();
+
+	LOG("binary_Log: boot, sysclk %u Hz", rcc_Get_Sysclk());
+	log_Measure();
+	LOG("LOG() cost: %u cycles (0 args), %u (2 args), %u (4 args)",
+		log_cost[0], log_cost[1], log_cost[2]);
+
+	while(1)
+	{
+		if((count & 0xFFFF) == 0)
+		{
+			LOG("main loop %u, dropped %u", count, log_ring.dropped);
+		}
+		count++;
+		log_Drain(UART_CONSOLE);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR & (~0x00010000); /*HES is disable */
+
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	//clock configuration
+
+	RCC->CFGR = RCC->CFGR & (~0x00000003); /* disable the sw0 and sw1*/
+
+	RCC->CFGR = RCC->CFGR | (1<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 1);
+}
+
+void log_Measure()
+{
+	unsigned int t;
+
+	t = DWT->CYCCNT;
+	LOG("measure 0");
+	log_cost[0] = DWT->CYCCNT - t;
+
+	t = DWT->CYCCNT;
+	LOG("measure %d %u", -1, 2);
+	log_cost[1] = DWT->CYCCNT - t;
+
+	t = DWT->CYCCNT;
+	LOG("measure %x %x %x %x", 1, 2, 3, 4);
+	log_cost[2] = DWT->CYCCNT - t;
+}
@@ -0,0 +1,70 @@
+/*
+ * bitband.h
+ *
+ *  Created on: Feb 14, 2025
+ *      Author: moni
+ *
+ *  Cortex-M4 bit-band alias helpers.
+ *
+ *  Every bit of the first 1 MB of SRAM (0x20000000) and of the peripheral
+ *  space (0x40000000) has its own word in the alias regions at 0x22000000 and
+ *  0x42000000:
+ *
+ *      alias = region + 0x02000000 + (byte offset * 32) + (bit * 4)
+ *
+ *  A store to the alias word sets or clears just that bit and the bus does
+ *  the read-modify-write as one locked transfer, so an ISR cannot slip in
+ *  between. A load returns 0 or 1. With a constant register address the
+ *  whole alias folds to a constant and the access is a single LDR/STR.
+ *
+ *  Do NOT use the alias on status registers with rc_w1 / rc_w0 semantics
+ *  (EXTI_PR, TIMx_SR, USART_SR): the locked RMW writes back every other
+ *  flag too, so on EXTI_PR it clears all pending lines, and on TIMx_SR a
+ *  flag raised during the RMW is lost. Write those registers directly,
+ *  e.g. EXTI_PR = (1<<n) or TIMx->SR = ~(1<<n).
+ */
+
+#ifndef BITBAND_H_
+#define BITBAND_H_
+
+#define BITBAND_SRAM_START	0x20000000
+#define BITBAND_PERI_START	0x40000000
+#define BITBAND_SIZE		0x00100000
+
+/* Alias word of bit 'bit' of the word at 'addr' (SRAM or peripheral region). */
+#define BITBAND_ADDR(addr, bit)		((((unsigned int)(addr)) & 0xF0000000) + 0x02000000	\
+									+ ((((unsigned int)(addr)) & 0x000FFFFF) << 5)		\
+									+ ((unsigned int)(bit) << 2))
+
+/* lvalue: BITBAND(&GPIOA->ODR, 8) = 1;  if(BITBAND(&flags, 3)) ... */
+#define BITBAND(addr, bit)			(*(volatile unsigned int *)BITBAND_ADDR((addr), (bit)))
+
+#define BITBAND_IN_RANGE(addr)		((((unsigned int)(addr)) - BITBAND_SRAM_START < BITBAND_SIZE) ||	\
+									 (((unsigned int)(addr)) - BITBAND_PERI_START < BITBAND_SIZE))
+
+static inline void bit_Set(volatile void *addr, unsigned int bit)
+{
+	BITBAND(addr, bit) = 1;
+}
+
+static inline void bit_Clear(volatile void *addr, unsigned int bit)
+{
+	BITBAND(addr, bit) = 0;
+}
+
+static inline unsigned int bit_Test(volatile void *addr, unsigned int bit)
+{
+	return BITBAND(addr, bit);
+}
+
+/*
+ * For flags in RAM the address is only known at link time, so the alias is
+ * computed at run time. Keep the alias pointer instead when a flag is hit
+ * in a hot path:  volatile unsigned int *ready = bitband_Ptr(&flags, 2);
+ */
+static inline volatile unsigned int *bitband_Ptr(volatile void *addr, unsigned int bit)
+{
+	return (volatile unsigned int *)BITBAND_ADDR(addr, bit);
+}
+
+#endif /* BITBAND_H_ */
@@ -0,0 +1,99 @@
+/**
+ ******************************************************************************
+ * @file    bitband_Test.c
+ * @author  Monish Kumar.k
+ * @date    14/02/2025
+ * @brief   Host test of the bit-band alias arithmetic in bitband.h.
+ *
+ * @details
+ * Build and run on the host:
+ *
+ *     gcc -O2 -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast -o bitband_Test bitband_Test.c && ./bitband_Test
+ *
+ * Checks:
+ *  - the alias examples given in PM0214 (Cortex-M4 programming manual).
+ *  - every byte/bit of both 1 MB regions: BITBAND_ADDR() matches the
+ *    formula, maps back to the same byte and bit, lands inside the 32 MB
+ *    alias region, and is 4 above the alias of the previous bit (so no two
+ *    bits share a word).
+ *  - word address + bit n and byte address (+n/8) + bit n%8 give the same
+ *    alias, so BITBAND(&REG, 8) and BITBAND((char *)&REG + 1, 0) agree.
+ *  - BITBAND_IN_RANGE() at both edges of both regions.
+ *  - a constant register address folds to a constant (used as a static
+ *    initialiser below, which only compiles if it does).
+ *
+ * There is no timing here: the cycle counts in main.c need the Cortex-M4
+ * bus and its alias region, which a host does not have.
+ * Exits non-zero on a failure.
+ ******************************************************************************
+ */
+#include <stdio.h>
+#include "bitband.h"
+
+static unsigned int failures;
+
+/* GPIOA->ODR bit 8 and EXTI_IMR bit 0, as used in main.c */
+static const unsigned int odr_alias = BITBAND_ADDR(0x40020014, 8);
+static const unsigned int imr_alias = BITBAND_ADDR(0x40013C00, 0);
+
+static void check(int ok, const char *what, unsigned int addr, unsigned int bit)
+{
+	if(!ok && failures++ < 10)
+		printf("FAIL %s: addr 0x%08X bit %u\n", what, addr, bit);
+}
+
+static void check_Region(unsigned int start)
+{
+	unsigned int offset, bit, alias, prev = 0;
+	unsigned int alias_start = start + 0x02000000;
+
+	for(offset = 0; offset < BITBAND_SIZE; offset++)
+	{
+		for(bit = 0; bit < 8; bit++)
+		{
+			alias = BITBAND_ADDR(start + offset, bit);
+
+			check(alias == alias_start + offset * 32 + bit * 4, "formula", start + offset, bit);
+			check(alias >= alias_start && alias < alias_start + 0x02000000, "alias region", start + offset, bit);
+			check(start + ((alias - alias_start) >> 5) == start + offset, "byte back", start + offset, bit);
+			check(((alias >> 2) & 7) == bit, "bit back", start + offset, bit);
+			if(offset | bit)
+				check(alias == prev + 4, "step", start + offset, bit);
+			prev = alias;
+		}
+	}
+
+	/* word address with bit 0..31 against byte address with bit 0..7 */
+	for(offset = 0; offset < BITBAND_SIZE; offset += 4)
+		for(bit = 0; bit < 32; bit++)
+			check(BITBAND_ADDR(start + offset, bit) == BITBAND_ADDR(start + offset + bit / 8, bit % 8),
+					"word/byte", start + offset, bit);
+
+	check(BITBAND_IN_RANGE(start), "in range start", start, 0);
+	check(BITBAND_IN_RANGE(start + BITBAND_SIZE - 1), "in range end", start + BITBAND_SIZE - 1, 0);
+	check(!BITBAND_IN_RANGE(start + BITBAND_SIZE), "past end", start + BITBAND_SIZE, 0);
+	check(!BITBAND_IN_RANGE(start - 1), "before start", start - 1, 0);
+}
+
+int main(void)
+{
+	/* PM0214 examples */
+	check(BITBAND_ADDR(0x20000300, 2) == 0x22006008, "PM0214 0x22006008", 0x20000300, 2);
+	check(BITBAND_ADDR(0x20000000, 0) == 0x22000000, "PM0214 0x22000000", 0x20000000, 0);
+	check(BITBAND_ADDR(0x20000000, 7) == 0x2200001C, "PM0214 0x2200001C", 0x20000000, 7);
+	check(BITBAND_ADDR(0x200FFFFF, 0) == 0x23FFFFE0, "PM0214 0x23FFFFE0", 0x200FFFFF, 0);
+	check(BITBAND_ADDR(0x200FFFFF, 7) == 0x23FFFFFC, "PM0214 0x23FFFFFC", 0x200FFFFF, 7);
+
+	check(odr_alias == 0x42000000 + 0x20014 * 32 + 8 * 4, "GPIOA ODR 8", 0x40020014, 8);
+	check(imr_alias == 0x42000000 + 0x13C00 * 32, "EXTI IMR 0", 0x40013C00, 0);
+
+	check_Region(BITBAND_SRAM_START);
+	check_Region(BITBAND_PERI_START);
+
+	check(!BITBAND_IN_RANGE(0x08000000), "flash", 0x08000000, 0);
+	check(!BITBAND_IN_RANGE(0x50000000), "AHB2 (OTG)", 0x50000000, 0);
+	check(!BITBAND_IN_RANGE(0xE000E100), "NVIC", 0xE000E100, 0);
+
+	printf("bitband: %u failures\n", failures);
+	return failures != 0;
+}
@@ -0,0 +1,132 @@
+/**
+ ******************************************************************************
+ * @file    bit_Band.c
+ * @author  Monish Kumar.k
+ * @date    14/02/2025
+ * @brief   Bit-band alias access compared with read-modify-write on target.
+ *
+ * @details
+ * Each case runs BENCH_LOOPS times with the loop unrolled by 4 and the cycle
+ * count per operation (loop overhead removed) is stored in bench[]:
+ *
+ *  - ODR_RMW      : GPIOA->ODR |= (1<<8)                      (not ISR safe)
+ *  - ODR_BITBAND  : BITBAND(&GPIOA->ODR, 8) = 1               (ISR safe)
+ *  - IMR_RMW      : *EXTI_IMR |= (1<<0)
+ *  - IMR_BITBAND  : BITBAND(EXTI_IMR, 0) = 1
+ *  - FLAG_CRIT    : RAM flag |= bit inside cpsid/cpsie
+ *  - FLAG_BITBAND : RAM flag set through a cached alias pointer
+ *  - SR_TEST      : (TIM10->SR & 1) against BITBAND(&TIM10->SR, 0)
+ *
+ * The results are reported through the deferred logger (binary_Log) on
+ * USART2 and can also be read from bench[] with the debugger.
+ *
+ * Note:
+ *  - Build with -O2; the RMW cases are LDR/ORR/STR, the bit-band cases a
+ *    single STR to a constant address.
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 14/02/2025
+  File : bit_Band
+ ******************************************************************************/
+#include <arm.h>
+#include <uart.h>
+#include <log.h>
+#include "bitband.h"
+
+#define BENCH_LOOPS		1000
+
+volatile unsigned int *EXTI_IMR = (volatile unsigned int *)0x40013C00;
+
+enum
+{
+	ODR_RMW, ODR_BITBAND, IMR_RMW, IMR_BITBAND,
+	FLAG_CRIT, FLAG_BITBAND, SR_RMW_TEST, SR_BITBAND_TEST, BENCH_COUNT
+};
+
+volatile unsigned int bench[BENCH_COUNT];
+volatile unsigned int shared_flags;		//set by ISRs, cleared by main
+
+void rcc_Config(void);
+void choose_Port(void);
+unsigned int bench_Overhead(void);
+void bench_Run(void);
+
+int main(void)
+{
+	rcc_Config();
+	choose_Port();
+	uart_Init(UART_CONSOLE, 115200);
+	log_Init();
+
+	bench_Run();
+	LOG("ODR: rmw %u, bitband %u cycles", bench[ODR_RMW], bench[ODR_BITBAND]);
+	LOG("EXTI_IMR: rmw %u, bitband %u cycles", bench[IMR_RMW], bench[IMR_BITBAND]);
+	LOG("RAM flag: critical section %u, bitband %u cycles", bench[FLAG_CRIT], bench[FLAG_BITBAND]);
+	LOG("TIM10 SR test: and-mask %u, bitband %u cycles", bench[SR_RMW_TEST], bench[SR_BITBAND_TEST]);
+	while(1)
+	{
+		log_Drain(UART_CONSOLE);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	RCC->CFGR = RCC->CFGR & (~0x00000003); /* disable the sw0 and sw1*/
+	RCC->CFGR = RCC->CFGR | (1<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 1);
+}
+
+void choose_Port()
+{
+	RCC->AHB1ENR |= (1<<0);			//GPIOA
+	RCC->APB2ENR |= (1<<14) | (1<<17);	//SYSCFG, TIM10
+	GPIOA->MODER = (GPIOA->MODER & ~(0x3<<16)) | (1<<16);	//PA8 output
+}
+
+unsigned int bench_Overhead()
+{
+	unsigned int t = DWT->CYCCNT;
+	for(int i=0; i<BENCH_LOOPS; i++)
+	{
+		__asm volatile("" ::: "memory");
+	}
+	return DWT->CYCCNT - t;
+}
+
+#define BENCH(slot, op)															\
+	do																			\
+	{																			\
+		unsigned int t = DWT->CYCCNT;											\
+		for(int i=0; i<BENCH_LOOPS; i++)										\
+		{																		\
+			op; op; op; op;														\
+			__asm volatile("" ::: "memory");									\
+		}																		\
+		bench[slot] = (DWT->CYCCNT - t - overhead) / (BENCH_LOOPS * 4);		\
+	} while(0)
+
+void bench_Run()
+{
+	volatile unsigned int *flag = bitband_Ptr(&shared_flags, 2);
+	unsigned int overhead = bench_Overhead();
+	unsigned int sink = 0;
+
+	BENCH(ODR_RMW,      GPIOA->ODR |= (1<<8));
+	BENCH(ODR_BITBAND,  BITBAND(&GPIOA->ODR, 8) = 1);
+	BENCH(IMR_RMW,      *EXTI_IMR |= (1<<0));
+	BENCH(IMR_BITBAND,  BITBAND(0x40013C00, 0) = 1);
+	BENCH(FLAG_CRIT,    __asm volatile("cpsid i" ::: "memory"); shared_flags |= (1<<2); __asm volatile("cpsie i" ::: "memory"));
+	BENCH(FLAG_BITBAND, *flag = 1);
+	BENCH(SR_RMW_TEST,  sink += (TIM10->SR & (1<<0)));
+	BENCH(SR_BITBAND_TEST, sink += BITBAND(&TIM10->SR, 0));
+
+	*EXTI_IMR &= ~(1<<0);
+	(void)sink;
+}
@@ -0,0 +1,478 @@
+#!/usr/bin/env python3
+"""
+board_Gen.py - board description to init code for the STM32F401 examples.
+
+Every example used to carry its own rcc_Config() / choose_Port() /
+gpio_Moder() with raw register addresses. A .board file lists what the
+example uses instead, and this script writes board.c / board.h with one
+board_Init() that touches exactly that:
+
+    clock   pll84                       # hsi (16 MHz) | hse (25 MHz) | pll84
+    pin     PA0  in  pull=up  exti=falling  prio=5  label=BUTTON
+    pin     PA5  out level=0  label=LED
+    pin     PA9  af=USART1_TX speed=high
+    pin     PA2  af=USART2_TX driver    # reserved, set up by the driver
+    enable  TIM4                        # RCC clock only
+    irq     TIM4 prio=3                 # NVIC priority + enable
+    dma     USART2_TX driver            # stream/channel from the table
+    dma     SPI1_TX prio=5              # claimed here, IRQ enabled here
+
+Pin options: in | out | af=<signal or 0..15> | analog, pull=up|down,
+od, speed=low|medium|fast|high, level=0|1, exti=rising|falling|both,
+prio=<0..15> (EXTI IRQ), label=<NAME>, driver.
+
+Checks (any failure stops with an error, nothing is written):
+  - a pin, an EXTI line or a DMA stream claimed twice
+  - an AF signal that the pin does not have, a DMA request the stream
+    table does not have
+  - two different priorities for one shared IRQ (EXTI9_5, EXTI15_10)
+
+Generated code:
+  - one |= per RCC enable register, with the GPIO/DMA/SYSCFG and
+    peripheral clocks the description needs
+  - per port: BSRR, OTYPER, OSPEEDR, PUPDR, AFRL, AFRH, MODER, one masked
+    write each (as gpio_Table), registers only through arm.h names
+  - SYSCFG EXTICR, EXTI RTSR/FTSR/PR/IMR, NVIC IP and ISER writes
+
+Usage:
+    board_Gen.py falling_edge.board -o .      # writes ./board.c, ./board.h
+    board_Gen.py falling_edge.board --check   # checks only
+
+Author: Monish Kumar.k
+Date  : 08/04/2025
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# RCC enable bits: name -> (register, bit)
+RCC_BITS = {
+    "GPIOA": ("AHB1ENR", 0), "GPIOB": ("AHB1ENR", 1), "GPIOC": ("AHB1ENR", 2),
+    "DMA1": ("AHB1ENR", 21), "DMA2": ("AHB1ENR", 22),
+    "TIM2": ("APB1ENR", 0), "TIM3": ("APB1ENR", 1), "TIM4": ("APB1ENR", 2),
+    "TIM5": ("APB1ENR", 3), "SPI2": ("APB1ENR", 14), "SPI3": ("APB1ENR", 15),
+    "USART2": ("APB1ENR", 17), "I2C1": ("APB1ENR", 21), "I2C2": ("APB1ENR", 22),
+    "I2C3": ("APB1ENR", 23), "PWR": ("APB1ENR", 28),
+    "TIM1": ("APB2ENR", 0), "USART1": ("APB2ENR", 4), "USART6": ("APB2ENR", 5),
+    "ADC1": ("APB2ENR", 8), "SPI1": ("APB2ENR", 12), "SPI4": ("APB2ENR", 13),
+    "SYSCFG": ("APB2ENR", 14), "TIM9": ("APB2ENR", 16), "TIM10": ("APB2ENR", 17),
+    "TIM11": ("APB2ENR", 18),
+}
+
+# NVIC position of the peripheral interrupts used in this repo
+IRQS = {
+    "EXTI0": 6, "EXTI1": 7, "EXTI2": 8, "EXTI3": 9, "EXTI4": 10,
+    "EXTI9_5": 23, "EXTI15_10": 40, "ADC": 18,
+    "TIM1_BRK_TIM9": 24, "TIM1_UP_TIM10": 25, "TIM1_TRG_COM_TIM11": 26, "TIM1_CC": 27,
+    "TIM2": 28, "TIM3": 29, "TIM4": 30, "TIM5": 50,
+    "TIM9": 24, "TIM10": 25, "TIM11": 26,
+    "SPI1": 35, "SPI2": 36, "SPI3": 51, "USART1": 37, "USART2": 38, "USART6": 71,
+    "I2C1_EV": 31, "I2C1_ER": 32,
+}
+DMA_IRQS = {
+    1: [11, 12, 13, 14, 15, 16, 17, 47],
+    2: [56, 57, 58, 59, 60, 68, 69, 70],
+}
+
+# alternate functions (RM0368 / DS9716 table 9), the signals the examples use
+AF = {
+    "PA0": {"TIM2_CH1": 1, "TIM2_ETR": 1, "TIM5_CH1": 2, "USART2_CTS": 7},
+    "PA1": {"TIM2_CH2": 1, "TIM5_CH2": 2, "USART2_RTS": 7},
+    "PA2": {"TIM2_CH3": 1, "TIM5_CH3": 2, "TIM9_CH1": 3, "USART2_TX": 7},
+    "PA3": {"TIM2_CH4": 1, "TIM5_CH4": 2, "TIM9_CH2": 3, "USART2_RX": 7},
+    "PA5": {"TIM2_CH1": 1, "TIM2_ETR": 1, "SPI1_SCK": 5},
+    "PA6": {"TIM1_BKIN": 1, "TIM3_CH1": 2, "SPI1_MISO": 5},
+    "PA7": {"TIM1_CH1N": 1, "TIM3_CH2": 2, "SPI1_MOSI": 5},
+    "PA8": {"MCO1": 0, "TIM1_CH1": 1, "I2C3_SCL": 4, "USART1_CK": 7},
+    "PA9": {"TIM1_CH2": 1, "USART1_TX": 7},
+    "PA10": {"TIM1_CH3": 1, "USART1_RX": 7},
+    "PA11": {"TIM1_CH4": 1, "USART1_CTS": 7, "USART6_TX": 8},
+    "PA12": {"TIM1_ETR": 1, "USART1_RTS": 7, "USART6_RX": 8},
+    "PA15": {"TIM2_CH1": 1, "TIM2_ETR": 1, "SPI1_NSS": 5, "SPI3_NSS": 6},
+    "PB0": {"TIM1_CH2N": 1, "TIM3_CH3": 2},
+    "PB1": {"TIM1_CH3N": 1, "TIM3_CH4": 2},
+    "PB3": {"TIM2_CH2": 1, "SPI1_SCK": 5, "SPI3_SCK": 6},
+    "PB4": {"TIM3_CH1": 2, "SPI1_MISO": 5, "SPI3_MISO": 6},
+    "PB5": {"TIM3_CH2": 2, "SPI1_MOSI": 5, "SPI3_MOSI": 6},
+    "PB6": {"TIM4_CH1": 2, "I2C1_SCL": 4, "USART1_TX": 7},
+    "PB7": {"TIM4_CH2": 2, "I2C1_SDA": 4, "USART1_RX": 7},
+    "PB8": {"TIM4_CH3": 2, "TIM10_CH1": 3, "I2C1_SCL": 4},
+    "PB9": {"TIM4_CH4": 2, "TIM11_CH1": 3, "I2C1_SDA": 4},
+    "PB10": {"TIM2_CH3": 1, "I2C2_SCL": 4, "SPI2_SCK": 5},
+    "PB12": {"TIM1_BKIN": 1, "SPI2_NSS": 5},
+    "PB13": {"TIM1_CH1N": 1, "SPI2_SCK": 5},
+    "PB14": {"TIM1_CH2N": 1, "SPI2_MISO": 5},
+    "PB15": {"TIM1_CH3N": 1, "SPI2_MOSI": 5},
+    "PC6": {"TIM3_CH1": 2, "USART6_TX": 8},
+    "PC7": {"TIM3_CH2": 2, "USART6_RX": 8},
+}
+
+# DMA requests (RM0368 tables 27/28): name -> [(controller, stream, channel)]
+DMA = {
+    "ADC1": [(2, 0, 0), (2, 4, 0)],
+    "SPI1_RX": [(2, 0, 3), (2, 2, 3)], "SPI1_TX": [(2, 3, 3), (2, 5, 3)],
+    "SPI2_RX": [(1, 3, 0)], "SPI2_TX": [(1, 4, 0)],
+    "USART1_RX": [(2, 2, 4), (2, 5, 4)], "USART1_TX": [(2, 7, 4)],
+    "USART2_RX": [(1, 5, 4)], "USART2_TX": [(1, 6, 4)],
+    "USART6_RX": [(2, 1, 5), (2, 2, 5)], "USART6_TX": [(2, 6, 5), (2, 7, 5)],
+    "I2C1_RX": [(1, 0, 1), (1, 5, 1)], "I2C1_TX": [(1, 6, 1), (1, 7, 1)],
+    "TIM1_UP": [(2, 5, 6)], "TIM1_CH1": [(2, 1, 6), (2, 3, 6)],
+    "TIM2_UP": [(1, 1, 3), (1, 7, 3)], "TIM2_CH1": [(1, 5, 3)],
+    "TIM3_UP": [(1, 2, 5)], "TIM3_CH1": [(1, 4, 5)], "TIM3_CH2": [(1, 5, 5)],
+    "TIM3_CH3": [(1, 7, 5)], "TIM3_CH4": [(1, 2, 5)],
+    "TIM4_UP": [(1, 6, 2)], "TIM4_CH1": [(1, 0, 2)], "TIM4_CH2": [(1, 3, 2)],
+    "TIM4_CH3": [(1, 7, 2)],
+    "TIM5_UP": [(1, 0, 6), (1, 6, 6)], "TIM5_CH1": [(1, 2, 6)],
+}
+
+CLOCKS = {"hsi": 16000000, "hse": 25000000, "pll84": 84000000}
+MODES = {"in": 0, "out": 1, "af": 2, "analog": 3}
+PULLS = {"none": 0, "up": 1, "down": 2}
+SPEEDS = {"low": 0, "medium": 1, "fast": 2, "high": 3}
+EDGES = {"rising": (1, 0), "falling": (0, 1), "both": (1, 1)}
+
+
+class BoardError(Exception):
+    pass
+
+
+def exti_irq(line):
+    if line <= 4:
+        return "EXTI%d" % line
+    return "EXTI9_5" if line <= 9 else "EXTI15_10"
+
+
+def peripheral_of(signal):
+    return signal.split("_")[0]
+
+
+class Board:
+    def __init__(self, path):
+        self.path = path
+        self.clock = "hsi"
+        self.pins = {}          # "PA0" -> dict
+        self.enables = []       # peripheral names, in order
+        self.irqs = {}          # irq name -> priority or None
+        self.dma = {}           # (ctrl, stream) -> dict
+        self.exti = {}          # line -> pin name
+
+    def error(self, n, msg):
+        raise BoardError("%s:%d: %s" % (self.path, n, msg))
+
+    def enable(self, name):
+        if name not in self.enables:
+            self.enables.append(name)
+
+    def irq(self, n, name, prio):
+        if name not in IRQS:
+            self.error(n, "unknown IRQ '%s'" % name)
+        old = self.irqs.get(name)
+        if old is not None and prio is not None and old != prio:
+            self.error(n, "%s already has priority %d" % (name, old))
+        self.irqs[name] = prio if prio is not None else old
+
+    def parse(self):
+        with open(self.path) as fh:
+            for n, line in enumerate(fh, 1):
+                words = line.split("#", 1)[0].split()
+                if not words:
+                    continue
+                kind, args = words[0], words[1:]
+                opts = {}
+                flags = []
+                for a in args[1:] if kind in ("pin", "dma", "irq") else args:
+                    if "=" in a:
+                        k, v = a.split("=", 1)
+                        opts[k] = v
+                    else:
+                        flags.append(a)
+                if kind == "clock":
+                    if len(args) != 1 or args[0] not in CLOCKS:
+                        self.error(n, "clock must be one of %s" % ", ".join(CLOCKS))
+                    self.clock = args[0]
+                elif kind == "pin":
+                    self.parse_pin(n, args[0] if args else "", opts, flags)
+                elif kind == "enable":
+                    for a in args:
+                        if a not in RCC_BITS:
+                            self.error(n, "unknown peripheral '%s'" % a)
+                        self.enable(a)
+                elif kind == "irq":
+                    if not args or "prio" not in opts:
+                        self.error(n, "irq needs a name and prio=")
+                    self.irq(n, args[0], self.prio(n, opts["prio"]))
+                elif kind == "dma":
+                    self.parse_dma(n, args[0] if args else "", opts, flags)
+                else:
+                    self.error(n, "unknown keyword '%s'" % kind)
+
+    def prio(self, n, v):
+        if not v.isdigit() or int(v) > 15:
+            self.error(n, "priority must be 0..15")
+        return int(v)
+
+    def parse_pin(self, n, name, opts, flags):
+        m = re.match(r"^P([ABC])(\d+)$", name)
+        if not m or int(m.group(2)) > 15:
+            self.error(n, "bad pin '%s'" % name)
+        if name in self.pins:
+            self.error(n, "%s already used on line %d" % (name, self.pins[name]["line"]))
+        p = {"line": n, "port": m.group(1), "pin": int(m.group(2)), "mode": None,
+             "af": 0, "pull": 0, "od": 0, "speed": 0, "level": None,
+             "exti": None, "label": opts.get("label"), "driver": "driver" in flags}
+        for f in flags:
+            if f in MODES and f != "af":
+                p["mode"] = MODES[f]
+            elif f == "od":
+                p["od"] = 1
+            elif f != "driver":
+                self.error(n, "unknown pin option '%s'" % f)
+        if "af" in opts:
+            p["mode"] = MODES["af"]
+            v = opts["af"]
+            if v.isdigit():
+                p["af"] = int(v)
+                if p["af"] > 15:
+                    self.error(n, "AF must be 0..15")
+            else:
+                table = AF.get(name, {})
+                if v not in table:
+                    self.error(n, "%s has no alternate function %s" % (name, v))
+                p["af"] = table[v]
+                if not p["driver"] and peripheral_of(v) in RCC_BITS:
+                    self.enable(peripheral_of(v))
+        if p["mode"] is None:
+            self.error(n, "%s needs in, out, af= or analog" % name)
+        if "pull" in opts:
+            if opts["pull"] not in PULLS:
+                self.error(n, "pull must be up, down or none")
+            p["pull"] = PULLS[opts["pull"]]
+        if "speed" in opts:
+            if opts["speed"] not in SPEEDS:
+                self.error(n, "speed must be low, medium, fast or high")
+            p["speed"] = SPEEDS[opts["speed"]]
+        if "level" in opts:
+            if p["mode"] != MODES["out"] or opts["level"] not in ("0", "1"):
+                self.error(n, "level=0|1 is for outputs")
+            p["level"] = int(opts["level"])
+        if "exti" in opts:
+            if opts["exti"] not in EDGES:
+                self.error(n, "exti must be rising, falling or both")
+            line = p["pin"]
+            if line in self.exti:
+                self.error(n, "EXTI line %d already used by %s" % (line, self.exti[line]))
+            self.exti[line] = name
+            p["exti"] = EDGES[opts["exti"]]
+            self.irq(n, exti_irq(line), self.prio(n, opts["prio"]) if "prio" in opts else None)
+            self.enable("SYSCFG")
+        if not p["driver"]:
+            self.enable("GPIO" + p["port"])
+        self.pins[name] = p
+
+    def parse_dma(self, n, name, opts, flags):
+        if name not in DMA:
+            self.error(n, "unknown DMA request '%s'" % name)
+        want = None
+        if "stream" in opts:
+            m = re.match(r"^DMA([12])_S([0-7])$", opts["stream"])
+            if not m:
+                self.error(n, "stream must look like DMA2_S3")
+            want = (int(m.group(1)), int(m.group(2)))
+        choice = None
+        for ctrl, stream, ch in DMA[name]:
+            if want and want != (ctrl, stream):
+                continue
+            if (ctrl, stream) not in self.dma:
+                choice = (ctrl, stream, ch)
+                break
+        if not choice:
+            used = ", ".join("DMA%d_S%d (%s)" % (c, s, self.dma[(c, s)]["name"])
+                             for c, s, _ in DMA[name] if (c, s) in self.dma)
+            self.error(n, "no free stream for %s%s" % (name, ": " + used if used else ""))
+        ctrl, stream, ch = choice
+        driver = "driver" in flags
+        self.dma[(ctrl, stream)] = {"name": name, "channel": ch, "driver": driver, "line": n}
+        if not driver:
+            self.enable("DMA%d" % ctrl)
+            if "prio" in opts:
+                self.irqs["DMA%d_S%d" % (ctrl, stream)] = self.prio(n, opts["prio"])
+
+    def check(self):
+        for name, prio in self.irqs.items():
+            if prio is None:
+                raise BoardError("%s: %s has no priority (prio= on one of its pins)" % (self.path, name))
+
+
+def reg_masks(pins):
+    """per port: register -> (mask, value); bsrr"""
+    ports = {}
+    for name, p in sorted(pins.items(), key=lambda kv: (kv[1]["port"], kv[1]["pin"])):
+        if p["driver"]:
+            continue
+        r = ports.setdefault(p["port"], {"names": [], "bsrr": 0, "regs": {}})
+        r["names"].append(name + (" " + p["label"] if p["label"] else ""))
+        pin = p["pin"]
+
+        def put(reg, shift, width, v):
+            m, val = r["regs"].get(reg, (0, 0))
+            bits = ((1 << width) - 1) << shift
+            r["regs"][reg] = (m | bits, (val & ~bits) | (v << shift))
+
+        put("MODER", pin * 2, 2, p["mode"])
+        put("PUPDR", pin * 2, 2, p["pull"])
+        if p["mode"] in (MODES["out"], MODES["af"]):
+            put("OTYPER", pin, 1, p["od"])
+            put("OSPEEDR", pin * 2, 2, p["speed"])
+        if p["mode"] == MODES["af"]:
+            if pin < 8:
+                put("AFRL", pin * 4, 4, p["af"])
+            else:
+                put("AFRH", (pin - 8) * 4, 4, p["af"])
+        if p["level"] is not None:
+            r["bsrr"] |= (1 << pin) if p["level"] else (1 << (pin + 16))
+    return ports
+
+
+CLOCK_CODE = {
+    "hsi": [
+        "/* clock: HSI 16 MHz, reset state */",
+    ],
+    "hse": [
+        "/* clock: HSE 25 MHz as SYSCLK */",
+        "RCC->CR |= (1<<16);\t\t\t\t\t\t\t/* HSEON */",
+        "while(!(RCC->CR & (1<<17)));",
+        "RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (1<<0);\t/* SW = HSE */",
+        "while(((RCC->CFGR >> 2) & 0x3) != 1);",
+    ],
+    "pll84": [
+        "/* clock: PLL 25 MHz / M25 * N336 / P4 = 84 MHz from HSE, APB1 /2 */",
+        "RCC->CR |= (1<<16);",
+        "while(!(RCC->CR & (1<<17)));",
+        "FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);\t/* DCEN, ICEN, PRFTEN, 2 wait states */",
+        "RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);",
+        "RCC->CR |= (1<<24);",
+        "while(!(RCC->CR & (1<<25)));",
+        "RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);",
+        "RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);",
+        "while(((RCC->CFGR >> 2) & 0x3) != 2);",
+    ],
+}
+
+
+def gen_c(b, src):
+    out = ["/* generated by board_Gen.py from %s, do not edit */" % src,
+           "#include <arm.h>", '#include "board.h"', "", "void board_Init(void)", "{"]
+    body = list(CLOCK_CODE[b.clock])
+
+    regs = {}
+    for name in b.enables:
+        reg, bit = RCC_BITS[name]
+        regs.setdefault(reg, []).append((bit, name))
+    for reg in ("AHB1ENR", "APB1ENR", "APB2ENR"):
+        if reg in regs:
+            mask = sum(1 << bit for bit, _ in regs[reg])
+            body.append("RCC->%s |= 0x%08X;\t\t/* %s */" % (reg, mask, ", ".join(n for _, n in sorted(regs[reg]))))
+
+    for port, r in sorted(reg_masks(b.pins).items()):
+        body.append("")
+        body.append("/* GPIO%s: %s */" % (port, ", ".join(r["names"])))
+        if r["bsrr"]:
+            body.append("GPIO%s->BSRR = 0x%08X;" % (port, r["bsrr"]))
+        for reg in ("OTYPER", "OSPEEDR", "PUPDR", "AFRL", "AFRH", "MODER"):
+            if reg in r["regs"]:
+                m, v = r["regs"][reg]
+                body.append("GPIO%s->%s = (GPIO%s->%s & ~0x%08XU) | 0x%08XU;" % (port, reg, port, reg, m, v))
+
+    if b.exti:
+        body.append("")
+        body.append("/* EXTI: %s */" % ", ".join("line %d %s" % (l, b.exti[l]) for l in sorted(b.exti)))
+        cr = {}
+        rise = fall = 0
+        for line, name in b.exti.items():
+            p = b.pins[name]
+            i, shift = divmod(line, 4)
+            m, v = cr.get(i, (0, 0))
+            cr[i] = (m | (0xF << shift * 4), v | ("ABC".index(p["port"]) << shift * 4))
+            rise |= p["exti"][0] << line
+            fall |= p["exti"][1] << line
+        lines = sum(1 << l for l in b.exti)
+        for i in sorted(cr):
+            body.append("SYSCFG->EXTICR[%d] = (SYSCFG->EXTICR[%d] & ~0x%04XU) | 0x%04XU;" % (i, i, cr[i][0], cr[i][1]))
+        body.append("EXTI->RTSR = (EXTI->RTSR & ~0x%04XU) | 0x%04XU;" % (lines, rise))
+        body.append("EXTI->FTSR = (EXTI->FTSR & ~0x%04XU) | 0x%04XU;" % (lines, fall))
+        body.append("EXTI->PR = 0x%04XU;\t\t\t\t\t\t\t/* drop edges seen before the setup */" % lines)
+        body.append("EXTI->IMR |= 0x%04XU;" % lines)
+
+    irqs = []
+    for name, prio in b.irqs.items():
+        m = re.match(r"^DMA([12])_S([0-7])$", name)
+        num = DMA_IRQS[int(m.group(1))][int(m.group(2))] if m else IRQS[name]
+        irqs.append((num, name, prio))
+    if irqs:
+        body.append("")
+        body.append("/* NVIC */")
+        iser = {}
+        for num, name, prio in sorted(irqs):
+            body.append("NVIC->IP[%d] = (%d<<4);\t\t\t\t\t\t/* %s */" % (num, prio, name))
+            iser[num >> 5] = iser.get(num >> 5, 0) | (1 << (num & 31))
+        for i in sorted(iser):
+            body.append("NVIC->ISER[%d] = 0x%08X;" % (i, iser[i]))
+
+    out += [("\t" + l) if l else "" for l in body]
+    out += ["}", ""]
+    return "\n".join(out)
+
+
+def gen_h(b, src):
+    out = ["/* generated by board_Gen.py from %s, do not edit */" % src, "",
+           "#ifndef BOARD_H_", "#define BOARD_H_", "",
+           "#define BOARD_SYSCLK\t\t%d" % CLOCKS[b.clock], ""]
+    for name, p in sorted(b.pins.items(), key=lambda kv: kv[1]["line"]):
+        if p["label"]:
+            out.append("#define %s_PORT\t\tGPIO%s" % (p["label"], p["port"]))
+            out.append("#define %s_PIN\t\t%d" % (p["label"], p["pin"]))
+    out.append("")
+    out.append("/* pins claimed by this board, drivers included */")
+    for port in "ABC":
+        mask = sum(1 << p["pin"] for p in b.pins.values() if p["port"] == port)
+        if mask:
+            out.append("#define BOARD_GPIO%s_PINS\t0x%04X" % (port, mask))
+    if b.dma:
+        out.append("")
+        out.append("/* DMA streams: request, channel */")
+        for (ctrl, stream), d in sorted(b.dma.items()):
+            out.append("#define %s_DMA\t\t(&DMA%d->S[%d])\t/* channel %d%s */"
+                       % (d["name"], ctrl, stream, d["channel"], ", set up by the driver" if d["driver"] else ""))
+            out.append("#define %s_DMA_CHANNEL\t%d" % (d["name"], d["channel"]))
+            out.append("#define %s_DMA_IRQ\t%d" % (d["name"], DMA_IRQS[ctrl][stream]))
+    out += ["", "void board_Init(void);", "", "#endif /* BOARD_H_ */", ""]
+    return "\n".join(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description="board description to init code")
+    ap.add_argument("board")
+    ap.add_argument("-o", "--outdir", help="write board.c and board.h here")
+    ap.add_argument("--check", action="store_true", help="check only")
+    args = ap.parse_args()
+
+    b = Board(args.board)
+    try:
+        b.parse()
+        b.check()
+    except BoardError as e:
+        sys.exit(str(e))
+    if args.check:
+        return
+    src = os.path.basename(args.board)
+    outdir = args.outdir or os.path.dirname(args.board) or "."
+    with open(os.path.join(outdir, "board.c"), "w") as fh:
+        fh.write(gen_c(b, src))
+    with open(os.path.join(outdir, "board.h"), "w") as fh:
+        fh.write(gen_h(b, src))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,342 @@
+/**
+ ******************************************************************************
+ * @file    board_Test.c
+ * @author  Monish Kumar.k
+ * @date    08/04/2025
+ * @brief   Host test of board_Gen.py: generated board_Init() on RAM-mapped
+ *          registers, the conflict checks, and the committed board files.
+ *
+ * @details
+ * Build and run on the host from board_Gen/ (Linux, the register blocks are
+ * mapped at their STM32 addresses):
+ *
+ *     python3 board_Gen.py board_Test.board -o /tmp && gcc -O2 -I../manual_PWM -I/tmp -o board_Test board_Test.c /tmp/board.c && ./board_Test
+ *
+ *  - board_Init() generated from board_Test.board runs over random register
+ *    contents. Every GPIO, RCC enable, SYSCFG, EXTI and NVIC register must
+ *    end up as ref_Pins()/the expectations below say: the fields of the
+ *    described pins set, every other bit (driver pins, other lines, other
+ *    enable bits) as it was.
+ *  - board.h: labels, claimed pin masks (driver pins included) and the DMA
+ *    stream picked for SPI1_TX are checked at compile time.
+ *  - each description in bad[] must be refused by board_Gen.py --check with
+ *    the expected message.
+ *  - falling_edge.board regenerated into a temporary directory must give
+ *    the committed board.c and board.h byte for byte.
+ * Exits non-zero on a failure.
+ ******************************************************************************
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <arm.h>
+#include "board.h"
+
+#define FALLING_EDGE	"../External_Interrupt/External_interrupt_with_falling_edge/"
+
+_Static_assert(BOARD_SYSCLK == 84000000, "pll84 clock");
+_Static_assert(CS_PIN == 6 && KEY_PIN == 8 && BUTTON_PIN == 13, "labels");
+_Static_assert(BOARD_GPIOA_PINS == 0x136F && BOARD_GPIOB_PINS == 0x4288 && BOARD_GPIOC_PINS == 0x2000, "claimed pins");
+_Static_assert(SPI1_TX_DMA_CHANNEL == 3 && SPI1_TX_DMA_IRQ == 59, "SPI1_TX on DMA2 stream 3");
+_Static_assert(USART2_TX_DMA_CHANNEL == 4 && USART2_TX_DMA_IRQ == 17, "USART2_TX on DMA1 stream 6");
+
+/* board_Test.board, pin by pin: port, pin, mode, od, speed, pull, af, level (-1 none) */
+static const struct
+{
+	unsigned char port, pin, mode, od, speed, pull, af;
+	signed char level;
+} pins[] =
+{
+	{ 0, 0,  3, 0, 0, 0, 0,  -1 },		//PA0 analog
+	{ 0, 1,  0, 0, 0, 2, 0,  -1 },		//PA1 in, pull down
+	{ 0, 5,  2, 0, 3, 0, 5,  -1 },		//PA5 SPI1_SCK, high speed
+	{ 0, 6,  1, 1, 1, 0, 0,  1 },		//PA6 out, od, medium, level 1
+	{ 0, 8,  0, 0, 0, 1, 0,  -1 },		//PA8 in, pull up, EXTI falling
+	{ 0, 9,  2, 0, 2, 1, 7,  -1 },		//PA9 USART1_TX, pull up, fast
+	{ 0, 12, 0, 0, 0, 0, 0,  -1 },		//PA12 in, EXTI both
+	{ 1, 3,  0, 0, 0, 0, 0,  -1 },		//PB3 in, EXTI rising
+	{ 1, 7,  0, 0, 0, 2, 0,  -1 },		//PB7 in, pull down, EXTI rising
+	{ 1, 9,  2, 1, 0, 0, 11, -1 },		//PB9 AF11, od
+	{ 1, 14, 1, 0, 0, 0, 0,  0 },		//PB14 out, level 0
+	{ 2, 13, 0, 0, 0, 0, 0,  -1 },		//PC13 in, EXTI falling
+};
+
+/* EXTI lines: line, port, rising, falling */
+static const unsigned char lines[][4] =
+{
+	{ 3, 1, 1, 0 }, { 7, 1, 1, 0 }, { 8, 0, 0, 1 }, { 12, 0, 1, 1 }, { 13, 2, 0, 1 },
+};
+
+/* NVIC: IRQ number, priority */
+static const unsigned char irqs[][2] =
+{
+	{ 9, 6 }, { 23, 4 }, { 30, 3 }, { 40, 2 }, { 59, 5 },
+};
+
+/* refused descriptions and the message board_Gen.py must give */
+static const char *const bad[][2] =
+{
+	{ "pin PA0 in\npin PA0 out\n",								"PA0 already used on line 1" },
+	{ "pin PA0 in exti=rising prio=1\npin PB0 in exti=falling prio=1\n",	"EXTI line 0 already used by PA0" },
+	{ "pin PA5 in exti=rising prio=1\npin PB6 in exti=rising prio=2\n",	"EXTI9_5 already has priority 1" },
+	{ "pin PA10 in exti=rising\n",								"EXTI15_10 has no priority" },
+	{ "pin PA0 af=SPI1_SCK\n",									"PA0 has no alternate function SPI1_SCK" },
+	{ "pin PA0 af=16\n",										"AF must be 0..15" },
+	{ "pin PD0 in\n",											"bad pin 'PD0'" },
+	{ "pin PA16 in\n",											"bad pin 'PA16'" },
+	{ "pin PA0\n",												"PA0 needs in, out, af= or analog" },
+	{ "pin PA0 in level=1\n",									"level=0|1 is for outputs" },
+	{ "pin PA0 out pull=sideways\n",							"pull must be up, down or none" },
+	{ "dma USART2_TX\ndma USART2_TX\n",							"no free stream for USART2_TX" },
+	{ "dma SPI1_TX stream=DMA1_S3\n",							"no free stream for SPI1_TX" },
+	{ "dma UART9_TX\n",											"unknown DMA request 'UART9_TX'" },
+	{ "irq TIM4\n",												"irq needs a name and prio=" },
+	{ "irq TIM4 prio=16\n",										"priority must be 0..15" },
+	{ "enable TIM42\n",											"unknown peripheral 'TIM42'" },
+	{ "clock pll100\n",											"clock must be one of" },
+	{ "blink PA5\n",											"unknown keyword 'blink'" },
+};
+
+static volatile struct gpio *const gpio[3] = { GPIOA, GPIOB, GPIOC };
+static unsigned int failures;
+
+static void map(unsigned long addr, unsigned long len)
+{
+	if(mmap((void *)addr, len, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED)
+	{
+		perror("mmap");
+		exit(2);
+	}
+}
+
+static void check(const char *what, unsigned int got, unsigned int want)
+{
+	if(got != want && failures++ < 20)
+		printf("FAIL %s: 0x%08X, expected 0x%08X\n", what, got, want);
+}
+
+static unsigned int random32(void)
+{
+	return (unsigned int)rand() ^ ((unsigned int)rand() << 16);
+}
+
+static unsigned int field(unsigned int reg, unsigned int shift, unsigned int width, unsigned int v)
+{
+	unsigned int m = ((1u << width) - 1) << shift;
+	return (reg & ~m) | ((v << shift) & m);
+}
+
+struct port_regs
+{
+	unsigned int moder, otyper, ospeedr, pupdr, afrl, afrh, bsrr;
+};
+
+/* expected GPIO contents: the fields of each described pin over the old value */
+static void ref_Pins(struct port_regs *r)
+{
+	for(unsigned int i = 0; i < sizeof(pins) / sizeof(pins[0]); i++)
+	{
+		struct port_regs *p = &r[pins[i].port];
+		unsigned int pin = pins[i].pin;
+
+		p->moder = field(p->moder, pin * 2, 2, pins[i].mode);
+		p->pupdr = field(p->pupdr, pin * 2, 2, pins[i].pull);
+		if(pins[i].mode == 1 || pins[i].mode == 2)
+		{
+			p->otyper = field(p->otyper, pin, 1, pins[i].od);
+			p->ospeedr = field(p->ospeedr, pin * 2, 2, pins[i].speed);
+		}
+		if(pins[i].mode == 2)
+		{
+			if(pin < 8)
+				p->afrl = field(p->afrl, pin * 4, 4, pins[i].af);
+			else
+				p->afrh = field(p->afrh, (pin - 8) * 4, 4, pins[i].af);
+		}
+		if(pins[i].level >= 0)
+			p->bsrr |= pins[i].level ? (1u << pin) : (1u << (pin + 16));
+	}
+}
+
+static void test_Init(void)
+{
+	struct port_regs want[3];
+	unsigned int ahb1, apb1, apb2, rtsr, ftsr, imr, exticr[4], iser[8];
+	unsigned char ip[64];
+	unsigned int mask = 0, rise = 0, fall = 0;
+
+	for(int p = 0; p < 3; p++)
+	{
+		want[p].moder = gpio[p]->MODER = random32();
+		want[p].otyper = gpio[p]->OTYPER = random32() & 0xFFFF;
+		want[p].ospeedr = gpio[p]->OSPEEDR = random32();
+		want[p].pupdr = gpio[p]->PUPDR = random32();
+		want[p].afrl = gpio[p]->AFRL = random32();
+		want[p].afrh = gpio[p]->AFRH = random32();
+		want[p].bsrr = gpio[p]->BSRR = 0;
+	}
+	ahb1 = RCC->AHB1ENR = random32();
+	apb1 = RCC->APB1ENR = random32();
+	apb2 = RCC->APB2ENR = random32();
+	RCC->CR = (1<<17) | (1<<25);				//HSERDY, PLLRDY
+	RCC->CFGR = (random32() & ~(0x3<<2)) | (2<<2);	//SWS = PLL
+	rtsr = EXTI->RTSR = random32() & 0x7FFFFF;
+	ftsr = EXTI->FTSR = random32() & 0x7FFFFF;
+	imr = EXTI->IMR = random32() & 0x7FFFFF;
+	for(int i = 0; i < 4; i++)
+		exticr[i] = SYSCFG->EXTICR[i] = random32() & 0xFFFF;
+	for(int i = 0; i < 8; i++)
+		iser[i] = NVIC->ISER[i] = 0;			//write-1-to-set, reads back the enabled set
+	for(int i = 0; i < 64; i++)
+		ip[i] = NVIC->IP[i] = (unsigned char)rand();
+
+	board_Init();
+
+	ref_Pins(want);
+	for(int p = 0; p < 3; p++)
+	{
+		char name[32];
+
+		snprintf(name, sizeof(name), "GPIO%c->MODER", 'A' + p);		check(name, gpio[p]->MODER, want[p].moder);
+		snprintf(name, sizeof(name), "GPIO%c->OTYPER", 'A' + p);	check(name, gpio[p]->OTYPER, want[p].otyper);
+		snprintf(name, sizeof(name), "GPIO%c->OSPEEDR", 'A' + p);	check(name, gpio[p]->OSPEEDR, want[p].ospeedr);
+		snprintf(name, sizeof(name), "GPIO%c->PUPDR", 'A' + p);		check(name, gpio[p]->PUPDR, want[p].pupdr);
+		snprintf(name, sizeof(name), "GPIO%c->AFRL", 'A' + p);		check(name, gpio[p]->AFRL, want[p].afrl);
+		snprintf(name, sizeof(name), "GPIO%c->AFRH", 'A' + p);		check(name, gpio[p]->AFRH, want[p].afrh);
+		snprintf(name, sizeof(name), "GPIO%c->BSRR", 'A' + p);		check(name, gpio[p]->BSRR, want[p].bsrr);
+	}
+
+	/* GPIOA..C and DMA2 (SPI1_TX); DMA1 only serves the driver's USART2 */
+	check("RCC->AHB1ENR", RCC->AHB1ENR, ahb1 | (1<<0) | (1<<1) | (1<<2) | (1<<22));
+	check("RCC->APB1ENR", RCC->APB1ENR, apb1 | (1<<2));									//TIM4, not USART2
+	check("RCC->APB2ENR", RCC->APB2ENR, apb2 | (1<<4) | (1<<12) | (1<<14));				//USART1, SPI1, SYSCFG
+	check("RCC->PLLCFGR", RCC->PLLCFGR, (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0));
+	check("RCC->CFGR SW/PPRE1", RCC->CFGR & ((0x3<<0) | (0x7<<10)), (2<<0) | (4<<10));
+	check("FLASH->ACR", FLASH->ACR, (1<<10) | (1<<9) | (1<<8) | (2<<0));
+
+	for(unsigned int i = 0; i < sizeof(lines) / sizeof(lines[0]); i++)
+	{
+		unsigned int l = lines[i][0];
+
+		exticr[l / 4] = field(exticr[l / 4], (l % 4) * 4, 4, lines[i][1]);
+		mask |= 1u << l;
+		rise |= (unsigned int)lines[i][2] << l;
+		fall |= (unsigned int)lines[i][3] << l;
+	}
+	for(int i = 0; i < 4; i++)
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "SYSCFG->EXTICR[%d]", i);
+		check(name, SYSCFG->EXTICR[i], exticr[i]);
+	}
+	check("EXTI->RTSR", EXTI->RTSR, (rtsr & ~mask) | rise);
+	check("EXTI->FTSR", EXTI->FTSR, (ftsr & ~mask) | fall);
+	check("EXTI->PR", EXTI->PR, mask);
+	check("EXTI->IMR", EXTI->IMR, imr | mask);
+
+	for(unsigned int i = 0; i < sizeof(irqs) / sizeof(irqs[0]); i++)
+	{
+		ip[irqs[i][0]] = (unsigned char)(irqs[i][1] << 4);
+		iser[irqs[i][0] >> 5] |= 1u << (irqs[i][0] & 31);
+	}
+	for(int i = 0; i < 64; i++)
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "NVIC->IP[%d]", i);
+		check(name, NVIC->IP[i], ip[i]);
+	}
+	for(int i = 0; i < 8; i++)
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "NVIC->ISER[%d]", i);
+		check(name, NVIC->ISER[i], iser[i]);
+	}
+}
+
+/* runs a shell command, returns its exit status and output */
+static int run(const char *cmd, char *out, unsigned int size)
+{
+	FILE *f = popen(cmd, "r");
+	unsigned int n = 0;
+
+	if(!f)
+		return -1;
+	while(n + 1 < size && fgets(out + n, size - n, f))
+		n += strlen(out + n);
+	out[n] = 0;
+	return pclose(f);
+}
+
+static void test_Bad(void)
+{
+	char path[] = "/tmp/board_TestXXXXXX", cmd[256], out[1024];
+
+	for(unsigned int i = 0; i < sizeof(bad) / sizeof(bad[0]); i++)
+	{
+		int fd = mkstemp(path);
+		FILE *f = fdopen(fd, "w");
+
+		fputs(bad[i][0], f);
+		fclose(f);
+		snprintf(cmd, sizeof(cmd), "python3 board_Gen.py %s --check 2>&1", path);
+		if(run(cmd, out, sizeof(out)) == 0 || !strstr(out, bad[i][1]))
+		{
+			if(failures++ < 20)
+				printf("FAIL bad[%u] not refused with \"%s\": %s\n", i, bad[i][1], out);
+		}
+		unlink(path);
+		strcpy(path, "/tmp/board_TestXXXXXX");
+	}
+}
+
+static int same_File(const char *a, const char *b)
+{
+	char cmd[512], out[64];
+
+	snprintf(cmd, sizeof(cmd), "cmp -s %s %s", a, b);
+	return run(cmd, out, sizeof(out)) == 0;
+}
+
+static void test_Committed(void)
+{
+	char dir[] = "/tmp/board_TestXXXXXX", cmd[512], out[1024], a[256];
+
+	if(!mkdtemp(dir))
+	{
+		perror("mkdtemp");
+		exit(2);
+	}
+	snprintf(cmd, sizeof(cmd), "python3 board_Gen.py " FALLING_EDGE "falling_edge.board -o %s 2>&1", dir);
+	if(run(cmd, out, sizeof(out)) != 0)
+	{
+		failures++;
+		printf("FAIL falling_edge.board: %s\n", out);
+	}
+	snprintf(a, sizeof(a), "%s/board.c", dir);
+	if(!same_File(a, FALLING_EDGE "board.c") && failures++ < 20)
+		printf("FAIL " FALLING_EDGE "board.c differs from board_Gen.py output\n");
+	snprintf(a, sizeof(a), "%s/board.h", dir);
+	if(!same_File(a, FALLING_EDGE "board.h") && failures++ < 20)
+		printf("FAIL " FALLING_EDGE "board.h differs from board_Gen.py output\n");
+	snprintf(cmd, sizeof(cmd), "rm -r %s", dir);
+	run(cmd, out, sizeof(out));
+}
+
+int main(void)
+{
+	map(0x40000000, 0x30000);
+	map(0xE000E000, 0x1000);
+	srand(1);
+
+	for(int i = 0; i < 100; i++)
+	{
+		test_Init();
+	}
+	test_Bad();
+	test_Committed();
+
+	printf("board: %u failures\n", failures);
+	return failures != 0;
+}
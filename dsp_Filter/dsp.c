@@ -0,0 +1,369 @@
+/**
+ ******************************************************************************
+ * @file    dsp.c
+ * @author  Monish Kumar.k
+ * @date    27/02/2025
+ * @brief   q15 block filters: FIR, moving average, biquad low-pass, median of
+ *          three, threshold with hysteresis and saturating add.
+ *
+ * @details
+ * The fast versions work on sample pairs:
+ *  - FIR       : SMLAD, two taps per instruction, two outputs per pass so
+ *                every coefficient pair is loaded once for both.
+ *  - Average   : running sum, O(1) per sample; pairs loaded/stored as words.
+ *  - Biquad    : DF1 with PKHBT-packed state, two SMLAD + one MLA + SSAT.
+ *  - Median3   : two outputs at once with SSUB16/SEL packed min/max,
+ *                no branches.
+ *  - Hysteresis: both thresholds compared for two samples with SSUB16/SEL,
+ *                state update is branch-free.
+ *  - Add_Sat   : QADD16, two saturating adds per instruction.
+ *
+ * The _Ref versions are the straightforward scalar loops and are the
+ * specification: for the same input and initial state the output is
+ * bit-identical (rounding, saturation and 32-bit accumulator wrap included).
+ ******************************************************************************
+ */
+#include "dsp.h"
+
+static short med3(short a, short b, short c)
+{
+	short lo = (a < b) ? a : b;
+	short hi = (a < b) ? b : a;
+	short m  = (hi < c) ? hi : c;
+	return (lo > m) ? lo : m;
+}
+
+void dsp_Fir_Init(struct dsp_fir *f, const short *coeffs, unsigned int taps, short *work)
+{
+	f->coeffs = coeffs;
+	f->taps = taps;
+	f->work = work;
+	for(unsigned int i = 0; i < taps - 1 + DSP_BLOCK_MAX; i++)
+	{
+		work[i] = 0;
+	}
+}
+
+void dsp_Avg_Init(struct dsp_avg *a, unsigned int log2n)
+{
+	for(unsigned int i = 0; i < DSP_AVG_MAX; i++)
+	{
+		a->hist[i] = 0;
+	}
+	a->pos = 0;
+	a->log2n = log2n;
+	a->sum = 0;
+}
+
+void dsp_Biquad_Init(struct dsp_biquad *q, short b0, short b1, short b2, short a1, short a2)
+{
+	q->b0 = b0;
+	q->b1 = b1;
+	q->b2 = b2;
+	q->a1 = a1;
+	q->a2 = a2;
+	q->b01  = dsp_Pack(b0, b1);
+	q->b2a1 = dsp_Pack(b2, (short)-a1);
+	q->x1 = q->x2 = q->y1 = q->y2 = 0;
+}
+
+/* history lives in work[0 .. taps-2], the new block is appended after it */
+static void fir_Load(struct dsp_fir *f, const short *in, unsigned int n)
+{
+	short *w = f->work + f->taps - 1;
+	for(unsigned int i = 0; i < n; i++)
+	{
+		w[i] = in[i];
+	}
+}
+
+static void fir_Keep(struct dsp_fir *f, unsigned int n)
+{
+	short *w = f->work;
+	for(unsigned int i = 0; i < f->taps - 1; i++)
+	{
+		w[i] = w[i + n];
+	}
+}
+
+void dsp_Fir(struct dsp_fir *f, const short *in, short *out, unsigned int n)
+{
+	const short *h = f->coeffs;
+	const short *x = f->work;
+	unsigned int taps = f->taps, i = 0;
+
+	fir_Load(f, in, n);
+	for(; i + 1 < n; i += 2)
+	{
+		int acc0 = 1 << 14, acc1 = 1 << 14;
+		for(unsigned int j = 0; j < taps; j += 2)
+		{
+			unsigned int c = dsp_Read2(&h[j]);
+			acc0 = dsp_Smlad(dsp_Read2(&x[i + j]), c, acc0);
+			acc1 = dsp_Smlad(dsp_Read2(&x[i + j + 1]), c, acc1);
+		}
+		dsp_Write2(&out[i], dsp_Pack(dsp_Sat16(acc0 >> 15), dsp_Sat16(acc1 >> 15)));
+	}
+	if(i < n)
+	{
+		int acc = 1 << 14;
+		for(unsigned int j = 0; j < taps; j += 2)
+		{
+			acc = dsp_Smlad(dsp_Read2(&x[i + j]), dsp_Read2(&h[j]), acc);
+		}
+		out[i] = dsp_Sat16(acc >> 15);
+	}
+	fir_Keep(f, n);
+}
+
+void dsp_Fir_Ref(struct dsp_fir *f, const short *in, short *out, unsigned int n)
+{
+	const short *h = f->coeffs;
+	const short *x = f->work;
+
+	fir_Load(f, in, n);
+	for(unsigned int i = 0; i < n; i++)
+	{
+		unsigned int acc = 1 << 14;
+		for(unsigned int j = 0; j < f->taps; j++)
+		{
+			acc += (unsigned int)(h[j] * x[i + j]);
+		}
+		int y = (int)acc >> 15;
+		out[i] = (short)(y > 32767 ? 32767 : (y < -32768 ? -32768 : y));
+	}
+	fir_Keep(f, n);
+}
+
+void dsp_Moving_Average(struct dsp_avg *a, const short *in, short *out, unsigned int n)
+{
+	unsigned int mask = (1u << a->log2n) - 1, shift = a->log2n, pos = a->pos, i = 0;
+	short *hist = a->hist;
+	int sum = a->sum;
+
+	for(; i + 1 < n; i += 2)
+	{
+		unsigned int x = dsp_Read2(&in[i]);
+		short x0 = (short)x, x1 = (short)(x >> 16), y0;
+
+		sum += x0 - hist[pos];
+		hist[pos] = x0;
+		pos = (pos + 1) & mask;
+		y0 = (short)(sum >> shift);
+
+		sum += x1 - hist[pos];
+		hist[pos] = x1;
+		pos = (pos + 1) & mask;
+		dsp_Write2(&out[i], dsp_Pack(y0, (short)(sum >> shift)));
+	}
+	if(i < n)
+	{
+		sum += in[i] - hist[pos];
+		hist[pos] = in[i];
+		pos = (pos + 1) & mask;
+		out[i] = (short)(sum >> shift);
+	}
+	a->pos = pos;
+	a->sum = sum;
+}
+
+void dsp_Moving_Average_Ref(struct dsp_avg *a, const short *in, short *out, unsigned int n)
+{
+	unsigned int len = 1u << a->log2n;
+
+	for(unsigned int i = 0; i < n; i++)
+	{
+		int sum = 0;
+
+		a->hist[a->pos] = in[i];
+		a->pos = (a->pos + 1) & (len - 1);
+		for(unsigned int k = 0; k < len; k++)
+		{
+			sum += a->hist[k];
+		}
+		out[i] = (short)(sum >> a->log2n);
+	}
+}
+
+void dsp_Biquad(struct dsp_biquad *q, const short *in, short *out, unsigned int n)
+{
+	unsigned int b01 = q->b01, b2a1 = q->b2a1;
+	int na2 = -q->a2;
+	short x1 = q->x1, x2 = q->x2, y1 = q->y1, y2 = q->y2;
+
+	for(unsigned int i = 0; i < n; i++)
+	{
+		short x0 = in[i], y0;
+		int acc;
+
+		acc = dsp_Smlad(dsp_Pack(x0, x1), b01, 1 << 13);
+		acc = dsp_Smlad(dsp_Pack(x2, y1), b2a1, acc);
+		acc = (int)((unsigned int)acc + (unsigned int)(na2 * y2));
+		y0 = dsp_Sat16(acc >> 14);
+
+		x2 = x1;
+		x1 = x0;
+		y2 = y1;
+		y1 = y0;
+		out[i] = y0;
+	}
+	q->x1 = x1;
+	q->x2 = x2;
+	q->y1 = y1;
+	q->y2 = y2;
+}
+
+void dsp_Biquad_Ref(struct dsp_biquad *q, const short *in, short *out, unsigned int n)
+{
+	for(unsigned int i = 0; i < n; i++)
+	{
+		unsigned int acc = 1 << 13;
+		int y;
+
+		acc += (unsigned int)(q->b0 * in[i]);
+		acc += (unsigned int)(q->b1 * q->x1);
+		acc += (unsigned int)(q->b2 * q->x2);
+		acc -= (unsigned int)(q->a1 * q->y1);
+		acc -= (unsigned int)(q->a2 * q->y2);
+		y = (int)acc >> 14;
+		if(y > 32767)
+			y = 32767;
+		if(y < -32768)
+			y = -32768;
+
+		q->x2 = q->x1;
+		q->x1 = in[i];
+		q->y2 = q->y1;
+		q->y1 = (short)y;
+		out[i] = (short)y;
+	}
+}
+
+void dsp_Median3(struct dsp_median *m, const short *in, short *out, unsigned int n)
+{
+	unsigned int i;
+
+	if(n < 2)
+	{
+		dsp_Median3_Ref(m, in, out, n);
+		return;
+	}
+	out[0] = med3(m->x2, m->x1, in[0]);
+	out[1] = med3(m->x1, in[0], in[1]);
+
+	/* outputs i and i+1 need (in[i-2], in[i-1], in[i]) and the same shifted by one */
+	for(i = 2; i + 1 < n; i += 2)
+	{
+		unsigned int a = dsp_Read2(&in[i - 2]);
+		unsigned int b = dsp_Read2(&in[i - 1]);
+		unsigned int c = dsp_Read2(&in[i]);
+		unsigned int lo = dsp_Min16(a, b);
+		unsigned int hi = dsp_Max16(a, b);
+
+		dsp_Write2(&out[i], dsp_Max16(lo, dsp_Min16(hi, c)));
+	}
+	if(i < n)
+	{
+		out[i] = med3(in[i - 2], in[i - 1], in[i]);
+	}
+	m->x2 = in[n - 2];
+	m->x1 = in[n - 1];
+}
+
+void dsp_Median3_Ref(struct dsp_median *m, const short *in, short *out, unsigned int n)
+{
+	for(unsigned int i = 0; i < n; i++)
+	{
+		short a = m->x2, b = m->x1, c = in[i];
+
+		if((a <= b && b <= c) || (c <= b && b <= a))
+			out[i] = b;
+		else if((b <= a && a <= c) || (c <= a && a <= b))
+			out[i] = a;
+		else
+			out[i] = c;
+		m->x2 = m->x1;
+		m->x1 = c;
+	}
+}
+
+unsigned int dsp_Hysteresis(struct dsp_hyst *h, const short *in, unsigned char *out, unsigned int n)
+{
+	unsigned int high = dsp_Pack(h->high, h->high);
+	unsigned int low  = dsp_Pack(h->low, h->low);
+	unsigned int s = h->state, changes = 0, i = 0;
+
+	for(; i + 1 < n; i += 2)
+	{
+		unsigned int x = dsp_Read2(&in[i]);
+		unsigned int above = dsp_Ge16(x, high);		//lane set: x >= high
+		unsigned int keep  = dsp_Ge16(x, low);		//lane set: x >= low
+		unsigned int s0, s1;
+
+		s0 = (above & 1) | (s & keep & 1);
+		s1 = ((above >> 16) & 1) | (s0 & (keep >> 16) & 1);
+		changes += (s ^ s0) + (s0 ^ s1);
+		out[i] = (unsigned char)s0;
+		out[i + 1] = (unsigned char)s1;
+		s = s1;
+	}
+	if(i < n)
+	{
+		unsigned int s0 = (in[i] >= h->high) | (s & (in[i] >= h->low));
+		changes += s ^ s0;
+		out[i] = (unsigned char)s0;
+		s = s0;
+	}
+	h->state = s;
+	return changes;
+}
+
+unsigned int dsp_Hysteresis_Ref(struct dsp_hyst *h, const short *in, unsigned char *out, unsigned int n)
+{
+	unsigned int changes = 0;
+
+	for(unsigned int i = 0; i < n; i++)
+	{
+		if(h->state)
+		{
+			if(in[i] < h->low)
+			{
+				h->state = 0;
+				changes++;
+			}
+		}
+		else
+		{
+			if(in[i] >= h->high)
+			{
+				h->state = 1;
+				changes++;
+			}
+		}
+		out[i] = (unsigned char)h->state;
+	}
+	return changes;
+}
+
+void dsp_Add_Sat(const short *a, const short *b, short *out, unsigned int n)
+{
+	unsigned int i = 0;
+
+	for(; i + 1 < n; i += 2)
+	{
+		dsp_Write2(&out[i], dsp_Qadd16(dsp_Read2(&a[i]), dsp_Read2(&b[i])));
+	}
+	if(i < n)
+	{
+		out[i] = dsp_Sat16(a[i] + b[i]);
+	}
+}
+
+void dsp_Add_Sat_Ref(const short *a, const short *b, short *out, unsigned int n)
+{
+	for(unsigned int i = 0; i < n; i++)
+	{
+		int s = a[i] + b[i];
+		out[i] = (short)(s > 32767 ? 32767 : (s < -32768 ? -32768 : s));
+	}
+}
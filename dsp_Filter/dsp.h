@@ -0,0 +1,205 @@
+/*
+ * dsp.h
+ *
+ *  Created on: Feb 27, 2025
+ *      Author: moni
+ *
+ *  Fixed-point (q15) block filters for sensor data.
+ *
+ *  Every kernel comes in two versions:
+ *   - dsp_Xxx()     : written on top of the packed 16-bit helpers below
+ *                     (SMLAD, QADD16, SSUB16 + SEL, SSAT, PKHBT), two samples
+ *                     per 32-bit word where the algorithm allows it.
+ *   - dsp_Xxx_Ref() : the plain one-sample-at-a-time C loop.
+ *  Both produce bit-identical output for the same input and state.
+ *
+ *  On a core without the DSP extension (__ARM_FEATURE_DSP not defined, e.g.
+ *  a host build) the helpers fall back to portable C with the exact
+ *  semantics of the instructions, including 32-bit wrap-around of SMLAD.
+ */
+
+#ifndef DSP_H_
+#define DSP_H_
+
+#define DSP_BLOCK_MAX		256			//largest block passed to dsp_Fir()
+#define DSP_AVG_MAX			64			//longest moving average window
+
+#define DSP_Q15(x)			((short)((x) * 32768.0 + ((x) < 0 ? -0.5 : 0.5)))
+#define DSP_Q14(x)			((short)((x) * 16384.0 + ((x) < 0 ? -0.5 : 0.5)))
+
+/*
+ * Packed 16-bit helpers. A "pair" is two q15 samples in one word, the lower
+ * address sample in bits 15:0.
+ */
+#if defined(__ARM_FEATURE_DSP)
+
+static inline int dsp_Smlad(unsigned int x, unsigned int y, int acc)
+{
+	int r;
+	__asm("smlad %0, %1, %2, %3" : "=r"(r) : "r"(x), "r"(y), "r"(acc));
+	return r;
+}
+
+static inline unsigned int dsp_Qadd16(unsigned int a, unsigned int b)
+{
+	unsigned int r;
+	__asm("qadd16 %0, %1, %2" : "=r"(r) : "r"(a), "r"(b));
+	return r;
+}
+
+static inline unsigned int dsp_Min16(unsigned int a, unsigned int b)
+{
+	unsigned int r;
+	__asm("ssub16 %0, %1, %2\n\tsel %0, %2, %1" : "=&r"(r) : "r"(a), "r"(b) : "cc");
+	return r;
+}
+
+static inline unsigned int dsp_Max16(unsigned int a, unsigned int b)
+{
+	unsigned int r;
+	__asm("ssub16 %0, %1, %2\n\tsel %0, %1, %2" : "=&r"(r) : "r"(a), "r"(b) : "cc");
+	return r;
+}
+
+/* lane mask: 0xFFFF in every lane where a >= b */
+static inline unsigned int dsp_Ge16(unsigned int a, unsigned int b)
+{
+	unsigned int r;
+	__asm("ssub16 %0, %1, %2\n\tsel %0, %3, %4" : "=&r"(r) : "r"(a), "r"(b), "r"(0xFFFFFFFF), "r"(0) : "cc");
+	return r;
+}
+
+static inline short dsp_Sat16(int x)
+{
+	int r;
+	__asm("ssat %0, #16, %1" : "=r"(r) : "r"(x));
+	return (short)r;
+}
+
+static inline unsigned int dsp_Pack(short lo, short hi)
+{
+	unsigned int r;
+	__asm("pkhbt %0, %1, %2, lsl #16" : "=r"(r) : "r"((int)lo), "r"((int)hi));
+	return r;
+}
+
+#else
+
+static inline int dsp_Smlad(unsigned int x, unsigned int y, int acc)
+{
+	return (int)((unsigned int)acc
+			   + (unsigned int)((short)x * (short)y)
+			   + (unsigned int)((short)(x >> 16) * (short)(y >> 16)));
+}
+
+static inline short dsp_Sat16(int x)
+{
+	return (short)(x > 32767 ? 32767 : (x < -32768 ? -32768 : x));
+}
+
+static inline unsigned int dsp_Qadd16(unsigned int a, unsigned int b)
+{
+	unsigned short lo = (unsigned short)dsp_Sat16((short)a + (short)b);
+	unsigned short hi = (unsigned short)dsp_Sat16((short)(a >> 16) + (short)(b >> 16));
+	return lo | ((unsigned int)hi << 16);
+}
+
+static inline unsigned int dsp_Min16(unsigned int a, unsigned int b)
+{
+	unsigned int lo = ((short)a < (short)b) ? (a & 0xFFFF) : (b & 0xFFFF);
+	unsigned int hi = ((short)(a >> 16) < (short)(b >> 16)) ? (a >> 16) : (b >> 16);
+	return lo | (hi << 16);
+}
+
+static inline unsigned int dsp_Max16(unsigned int a, unsigned int b)
+{
+	unsigned int lo = ((short)a >= (short)b) ? (a & 0xFFFF) : (b & 0xFFFF);
+	unsigned int hi = ((short)(a >> 16) >= (short)(b >> 16)) ? (a >> 16) : (b >> 16);
+	return lo | (hi << 16);
+}
+
+static inline unsigned int dsp_Ge16(unsigned int a, unsigned int b)
+{
+	unsigned int lo = ((short)a >= (short)b) ? 0x0000FFFF : 0;
+	unsigned int hi = ((short)(a >> 16) >= (short)(b >> 16)) ? 0xFFFF0000 : 0;
+	return lo | hi;
+}
+
+static inline unsigned int dsp_Pack(short lo, short hi)
+{
+	return (unsigned short)lo | ((unsigned int)(unsigned short)hi << 16);
+}
+
+#endif
+
+/* Two consecutive samples as one pair; LDR may be unaligned on the M4. */
+static inline unsigned int dsp_Read2(const short *p)
+{
+	unsigned int v;
+	__builtin_memcpy(&v, p, 4);
+	return v;
+}
+
+static inline void dsp_Write2(short *p, unsigned int v)
+{
+	__builtin_memcpy(p, &v, 4);
+}
+
+/* FIR: coeffs are stored time reversed, taps must be even (pad with 0). */
+struct dsp_fir
+{
+	const short *coeffs;
+	unsigned int taps;
+	short *work;				//taps - 1 + DSP_BLOCK_MAX samples, zeroed
+};
+
+/* Moving average over 2^log2n samples; use one instance per version. */
+struct dsp_avg
+{
+	short hist[DSP_AVG_MAX];
+	unsigned int pos;
+	unsigned int log2n;
+	int sum;
+};
+
+/* Direct form I biquad, coefficients in Q14: b0 b1 b2 a1 a2 (a0 = 1). */
+struct dsp_biquad
+{
+	unsigned int b01;			//pack(b0, b1)
+	unsigned int b2a1;			//pack(b2, -a1), a1 must be > -2.0
+	short b0, b1, b2, a1, a2;
+	short x1, x2, y1, y2;
+};
+
+/* Comparator with hysteresis: goes high at >= high, back low at < low. */
+struct dsp_hyst
+{
+	short high;
+	short low;
+	unsigned int state;
+};
+
+/* Causal median of the last three samples. */
+struct dsp_median
+{
+	short x1, x2;
+};
+
+void dsp_Fir_Init(struct dsp_fir *f, const short *coeffs, unsigned int taps, short *work);
+void dsp_Avg_Init(struct dsp_avg *a, unsigned int log2n);
+void dsp_Biquad_Init(struct dsp_biquad *q, short b0, short b1, short b2, short a1, short a2);
+
+void dsp_Fir(struct dsp_fir *f, const short *in, short *out, unsigned int n);
+void dsp_Fir_Ref(struct dsp_fir *f, const short *in, short *out, unsigned int n);
+void dsp_Moving_Average(struct dsp_avg *a, const short *in, short *out, unsigned int n);
+void dsp_Moving_Average_Ref(struct dsp_avg *a, const short *in, short *out, unsigned int n);
+void dsp_Biquad(struct dsp_biquad *q, const short *in, short *out, unsigned int n);
+void dsp_Biquad_Ref(struct dsp_biquad *q, const short *in, short *out, unsigned int n);
+void dsp_Median3(struct dsp_median *m, const short *in, short *out, unsigned int n);
+void dsp_Median3_Ref(struct dsp_median *m, const short *in, short *out, unsigned int n);
+unsigned int dsp_Hysteresis(struct dsp_hyst *h, const short *in, unsigned char *out, unsigned int n);
+unsigned int dsp_Hysteresis_Ref(struct dsp_hyst *h, const short *in, unsigned char *out, unsigned int n);
+void dsp_Add_Sat(const short *a, const short *b, short *out, unsigned int n);
+void dsp_Add_Sat_Ref(const short *a, const short *b, short *out, unsigned int n);
+
+#endif /* DSP_H_ */
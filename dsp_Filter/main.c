@@ -0,0 +1,185 @@
+/**
+ ******************************************************************************
+ * @file    dsp_Filter.c
+ * @author  Monish Kumar.k
+ * @date    27/02/2025
+ * @brief   Cycle count and bit-exactness check of the q15 filter kernels.
+ *
+ * @details
+ * A BLOCK sample test signal (slow ramp + noise + occasional spikes, like a
+ * PIR/IR sensor block from adc_Dma) is pushed through every kernel twice:
+ * once with the packed SIMD version and once with the scalar _Ref loop.
+ *
+ * For each kernel the program records in bench[]:
+ *  - cycles per sample x100 of both versions (DWT->CYCCNT over one block)
+ *  - the number of output samples that differ (must be 0)
+ *
+ * The results are logged with LOG() (binary_Log) on USART2.
+ *
+ * Note:
+ *  - Build with -O2 -mcpu=cortex-m4 so __ARM_FEATURE_DSP is defined; without
+ *    it the same code runs on the portable helpers.
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 27/02/2025
+  File : dsp_Filter
+ ******************************************************************************/
+#include <arm.h>
+#include <uart.h>
+#include <log.h>
+#include "dsp.h"
+
+#define BLOCK		DSP_BLOCK_MAX
+#define FIR_TAPS	16
+
+enum { K_FIR, K_AVG, K_BIQUAD, K_MEDIAN, K_HYST, K_ADD, K_COUNT };
+
+struct bench_result
+{
+	unsigned int fast_cps100;		//cycles per sample x100, SIMD version
+	unsigned int ref_cps100;		//cycles per sample x100, scalar version
+	unsigned int mismatches;
+};
+
+volatile struct bench_result bench[K_COUNT];
+
+static short signal_in[BLOCK], noise[BLOCK];
+static short out_fast[BLOCK], out_ref[BLOCK];
+static unsigned char cmp_fast[BLOCK], cmp_ref[BLOCK];
+static short fir_work[2][FIR_TAPS - 1 + DSP_BLOCK_MAX];
+
+/* 16 tap low-pass, time reversed (symmetric anyway), sums to 1.0 in q15 */
+static const short fir_coeffs[FIR_TAPS] =
+{
+	-147, -287, -229, 405, 1728, 3521, 5205, 6188,
+	6188, 5205, 3521, 1728, 405, -229, -287, -147
+};
+
+void rcc_Config(void);
+void signal_Make(void);
+void bench_Run(void);
+
+int main(void)
+{
+	rcc_Config();
+	uart_Init(UART_CONSOLE, 921600);
+	log_Init();
+
+	signal_Make();
+	bench_Run();
+	for(int k=0; k<K_COUNT; k++)
+	{
+		LOG("kernel %u: simd %u/100, scalar %u/100 cycles/sample, %u mismatches",
+			k, bench[k].fast_cps100, bench[k].ref_cps100, bench[k].mismatches);
+	}
+	while(1)
+	{
+		log_Drain(UART_CONSOLE);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* APB1 /2 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+void signal_Make()
+{
+	unsigned int seed = 12345;
+
+	for(int i=0; i<BLOCK; i++)
+	{
+		seed = seed * 1664525 + 1013904223;
+		signal_in[i] = (short)(i * 64 - 8192 + (int)((seed >> 20) & 0x3FF) - 512);
+		if((seed >> 28) == 0)
+		{
+			signal_in[i] = (seed & 1) ? 32767 : -32768;		/* spike */
+		}
+		noise[i] = (short)(seed >> 16);
+	}
+}
+
+static unsigned int diff16(const short *a, const short *b)
+{
+	unsigned int d = 0;
+	for(int i=0; i<BLOCK; i++)
+	{
+		d += (a[i] != b[i]);
+	}
+	return d;
+}
+
+static unsigned int diff8(const unsigned char *a, const unsigned char *b)
+{
+	unsigned int d = 0;
+	for(int i=0; i<BLOCK; i++)
+	{
+		d += (a[i] != b[i]);
+	}
+	return d;
+}
+
+#define MEASURE(slot, call)							\
+	do												\
+	{												\
+		unsigned int t = DWT->CYCCNT;				\
+		call;										\
+		slot = (DWT->CYCCNT - t) * 100 / BLOCK;		\
+	} while(0)
+
+void bench_Run()
+{
+	struct dsp_fir fir_fast, fir_ref;
+	struct dsp_avg avg_fast, avg_ref;
+	struct dsp_biquad bq_fast, bq_ref;
+	struct dsp_median med_fast = { 0, 0 }, med_ref = { 0, 0 };
+	struct dsp_hyst hy_fast = { 4096, 2048, 0 }, hy_ref = { 4096, 2048, 0 };
+
+	dsp_Fir_Init(&fir_fast, fir_coeffs, FIR_TAPS, fir_work[0]);
+	dsp_Fir_Init(&fir_ref, fir_coeffs, FIR_TAPS, fir_work[1]);
+	dsp_Avg_Init(&avg_fast, 4);
+	dsp_Avg_Init(&avg_ref, 4);
+	/* 2nd order Butterworth low-pass, fc = fs/20 */
+	dsp_Biquad_Init(&bq_fast, DSP_Q14(0.0201), DSP_Q14(0.0402), DSP_Q14(0.0201), DSP_Q14(-1.5610), DSP_Q14(0.6414));
+	bq_ref = bq_fast;
+
+	MEASURE(bench[K_FIR].fast_cps100, dsp_Fir(&fir_fast, signal_in, out_fast, BLOCK));
+	MEASURE(bench[K_FIR].ref_cps100, dsp_Fir_Ref(&fir_ref, signal_in, out_ref, BLOCK));
+	bench[K_FIR].mismatches = diff16(out_fast, out_ref);
+
+	MEASURE(bench[K_AVG].fast_cps100, dsp_Moving_Average(&avg_fast, signal_in, out_fast, BLOCK));
+	MEASURE(bench[K_AVG].ref_cps100, dsp_Moving_Average_Ref(&avg_ref, signal_in, out_ref, BLOCK));
+	bench[K_AVG].mismatches = diff16(out_fast, out_ref);
+
+	MEASURE(bench[K_BIQUAD].fast_cps100, dsp_Biquad(&bq_fast, signal_in, out_fast, BLOCK));
+	MEASURE(bench[K_BIQUAD].ref_cps100, dsp_Biquad_Ref(&bq_ref, signal_in, out_ref, BLOCK));
+	bench[K_BIQUAD].mismatches = diff16(out_fast, out_ref);
+
+	MEASURE(bench[K_MEDIAN].fast_cps100, dsp_Median3(&med_fast, signal_in, out_fast, BLOCK));
+	MEASURE(bench[K_MEDIAN].ref_cps100, dsp_Median3_Ref(&med_ref, signal_in, out_ref, BLOCK));
+	bench[K_MEDIAN].mismatches = diff16(out_fast, out_ref);
+
+	MEASURE(bench[K_HYST].fast_cps100, dsp_Hysteresis(&hy_fast, signal_in, cmp_fast, BLOCK));
+	MEASURE(bench[K_HYST].ref_cps100, dsp_Hysteresis_Ref(&hy_ref, signal_in, cmp_ref, BLOCK));
+	bench[K_HYST].mismatches = diff8(cmp_fast, cmp_ref);
+
+	MEASURE(bench[K_ADD].fast_cps100, dsp_Add_Sat(signal_in, noise, out_fast, BLOCK));
+	MEASURE(bench[K_ADD].ref_cps100, dsp_Add_Sat_Ref(signal_in, noise, out_ref, BLOCK));
+	bench[K_ADD].mismatches = diff16(out_fast, out_ref);
+}
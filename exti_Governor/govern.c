@@ -0,0 +1,191 @@
+/**
+ ******************************************************************************
+ * @file    govern.c
+ * @author  Monish Kumar.k
+ * @date    20/04/2025
+ * @brief   EXTI interrupt-to-polling governor with per-line rate windows.
+ *
+ * @details
+ *  - Interrupt mode: the EXTI handler clears PR, restarts the line's
+ *    window when GOV_WINDOW_US of CYCCNT have gone by, counts and calls
+ *    the handler. The GOV_BUDGET-th interrupt of a window masks the line
+ *    and starts the poll tick.
+ *  - Poll mode: each TIM10 tick reads and clears PR and compares the pin
+ *    with the level of the last tick. An edge latched in PR or a level
+ *    change in a direction given to gov_Add() is activity; a change the
+ *    other way only updates the level, as it would not have interrupted
+ *    either. Activity calls the handler once and
+ *    restarts the quiet count; GOV_QUIET quiet ticks unmask the line
+ *    with PR cleared, so an old edge does not come back as an interrupt.
+ ******************************************************************************
+ */
+#include <arm.h>
+#include <rcc.h>
+#include "govern.h"
+
+#define TIM10_IRQ		25
+#define GPIO(port)		((volatile struct gpio*)(0x40020000 + (port) * 0x400))
+
+struct gov_line
+{
+	gov_handler handler;
+	volatile struct gpio *gpio;
+	unsigned int window_start;
+	unsigned int count;
+	unsigned int quiet;
+	unsigned int level;
+	unsigned int edges;					//GOV_RISING / GOV_FALLING
+	struct gov_stats stats;
+};
+
+static struct gov_line gov_lines[16];
+static unsigned int gov_active;			//lines added
+static unsigned int gov_polled;			//lines in poll mode
+static unsigned int gov_window;			//cycles
+
+static const unsigned char exti_irq[16] = { 6, 7, 8, 9, 10, 23, 23, 23, 23, 23, 40, 40, 40, 40, 40, 40 };
+
+void gov_Init()
+{
+	RCC->APB2ENR |= (1<<14) | (1<<17);		/* SYSCFG, TIM10 */
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);
+	gov_window = rcc_Get_Sysclk() / 1000000 * GOV_WINDOW_US;
+	gov_active = 0;
+	gov_polled = 0;
+
+	TIM10->CR1 = 0;
+	TIM10->PSC = rcc_Get_Tim_Clock(2) / 1000000 - 1;	/* 1 MHz */
+	TIM10->ARR = 1000000 / GOV_POLL_HZ - 1;
+	TIM10->EGR = (1<<0);
+	TIM10->SR = 0;
+	TIM10->DIER = (1<<0);
+	NVIC->IP[TIM10_IRQ] = (GOV_PRIORITY<<4);
+	NVIC->ISER[TIM10_IRQ >> 5] = (1 << (TIM10_IRQ & 31));
+}
+
+int gov_Add(unsigned int line, unsigned int port, unsigned int edges, gov_handler h)
+{
+	struct gov_line *l;
+	unsigned int bit = 1u << line;
+
+	if(line > 15 || port > 2 || !h || !(edges & (GOV_RISING | GOV_FALLING)))
+		return -1;
+	l = &gov_lines[line];
+	l->handler = h;
+	l->gpio = GPIO(port);
+	l->count = 0;
+	l->quiet = 0;
+	l->level = (l->gpio->IDR >> line) & 1;
+	l->edges = edges;
+	l->window_start = DWT->CYCCNT;
+	l->stats = (struct gov_stats){ 0 };
+
+	SYSCFG->EXTICR[line >> 2] = (SYSCFG->EXTICR[line >> 2] & ~(0xF << ((line & 3)*4))) | (port << ((line & 3)*4));
+	EXTI->RTSR = (edges & GOV_RISING)  ? (EXTI->RTSR | bit) : (EXTI->RTSR & ~bit);
+	EXTI->FTSR = (edges & GOV_FALLING) ? (EXTI->FTSR | bit) : (EXTI->FTSR & ~bit);
+	EXTI->PR = bit;
+	gov_active |= bit;
+	EXTI->IMR |= bit;
+	NVIC->IP[exti_irq[line]] = (GOV_PRIORITY<<4);
+	NVIC->ISER[exti_irq[line] >> 5] = (1 << (exti_irq[line] & 31));
+	return 0;
+}
+
+void gov_Stats(unsigned int line, struct gov_stats *s)
+{
+	*s = gov_lines[line & 15].stats;
+}
+
+static void gov_Storm(unsigned int line, struct gov_line *l)
+{
+	unsigned int bit = 1u << line;
+
+	EXTI->IMR &= ~bit;
+	EXTI->PR = bit;
+	l->stats.storms++;
+	l->stats.polling = 1;
+	l->quiet = 0;
+	if(!gov_polled)
+	{
+		TIM10->CNT = 0;
+		TIM10->SR = 0;
+		TIM10->CR1 = (1<<0);
+	}
+	gov_polled |= bit;
+}
+
+/* lines: the EXTI lines of the vector that was taken */
+static void gov_Exti(unsigned int lines)
+{
+	unsigned int pr = EXTI->PR & lines & gov_active & ~gov_polled;
+
+	EXTI->PR = pr;
+	while(pr)
+	{
+		unsigned int line = __builtin_ctz(pr);
+		struct gov_line *l = &gov_lines[line];
+		unsigned int now = DWT->CYCCNT;
+
+		pr &= pr - 1;
+		if(now - l->window_start >= gov_window)
+		{
+			l->window_start = now;
+			l->count = 0;
+		}
+		l->count++;
+		if(l->count > l->stats.peak)
+			l->stats.peak = l->count;
+		l->stats.irqs++;
+		l->level = (l->gpio->IDR >> line) & 1;
+		l->handler(line, l->level);
+		if(l->count >= GOV_BUDGET)
+			gov_Storm(line, l);
+	}
+}
+
+void EXTI0_IRQHandler()			{ gov_Exti(1<<0); }
+void EXTI1_IRQHandler()			{ gov_Exti(1<<1); }
+void EXTI2_IRQHandler()			{ gov_Exti(1<<2); }
+void EXTI3_IRQHandler()			{ gov_Exti(1<<3); }
+void EXTI4_IRQHandler()			{ gov_Exti(1<<4); }
+void EXTI9_5_IRQHandler()		{ gov_Exti(0x03E0); }
+void EXTI15_10_IRQHandler()		{ gov_Exti(0xFC00); }
+
+void TIM1_UP_TIM10_IRQHandler()
+{
+	unsigned int lines = gov_polled;
+
+	TIM10->SR = ~(1<<0);					//rc_w0
+	while(lines)
+	{
+		unsigned int line = __builtin_ctz(lines);
+		unsigned int bit = 1u << line;
+		struct gov_line *l = &gov_lines[line];
+		unsigned int pr = EXTI->PR & bit;
+		unsigned int level = (l->gpio->IDR >> line) & 1;
+		unsigned int edge = (level && !l->level) ? GOV_RISING : (!level && l->level) ? GOV_FALLING : 0;
+
+		lines &= lines - 1;
+		EXTI->PR = pr;
+		l->level = level;
+		if(pr || (edge & l->edges))
+		{
+			l->quiet = 0;
+			l->stats.polls++;
+			l->handler(line, level);
+		}
+		else if(++l->quiet >= GOV_QUIET)
+		{
+			/* quiet again: back to interrupts with a fresh window */
+			gov_polled &= ~bit;
+			l->stats.polling = 0;
+			l->count = 0;
+			l->window_start = DWT->CYCCNT;
+			EXTI->PR = bit;
+			EXTI->IMR |= bit;
+		}
+	}
+	if(!gov_polled)
+		TIM10->CR1 = 0;
+}
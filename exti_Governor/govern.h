@@ -0,0 +1,52 @@
+/*
+ * govern.h
+ *
+ *  Created on: Apr 20, 2025
+ *      Author: moni
+ *
+ *  EXTI rate governor. Every line counts its interrupts in a window of
+ *  GOV_WINDOW_US. When a line reaches GOV_BUDGET in one window it is
+ *  masked in EXTI_IMR and served from a poll tick (TIM10, GOV_POLL_HZ)
+ *  instead, so a noisy or floating input costs at most GOV_BUDGET
+ *  interrupts per window plus one tick per poll period, whatever its edge
+ *  rate. After GOV_QUIET ticks without activity the line goes back to
+ *  interrupt mode (as NAPI does for a network card).
+ *
+ *  The handler gets the line and the pin level. In interrupt mode it runs
+ *  once per edge; in poll mode at most once per tick, when the line latched
+ *  an edge or the pin changed level in one of the line's directions since
+ *  the last tick, so edges are coalesced there. TIM10 runs only while a
+ *  line is polled.
+ *
+ *  The EXTI handlers and TIM10 share one priority (GOV_PRIORITY), so they
+ *  never preempt each other and need no critical sections.
+ */
+
+#ifndef GOVERN_H_
+#define GOVERN_H_
+
+#define GOV_WINDOW_US	1000
+#define GOV_BUDGET		20				//interrupts per window, 20 kHz
+#define GOV_POLL_HZ		1000
+#define GOV_QUIET		50				//quiet ticks before interrupts are back
+#define GOV_PRIORITY	5
+
+#define GOV_RISING		(1<<0)
+#define GOV_FALLING		(1<<1)
+
+typedef void (*gov_handler)(unsigned int line, unsigned int level);
+
+struct gov_stats
+{
+	unsigned int irqs;					//handler calls from the EXTI interrupt
+	unsigned int polls;					//handler calls from the poll tick
+	unsigned int storms;				//switches to poll mode
+	unsigned int peak;					//most interrupts in one window
+	unsigned int polling;				//1 while the line is masked
+};
+
+void gov_Init(void);
+int  gov_Add(unsigned int line, unsigned int port, unsigned int edges, gov_handler h);	//port 0 = A
+void gov_Stats(unsigned int line, struct gov_stats *s);
+
+#endif /* GOVERN_H_ */
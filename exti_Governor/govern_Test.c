@@ -0,0 +1,411 @@
+/**
+ ******************************************************************************
+ * @file    govern_Test.c
+ * @author  Monish Kumar.k
+ * @date    20/04/2025
+ * @brief   Host model of the EXTI governor under edge floods: main loop
+ *          throughput, poll/interrupt switching and the reported edges.
+ *
+ * @details
+ * Build and run on the host (Linux x86-64, the register blocks are mapped
+ * at their STM32 addresses):
+ *
+ *     gcc -O2 -I../manual_PWM -o govern_Test govern_Test.c && ./govern_Test
+ *
+ * govern.c is included unmodified. A discrete-event loop runs in 84 MHz
+ * CPU cycles: pin sources make edges on PA0/PA1/PA15, an edge in the
+ * direction of RTSR/FTSR sets EXTI_PR, a pending unmasked line runs its
+ * EXTI vector (ISR_CYCLES), a due TIM10 update runs the poll tick
+ * (TICK_CYCLES, period from TIM10 PSC/ARR), otherwise the main loop does
+ * one iteration (LOOP_CYCLES). DWT_CYCCNT is the model time. EXTI_PR is
+ * write-1-to-clear as on the chip: its page is read-only while the driver
+ * runs, a store traps, is single-stepped and then applied as W1C.
+ *
+ * Scenarios, 1 MHz means a 50 % square wave with an edge every 42 cycles:
+ *  - 1 MHz rising-edge flood on PA0 for 1 s: the main loop keeps >= 99 %
+ *    of its idle rate, GOV_BUDGET interrupts, then one poll per tick.
+ *  - the same flood on a plain one-interrupt-per-edge handler
+ *    (Three_external_interrupt): the main loop gets < 1 % of idle.
+ *  - 0.3 s flood: after GOV_QUIET quiet ticks the line is back in
+ *    interrupt mode, and a later single edge is an interrupt again.
+ *  - a 200 Hz square wave after a flood (polled) and alone (interrupts),
+ *    for GOV_RISING, GOV_FALLING and both: the handler runs once per
+ *    configured edge in both modes.
+ *  - PA0, PA1 and PA15 flooded together, then 10 us pulses every 5 ms,
+ *    shorter than a tick: every pulse is reported on every line, so one
+ *    line's PR clear does not drop another line's edge.
+ * Exits non-zero on a failure.
+ ******************************************************************************
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <ucontext.h>
+#include <sys/mman.h>
+
+unsigned int rcc_Get_Sysclk(void)				{ return 84000000; }
+unsigned int rcc_Get_Tim_Clock(int bus)			{ (void)bus; return 84000000; }
+
+#include "govern.c"
+
+#define CLK				84000000ULL
+#define MS				(CLK / 1000)
+#define ISR_CYCLES		90
+#define TICK_CYCLES		80
+#define LOOP_CYCLES		20
+#define IDLE_LOOPS(t)	((t) / LOOP_CYCLES)
+#define EXTI_PAGE		0x40013000UL
+#define TF				0x100				//x86 trap flag
+
+/* high for width cycles every period, from start to end */
+struct wave
+{
+	unsigned long long start, end, period, width;
+};
+
+struct source
+{
+	const struct wave *w;
+	unsigned int n, i, level;
+	unsigned long long k, next;
+};
+
+static const unsigned int model_lines[3] = { 0, 1, 15 };
+static struct source src[16];
+static unsigned long long now, mark;
+static unsigned int calls[16], calls_after[16], failures;
+
+/* ---- EXTI_PR write-1-to-clear ---- */
+
+static volatile unsigned int *trap_addr;
+static unsigned int trap_old, trap_pr;		//PR stores seen
+
+static void on_Segv(int sig, siginfo_t *si, void *ctx)
+{
+	ucontext_t *uc = ctx;
+	unsigned long a = (unsigned long)si->si_addr;
+
+	(void)sig;
+	if(a < EXTI_PAGE || a >= EXTI_PAGE + 0x1000)
+		abort();
+	trap_addr = (volatile unsigned int *)a;
+	trap_old = EXTI->PR;
+	mprotect((void *)EXTI_PAGE, 0x1000, PROT_READ | PROT_WRITE);
+	uc->uc_mcontext.gregs[REG_EFL] |= TF;			//one instruction, then SIGTRAP
+}
+
+static void on_Trap(int sig, siginfo_t *si, void *ctx)
+{
+	ucontext_t *uc = ctx;
+
+	(void)sig;
+	(void)si;
+	if(trap_addr == &EXTI->PR)
+	{
+		EXTI->PR = trap_old & ~EXTI->PR;
+		trap_pr++;
+	}
+	mprotect((void *)EXTI_PAGE, 0x1000, PROT_READ);
+	uc->uc_mcontext.gregs[REG_EFL] &= ~TF;
+}
+
+static void drv(void (*f)(void))
+{
+	mprotect((void *)EXTI_PAGE, 0x1000, PROT_READ);
+	f();
+	mprotect((void *)EXTI_PAGE, 0x1000, PROT_READ | PROT_WRITE);
+}
+
+static void map(unsigned long addr, unsigned long len)
+{
+	if(mmap((void *)addr, len, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED)
+	{
+		perror("mmap");
+		exit(2);
+	}
+}
+
+/* ---- pin sources ---- */
+
+static void source_Set(unsigned int line, const struct wave *w, unsigned int n)
+{
+	struct source *s = &src[line];
+
+	s->w = w;
+	s->n = n;
+	s->i = 0;
+	s->k = 0;
+	s->level = 0;
+	s->next = n ? w[0].start : ~0ULL;
+}
+
+/* next edge of s, after the one at s->next */
+static void source_Step(struct source *s)
+{
+	const struct wave *w = &s->w[s->i];
+
+	if(s->level)
+		s->k++;
+	s->level ^= 1;
+	s->next = w->start + s->k * w->period + (s->level ? w->width : 0);
+	if(!s->level && s->next >= w->end)
+	{
+		s->k = 0;
+		s->next = (++s->i < s->n) ? s->w[s->i].start : ~0ULL;
+	}
+}
+
+/* edges up to now: IDR follows the pin, PR latches the configured edges */
+static void pins_Update(void)
+{
+	for(unsigned int i = 0; i < 3; i++)
+	{
+		unsigned int line = model_lines[i], bit = 1u << line;
+		struct source *s = &src[line];
+
+		while(s->next <= now)
+		{
+			if(s->level ? (EXTI->FTSR & bit) : (EXTI->RTSR & bit))
+				EXTI->PR |= bit;
+			source_Step(s);
+			GPIOA->IDR = (GPIOA->IDR & ~bit) | (s->level << line);
+		}
+	}
+}
+
+/* ---- model ---- */
+
+static void handler(unsigned int line, unsigned int level)
+{
+	(void)level;
+	calls[line]++;
+	if(now >= mark)
+		calls_after[line]++;
+}
+
+/* Three_external_interrupt: one handler call per edge */
+static void plain_Exti0(void)
+{
+	EXTI->PR = EXTI->PR & ~(1u << 0);
+	handler(0, GPIOA->IDR & 1);
+}
+
+struct run
+{
+	unsigned long long loops;
+	unsigned int ticks, irqs;
+};
+
+static void model_Reset(void)
+{
+	memset((void *)EXTI, 0, sizeof(*EXTI));
+	memset((void *)TIM10, 0, sizeof(*TIM10));
+	GPIOA->IDR = 0;
+	memset(calls, 0, sizeof(calls));
+	memset(calls_after, 0, sizeof(calls_after));
+	memset(src, 0, sizeof(src));
+	for(int i = 0; i < 16; i++)
+		src[i].next = ~0ULL;
+	now = 0;
+	mark = ~0ULL;
+	DWT->CYCCNT = 0;
+	drv(gov_Init);
+}
+
+static void model_Add(unsigned int line, unsigned int edges)
+{
+	mprotect((void *)EXTI_PAGE, 0x1000, PROT_READ);
+	gov_Add(line, 0, edges, handler);
+	mprotect((void *)EXTI_PAGE, 0x1000, PROT_READ | PROT_WRITE);
+}
+
+/* runs the model until end; plain: PA0 on plain_Exti0() instead of the governor */
+static struct run model_Run(unsigned long long end, int plain)
+{
+	struct run r = { 0, 0, 0 };
+	unsigned long long tick = ~0ULL;
+	unsigned int tick_period = (TIM10->PSC + 1) * (TIM10->ARR + 1), running = 0;
+
+	if(plain)
+		EXTI->IMR |= 1, EXTI->RTSR |= 1;
+	while(now < end)
+	{
+		pins_Update();
+		DWT->CYCCNT = (unsigned int)now;
+		if(!running && (TIM10->CR1 & 1))
+			tick = now + tick_period;
+		running = TIM10->CR1 & 1;
+
+		if(EXTI->IMR & EXTI->PR & (1u << 0))
+		{
+			plain ? plain_Exti0() : drv(EXTI0_IRQHandler);
+			now += ISR_CYCLES;
+			r.irqs++;
+		}
+		else if(EXTI->IMR & EXTI->PR & (1u << 1))
+		{
+			drv(EXTI1_IRQHandler);
+			now += ISR_CYCLES;
+			r.irqs++;
+		}
+		else if(EXTI->IMR & EXTI->PR & 0xFC00)
+		{
+			drv(EXTI15_10_IRQHandler);
+			now += ISR_CYCLES;
+			r.irqs++;
+		}
+		else if(running && now >= tick)
+		{
+			drv(TIM1_UP_TIM10_IRQHandler);
+			tick += tick_period;
+			now += TICK_CYCLES;
+			r.ticks++;
+		}
+		else
+		{
+			now += LOOP_CYCLES;
+			r.loops++;
+		}
+	}
+	return r;
+}
+
+static void expect(const char *what, unsigned long long got, unsigned long long lo, unsigned long long hi)
+{
+	if(got < lo || got > hi)
+	{
+		failures++;
+		printf("FAIL %s: %llu, expected %llu..%llu\n", what, got, lo, hi);
+	}
+}
+
+static const struct wave flood_1s[] = { { 0, CLK, 84, 42 } };
+
+static void test_Flood(void)
+{
+	struct gov_stats s;
+	struct run r;
+
+	model_Reset();
+	model_Add(0, GOV_RISING);
+	source_Set(0, flood_1s, 1);
+	r = model_Run(CLK, 0);
+	gov_Stats(0, &s);
+	printf("governed, 1 MHz for 1 s: main loop %llu (%.1f %% of idle), %u irqs, %u polls, %u storms, peak %u\n",
+		r.loops, r.loops * 100.0 / IDLE_LOOPS(CLK), s.irqs, s.polls, s.storms, s.peak);
+	expect("governed flood: main loop", r.loops, IDLE_LOOPS(CLK) * 99 / 100, IDLE_LOOPS(CLK));
+	expect("governed flood: irqs", s.irqs, GOV_BUDGET, GOV_BUDGET);
+	expect("governed flood: polls", s.polls, GOV_POLL_HZ - 2, GOV_POLL_HZ);
+	expect("governed flood: storms", s.storms, 1, 1);
+	expect("governed flood: still polling", s.polling, 1, 1);
+
+	model_Reset();
+	source_Set(0, flood_1s, 1);
+	r = model_Run(CLK, 1);
+	printf("plain ISR, 1 MHz for 1 s: main loop %llu (%.3f %% of idle), %u irqs\n",
+		r.loops, r.loops * 100.0 / IDLE_LOOPS(CLK), r.irqs);
+	expect("plain ISR flood: main loop", r.loops, 0, IDLE_LOOPS(CLK) / 100);
+}
+
+static void test_Recover(void)
+{
+	static const struct wave w[] = { { 0, 3 * CLK / 10, 84, 42 }, { 8 * CLK / 10, 8 * CLK / 10 + 1, 84, 42 } };
+	struct gov_stats s;
+	struct run r;
+
+	model_Reset();
+	model_Add(0, GOV_RISING);
+	source_Set(0, w, 2);
+	r = model_Run(7 * CLK / 10, 0);
+	gov_Stats(0, &s);
+	printf("governed, 1 MHz for 0.3 s: %u irqs, %u polls, %u ticks, polling %u at 0.7 s\n",
+		s.irqs, s.polls, r.ticks, s.polling);
+	expect("recover: polling after the quiet period", s.polling, 0, 0);
+	expect("recover: ticks", r.ticks, 300 + GOV_QUIET - 2, 300 + GOV_QUIET + 1);
+	expect("recover: TIM10 stopped", TIM10->CR1 & 1, 0, 0);
+	model_Run(CLK, 0);
+	gov_Stats(0, &s);
+	expect("recover: single edge as an interrupt", s.irqs, GOV_BUDGET + 1, GOV_BUDGET + 1);
+}
+
+/* a 200 Hz square wave from 0.11 s to 0.51 s, after a 0.1 s flood or alone */
+static void test_Edges(unsigned int edges, int flood)
+{
+	static const struct wave flood_wave[] = { { 0, CLK / 10, 84, 42 }, { 110 * MS, 510 * MS, 5 * MS, 5 * MS / 2 } };
+	const unsigned int periods = 80;
+	unsigned int want = periods * (!!(edges & GOV_RISING) + !!(edges & GOV_FALLING));
+	struct gov_stats s;
+	char what[64];
+
+	model_Reset();
+	model_Add(0, edges);
+	source_Set(0, flood ? flood_wave : flood_wave + 1, flood ? 2 : 1);
+	mark = 105 * MS;							//flood edges reported by then
+	model_Run(520 * MS, 0);
+	gov_Stats(0, &s);
+	snprintf(what, sizeof(what), "%s%s, %s: handler calls", (edges & GOV_RISING) ? "rising" : "",
+		(edges & GOV_FALLING) ? "falling" : "", flood ? "polled" : "interrupts");
+	expect(what, calls_after[0], want, want);
+	snprintf(what, sizeof(what), "%s%s, %s: polling", (edges & GOV_RISING) ? "rising" : "",
+		(edges & GOV_FALLING) ? "falling" : "", flood ? "polled" : "interrupts");
+	expect(what, s.polling, flood, flood);
+}
+
+/* all three lines flooded, then 10 us pulses every 5 ms: no pulse lost on any line */
+static void test_Lines(void)
+{
+	static const struct wave w[] = { { 0, CLK / 5, 84, 42 }, { 210 * MS, 410 * MS, 5 * MS, 840 } };
+	struct gov_stats s;
+	struct run r;
+
+	model_Reset();
+	for(unsigned int i = 0; i < 3; i++)
+	{
+		model_Add(model_lines[i], GOV_RISING);
+		source_Set(model_lines[i], w, 2);
+	}
+	mark = 205 * MS;
+	r = model_Run(420 * MS, 0);
+	printf("three lines, 1 MHz for 0.2 s then 10 us pulses: main loop %.1f %% of idle\n",
+		r.loops * 100.0 / IDLE_LOOPS(420 * MS));
+	for(unsigned int i = 0; i < 3; i++)
+	{
+		char what[64];
+
+		gov_Stats(model_lines[i], &s);
+		snprintf(what, sizeof(what), "EXTI%u pulses reported", model_lines[i]);
+		expect(what, calls_after[model_lines[i]], 40, 40);
+		snprintf(what, sizeof(what), "EXTI%u storms", model_lines[i]);
+		expect(what, s.storms, 1, 1);
+	}
+	expect("three lines: main loop", r.loops, IDLE_LOOPS(420 * MS) * 98 / 100, IDLE_LOOPS(420 * MS));
+}
+
+int main(void)
+{
+	struct sigaction sa;
+
+	map(0x40000000, 0x30000);
+	map(0xE0000000, 0x10000);
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_flags = SA_SIGINFO;
+	sa.sa_sigaction = on_Segv;
+	sigaction(SIGSEGV, &sa, NULL);
+	sa.sa_sigaction = on_Trap;
+	sigaction(SIGTRAP, &sa, NULL);
+
+	test_Flood();
+	test_Recover();
+	for(int flood = 0; flood < 2; flood++)
+	{
+		test_Edges(GOV_RISING, flood);
+		test_Edges(GOV_FALLING, flood);
+		test_Edges(GOV_RISING | GOV_FALLING, flood);
+	}
+	test_Lines();
+
+	printf("govern: %u EXTI_PR stores, %u failures\n", trap_pr, failures);
+	return failures != 0;
+}
@@ -0,0 +1,142 @@
+/**
+ ******************************************************************************
+ * @file    exti_Governor.c
+ * @author  Monish Kumar.k
+ * @date    20/04/2025
+ * @brief   Three_external_interrupt behind the EXTI rate governor: a noisy
+ *          or floating input can no longer starve the main loop.
+ *
+ * @details
+ * Hardware Connections: as Three_external_interrupt. Buttons on PA0
+ * (pull-down), PA1 (pull-up) and PA15 (pull-down), LEDs on PA5..PA7,
+ * USART2 TX on PA2 for the log. Clock is 84 MHz.
+ *
+ * Three_external_interrupt took one interrupt per edge. A floating PA1 or a
+ * signal generator on PA0 gave an interrupt storm, and the main loop (the
+ * log drain) stopped. Here the three lines are added to the governor
+ * (govern.h):
+ *  - PA0  : toggles the LED on PA6,
+ *  - PA1  : toggles the LED on PA5,
+ *  - PA15 : toggles the LED on PA7.
+ * The handlers toggle and count. Every edge is no longer logged, because
+ * in a storm the log itself would be the flood.
+ *
+ * Once per second LOG() reports the main loop iterations in that second,
+ * which is the throughput left to the application, and for each line the
+ * edges handled, the governor statistics and the current mode. Feed a
+ * square wave of up to several MHz into PA0 to see the loop count stay
+ * bounded.
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 20/04/2025
+  File : exti_Governor
+ ******************************************************************************/
+#include <arm.h>
+#include <rcc.h>
+#include <uart.h>
+#include <log.h>
+#include <pins.h>
+#include "govern.h"
+
+#define LOG_PORT		UART_2
+
+/* LEDs PA5..PA7; buttons PA0 (pull-down), PA1 (pull-up), PA15 (pull-down) */
+static const struct pin_cfg exti_pins[] =
+{
+	{ PORT_A, 0,  PIN_IN,  PIN_PP, PIN_LOW, PIN_DOWN,   0, 0 },
+	{ PORT_A, 1,  PIN_IN,  PIN_PP, PIN_LOW, PIN_UP,     0, 0 },
+	{ PORT_A, 5,  PIN_OUT, PIN_PP, PIN_LOW, PIN_NOPULL, 0, 0 },
+	{ PORT_A, 6,  PIN_OUT, PIN_PP, PIN_LOW, PIN_NOPULL, 0, 0 },
+	{ PORT_A, 7,  PIN_OUT, PIN_PP, PIN_LOW, PIN_NOPULL, 0, 0 },
+	{ PORT_A, 15, PIN_IN,  PIN_PP, PIN_LOW, PIN_DOWN,   0, 0 },
+};
+
+static const unsigned char led_pin[16] = { [0] = 6, [1] = 5, [15] = 7 };
+static volatile unsigned int edges[16];
+
+void rcc_Config(void);
+void button(unsigned int line, unsigned int level);
+void report(unsigned int loops);
+
+int main(void)
+{
+	unsigned int last, loops = 0;
+	int pins_ok;
+
+	rcc_Config();
+	pins_ok = (pins_Config(exti_pins, sizeof(exti_pins) / sizeof(exti_pins[0])) == 0);
+	uart_Init(LOG_PORT, 921600);
+	log_Init();
+	if(!pins_ok)
+	{
+		/* bad pin table: pins stay at reset, no line is governed */
+		LOG("governor: pin table rejected");
+		while(1)
+		{
+			log_Drain(LOG_PORT);
+		}
+	}
+
+	gov_Init();
+	gov_Add(0, PORT_A, GOV_RISING, button);
+	gov_Add(1, PORT_A, GOV_RISING, button);
+	gov_Add(15, PORT_A, GOV_RISING, button);
+	LOG("governor: %u interrupts per %u us, then polled at %u Hz",
+		GOV_BUDGET, GOV_WINDOW_US, GOV_POLL_HZ);
+
+	last = DWT->CYCCNT;
+	while(1)
+	{
+		loops++;
+		if(DWT->CYCCNT - last >= rcc_Get_Sysclk())
+		{
+			last += rcc_Get_Sysclk();
+			report(loops);
+			loops = 0;
+		}
+		log_Drain(LOG_PORT);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* APB1 /2 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+/* EXTI interrupt or poll tick, at most GOV_BUDGET per window + one per tick */
+void button(unsigned int line, unsigned int level)
+{
+	(void)level;
+	GPIOA->ODR ^= (1u << led_pin[line]);
+	edges[line]++;
+}
+
+void report(unsigned int loops)
+{
+	static const unsigned char lines[] = { 0, 1, 15 };
+	struct gov_stats s;
+
+	LOG("main loop: %u iterations/s", loops);
+	for(unsigned int i = 0; i < sizeof(lines); i++)
+	{
+		gov_Stats(lines[i], &s);
+		LOG("EXTI%u: %u handled, %u irqs, %u polls, %u storms, peak %u/window, polling %u",
+			lines[i], edges[lines[i]], s.irqs, s.polls, s.storms, s.peak, s.polling);
+	}
+}
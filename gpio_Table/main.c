@@ -0,0 +1,235 @@
+/**
+ ******************************************************************************
+ * @file    gpio_Table.c
+ * @author  Monish Kumar.k
+ * @date    05/04/2025
+ * @brief   Pin tables for the GPIO setups of Three_external_interrupt and
+ *          8x8_Led_PullUp_PullDown, checked against the hand-written code.
+ *
+ * @details
+ * Hardware Connections: none needed; USART1 TX on PA9 for the log.
+ *
+ * For each of the two setups:
+ *  - put GPIOA/GPIOB back to their reset values, run the original
+ *    gpio_Moder() code and take a copy of MODER, OTYPER, OSPEEDR, PUPDR,
+ *    AFRL and AFRH,
+ *  - reset again, apply the pin table with pins_Apply() and compare.
+ * Both are timed with CYCCNT. This runs before USART1 is set up, because
+ * the reset values take PA9/PA10 away from the UART; the results are
+ * logged afterwards with LOG() and kept in check[].
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 05/04/2025
+  File : gpio_Table
+ ******************************************************************************/
+#include <arm.h>
+#include <uart.h>
+#include <log.h>
+#include "pins.h"
+
+#define LOG_PORT		UART_1
+
+struct gpio_regs
+{
+	unsigned int moder, otyper, ospeedr, pupdr, afrl, afrh;
+};
+
+struct check_result
+{
+	unsigned int mismatches;		//registers that differ, both ports
+	unsigned int old_cycles;
+	unsigned int table_cycles;
+};
+
+/* Three_external_interrupt: LEDs PA5..PA7, buttons PA0 (pull-down), PA1 (pull-up), PA15 (pull-down) */
+static const struct pin_cfg exti_pins[] =
+{
+	{ PORT_A, 0,  PIN_IN,  PIN_PP, PIN_LOW, PIN_DOWN,   0, 0 },
+	{ PORT_A, 1,  PIN_IN,  PIN_PP, PIN_LOW, PIN_UP,     0, 0 },
+	{ PORT_A, 5,  PIN_OUT, PIN_PP, PIN_LOW, PIN_NOPULL, 0, 0 },
+	{ PORT_A, 6,  PIN_OUT, PIN_PP, PIN_LOW, PIN_NOPULL, 0, 0 },
+	{ PORT_A, 7,  PIN_OUT, PIN_PP, PIN_LOW, PIN_NOPULL, 0, 0 },
+	{ PORT_A, 15, PIN_IN,  PIN_PP, PIN_LOW, PIN_DOWN,   0, 0 },
+};
+
+/* 8x8_Led_PullUp_PullDown: rows PA0..PA7, columns PB0..2, PB5..9, buttons PB12/PB14, PB13/PB15 out */
+#define OUT(port, pin)	{ port, pin, PIN_OUT, PIN_PP, PIN_LOW, PIN_NOPULL, 0, 0 }
+static const struct pin_cfg matrix_pins[] =
+{
+	OUT(PORT_A, 0), OUT(PORT_A, 1), OUT(PORT_A, 2), OUT(PORT_A, 3),
+	OUT(PORT_A, 4), OUT(PORT_A, 5), OUT(PORT_A, 6), OUT(PORT_A, 7),
+	OUT(PORT_B, 0), OUT(PORT_B, 1), OUT(PORT_B, 2), OUT(PORT_B, 5),
+	OUT(PORT_B, 6), OUT(PORT_B, 7), OUT(PORT_B, 8), OUT(PORT_B, 9),
+	OUT(PORT_B, 13), OUT(PORT_B, 15),
+	{ PORT_B, 12, PIN_IN, PIN_PP, PIN_LOW, PIN_NOPULL, 0, 0 },
+	{ PORT_B, 14, PIN_IN, PIN_PP, PIN_LOW, PIN_NOPULL, 0, 0 },
+};
+
+volatile struct check_result check[2];
+
+void rcc_Config(void);
+void gpio_Reset(void);
+void gpio_Save(struct gpio_regs *r, volatile struct gpio *g);
+void exti_Gpio_Old(void);
+void matrix_Gpio_Old(void);
+void check_Run(volatile struct check_result *r, void (*old)(void), const struct pin_cfg *table, unsigned int n);
+
+int main(void)
+{
+	rcc_Config();
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);		/* CYCCNTENA */
+
+	check_Run(&check[0], exti_Gpio_Old, exti_pins, sizeof(exti_pins) / sizeof(exti_pins[0]));
+	check_Run(&check[1], matrix_Gpio_Old, matrix_pins, sizeof(matrix_pins) / sizeof(matrix_pins[0]));
+	gpio_Reset();
+
+	uart_Init(LOG_PORT, 921600);
+	log_Init();
+	LOG("Three_external_interrupt: %u registers differ, %u cycles by hand, %u from the table",
+		check[0].mismatches, check[0].old_cycles, check[0].table_cycles);
+	LOG("8x8_Led_PullUp_PullDown: %u registers differ, %u cycles by hand, %u from the table",
+		check[1].mismatches, check[1].old_cycles, check[1].table_cycles);
+	while(1)
+	{
+		log_Drain(LOG_PORT);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* APB1 /2 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+/* reset values of RM0368; PA13/PA14 stay on SWD */
+void gpio_Reset()
+{
+	RCC->AHB1ENR |= (1<<0) | (1<<1);
+	GPIOA->MODER   = 0xA8000000;
+	GPIOA->OTYPER  = 0;
+	GPIOA->OSPEEDR = 0x0C000000;
+	GPIOA->PUPDR   = 0x64000000;
+	GPIOA->AFRL    = 0;
+	GPIOA->AFRH    = 0;
+	GPIOB->MODER   = 0x00000280;
+	GPIOB->OTYPER  = 0;
+	GPIOB->OSPEEDR = 0x000000C0;
+	GPIOB->PUPDR   = 0x00000100;
+	GPIOB->AFRL    = 0;
+	GPIOB->AFRH    = 0;
+}
+
+void gpio_Save(struct gpio_regs *r, volatile struct gpio *g)
+{
+	r->moder   = g->MODER;
+	r->otyper  = g->OTYPER;
+	r->ospeedr = g->OSPEEDR;
+	r->pupdr   = g->PUPDR;
+	r->afrl    = g->AFRL;
+	r->afrh    = g->AFRH;
+}
+
+/* gpio_Moder() of Three_external_interrupt, unchanged */
+void exti_Gpio_Old()
+{
+	volatile unsigned int *GPIOA_MODER = &GPIOA->MODER;
+	volatile unsigned int *GPIOA_PUPDR = &GPIOA->PUPDR;
+
+	*GPIOA_MODER |= (1 << 10);
+	*GPIOA_MODER &= ~(1 << 11);
+	*GPIOA_MODER |= (1 << 12);
+	*GPIOA_MODER &= ~(1 << 13);
+	*GPIOA_MODER |= (1<<14);
+	*GPIOA_MODER &= ~(1<<15);
+	*GPIOA_MODER &= ~(1 << 2);
+	*GPIOA_MODER &= ~(1 << 3);
+	*GPIOA_MODER &= ~(1 << 0);
+	*GPIOA_MODER &= ~(1 << 1);
+	*GPIOA_MODER &= ~(1<<30);
+	*GPIOA_MODER &= ~(1<<31);
+
+	*GPIOA_PUPDR |= (1<<1);
+	*GPIOA_PUPDR &= ~(1<<0);
+	*GPIOA_PUPDR |= (1 << 2);
+	*GPIOA_PUPDR &= ~(1 << 3);
+	*GPIOA_PUPDR |= (1<<31);
+	*GPIOA_PUPDR &= ~(1<<30);
+}
+
+/* gpio_Moder() and gpio_Moder_Pattern() of 8x8_Led_PullUp_PullDown, unchanged */
+void matrix_Gpio_Old()
+{
+	volatile unsigned int *GPIOA_MODER = &GPIOA->MODER;
+	volatile unsigned int *GPIOB_MODER = &GPIOB->MODER;
+	int j=10;
+
+	*GPIOB_MODER = *GPIOB_MODER | (1<<26);
+	*GPIOB_MODER = *GPIOB_MODER & (~0x03000000);
+	*GPIOB_MODER = *GPIOB_MODER & (~0x30000000);
+	*GPIOB_MODER = *GPIOB_MODER | (1<<30);
+
+	for(int i=0 ; i<=14; i=i+2)
+	{
+		*GPIOA_MODER = *GPIOA_MODER | (1<<i);
+		if(i>=6)
+		{
+			*GPIOB_MODER = *GPIOB_MODER | (1<<j);
+			j=j+2;
+		}
+		else
+		{
+			*GPIOB_MODER = *GPIOB_MODER | (1<<i);
+		}
+	}
+}
+
+static unsigned int regs_Diff(const struct gpio_regs *a, const struct gpio_regs *b)
+{
+	return (a->moder != b->moder) + (a->otyper != b->otyper) + (a->ospeedr != b->ospeedr)
+		+ (a->pupdr != b->pupdr) + (a->afrl != b->afrl) + (a->afrh != b->afrh);
+}
+
+void check_Run(volatile struct check_result *r, void (*old)(void), const struct pin_cfg *table, unsigned int n)
+{
+	struct gpio_regs old_a, old_b, new_a, new_b;
+	struct pins p;
+	unsigned int start;
+
+	if(pins_Reduce(table, n, &p))
+	{
+		r->mismatches = 12;			/* bad table, count every register */
+		return;
+	}
+
+	gpio_Reset();
+	start = DWT->CYCCNT;
+	old();
+	r->old_cycles = DWT->CYCCNT - start;
+	gpio_Save(&old_a, GPIOA);
+	gpio_Save(&old_b, GPIOB);
+
+	gpio_Reset();
+	start = DWT->CYCCNT;
+	pins_Apply(&p);
+	r->table_cycles = DWT->CYCCNT - start;
+	gpio_Save(&new_a, GPIOA);
+	gpio_Save(&new_b, GPIOB);
+
+	r->mismatches = regs_Diff(&old_a, &new_a) + regs_Diff(&old_b, &new_b);
+}
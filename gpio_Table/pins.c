@@ -0,0 +1,104 @@
+/**
+ ******************************************************************************
+ * @file    pins.c
+ * @author  Monish Kumar.k
+ * @date    05/04/2025
+ * @brief   Table-driven GPIO setup: reduce a pin table to per-register
+ *          mask/value pairs, apply them with one write per register.
+ *
+ * @details
+ *  - pins_Reduce() rejects a pin listed twice or a field out of range and
+ *    returns -1, leaving the hardware alone.
+ *  - pins_Apply() turns on the GPIO clocks of all used ports with one
+ *    AHB1ENR write and skips registers with an empty mask.
+ ******************************************************************************
+ */
+#include <arm.h>
+#include "pins.h"
+
+static volatile struct gpio *const pins_gpio[PINS_PORTS] = { GPIOA, GPIOB, GPIOC };
+
+static void reg_Set(struct pins_reg *r, unsigned int shift, unsigned int width, unsigned int v)
+{
+	unsigned int m = ((1u << width) - 1) << shift;
+
+	r->mask |= m;
+	r->value = (r->value & ~m) | ((v << shift) & m);
+}
+
+int pins_Reduce(const struct pin_cfg *table, unsigned int n, struct pins *out)
+{
+	struct pins p = { 0 };
+
+	for(unsigned int i = 0; i < n; i++)
+	{
+		const struct pin_cfg *c = &table[i];
+		struct pins_port *port;
+		unsigned int pin = c->pin;
+
+		if(c->port >= PINS_PORTS || pin > 15 || c->mode > PIN_ANALOG || c->otype > PIN_OD
+			|| c->speed > PIN_HIGH || c->pull > PIN_DOWN || c->af > 15)
+			return -1;
+		port = &p.port[c->port];
+		if(port->used & (1u << pin))
+			return -1;
+		port->used |= 1u << pin;
+		p.ahb1enr |= 1u << c->port;
+
+		reg_Set(&port->moder, pin*2, 2, c->mode);
+		reg_Set(&port->pupdr, pin*2, 2, c->pull);
+		if(c->mode == PIN_OUT || c->mode == PIN_AF)
+		{
+			reg_Set(&port->otyper, pin, 1, c->otype);
+			reg_Set(&port->ospeedr, pin*2, 2, c->speed);
+		}
+		if(c->mode == PIN_AF)
+		{
+			if(pin < 8)
+				reg_Set(&port->afrl, pin*4, 4, c->af);
+			else
+				reg_Set(&port->afrh, (pin-8)*4, 4, c->af);
+		}
+		if(c->mode == PIN_OUT)
+			port->bsrr |= c->level ? (1u << pin) : (1u << (pin + 16));
+	}
+	*out = p;
+	return 0;
+}
+
+static void reg_Write(volatile unsigned int *reg, const struct pins_reg *r)
+{
+	if(r->mask)
+		*reg = (*reg & ~r->mask) | r->value;
+}
+
+void pins_Apply(const struct pins *p)
+{
+	RCC->AHB1ENR |= p->ahb1enr;
+	for(unsigned int i = 0; i < PINS_PORTS; i++)
+	{
+		const struct pins_port *s = &p->port[i];
+		volatile struct gpio *g = pins_gpio[i];
+
+		if(!s->used)
+			continue;
+		if(s->bsrr)
+			g->BSRR = s->bsrr;
+		reg_Write(&g->OTYPER, &s->otyper);
+		reg_Write(&g->OSPEEDR, &s->ospeedr);
+		reg_Write(&g->PUPDR, &s->pupdr);
+		reg_Write(&g->AFRL, &s->afrl);
+		reg_Write(&g->AFRH, &s->afrh);
+		reg_Write(&g->MODER, &s->moder);
+	}
+}
+
+int pins_Config(const struct pin_cfg *table, unsigned int n)
+{
+	struct pins p;
+
+	if(pins_Reduce(table, n, &p))
+		return -1;
+	pins_Apply(&p);
+	return 0;
+}
@@ -0,0 +1,73 @@
+/*
+ * pins.h
+ *
+ *  Created on: Apr 05, 2025
+ *      Author: moni
+ *
+ *  Pin configuration as a table instead of a row of |= / &= on MODER and
+ *  PUPDR. pins_Reduce() folds the table into one mask/value pair per port
+ *  register, pins_Apply() then configures each port with one masked write
+ *  per register:
+ *
+ *      static const struct pin_cfg leds[] =
+ *      {
+ *          { PORT_A, 5, PIN_OUT, PIN_PP, PIN_LOW, PIN_NOPULL, 0, 0 },
+ *          { PORT_A, 0, PIN_IN,  PIN_PP, PIN_LOW, PIN_DOWN,   0, 0 },
+ *      };
+ *      pins_Config(leds, sizeof(leds) / sizeof(leds[0]));
+ *
+ *  Reduce once and keep the struct pins when the same setup is applied
+ *  again (low-power exit, re-init after a fault).
+ *
+ *  Write order per port: initial output level (BSRR), OTYPER, OSPEEDR,
+ *  PUPDR, AFRL/AFRH and MODER last. An output therefore starts driving at
+ *  its configured level, type and speed, with no glitch to the reset level.
+ */
+
+#ifndef PINS_H_
+#define PINS_H_
+
+#define PINS_PORTS		3			//A, B, C on the F401 board
+
+enum pin_port  { PORT_A, PORT_B, PORT_C };
+enum pin_mode  { PIN_IN, PIN_OUT, PIN_AF, PIN_ANALOG };
+enum pin_otype { PIN_PP, PIN_OD };
+enum pin_speed { PIN_LOW, PIN_MEDIUM, PIN_FAST, PIN_HIGH };
+enum pin_pull  { PIN_NOPULL, PIN_UP, PIN_DOWN };
+
+struct pin_cfg
+{
+	unsigned char port;				//enum pin_port
+	unsigned char pin;				//0..15
+	unsigned char mode;				//enum pin_mode
+	unsigned char otype;			//enum pin_otype
+	unsigned char speed;			//enum pin_speed
+	unsigned char pull;				//enum pin_pull
+	unsigned char af;				//0..15, PIN_AF only
+	unsigned char level;			//initial output level, PIN_OUT only
+};
+
+struct pins_reg
+{
+	unsigned int mask;
+	unsigned int value;
+};
+
+struct pins_port
+{
+	unsigned int used;				//pins of this port in the table
+	unsigned int bsrr;				//initial levels of the outputs
+	struct pins_reg otyper, ospeedr, pupdr, afrl, afrh, moder;
+};
+
+struct pins
+{
+	unsigned int ahb1enr;			//GPIO clock bits of the ports used
+	struct pins_port port[PINS_PORTS];
+};
+
+int  pins_Reduce(const struct pin_cfg *table, unsigned int n, struct pins *out);
+void pins_Apply(const struct pins *p);
+int  pins_Config(const struct pin_cfg *table, unsigned int n);
+
+#endif /* PINS_H_ */
@@ -0,0 +1,234 @@
+/**
+ ******************************************************************************
+ * @file    pins_Test.c
+ * @author  Monish Kumar.k
+ * @date    05/04/2025
+ * @brief   Host test of pins_Reduce()/pins_Apply() on RAM-mapped GPIO
+ *          registers.
+ *
+ * @details
+ * Build and run on the host (Linux, the register blocks are mapped at
+ * their STM32 addresses):
+ *
+ *     gcc -O2 -I../manual_PWM -I../uart_Dma -I../binary_Log -o pins_Test pins_Test.c pins.c && ./pins_Test
+ *
+ * main.c is included with its main() renamed, so the on-target check runs
+ * here unchanged:
+ *  - check_Run() with the Three_external_interrupt and the
+ *    8x8_Led_PullUp_PullDown tables against the original hand-written
+ *    RMW sequences: 0 registers may differ.
+ *  - random tables (1..16 pins over ports A..C, any mode/type/speed/pull/AF
+ *    /level) applied over random register contents must give the same
+ *    MODER, OTYPER, OSPEEDR, PUPDR, AFRL, AFRH, BSRR and AHB1ENR as
+ *    ref_Apply(), one read-modify-write per field in table order, and must
+ *    leave the pins not in the table alone.
+ *  - a pin listed twice or any field out of range makes pins_Config()
+ *    return -1 without touching a register.
+ * Exits non-zero on a failure.
+ ******************************************************************************
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define main target_main
+#include "main.c"
+#undef main
+
+#define TABLES		200000
+
+static volatile struct gpio *const test_gpio[PINS_PORTS] = { GPIOA, GPIOB, GPIOC };
+static unsigned int failures;
+
+/* main.c logs through binary_Log and uart_Dma, not linked here */
+struct log_ring log_ring;
+int  uart_Init(int port, unsigned int baud)			{ (void)port; (void)baud; return 0; }
+void log_Init(void)									{ }
+void log_Drain(int port)							{ (void)port; }
+
+static void map(unsigned long addr, unsigned long len)
+{
+	if(mmap((void *)addr, len, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED)
+	{
+		perror("mmap");
+		exit(2);
+	}
+}
+
+struct port_regs
+{
+	unsigned int moder, otyper, ospeedr, pupdr, afrl, afrh, bsrr;
+};
+
+static void field(unsigned int *reg, unsigned int shift, unsigned int width, unsigned int v)
+{
+	unsigned int m = ((1u << width) - 1) << shift;
+	*reg = (*reg & ~m) | ((v << shift) & m);
+}
+
+/* what the hand-written code does: one RMW per field, pin by pin */
+static void ref_Apply(const struct pin_cfg *t, unsigned int n, struct port_regs *r, unsigned int *ahb1enr)
+{
+	for(unsigned int i = 0; i < n; i++)
+	{
+		struct port_regs *p = &r[t[i].port];
+		unsigned int pin = t[i].pin;
+
+		*ahb1enr |= 1u << t[i].port;
+		if(t[i].mode == PIN_OUT)
+			p->bsrr |= t[i].level ? (1u << pin) : (1u << (pin + 16));
+		if(t[i].mode == PIN_OUT || t[i].mode == PIN_AF)
+		{
+			field(&p->otyper, pin, 1, t[i].otype);
+			field(&p->ospeedr, pin * 2, 2, t[i].speed);
+		}
+		if(t[i].mode == PIN_AF)
+			field(pin < 8 ? &p->afrl : &p->afrh, (pin & 7) * 4, 4, t[i].af);
+		field(&p->pupdr, pin * 2, 2, t[i].pull);
+		field(&p->moder, pin * 2, 2, t[i].mode);
+	}
+}
+
+static void regs_Load(const struct port_regs *r)
+{
+	for(int i = 0; i < PINS_PORTS; i++)
+	{
+		test_gpio[i]->MODER = r[i].moder;
+		test_gpio[i]->OTYPER = r[i].otyper;
+		test_gpio[i]->OSPEEDR = r[i].ospeedr;
+		test_gpio[i]->PUPDR = r[i].pupdr;
+		test_gpio[i]->AFRL = r[i].afrl;
+		test_gpio[i]->AFRH = r[i].afrh;
+		test_gpio[i]->BSRR = r[i].bsrr;
+	}
+}
+
+static int regs_Match(const struct port_regs *r)
+{
+	for(int i = 0; i < PINS_PORTS; i++)
+	{
+		if(test_gpio[i]->MODER != r[i].moder || test_gpio[i]->OTYPER != r[i].otyper
+			|| test_gpio[i]->OSPEEDR != r[i].ospeedr || test_gpio[i]->PUPDR != r[i].pupdr
+			|| test_gpio[i]->AFRL != r[i].afrl || test_gpio[i]->AFRH != r[i].afrh
+			|| test_gpio[i]->BSRR != r[i].bsrr)
+			return 0;
+	}
+	return 1;
+}
+
+static void random_Regs(struct port_regs *r)
+{
+	for(int i = 0; i < PINS_PORTS; i++)
+	{
+		r[i].moder = (unsigned int)rand() ^ ((unsigned int)rand() << 16);
+		r[i].otyper = (unsigned int)rand() & 0xFFFF;
+		r[i].ospeedr = (unsigned int)rand() ^ ((unsigned int)rand() << 16);
+		r[i].pupdr = (unsigned int)rand() ^ ((unsigned int)rand() << 16);
+		r[i].afrl = (unsigned int)rand() ^ ((unsigned int)rand() << 16);
+		r[i].afrh = (unsigned int)rand() ^ ((unsigned int)rand() << 16);
+		r[i].bsrr = 0;				//write-only, reads 0
+	}
+}
+
+static unsigned int random_Table(struct pin_cfg *t)
+{
+	unsigned int n = 1 + rand() % 16, used[PINS_PORTS] = { 0 };
+
+	for(unsigned int i = 0; i < n; i++)
+	{
+		do
+		{
+			t[i].port = (unsigned char)(rand() % PINS_PORTS);
+			t[i].pin = (unsigned char)(rand() % 16);
+		} while(used[t[i].port] & (1u << t[i].pin));
+		used[t[i].port] |= 1u << t[i].pin;
+		t[i].mode = (unsigned char)(rand() % 4);
+		t[i].otype = (unsigned char)(rand() % 2);
+		t[i].speed = (unsigned char)(rand() % 4);
+		t[i].pull = (unsigned char)(rand() % 3);
+		t[i].af = (unsigned char)(rand() % 16);
+		t[i].level = (unsigned char)(rand() % 2);
+	}
+	return n;
+}
+
+static void test_Tables(void)
+{
+	struct pin_cfg t[16];
+	struct port_regs before[PINS_PORTS], want[PINS_PORTS];
+
+	for(int k = 0; k < TABLES; k++)
+	{
+		unsigned int n = random_Table(t), ahb1enr = 0;
+
+		random_Regs(before);
+		memcpy(want, before, sizeof(want));
+		ref_Apply(t, n, want, &ahb1enr);
+
+		regs_Load(before);
+		RCC->AHB1ENR = 0;
+		if(pins_Config(t, n) != 0 || !regs_Match(want) || RCC->AHB1ENR != ahb1enr)
+		{
+			if(failures++ < 10)
+				printf("FAIL table %d (%u pins): registers differ from the per-pin RMW\n", k, n);
+		}
+	}
+}
+
+static void test_Reject(void)
+{
+	struct pin_cfg t[16];
+	struct port_regs before[PINS_PORTS];
+
+	for(int k = 0; k < 10000; k++)
+	{
+		unsigned int n = random_Table(t), i = rand() % n;
+
+		switch(k % 8)
+		{
+		case 0:	t[i].port = (unsigned char)(PINS_PORTS + rand() % 200);	break;
+		case 1:	t[i].pin = (unsigned char)(16 + rand() % 200);			break;
+		case 2:	t[i].mode = (unsigned char)(4 + rand() % 200);			break;
+		case 3:	t[i].otype = (unsigned char)(2 + rand() % 200);			break;
+		case 4:	t[i].speed = (unsigned char)(4 + rand() % 200);			break;
+		case 5:	t[i].pull = (unsigned char)(3 + rand() % 200);			break;
+		case 6:	t[i].af = (unsigned char)(16 + rand() % 200);			break;
+		case 7:													//duplicate
+			if(n < 2)
+				continue;
+			t[i] = t[(i + 1) % n];
+			t[i].mode = (unsigned char)(rand() % 4);
+			break;
+		}
+		random_Regs(before);
+		regs_Load(before);
+		RCC->AHB1ENR = 0;
+		if(pins_Config(t, n) != -1 || !regs_Match(before) || RCC->AHB1ENR != 0)
+		{
+			if(failures++ < 10)
+				printf("FAIL bad table %d (case %d) accepted or registers touched\n", k, k % 8);
+		}
+	}
+}
+
+int main(void)
+{
+	map(0x40000000, 0x30000);
+	map(0xE0000000, 0x10000);
+	srand(1);
+
+	check_Run(&check[0], exti_Gpio_Old, exti_pins, sizeof(exti_pins) / sizeof(exti_pins[0]));
+	check_Run(&check[1], matrix_Gpio_Old, matrix_pins, sizeof(matrix_pins) / sizeof(matrix_pins[0]));
+	if(check[0].mismatches || check[1].mismatches)
+	{
+		printf("FAIL hand-written vs table: %u / %u registers differ\n", check[0].mismatches, check[1].mismatches);
+		failures++;
+	}
+
+	test_Tables();
+	test_Reject();
+
+	printf("pins: %d random tables, %u failures\n", TABLES, failures);
+	return failures != 0;
+}
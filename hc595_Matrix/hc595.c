@@ -0,0 +1,201 @@
+/**
+ ******************************************************************************
+ * @file    hc595.c
+ * @author  Monish Kumar.k
+ * @date    13/03/2025
+ * @brief   8x8 matrix through two cascaded 74HC595: unrolled bit-bang and
+ *          SPI + DMA scan steps for the led_Matrix scanned refresh.
+ *
+ * @details
+ *  - BSRR bit-bang: per bit, one write puts SER on the data bit and SRCLK
+ *    low, a second write raises SRCLK. The SER half of the first write is
+ *    picked branch-free by shifting the SET bit into the RESET half when
+ *    the data bit is 0. All 16 bits are unrolled.
+ *  - Bit-band bit-bang: SER is stored straight from the data bit into its
+ *    ODR alias word, SRCLK is pulsed through its own alias word.
+ *  - SPI: the row word is handed to DMA2 Stream3 (NDTR = 1); the transfer
+ *    complete interrupt waits for BSY to clear and pulses RCLK. The scan
+ *    ISR never waits for the shift.
+ *
+ * Note:
+ *  - Back-to-back GPIO stores on AHB1 are >= 2 cycles apart (24 ns at
+ *    84 MHz), which meets the 595 setup and pulse width at 3.3 V.
+ ******************************************************************************
+ */
+#include <arm.h>
+#include <rcc.h>
+#include <bitband.h>
+#include "hc595.h"
+
+#define DMA2_S3_IRQ		59
+#define SPI_DMA			(&DMA2->S[3])
+#define SPI_DMA_SHIFT	22
+
+#define SER_PIN			7
+#define CLK_PIN			5
+#define LATCH_PIN		4
+
+#define SER_SET			(1 << SER_PIN)
+#define CLK_SET			(1 << CLK_PIN)
+#define CLK_RESET		(1 << (CLK_PIN + 16))
+
+#define SER_ODR			BITBAND(&GPIOA->ODR, SER_PIN)
+#define CLK_ODR			BITBAND(&GPIOA->ODR, CLK_PIN)
+
+/* data bit 1: SER set, data bit 0: same bit moved to the RESET half */
+#define BSRR_BIT(w, i)															\
+	do																			\
+	{																			\
+		GPIOA->BSRR = CLK_RESET | (SER_SET << (((((w) >> (i)) & 1) ^ 1) * 16));	\
+		GPIOA->BSRR = CLK_SET;													\
+	} while(0)
+
+#define BITBAND_BIT(w, i)			\
+	do								\
+	{								\
+		CLK_ODR = 0;				\
+		SER_ODR = (w) >> (i);		\
+		CLK_ODR = 1;				\
+	} while(0)
+
+static unsigned short spi_word;
+static volatile unsigned int spi_busy;
+
+static unsigned int row_Word(unsigned int row, unsigned char bits)
+{
+	return ((unsigned int)bits << 8) | (1u << row);
+}
+
+static void latch()
+{
+	GPIOA->BSRR = 1 << LATCH_PIN;
+	GPIOA->BSRR = 1 << (LATCH_PIN + 16);
+}
+
+void hc595_Bsrr_Row(unsigned int row, unsigned char bits)
+{
+	unsigned int w = row_Word(row, bits);
+
+	BSRR_BIT(w, 15); BSRR_BIT(w, 14); BSRR_BIT(w, 13); BSRR_BIT(w, 12);
+	BSRR_BIT(w, 11); BSRR_BIT(w, 10); BSRR_BIT(w, 9);  BSRR_BIT(w, 8);
+	BSRR_BIT(w, 7);  BSRR_BIT(w, 6);  BSRR_BIT(w, 5);  BSRR_BIT(w, 4);
+	BSRR_BIT(w, 3);  BSRR_BIT(w, 2);  BSRR_BIT(w, 1);  BSRR_BIT(w, 0);
+	latch();
+}
+
+void hc595_Bitband_Row(unsigned int row, unsigned char bits)
+{
+	unsigned int w = row_Word(row, bits);
+
+	/* the alias only looks at bit 0 of the stored value */
+	BITBAND_BIT(w, 15); BITBAND_BIT(w, 14); BITBAND_BIT(w, 13); BITBAND_BIT(w, 12);
+	BITBAND_BIT(w, 11); BITBAND_BIT(w, 10); BITBAND_BIT(w, 9);  BITBAND_BIT(w, 8);
+	BITBAND_BIT(w, 7);  BITBAND_BIT(w, 6);  BITBAND_BIT(w, 5);  BITBAND_BIT(w, 4);
+	BITBAND_BIT(w, 3);  BITBAND_BIT(w, 2);  BITBAND_BIT(w, 1);  BITBAND_BIT(w, 0);
+	latch();
+}
+
+void hc595_Spi_Row(unsigned int row, unsigned char bits)
+{
+	volatile struct dma_stream *s = SPI_DMA;
+
+	if(spi_busy)				//previous step not latched yet, skip this one
+		return;
+	spi_busy = 1;
+	spi_word = (unsigned short)row_Word(row, bits);
+	s->M0AR = (unsigned int)&spi_word;
+	s->NDTR = 1;
+	s->CR  |= (1<<0);
+}
+
+void hc595_Spi_Wait()
+{
+	while(spi_busy);
+}
+
+static void gpio_Init(int spi)
+{
+	unsigned int af = spi ? 0x2 : 0x1;
+
+	RCC->AHB1ENR |= (1<<0);
+	GPIOA->BSRR   = (1 << (LATCH_PIN + 16)) | CLK_RESET | (SER_SET << 16);
+	GPIOA->MODER  = (GPIOA->MODER & ~((0x3 << (LATCH_PIN*2)) | (0x3 << (CLK_PIN*2)) | (0x3 << (SER_PIN*2))))
+				  | (0x1 << (LATCH_PIN*2)) | (af << (CLK_PIN*2)) | (af << (SER_PIN*2));
+	GPIOA->OSPEEDR |= (0x3 << (LATCH_PIN*2)) | (0x3 << (CLK_PIN*2)) | (0x3 << (SER_PIN*2));
+	GPIOA->AFRL   = (GPIOA->AFRL & ~((0xF << (CLK_PIN*4)) | (0xF << (SER_PIN*4))))
+				  | (5 << (CLK_PIN*4)) | (5 << (SER_PIN*4));
+}
+
+static void spi_Init()
+{
+	volatile struct dma_stream *s = SPI_DMA;
+	unsigned int pclk = rcc_Get_Pclk(2), br = 0;
+
+	RCC->AHB1ENR |= (1<<22);				//DMA2
+	RCC->APB2ENR |= (1<<12);				//SPI1
+
+	while(br < 7 && (pclk >> (br + 1)) > HC595_SPI_HZ)
+	{
+		br++;
+	}
+	SPI1->CR1 = 0;
+	SPI1->CR2 = (1<<1);						//TXDMAEN
+	SPI1->CR1 = (1<<11) | (1<<9) | (1<<8) | (br<<3) | (1<<2) | (1<<6);	//DFF 16 bit, SSM, SSI, BR, master, SPE
+
+	s->CR = 0;
+	while(s->CR & (1<<0));
+	DMA2->LIFCR = 0x3D << SPI_DMA_SHIFT;
+	s->PAR = (unsigned int)&SPI1->DR;
+	s->FCR = 0;
+	s->CR  = (3<<25) | (2<<16) | (1<<13) | (1<<11) | (1<<6) | (1<<4) | (1<<2);
+			//CH3, PL high, MSIZE/PSIZE 16 bit, M->P, TCIE, TEIE
+
+	spi_busy = 0;
+	NVIC->IP[DMA2_S3_IRQ] = (2<<4);			//above the scan timer, latches on time
+	NVIC->ISER[DMA2_S3_IRQ >> 5] = (1 << (DMA2_S3_IRQ & 31));
+}
+
+void DMA2_Stream3_IRQHandler()
+{
+	unsigned int flags = (DMA2->LISR >> SPI_DMA_SHIFT) & 0x3D;
+
+	DMA2->LIFCR = flags << SPI_DMA_SHIFT;
+	if(!(flags & ((1<<5) | (1<<3))))
+		return;
+
+	while(!(SPI1->SR & (1<<1)));			//TXE
+	while(SPI1->SR & (1<<7));				//BSY
+	latch();
+	spi_busy = 0;
+}
+
+static void bsrr_Init(struct matrix *m)
+{
+	(void)m;
+	gpio_Init(0);
+	matrix_Scan_Init(hc595_Bsrr_Row);
+}
+
+static void bitband_Init(struct matrix *m)
+{
+	(void)m;
+	gpio_Init(0);
+	matrix_Scan_Init(hc595_Bitband_Row);
+}
+
+static void spi_Backend_Init(struct matrix *m)
+{
+	(void)m;
+	gpio_Init(1);
+	spi_Init();
+	matrix_Scan_Init(hc595_Spi_Row);
+}
+
+static void hc595_Show(struct matrix *m)
+{
+	matrix_Scan_Load(m);
+}
+
+const struct matrix_backend hc595_bsrr    = { bsrr_Init, hc595_Show };
+const struct matrix_backend hc595_bitband = { bitband_Init, hc595_Show };
+const struct matrix_backend hc595_spi     = { spi_Backend_Init, hc595_Show };
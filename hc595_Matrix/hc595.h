@@ -0,0 +1,46 @@
+/*
+ * hc595.h
+ *
+ *  Created on: Mar 13, 2025
+ *      Author: moni
+ *
+ *  8x8 matrix behind two cascaded 74HC595 shift registers, scanned by the
+ *  led_Matrix refresh (TIM4, one row per interrupt). Three pins instead of
+ *  sixteen:
+ *
+ *  PA7 -> SER   (DS)    of the first 595      SPI1 MOSI in SPI mode
+ *  PA5 -> SRCLK (SHCP)  of both               SPI1 SCK  in SPI mode
+ *  PA4 -> RCLK  (STCP)  of both, latch        GPIO in every mode
+ *  QH' of the first 595 -> SER of the second
+ *
+ *  First 595: rows (Q0 = row 0, active high), second 595: columns. One
+ *  scan step shifts the 16 bit word (columns << 8) | (1 << row), MSB first,
+ *  and pulses RCLK. The outputs only change on the latch edge, so no
+ *  blanking is needed while the word is shifted.
+ *
+ *  Backends:
+ *   hc595_bsrr    : bit-bang, fully unrolled, two BSRR writes per bit
+ *   hc595_bitband : bit-bang, fully unrolled, SER/SRCLK through bit-band
+ *                   aliases of ODR
+ *   hc595_spi     : SPI1 16 bit + DMA2 Stream3, RCLK pulsed from the DMA
+ *                   transfer-complete interrupt
+ */
+
+#ifndef HC595_H_
+#define HC595_H_
+
+#include <matrix.h>
+
+#define HC595_SPI_HZ		21000000	//upper limit, the 595 takes ~25 MHz at 3.3 V
+
+extern const struct matrix_backend hc595_bsrr;
+extern const struct matrix_backend hc595_bitband;
+extern const struct matrix_backend hc595_spi;
+
+/* one scan step, without the refresh timer; for benchmarks */
+void hc595_Bsrr_Row(unsigned int row, unsigned char bits);
+void hc595_Bitband_Row(unsigned int row, unsigned char bits);
+void hc595_Spi_Row(unsigned int row, unsigned char bits);
+void hc595_Spi_Wait(void);
+
+#endif /* HC595_H_ */
@@ -0,0 +1,145 @@
+/**
+ ******************************************************************************
+ * @file    hc595_Matrix.c
+ * @author  Monish Kumar.k
+ * @date    13/03/2025
+ * @brief   8x8_Led_Display patterns through two cascaded 74HC595, with a
+ *          maximum scan rate benchmark of the bit-bang and SPI + DMA modes.
+ *
+ * @details
+ * Hardware Connections (see hc595.h):
+ *  - PA7 SER, PA5 SRCLK, PA4 RCLK
+ *  - first 595 Q0..Q7 -> rows 0..7, second 595 Q0..Q7 -> columns 0..7
+ *
+ * Benchmark (84 MHz SYSCLK):
+ *  - each mode runs BENCH_STEPS scan steps back to back with the refresh
+ *    timer stopped; SPI mode waits for the latch of one step before the
+ *    next, so the figure includes the shift and the interrupt.
+ *  - max row rate = SYSCLK / cycles per step, a full 8x8 frame is 8 steps.
+ *  - for SPI mode the CPU share per step (start + interrupt) is measured
+ *    separately, the rest of the step time is free for the application.
+ *  Results are logged with LOG() (binary_Log) on USART2 and kept in bench[].
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 13/03/2025
+  File : hc595_Matrix
+ ******************************************************************************/
+#include <arm.h>
+#include <rcc.h>
+#include <uart.h>
+#include <log.h>
+#include <matrix.h>
+#include <patterns.h>
+#include "hc595.h"
+
+#define BENCH_STEPS		1024
+
+struct bench_result
+{
+	unsigned int step_cycles;
+	unsigned int cpu_cycles;
+	unsigned int rows_per_s;
+	unsigned int frames_per_s;
+};
+
+/* 0: BSRR bit-bang, 1: bit-band bit-bang, 2: SPI + DMA */
+volatile struct bench_result bench[3];
+
+static struct matrix led;
+
+void rcc_Config(void);
+void bench_Run(void);
+unsigned int bench_Steps(matrix_row_out out, int spi);
+
+int main(void)
+{
+	rcc_Config();
+	uart_Init(UART_CONSOLE, 921600);
+	log_Init();
+
+	bench_Run();
+
+	matrix_Init(&led, &hc595_spi, 1);
+	while(1)
+	{
+		patterns(&led);
+		log_Drain(UART_CONSOLE);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* APB1 /2 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+unsigned int bench_Steps(matrix_row_out out, int spi)
+{
+	unsigned int start = DWT->CYCCNT;
+
+	for(unsigned int i = 0; i < BENCH_STEPS; i++)
+	{
+		out(i & 7, (unsigned char)(0x55 << (i & 1)));
+		if(spi)
+			hc595_Spi_Wait();
+	}
+	return (DWT->CYCCNT - start) / BENCH_STEPS;
+}
+
+void bench_Run()
+{
+	static const struct matrix_backend *const modes[3] = { &hc595_bsrr, &hc595_bitband, &hc595_spi };
+	static const matrix_row_out steps[3] = { hc595_Bsrr_Row, hc595_Bitband_Row, hc595_Spi_Row };
+	unsigned int sysclk = rcc_Get_Sysclk();
+
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);		/* CYCCNTENA */
+
+	for(unsigned int i = 0; i < 3; i++)
+	{
+		matrix_Init(&led, modes[i], 1);
+		matrix_Scan_Stop();
+
+		bench[i].step_cycles = bench_Steps(steps[i], i == 2);
+		bench[i].cpu_cycles = bench[i].step_cycles;
+		if(i == 2)
+		{
+			/* CPU share: the start call and the interrupt are the gaps the idle loop misses */
+			unsigned int window = bench[i].step_cycles * 2, start, t, idle = 0;
+
+			start = DWT->CYCCNT;
+			t = start;
+			hc595_Spi_Row(0, 0xFF);
+			while(DWT->CYCCNT - start < window)
+			{
+				unsigned int now = DWT->CYCCNT;
+				if(now - t < 16)
+				{
+					idle += now - t;
+				}
+				t = now;
+			}
+			bench[i].cpu_cycles = window - idle;
+		}
+		bench[i].rows_per_s = sysclk / bench[i].step_cycles;
+		bench[i].frames_per_s = bench[i].rows_per_s / 8;
+		LOG("mode %u: %u cycles/step (cpu %u), %u rows/s, %u frames/s", i, bench[i].step_cycles,
+			bench[i].cpu_cycles, bench[i].rows_per_s, bench[i].frames_per_s);
+		log_Drain(UART_CONSOLE);
+	}
+}
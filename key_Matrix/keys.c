@@ -0,0 +1,172 @@
+/**
+ ******************************************************************************
+ * @file    keys.c
+ * @author  Monish Kumar.k
+ * @date    03/04/2025
+ * @brief   Key matrix read in the blanking gap of the LED matrix scan, with
+ *          vertical-counter debounce and an event queue.
+ *
+ * @details
+ *  - keys_Row() is the row output of the TIM4 scan: blank, read key row r,
+ *    then hand over to matrix_Direct_Row() for display row r. The LEDs are
+ *    dark for the key read only, the rest of the row period is unchanged.
+ *  - Column pull-ups stay enabled all the time; in output mode they only
+ *    cost the pull-up current of the low columns.
+ *  - Debounce per key row: delta = raw ^ state, two counter bytes count
+ *    the scans a key has disagreed with its state, a key flips on the
+ *    KEYS_STABLE-th one and any agreeing scan resets its count.
+ ******************************************************************************
+ */
+#include <arm.h>
+#include <rcc.h>
+#include "keys.h"
+
+#define ROW_MODER		0x0000FFFF		//PA0..PA7
+#define COL_MODER		0x000FFC3F		//PB0..2, PB5..9
+#define COL_PUPDR		0x00055415		//pull-up on the column pins
+
+static unsigned char key_state[8];		//debounced, bit c = key (r, c) down
+static unsigned char key_ct0[8], key_ct1[8];
+static unsigned int key_first[64];
+
+static struct key_event key_queue[KEYS_QUEUE];
+static volatile unsigned int key_head, key_tail;
+static volatile unsigned int key_lost;
+
+static unsigned int key_settle;			//cycles
+static unsigned long long key_cycles;
+static unsigned int key_reads, key_worst;
+
+static void keys_Push(unsigned int key, unsigned int pressed, unsigned int now)
+{
+	unsigned int head = key_head;
+	struct key_event *e;
+
+	if(head - key_tail >= KEYS_QUEUE)
+	{
+		key_lost++;
+		return;
+	}
+	e = &key_queue[head & (KEYS_QUEUE - 1)];
+	e->key = (unsigned char)key;
+	e->pressed = (unsigned char)pressed;
+	e->first = key_first[key];
+	e->time = now;
+	key_head = head + 1;
+}
+
+static void keys_Debounce(unsigned int row, unsigned int raw, unsigned int now)
+{
+	unsigned int state = key_state[row];
+	unsigned int delta = raw ^ state;
+	unsigned int ct0 = key_ct0[row], ct1 = key_ct1[row], toggle, start;
+
+	start  = delta & ~(ct0 | ct1);			//first disagreeing scan
+	toggle = delta & ct0 & ct1;				//fourth one, the counter wraps to 0
+	ct1 = (ct1 ^ ct0) & delta;
+	ct0 = ~ct0 & delta;
+	key_ct0[row] = (unsigned char)ct0;
+	key_ct1[row] = (unsigned char)ct1;
+
+	while(start)
+	{
+		unsigned int c = __builtin_ctz(start);
+
+		key_first[row*8 + c] = now;
+		start &= start - 1;
+	}
+	if(toggle)
+	{
+		state ^= toggle;
+		key_state[row] = (unsigned char)state;
+		while(toggle)
+		{
+			unsigned int c = __builtin_ctz(toggle);
+
+			keys_Push(row*8 + c, (state >> c) & 1, now);
+			toggle &= toggle - 1;
+		}
+	}
+}
+
+/* TIM4 row output: key row first, then the display row */
+static void keys_Row(unsigned int row, unsigned char bits)
+{
+	unsigned int moder_a = GPIOA->MODER, moder_b = GPIOB->MODER;
+	unsigned int start = DWT->CYCCNT, idr, raw, c;
+
+	GPIOA->BSRR = 0x00FF << 16;									//blank, rows low
+	GPIOB->MODER = moder_b & ~COL_MODER;						//columns in, pulled up
+	GPIOA->MODER = (moder_a & ~ROW_MODER) | (1 << (row*2));		//only row r driven (low)
+	while(DWT->CYCCNT - start < key_settle);
+	idr = ~GPIOB->IDR;
+	GPIOA->MODER = moder_a;
+	GPIOB->MODER = moder_b;
+	c = DWT->CYCCNT - start;					//time the LEDs are dark for the keys
+	matrix_Direct_Row(row, bits);
+
+	key_cycles += c;
+	key_reads++;
+	if(c > key_worst)
+		key_worst = c;
+
+	raw = (idr & 0x07) | ((idr >> 2) & 0xF8);
+	keys_Debounce(row, raw, start);
+}
+
+static void keys_Init(struct matrix *m)
+{
+	(void)m;
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);
+	key_settle = rcc_Get_Sysclk() / 1000000 * KEYS_SETTLE_US;
+	matrix_Direct_Gpio();
+	GPIOB->PUPDR = (GPIOB->PUPDR & ~COL_MODER) | COL_PUPDR;
+	matrix_Scan_Init(keys_Row);
+}
+
+static void keys_Show(struct matrix *m)
+{
+	matrix_Scan_Load(m);
+}
+
+const struct matrix_backend matrix_direct_keys = { keys_Init, keys_Show };
+
+int keys_Get(struct key_event *e)
+{
+	unsigned int tail = key_tail;
+
+	if(tail == key_head)
+		return 0;
+	*e = key_queue[tail & (KEYS_QUEUE - 1)];
+	key_tail = tail + 1;
+	return 1;
+}
+
+int keys_Down(unsigned int key)
+{
+	return (key < 64) ? (key_state[key >> 3] >> (key & 7)) & 1 : 0;
+}
+
+unsigned long long keys_State()
+{
+	unsigned long long s = 0;
+
+	for(unsigned int r = 0; r < 8; r++)
+	{
+		s |= (unsigned long long)key_state[r] << (r*8);
+	}
+	return s;
+}
+
+unsigned int keys_Lost()
+{
+	return key_lost;
+}
+
+unsigned int keys_Read_Cycles(unsigned int *worst)
+{
+	if(worst)
+		*worst = key_worst;
+	return key_reads ? (unsigned int)(key_cycles / key_reads) : 0;
+}
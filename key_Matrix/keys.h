@@ -0,0 +1,47 @@
+/*
+ * keys.h
+ *
+ *  Created on: Apr 03, 2025
+ *      Author: moni
+ *
+ *  Key matrix on the wires of the direct-drive LED matrix (led_Matrix,
+ *  matrix_direct): one key with a series diode between row line r (PA0..7)
+ *  and column line c (PB0, PB1, PB2, PB5..PB9), anode on the column.
+ *
+ *  In the blanking gap before each display row, the row ISR turns the column
+ *  lines into inputs with pull-up, floats every row line except row r, which
+ *  it drives low, and reads the columns: a pressed key of row r pulls its
+ *  column low. One key row per display row, so all 64 keys are read once
+ *  per refresh frame with no extra pins and no extra interrupt.
+ *
+ *  Debounce: a key changes state after KEYS_STABLE consecutive scans that
+ *  disagree with it (vertical 2-bit counters, one byte per key row).
+ *  Key index = row * 8 + column.
+ */
+
+#ifndef KEYS_H_
+#define KEYS_H_
+
+#include <matrix.h>
+
+#define KEYS_STABLE		4			//scans, fixed by the 2-bit vertical counter
+#define KEYS_QUEUE		16			//events, power of two
+#define KEYS_SETTLE_US	2			//pull-up settling before the read
+
+struct key_event
+{
+	unsigned char key;
+	unsigned char pressed;
+	unsigned int first;				//CYCCNT of the first scan that saw the change
+	unsigned int time;				//CYCCNT when the event was queued
+};
+
+extern const struct matrix_backend matrix_direct_keys;
+
+int keys_Get(struct key_event *e);				//0 when the queue is empty
+int keys_Down(unsigned int key);
+unsigned long long keys_State(void);			//bit k = key k down
+unsigned int keys_Lost(void);					//events dropped on a full queue
+unsigned int keys_Read_Cycles(unsigned int *worst);	//average cycles of the key read
+
+#endif /* KEYS_H_ */
@@ -0,0 +1,131 @@
+/**
+ ******************************************************************************
+ * @file    key_Matrix.c
+ * @author  Monish Kumar.k
+ * @date    03/04/2025
+ * @brief   8x8_Led_PullUp_PullDown with the buttons moved into a key matrix
+ *          that shares the LED matrix wires, read during the scan.
+ *
+ * @details
+ * Hardware Connections: LED matrix as led_Matrix (rows PA0..PA7, columns
+ * PB0, PB1, PB2, PB5..PB9). Keys with a series diode (anode on the column)
+ * between row line r and column line c, see keys.h. USART1 TX on PA9 for
+ * the log.
+ *
+ * 8x8_Led_PullUp_PullDown polled PB12/PB14 between blocking patterns, so a
+ * press during the 800 ms of pattern0() was lost. Here the keys are read by
+ * the TIM4 scan whatever the main loop is doing and queued as events:
+ *  - key 0 (row 0, column 0) : pattern_0()   (was the PB12 button)
+ *  - key 1 (row 0, column 1) : pattern_1()   (was the PB14 button)
+ *  - key 2 (row 0, column 2) : pattern_2()
+ *  - any other key           : logged only
+ *
+ * Reported with LOG() on USART1:
+ *  - every key event with its latency from the first scan that saw the
+ *    change to the debounced event (KEYS_STABLE - 1 frames); add up to one
+ *    frame (8 ms) for the wait until the key's row comes round.
+ *  - the key read time per row, average and worst, and the display duty
+ *    cycle it costs in 1/10000: read time / row period (1 ms), logged
+ *    after each batch of key events.
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 03/04/2025
+  File : key_Matrix
+ ******************************************************************************/
+#include <arm.h>
+#include <rcc.h>
+#include <uart.h>
+#include <log.h>
+#include <matrix.h>
+#include <patterns.h>
+#include "keys.h"
+
+#define LOG_PORT		UART_1
+#define ROW_HZ			(8 * MATRIX_REFRESH_HZ)
+
+static struct matrix led;
+static volatile unsigned int selected;
+
+void rcc_Config(void);
+void keys_Report(void);
+
+int main(void)
+{
+	rcc_Config();
+	uart_Init(LOG_PORT, 921600);
+	log_Init();
+
+	matrix_Init(&led, &matrix_direct_keys, 1);
+	LOG("keys: %u scans to debounce, worst-case latency %u ms", KEYS_STABLE,
+		KEYS_STABLE * 1000 / MATRIX_REFRESH_HZ);
+	while(1)
+	{
+		keys_Report();
+		switch(selected)
+		{
+		case 1:
+			pattern_0(&led);
+			break;
+		case 2:
+			pattern_1(&led);
+			break;
+		case 3:
+			pattern_2(&led);
+			break;
+		default:
+			matrix_Clear(&led);
+			matrix_Show(&led);
+			matrix_Delay_Ms(10);
+			break;
+		}
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* APB1 /2 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+/* events queued while a pattern was running are handled here, none is lost */
+void keys_Report()
+{
+	unsigned int cycles_ms = rcc_Get_Sysclk() / 1000;
+	unsigned int avg, worst;
+	unsigned int events = 0;
+	struct key_event e;
+
+	while(keys_Get(&e))
+	{
+		events++;
+		LOG("key %u %u: latency %u us", e.key, e.pressed,
+			(e.time - e.first) / (cycles_ms / 1000));
+		if(e.pressed && e.key < 3)
+			selected = e.key + 1;
+		else if(!e.pressed && e.key < 3 && selected == e.key + 1u)
+			selected = 0;
+	}
+
+	if(events)
+	{
+		avg = keys_Read_Cycles(&worst);
+		LOG("keys: read %u cycles avg, %u worst, duty loss %u/10000, %u events lost",
+			avg, worst, avg * ROW_HZ * 10 / cycles_ms, keys_Lost());
+	}
+	log_Drain(LOG_PORT);
+}
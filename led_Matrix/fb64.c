@@ -0,0 +1,165 @@
+/**
+ ******************************************************************************
+ * @file    fb64.c
+ * @author  Monish Kumar.k
+ * @date    20/03/2025
+ * @brief   Per-pixel reference versions of the fb64.h transforms.
+ *
+ * @details
+ * Written for clarity, not speed: every output pixel is looked up from its
+ * source pixel with get()/put(). These define what the SWAR versions must
+ * produce.
+ ******************************************************************************
+ */
+#include "fb64.h"
+
+static unsigned int get(unsigned long long f, int x, int y)
+{
+	if(x < 0 || x > 7 || y < 0 || y > 7)
+		return 0;
+	return (f >> (y*8 + x)) & 1;
+}
+
+static unsigned long long put(unsigned long long f, int x, int y, unsigned int on)
+{
+	return f | ((unsigned long long)on << (y*8 + x));
+}
+
+unsigned long long fb64_Shift_Left_Ref(unsigned long long f, unsigned int n)
+{
+	unsigned long long r = 0;
+	n &= 7;
+	for(int y = 0; y < 8; y++)
+		for(int x = 0; x < 8; x++)
+			r = put(r, x, y, get(f, x + (int)n, y));
+	return r;
+}
+
+unsigned long long fb64_Shift_Right_Ref(unsigned long long f, unsigned int n)
+{
+	unsigned long long r = 0;
+	n &= 7;
+	for(int y = 0; y < 8; y++)
+		for(int x = 0; x < 8; x++)
+			r = put(r, x, y, get(f, x - (int)n, y));
+	return r;
+}
+
+unsigned long long fb64_Shift_Up_Ref(unsigned long long f, unsigned int n)
+{
+	unsigned long long r = 0;
+	n &= 7;
+	for(int y = 0; y < 8; y++)
+		for(int x = 0; x < 8; x++)
+			r = put(r, x, y, get(f, x, y + (int)n));
+	return r;
+}
+
+unsigned long long fb64_Shift_Down_Ref(unsigned long long f, unsigned int n)
+{
+	unsigned long long r = 0;
+	n &= 7;
+	for(int y = 0; y < 8; y++)
+		for(int x = 0; x < 8; x++)
+			r = put(r, x, y, get(f, x, y - (int)n));
+	return r;
+}
+
+unsigned long long fb64_Scroll_Left_Ref(unsigned long long f, unsigned int n)
+{
+	unsigned long long r = 0;
+	for(int y = 0; y < 8; y++)
+		for(int x = 0; x < 8; x++)
+			r = put(r, x, y, get(f, (x + (int)n) & 7, y));
+	return r;
+}
+
+unsigned long long fb64_Scroll_Right_Ref(unsigned long long f, unsigned int n)
+{
+	unsigned long long r = 0;
+	for(int y = 0; y < 8; y++)
+		for(int x = 0; x < 8; x++)
+			r = put(r, x, y, get(f, (x - (int)n) & 7, y));
+	return r;
+}
+
+unsigned long long fb64_Scroll_Up_Ref(unsigned long long f, unsigned int n)
+{
+	unsigned long long r = 0;
+	for(int y = 0; y < 8; y++)
+		for(int x = 0; x < 8; x++)
+			r = put(r, x, y, get(f, x, (y + (int)n) & 7));
+	return r;
+}
+
+unsigned long long fb64_Scroll_Down_Ref(unsigned long long f, unsigned int n)
+{
+	unsigned long long r = 0;
+	for(int y = 0; y < 8; y++)
+		for(int x = 0; x < 8; x++)
+			r = put(r, x, y, get(f, x, (y - (int)n) & 7));
+	return r;
+}
+
+unsigned long long fb64_Mirror_X_Ref(unsigned long long f)
+{
+	unsigned long long r = 0;
+	for(int y = 0; y < 8; y++)
+		for(int x = 0; x < 8; x++)
+			r = put(r, x, y, get(f, 7 - x, y));
+	return r;
+}
+
+unsigned long long fb64_Mirror_Y_Ref(unsigned long long f)
+{
+	unsigned long long r = 0;
+	for(int y = 0; y < 8; y++)
+		for(int x = 0; x < 8; x++)
+			r = put(r, x, y, get(f, x, 7 - y));
+	return r;
+}
+
+unsigned long long fb64_Transpose_Ref(unsigned long long f)
+{
+	unsigned long long r = 0;
+	for(int y = 0; y < 8; y++)
+		for(int x = 0; x < 8; x++)
+			r = put(r, x, y, get(f, y, x));
+	return r;
+}
+
+unsigned long long fb64_Rotate_CW_Ref(unsigned long long f)
+{
+	unsigned long long r = 0;
+	for(int y = 0; y < 8; y++)
+		for(int x = 0; x < 8; x++)
+			r = put(r, x, y, get(f, y, 7 - x));
+	return r;
+}
+
+unsigned long long fb64_Rotate_CCW_Ref(unsigned long long f)
+{
+	unsigned long long r = 0;
+	for(int y = 0; y < 8; y++)
+		for(int x = 0; x < 8; x++)
+			r = put(r, x, y, get(f, 7 - y, x));
+	return r;
+}
+
+unsigned long long fb64_Rotate_180_Ref(unsigned long long f)
+{
+	unsigned long long r = 0;
+	for(int y = 0; y < 8; y++)
+		for(int x = 0; x < 8; x++)
+			r = put(r, x, y, get(f, 7 - x, 7 - y));
+	return r;
+}
+
+unsigned long long fb64_Blend_Ref(unsigned long long a, unsigned long long b, unsigned long long mask)
+{
+	unsigned long long r = 0;
+	for(int y = 0; y < 8; y++)
+		for(int x = 0; x < 8; x++)
+			r = put(r, x, y, get(mask, x, y) ? get(b, x, y) : get(a, x, y));
+	return r;
+}
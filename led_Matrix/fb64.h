@@ -0,0 +1,183 @@
+/*
+ * fb64.h
+ *
+ *  Created on: Mar 20, 2025
+ *      Author: moni
+ *
+ *  Transforms of one 8x8 frame packed in a 64-bit word, the layout of
+ *  struct matrix: row y in byte y, column x in bit x of that byte, x = 0 is
+ *  the left edge and y = 0 the top row.
+ *
+ *  All of them are SWAR (the 8 rows are processed side by side as the 8
+ *  lanes of the word), branch-free and take the same instructions whatever
+ *  the frame or shift count; counts are taken modulo 8.
+ *
+ *  fb64.c holds a plain per-pixel version of each, fb64_Xxx_Ref(), which is
+ *  the specification; led_Matrix/main.c checks both agree.
+ */
+
+#ifndef FB64_H_
+#define FB64_H_
+
+#define FB64_REP(b)		((unsigned long long)(b) * 0x0101010101010101ULL)	//byte in every lane
+
+/* shifts, pixels pushed off the edge are lost, zeros come in */
+static inline unsigned long long fb64_Shift_Left(unsigned long long f, unsigned int n)
+{
+	n &= 7;
+	return (f >> n) & FB64_REP(0xFF >> n);
+}
+
+static inline unsigned long long fb64_Shift_Right(unsigned long long f, unsigned int n)
+{
+	n &= 7;
+	return (f << n) & FB64_REP((0xFF << n) & 0xFF);
+}
+
+static inline unsigned long long fb64_Shift_Up(unsigned long long f, unsigned int n)
+{
+	return f >> ((n & 7) * 8);
+}
+
+static inline unsigned long long fb64_Shift_Down(unsigned long long f, unsigned int n)
+{
+	return f << ((n & 7) * 8);
+}
+
+/* scrolls, pixels pushed off one edge come back at the other */
+static inline unsigned long long fb64_Scroll_Left(unsigned long long f, unsigned int n)
+{
+	unsigned long long m;
+
+	n &= 7;
+	m = FB64_REP(0xFF >> n);
+	return ((f >> n) & m) | ((f << (8 - n)) & ~m);
+}
+
+static inline unsigned long long fb64_Scroll_Right(unsigned long long f, unsigned int n)
+{
+	return fb64_Scroll_Left(f, 8 - (n & 7));
+}
+
+static inline unsigned long long fb64_Scroll_Up(unsigned long long f, unsigned int n)
+{
+	unsigned int s = (n & 7) * 8;
+	return (f >> s) | (f << ((64 - s) & 63));
+}
+
+static inline unsigned long long fb64_Scroll_Down(unsigned long long f, unsigned int n)
+{
+	return fb64_Scroll_Up(f, 8 - (n & 7));
+}
+
+/* left-right flip: reverse the bits of every byte */
+static inline unsigned long long fb64_Mirror_X(unsigned long long f)
+{
+#if defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_7M__)
+	unsigned int lo = (unsigned int)f, hi = (unsigned int)(f >> 32);
+
+	__asm("rbit %0, %0\n\trev %0, %0" : "+r"(lo));
+	__asm("rbit %0, %0\n\trev %0, %0" : "+r"(hi));
+	return ((unsigned long long)hi << 32) | lo;
+#else
+	f = ((f >> 1) & FB64_REP(0x55)) | ((f & FB64_REP(0x55)) << 1);
+	f = ((f >> 2) & FB64_REP(0x33)) | ((f & FB64_REP(0x33)) << 2);
+	return ((f >> 4) & FB64_REP(0x0F)) | ((f & FB64_REP(0x0F)) << 4);
+#endif
+}
+
+/* top-bottom flip: reverse the bytes */
+static inline unsigned long long fb64_Mirror_Y(unsigned long long f)
+{
+	return __builtin_bswap64(f);
+}
+
+/* pixel (x, y) <-> (y, x), three delta swaps */
+static inline unsigned long long fb64_Transpose(unsigned long long f)
+{
+	unsigned long long t;
+
+	t = (f ^ (f >> 7)) & 0x00AA00AA00AA00AAULL;
+	f ^= t ^ (t << 7);
+	t = (f ^ (f >> 14)) & 0x0000CCCC0000CCCCULL;
+	f ^= t ^ (t << 14);
+	t = (f ^ (f >> 28)) & 0x00000000F0F0F0F0ULL;
+	f ^= t ^ (t << 28);
+	return f;
+}
+
+/* quarter turns on screen (y down): clockwise moves the top row to the right column */
+static inline unsigned long long fb64_Rotate_CW(unsigned long long f)
+{
+	return fb64_Transpose(fb64_Mirror_Y(f));
+}
+
+static inline unsigned long long fb64_Rotate_CCW(unsigned long long f)
+{
+	return fb64_Mirror_Y(fb64_Transpose(f));
+}
+
+static inline unsigned long long fb64_Rotate_180(unsigned long long f)
+{
+	return fb64_Mirror_X(fb64_Mirror_Y(f));
+}
+
+static inline unsigned long long fb64_Invert(unsigned long long f)
+{
+	return ~f;
+}
+
+/* compositing */
+static inline unsigned long long fb64_Or(unsigned long long a, unsigned long long b)
+{
+	return a | b;
+}
+
+static inline unsigned long long fb64_And(unsigned long long a, unsigned long long b)
+{
+	return a & b;
+}
+
+static inline unsigned long long fb64_Xor(unsigned long long a, unsigned long long b)
+{
+	return a ^ b;
+}
+
+/* a with the pixels of b cut out */
+static inline unsigned long long fb64_Cut(unsigned long long a, unsigned long long b)
+{
+	return a & ~b;
+}
+
+/* b where mask is set, a elsewhere */
+static inline unsigned long long fb64_Blend(unsigned long long a, unsigned long long b, unsigned long long mask)
+{
+	return a ^ ((a ^ b) & mask);
+}
+
+/* column byte (bit y = row y) placed at column x, other columns empty */
+static inline unsigned long long fb64_Column(unsigned char c, unsigned int x)
+{
+	unsigned int lo = ((c & 0x0F) * 0x00204081u) & 0x01010101u;	//bit y -> bit 8y
+	unsigned int hi = ((c >> 4) * 0x00204081u) & 0x01010101u;
+
+	return (((unsigned long long)hi << 32) | lo) << (x & 7);
+}
+
+unsigned long long fb64_Shift_Left_Ref(unsigned long long f, unsigned int n);
+unsigned long long fb64_Shift_Right_Ref(unsigned long long f, unsigned int n);
+unsigned long long fb64_Shift_Up_Ref(unsigned long long f, unsigned int n);
+unsigned long long fb64_Shift_Down_Ref(unsigned long long f, unsigned int n);
+unsigned long long fb64_Scroll_Left_Ref(unsigned long long f, unsigned int n);
+unsigned long long fb64_Scroll_Right_Ref(unsigned long long f, unsigned int n);
+unsigned long long fb64_Scroll_Up_Ref(unsigned long long f, unsigned int n);
+unsigned long long fb64_Scroll_Down_Ref(unsigned long long f, unsigned int n);
+unsigned long long fb64_Mirror_X_Ref(unsigned long long f);
+unsigned long long fb64_Mirror_Y_Ref(unsigned long long f);
+unsigned long long fb64_Transpose_Ref(unsigned long long f);
+unsigned long long fb64_Rotate_CW_Ref(unsigned long long f);
+unsigned long long fb64_Rotate_CCW_Ref(unsigned long long f);
+unsigned long long fb64_Rotate_180_Ref(unsigned long long f);
+unsigned long long fb64_Blend_Ref(unsigned long long a, unsigned long long b, unsigned long long mask);
+
+#endif /* FB64_H_ */
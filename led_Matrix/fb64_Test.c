@@ -0,0 +1,215 @@
+/**
+ ******************************************************************************
+ * @file    fb64_Test.c
+ * @author  Monish Kumar.k
+ * @date    20/03/2025
+ * @brief   Host test and benchmark: fb64.h SWAR transforms against the
+ *          per-pixel fb64_Xxx_Ref() versions.
+ *
+ * @details
+ * Build and run on the host:
+ *
+ *     gcc -O2 -o fb64_Test fb64_Test.c fb64.c && ./fb64_Test
+ *
+ * Frames checked, for every shift/scroll count 0..15 (counts are mod 8):
+ *  - every single-pixel frame (64). The shifts, scrolls, mirrors,
+ *    transpose and rotations only move pixels, so they are linear over
+ *    GF(2): agreeing on these 64 basis frames and on 0 means agreeing on
+ *    all 2^64 frames. The frames below check that the SWAR code really
+ *    is linear (no stray carry or sign fill).
+ *  - every value of one row in each of the 8 rows and every value of one
+ *    column in each of the 8 columns (4096),
+ *  - 100000 random frames, plus 0 and ~0.
+ * Blend is checked per pixel with random a/b/mask, and fb64_Column()
+ * against a loop that sets bit x of byte y.
+ *
+ * The benchmark then times each transform on a chain of frames (every
+ * output feeds the next call, so nothing is hoisted) and prints ns per
+ * call for the SWAR and the per-pixel version. Host numbers only show the
+ * ratio; the target cycle counts come from led_Matrix/main.c.
+ * Exits non-zero on a failure.
+ ******************************************************************************
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "fb64.h"
+
+#define RANDOM_FRAMES	100000
+#define BENCH_CALLS		2000000
+
+typedef unsigned long long (*fb_fn)(unsigned long long f);
+typedef unsigned long long (*fb_fn_n)(unsigned long long f, unsigned int n);
+
+/* the SWAR versions are static inline, these give them an address */
+#define WRAP(name)		static unsigned long long name##_W(unsigned long long f) { return name(f); }
+#define WRAP_N(name)	static unsigned long long name##_W(unsigned long long f, unsigned int n) { return name(f, n); }
+
+WRAP_N(fb64_Shift_Left)		WRAP_N(fb64_Shift_Right)	WRAP_N(fb64_Shift_Up)		WRAP_N(fb64_Shift_Down)
+WRAP_N(fb64_Scroll_Left)	WRAP_N(fb64_Scroll_Right)	WRAP_N(fb64_Scroll_Up)		WRAP_N(fb64_Scroll_Down)
+WRAP(fb64_Mirror_X)			WRAP(fb64_Mirror_Y)			WRAP(fb64_Transpose)
+WRAP(fb64_Rotate_CW)		WRAP(fb64_Rotate_CCW)		WRAP(fb64_Rotate_180)
+
+static const struct
+{
+	const char *name;
+	fb_fn_n swar, ref;
+} shifts[] =
+{
+	{ "Shift_Left",   fb64_Shift_Left_W,   fb64_Shift_Left_Ref   },
+	{ "Shift_Right",  fb64_Shift_Right_W,  fb64_Shift_Right_Ref  },
+	{ "Shift_Up",     fb64_Shift_Up_W,     fb64_Shift_Up_Ref     },
+	{ "Shift_Down",   fb64_Shift_Down_W,   fb64_Shift_Down_Ref   },
+	{ "Scroll_Left",  fb64_Scroll_Left_W,  fb64_Scroll_Left_Ref  },
+	{ "Scroll_Right", fb64_Scroll_Right_W, fb64_Scroll_Right_Ref },
+	{ "Scroll_Up",    fb64_Scroll_Up_W,    fb64_Scroll_Up_Ref    },
+	{ "Scroll_Down",  fb64_Scroll_Down_W,  fb64_Scroll_Down_Ref  },
+};
+
+static const struct
+{
+	const char *name;
+	fb_fn swar, ref;
+} moves[] =
+{
+	{ "Mirror_X",   fb64_Mirror_X_W,   fb64_Mirror_X_Ref   },
+	{ "Mirror_Y",   fb64_Mirror_Y_W,   fb64_Mirror_Y_Ref   },
+	{ "Transpose",  fb64_Transpose_W,  fb64_Transpose_Ref  },
+	{ "Rotate_CW",  fb64_Rotate_CW_W,  fb64_Rotate_CW_Ref  },
+	{ "Rotate_CCW", fb64_Rotate_CCW_W, fb64_Rotate_CCW_Ref },
+	{ "Rotate_180", fb64_Rotate_180_W, fb64_Rotate_180_Ref },
+};
+
+#define N_SHIFTS	(sizeof(shifts) / sizeof(shifts[0]))
+#define N_MOVES		(sizeof(moves) / sizeof(moves[0]))
+
+static unsigned int failures;
+static unsigned long long frames;
+
+static unsigned long long random64(void)
+{
+	return ((unsigned long long)rand() << 42) ^ ((unsigned long long)rand() << 21) ^ (unsigned long long)rand();
+}
+
+static void check_Frame(unsigned long long f)
+{
+	frames++;
+	for(unsigned int i = 0; i < N_SHIFTS; i++)
+	{
+		for(unsigned int n = 0; n < 16; n++)
+		{
+			if(shifts[i].swar(f, n) != shifts[i].ref(f, n) && failures++ < 10)
+				printf("FAIL %s(0x%016llX, %u)\n", shifts[i].name, f, n);
+		}
+	}
+	for(unsigned int i = 0; i < N_MOVES; i++)
+	{
+		if(moves[i].swar(f) != moves[i].ref(f) && failures++ < 10)
+			printf("FAIL %s(0x%016llX)\n", moves[i].name, f);
+	}
+}
+
+static unsigned long long column_Ref(unsigned char c, unsigned int x)
+{
+	unsigned long long f = 0;
+
+	for(int y = 0; y < 8; y++)
+	{
+		if(c & (1 << y))
+			f |= 1ULL << (y * 8 + (x & 7));
+	}
+	return f;
+}
+
+static double now_ns(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static void bench(void)
+{
+	volatile unsigned long long sink;
+	unsigned long long f;
+	double t0, t_swar, t_ref;
+
+	printf("%-13s %9s %9s\n", "ns/call", "SWAR", "per-pixel");
+	for(unsigned int i = 0; i < N_SHIFTS; i++)
+	{
+		f = 0x0123456789ABCDEFULL;
+		t0 = now_ns();
+		for(unsigned int k = 0; k < BENCH_CALLS; k++)
+			f = shifts[i].swar(f, k) ^ k;
+		t_swar = now_ns() - t0;
+		sink = f;
+		f = 0x0123456789ABCDEFULL;
+		t0 = now_ns();
+		for(unsigned int k = 0; k < BENCH_CALLS / 20; k++)
+			f = shifts[i].ref(f, k) ^ k;
+		t_ref = now_ns() - t0;
+		sink = f;
+		printf("%-13s %9.2f %9.2f\n", shifts[i].name, t_swar / BENCH_CALLS, t_ref / (BENCH_CALLS / 20));
+	}
+	for(unsigned int i = 0; i < N_MOVES; i++)
+	{
+		f = 0x0123456789ABCDEFULL;
+		t0 = now_ns();
+		for(unsigned int k = 0; k < BENCH_CALLS; k++)
+			f = moves[i].swar(f) ^ k;
+		t_swar = now_ns() - t0;
+		sink = f;
+		f = 0x0123456789ABCDEFULL;
+		t0 = now_ns();
+		for(unsigned int k = 0; k < BENCH_CALLS / 20; k++)
+			f = moves[i].ref(f) ^ k;
+		t_ref = now_ns() - t0;
+		sink = f;
+		printf("%-13s %9.2f %9.2f\n", moves[i].name, t_swar / BENCH_CALLS, t_ref / (BENCH_CALLS / 20));
+	}
+	(void)sink;
+}
+
+int main(void)
+{
+	srand(1);
+
+	check_Frame(0);
+	check_Frame(~0ULL);
+	for(int bit = 0; bit < 64; bit++)
+	{
+		check_Frame(1ULL << bit);
+	}
+	for(unsigned int line = 0; line < 8; line++)
+	{
+		for(unsigned int v = 0; v < 256; v++)
+		{
+			check_Frame((unsigned long long)v << (line * 8));
+			check_Frame(column_Ref((unsigned char)v, line));
+		}
+	}
+	for(int i = 0; i < RANDOM_FRAMES; i++)
+	{
+		check_Frame(random64());
+	}
+
+	for(int i = 0; i < RANDOM_FRAMES; i++)
+	{
+		unsigned long long a = random64(), b = random64(), m = random64();
+		if(fb64_Blend(a, b, m) != fb64_Blend_Ref(a, b, m) && failures++ < 10)
+			printf("FAIL Blend(0x%016llX, 0x%016llX, 0x%016llX)\n", a, b, m);
+	}
+	for(unsigned int x = 0; x < 16; x++)
+	{
+		for(unsigned int c = 0; c < 256; c++)
+		{
+			if(fb64_Column((unsigned char)c, x) != column_Ref((unsigned char)c, x) && failures++ < 10)
+				printf("FAIL Column(0x%02X, %u)\n", c, x);
+		}
+	}
+	printf("fb64: %llu frames, %u failures\n", frames, failures);
+
+	bench();
+	return failures != 0;
+}
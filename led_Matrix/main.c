@@ -0,0 +1,181 @@
+/**
+ ******************************************************************************
+ * @file    led_Matrix.c
+ * @author  Monish Kumar.k
+ * @date    06/03/2025
+ * @brief   8x8_Led_Display patterns on the framebuffer API with the
+ *          direct-drive scanned backend.
+ *
+ * @details
+ * Same wiring as 8x8_Led_Display:
+ *  - GPIOA pins 0 to 7        : rows, driven high one at a time by TIM4
+ *  - GPIOB pins 0,1,2,5,6,7,8,9 : columns, high = LED on in the active row
+ *
+ * The original program lit whole columns with all rows on, which only works
+ * for patterns made of full columns. Scanning one row at a time shows any
+ * framebuffer content; the refresh runs entirely in the TIM4 interrupt so
+ * the patterns just draw and call matrix_Show().
+ *
+ * Before the patterns start, bench_Run() checks every fb64.h transform
+ * against its per-pixel reference on all 64 single-pixel frames plus
+ * random frames (all shift counts 0..7), and measures cycles per call of
+ * both. Results are logged with LOG() on USART1 (PA9, PA2/PA3 are rows)
+ * and kept in bench[].
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 06/03/2025
+  File : led_Matrix
+ ******************************************************************************/
+#include <arm.h>
+#include <uart.h>
+#include <log.h>
+#include "matrix.h"
+#include "patterns.h"
+#include "fb64.h"
+
+#define LOG_PORT		UART_1
+#define BENCH_FRAMES	256			//64 single pixels + random frames
+
+enum { T_SHIFT_L, T_SHIFT_R, T_SHIFT_U, T_SHIFT_D, T_SCROLL_L, T_SCROLL_R, T_SCROLL_U, T_SCROLL_D,
+	   T_MIRROR_X, T_MIRROR_Y, T_TRANSPOSE, T_ROT_CW, T_ROT_CCW, T_ROT_180, T_BLEND, T_COUNT };
+
+struct bench_result
+{
+	unsigned int swar_cycles;		//per call, x100
+	unsigned int ref_cycles;		//per call, x100
+	unsigned int mismatches;
+};
+
+volatile struct bench_result bench[T_COUNT];
+
+static struct matrix led;
+static unsigned long long frames[BENCH_FRAMES];
+
+void rcc_Config(void);
+void bench_Run(void);
+
+int main(void)
+{
+	rcc_Config();
+	uart_Init(LOG_PORT, 921600);
+	log_Init();
+
+	bench_Run();
+	for(int t=0; t<T_COUNT; t++)
+	{
+		LOG("transform %u: swar %u/100, per-pixel %u/100 cycles, %u mismatches",
+			t, bench[t].swar_cycles, bench[t].ref_cycles, bench[t].mismatches);
+	}
+
+	matrix_Init(&led, &matrix_direct, 1);
+	while(1)
+	{
+		patterns(&led);
+		log_Drain(LOG_PORT);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (1<<0);	/* HSE as system clock */
+	while(((RCC->CFGR >> 2) & 0x3) != 1);
+}
+
+/*
+ * Each transform runs over all frames (and shift counts); the results are
+ * XOR-folded so the compiler cannot drop the calls, then compared frame by
+ * frame against the reference.
+ */
+#define BENCH_N(slot, fast, ref)											\
+	do																		\
+	{																		\
+		unsigned long long acc = 0;											\
+		unsigned int t = DWT->CYCCNT;										\
+		for(int i=0; i<BENCH_FRAMES; i++)									\
+			for(unsigned int n=0; n<8; n++)									\
+				acc ^= fast(frames[i], n);									\
+		bench[slot].swar_cycles = (DWT->CYCCNT - t) * 100 / (BENCH_FRAMES * 8);	\
+		t = DWT->CYCCNT;													\
+		for(int i=0; i<BENCH_FRAMES; i++)									\
+			for(unsigned int n=0; n<8; n++)									\
+				acc ^= ref(frames[i], n);									\
+		bench[slot].ref_cycles = (DWT->CYCCNT - t) * 100 / (BENCH_FRAMES * 8);	\
+		for(int i=0; i<BENCH_FRAMES; i++)									\
+			for(unsigned int n=0; n<8; n++)									\
+				bench[slot].mismatches += (fast(frames[i], n) != ref(frames[i], n));	\
+		sink ^= acc;														\
+	} while(0)
+
+#define BENCH_1(slot, fast, ref)											\
+	do																		\
+	{																		\
+		unsigned long long acc = 0;											\
+		unsigned int t = DWT->CYCCNT;										\
+		for(int i=0; i<BENCH_FRAMES; i++)									\
+			acc ^= fast(frames[i]);											\
+		bench[slot].swar_cycles = (DWT->CYCCNT - t) * 100 / BENCH_FRAMES;	\
+		t = DWT->CYCCNT;													\
+		for(int i=0; i<BENCH_FRAMES; i++)									\
+			acc ^= ref(frames[i]);											\
+		bench[slot].ref_cycles = (DWT->CYCCNT - t) * 100 / BENCH_FRAMES;	\
+		for(int i=0; i<BENCH_FRAMES; i++)									\
+			bench[slot].mismatches += (fast(frames[i]) != ref(frames[i]));	\
+		sink ^= acc;														\
+	} while(0)
+
+volatile unsigned long long sink;
+
+void bench_Run()
+{
+	unsigned long long seed = 88172645463325252ULL;
+
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);		/* CYCCNTENA */
+
+	for(int i=0; i<BENCH_FRAMES; i++)
+	{
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		frames[i] = (i < 64) ? (1ULL << i) : seed;
+	}
+
+	BENCH_N(T_SHIFT_L,  fb64_Shift_Left,   fb64_Shift_Left_Ref);
+	BENCH_N(T_SHIFT_R,  fb64_Shift_Right,  fb64_Shift_Right_Ref);
+	BENCH_N(T_SHIFT_U,  fb64_Shift_Up,     fb64_Shift_Up_Ref);
+	BENCH_N(T_SHIFT_D,  fb64_Shift_Down,   fb64_Shift_Down_Ref);
+	BENCH_N(T_SCROLL_L, fb64_Scroll_Left,  fb64_Scroll_Left_Ref);
+	BENCH_N(T_SCROLL_R, fb64_Scroll_Right, fb64_Scroll_Right_Ref);
+	BENCH_N(T_SCROLL_U, fb64_Scroll_Up,    fb64_Scroll_Up_Ref);
+	BENCH_N(T_SCROLL_D, fb64_Scroll_Down,  fb64_Scroll_Down_Ref);
+	BENCH_1(T_MIRROR_X,  fb64_Mirror_X,    fb64_Mirror_X_Ref);
+	BENCH_1(T_MIRROR_Y,  fb64_Mirror_Y,    fb64_Mirror_Y_Ref);
+	BENCH_1(T_TRANSPOSE, fb64_Transpose,   fb64_Transpose_Ref);
+	BENCH_1(T_ROT_CW,    fb64_Rotate_CW,   fb64_Rotate_CW_Ref);
+	BENCH_1(T_ROT_CCW,   fb64_Rotate_CCW,  fb64_Rotate_CCW_Ref);
+	BENCH_1(T_ROT_180,   fb64_Rotate_180,  fb64_Rotate_180_Ref);
+
+	/* blend: frame i over frame i+1 through the mask of frame i+2 */
+	{
+		unsigned long long acc = 0;
+		unsigned int t = DWT->CYCCNT;
+		for(int i=0; i<BENCH_FRAMES-2; i++)
+			acc ^= fb64_Blend(frames[i], frames[i+1], frames[i+2]);
+		bench[T_BLEND].swar_cycles = (DWT->CYCCNT - t) * 100 / (BENCH_FRAMES - 2);
+		t = DWT->CYCCNT;
+		for(int i=0; i<BENCH_FRAMES-2; i++)
+			acc ^= fb64_Blend_Ref(frames[i], frames[i+1], frames[i+2]);
+		bench[T_BLEND].ref_cycles = (DWT->CYCCNT - t) * 100 / (BENCH_FRAMES - 2);
+		for(int i=0; i<BENCH_FRAMES-2; i++)
+			bench[T_BLEND].mismatches += (fb64_Blend(frames[i], frames[i+1], frames[i+2]) !=
+										  fb64_Blend_Ref(frames[i], frames[i+1], frames[i+2]));
+		sink ^= acc;
+	}
+}
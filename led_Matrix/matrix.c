@@ -0,0 +1,202 @@
+/**
+ ******************************************************************************
+ * @file    matrix.c
+ * @author  Monish Kumar.k
+ * @date    06/03/2025
+ * @brief   Framebuffer API for 8x8 LED matrices, TIM4 scanned refresh and the
+ *          direct-drive GPIO backend.
+ *
+ * @details
+ *  - Drawing only touches m->fb; nothing reaches the LEDs before
+ *    matrix_Show() calls the backend.
+ *  - The scanned refresh keeps two copies of the 8 row bytes. The ISR reads
+ *    scan_rows[scan_cur]; matrix_Scan_Load() fills the other copy and asks
+ *    for a swap, which the ISR performs when it gets back to row 0.
+ *  - Direct drive: one BSRR write blanks the rows, one BSRR write sets and
+ *    clears all eight column pins together, one BSRR write enables the row.
+ ******************************************************************************
+ */
+#include <arm.h>
+#include <rcc.h>
+#include "matrix.h"
+
+#define TIM4_IRQ		30
+
+#define ROW_PINS		0x00FF		//PA0..PA7
+#define COL_PINS		0x03E7		//PB0, PB1, PB2, PB5..PB9
+
+static unsigned char scan_rows[2][8];
+static volatile unsigned int scan_cur;
+static volatile unsigned int scan_swap;
+static volatile unsigned int scan_frames;
+static unsigned int scan_row;
+static matrix_row_out scan_out;
+static void (*scan_hook)(void);
+
+void matrix_Init(struct matrix *m, const struct matrix_backend *backend, unsigned int panels)
+{
+	m->backend = backend;
+	m->panels = (panels > MATRIX_MAX_PANELS) ? MATRIX_MAX_PANELS : panels;
+	matrix_Clear(m);
+	backend->init(m);
+}
+
+void matrix_Clear(struct matrix *m)
+{
+	for(unsigned int p = 0; p < MATRIX_MAX_PANELS; p++)
+	{
+		m->fb[p] = 0;
+	}
+}
+
+void matrix_Set_Pixel(struct matrix *m, unsigned int x, unsigned int y, int on)
+{
+	unsigned long long bit;
+
+	if(x >= m->panels * 8 || y >= 8)
+		return;
+	bit = 1ULL << (y*8 + (x & 7));
+	if(on)
+		m->fb[x >> 3] |= bit;
+	else
+		m->fb[x >> 3] &= ~bit;
+}
+
+int matrix_Get_Pixel(const struct matrix *m, unsigned int x, unsigned int y)
+{
+	if(x >= m->panels * 8 || y >= 8)
+		return 0;
+	return (m->fb[x >> 3] >> (y*8 + (x & 7))) & 1;
+}
+
+void matrix_Set_Row(struct matrix *m, unsigned int panel, unsigned int row, unsigned char bits)
+{
+	unsigned int shift = row * 8;
+
+	m->fb[panel] = (m->fb[panel] & ~(0xFFULL << shift)) | ((unsigned long long)bits << shift);
+}
+
+void matrix_Show(struct matrix *m)
+{
+	m->backend->show(m);
+}
+
+void matrix_Delay_Ms(unsigned int ms)
+{
+	unsigned int start, cycles = rcc_Get_Sysclk() / 1000 * ms;
+
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);
+	start = DWT->CYCCNT;
+	while(DWT->CYCCNT - start < cycles);
+}
+
+void matrix_Scan_Init(matrix_row_out out)
+{
+	unsigned int ticks = rcc_Get_Tim_Clock(1) / (8 * MATRIX_REFRESH_HZ);
+	unsigned int psc = (ticks - 1) >> 16;
+
+	scan_out = out;
+	scan_row = 0;
+	scan_cur = 0;
+	scan_swap = 0;
+	for(unsigned int r = 0; r < 8; r++)
+	{
+		scan_rows[0][r] = 0;
+		scan_rows[1][r] = 0;
+	}
+
+	RCC->APB1ENR |= (1<<2);			//TIM4
+	TIM4->CR1 = 0;
+	TIM4->PSC = psc;
+	TIM4->ARR = ticks / (psc + 1) - 1;
+	TIM4->EGR = (1<<0);
+	TIM4->SR  = 0;
+	TIM4->DIER = (1<<0);			//UIE
+
+	NVIC->IP[TIM4_IRQ] = (3<<4);	//above UART/ADC, a late row is visible
+	NVIC->ISER[TIM4_IRQ >> 5] = (1 << (TIM4_IRQ & 31));
+	TIM4->CR1 = (1<<0);
+}
+
+void matrix_Scan_Load(const struct matrix *m)
+{
+	unsigned char *rows;
+	unsigned long long fb = m->fb[0];
+
+	while(scan_swap);				//previous frame not taken yet
+	rows = scan_rows[scan_cur ^ 1];
+	for(unsigned int r = 0; r < 8; r++)
+	{
+		rows[r] = (unsigned char)(fb >> (r*8));
+	}
+	scan_swap = 1;
+}
+
+void matrix_Scan_Hook(void (*frame)(void))
+{
+	scan_hook = frame;
+}
+
+void matrix_Scan_Stop()
+{
+	TIM4->CR1 = 0;
+	NVIC->ICER[TIM4_IRQ >> 5] = (1 << (TIM4_IRQ & 31));
+}
+
+unsigned int matrix_Scan_Frames()
+{
+	return scan_frames;
+}
+
+void TIM4_IRQHandler()
+{
+	unsigned int row = scan_row;
+
+	TIM4->SR = ~(1<<0);
+	if(row == 0)
+	{
+		scan_frames++;
+		if(scan_swap)
+		{
+			scan_cur ^= 1;
+			scan_swap = 0;
+		}
+	}
+	scan_out(row, scan_rows[scan_cur][row]);
+	if(row == 0 && scan_hook)
+		scan_hook();
+	scan_row = (row + 1) & 7;
+}
+
+void matrix_Direct_Row(unsigned int row, unsigned char bits)
+{
+	unsigned int pins = (bits & 0x07) | ((unsigned int)(bits & 0xF8) << 2);
+
+	GPIOA->BSRR = ROW_PINS << 16;
+	GPIOB->BSRR = pins | ((COL_PINS & ~pins) << 16);
+	GPIOA->BSRR = 1 << row;
+}
+
+void matrix_Direct_Gpio()
+{
+	RCC->AHB1ENR |= (1<<0) | (1<<1);
+	GPIOA->BSRR  = ROW_PINS << 16;
+	GPIOB->BSRR  = COL_PINS << 16;
+	GPIOA->MODER = (GPIOA->MODER & ~0x0000FFFF) | 0x00005555;	//PA0..PA7 output
+	GPIOB->MODER = (GPIOB->MODER & ~0x000FFC3F) | 0x00055415;	//PB0..2, PB5..9 output
+}
+
+static void direct_Init(struct matrix *m)
+{
+	(void)m;
+	matrix_Direct_Gpio();
+	matrix_Scan_Init(matrix_Direct_Row);
+}
+
+static void direct_Show(struct matrix *m)
+{
+	matrix_Scan_Load(m);
+}
+
+const struct matrix_backend matrix_direct = { direct_Init, direct_Show };
@@ -0,0 +1,73 @@
+/*
+ * matrix.h
+ *
+ *  Created on: Mar 06, 2025
+ *      Author: moni
+ *
+ *  Framebuffer API for 8x8 LED matrices, independent of how the panels are
+ *  driven. Patterns draw into m->fb and call matrix_Show(); the backend
+ *  (direct-drive scanning, MAX7219 chain, ...) takes care of the hardware.
+ *
+ *  Layout: one unsigned long long per 8x8 panel, row r in byte r, column c
+ *  in bit c of that byte. Panel p covers x = 8p .. 8p+7, so a chain of
+ *  panels is one wide display.
+ */
+
+#ifndef MATRIX_H_
+#define MATRIX_H_
+
+#define MATRIX_MAX_PANELS	16
+
+struct matrix;
+
+struct matrix_backend
+{
+	void (*init)(struct matrix *m);
+	void (*show)(struct matrix *m);		//push m->fb to the panels
+};
+
+struct matrix
+{
+	const struct matrix_backend *backend;
+	unsigned int panels;
+	unsigned long long fb[MATRIX_MAX_PANELS];
+};
+
+void matrix_Init(struct matrix *m, const struct matrix_backend *backend, unsigned int panels);
+void matrix_Clear(struct matrix *m);
+void matrix_Set_Pixel(struct matrix *m, unsigned int x, unsigned int y, int on);
+int  matrix_Get_Pixel(const struct matrix *m, unsigned int x, unsigned int y);
+void matrix_Set_Row(struct matrix *m, unsigned int panel, unsigned int row, unsigned char bits);
+void matrix_Show(struct matrix *m);
+
+void matrix_Delay_Ms(unsigned int ms);
+
+/*
+ * Scanned refresh: TIM4 interrupts at 8 x MATRIX_REFRESH_HZ and hands one
+ * row (index + column bits of panel 0) to the row output function, which
+ * must blank the previous row, load the columns and enable the new row.
+ * New frames are taken over at row 0 only, so a frame never tears. The
+ * frame hook runs right after that, so it may draw and call matrix_Show()
+ * for the next frame without waiting.
+ */
+#define MATRIX_REFRESH_HZ	125
+
+typedef void (*matrix_row_out)(unsigned int row, unsigned char bits);
+
+void matrix_Scan_Init(matrix_row_out out);
+void matrix_Scan_Load(const struct matrix *m);
+void matrix_Scan_Stop(void);
+void matrix_Scan_Hook(void (*frame)(void));		//called from the ISR once per frame
+unsigned int matrix_Scan_Frames(void);
+
+/*
+ * Direct-drive backend for the wiring of 8x8_Led_Display: rows on PA0..PA7
+ * (active high), columns on PB0, PB1, PB2, PB5..PB9; one panel only.
+ */
+extern const struct matrix_backend matrix_direct;
+
+/* the direct-drive pieces, for backends that share its wiring */
+void matrix_Direct_Gpio(void);
+void matrix_Direct_Row(unsigned int row, unsigned char bits);
+
+#endif /* MATRIX_H_ */
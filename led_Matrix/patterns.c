@@ -0,0 +1,74 @@
+/**
+ ******************************************************************************
+ * @file    patterns.c
+ * @author  Monish Kumar.k
+ * @date    06/03/2025
+ * @brief   pattern_0 / pattern_1 of 8x8_Led_Display on the framebuffer API.
+ ******************************************************************************
+ */
+#include "patterns.h"
+#include "fb64.h"
+
+#define COLUMN_MS		100
+#define HOLD_MS			500
+
+static void column(struct matrix *m, unsigned int x, int on)
+{
+	for(unsigned int y = 0; y < 8; y++)
+	{
+		matrix_Set_Pixel(m, x, y, on);
+	}
+}
+
+void pattern_0(struct matrix *m)
+{
+	matrix_Clear(m);
+	for(unsigned int x = 0; x < m->panels * 8; x++)
+	{
+		column(m, x, 1);
+		matrix_Show(m);
+		matrix_Delay_Ms(COLUMN_MS);
+	}
+	matrix_Delay_Ms(HOLD_MS - COLUMN_MS);
+}
+
+void pattern_1(struct matrix *m)
+{
+	matrix_Clear(m);
+	for(unsigned int x = 0; x < m->panels * 8; x++)
+	{
+		if(x > 0)
+			column(m, x - 1, 0);
+		column(m, x, 1);
+		matrix_Show(m);
+		matrix_Delay_Ms(COLUMN_MS);
+	}
+	matrix_Clear(m);
+	matrix_Show(m);
+	matrix_Delay_Ms(COLUMN_MS);
+}
+
+void pattern_2(struct matrix *m)
+{
+	unsigned long long arrow = 0x10307FFFFF7F3010ULL;		//pointing right
+
+	for(unsigned int turn = 0; turn < 8; turn++)
+	{
+		for(unsigned int p = 0; p < m->panels; p++)
+		{
+			m->fb[p] = (p & 1) ? fb64_Invert(arrow) : arrow;
+		}
+		matrix_Show(m);
+		matrix_Delay_Ms(HOLD_MS / 2);
+		arrow = fb64_Rotate_CW(arrow);
+	}
+}
+
+void patterns(struct matrix *m)
+{
+	pattern_0(m);
+	matrix_Clear(m);
+	matrix_Show(m);
+	pattern_1(m);
+	pattern_2(m);
+}
@@ -0,0 +1,21 @@
+/*
+ * patterns.h
+ *
+ *  Created on: Mar 06, 2025
+ *      Author: moni
+ *
+ *  The patterns of 8x8_Led_Display, drawn through the framebuffer API so
+ *  they run on any backend and across any number of panels.
+ */
+
+#ifndef PATTERNS_H_
+#define PATTERNS_H_
+
+#include "matrix.h"
+
+void pattern_0(struct matrix *m);		//fill the columns one by one
+void pattern_1(struct matrix *m);		//walk one lit column across
+void pattern_2(struct matrix *m);		//arrow turning in quarter steps, every panel
+void patterns(struct matrix *m);
+
+#endif /* PATTERNS_H_ */
@@ -0,0 +1,331 @@
+/**
+ ******************************************************************************
+ * @file    la.c
+ * @author  Monish Kumar.k
+ * @date    18/04/2025
+ * @brief   Timer-triggered DMA sampling of GPIO IDR with pre-trigger ring,
+ *          EXTI pattern trigger, hardware stop and run-length dump.
+ *
+ * @details
+ *  - TIM1: update every 1/rate (UDE -> DMA2 S5 CH6), TRGO = update,
+ *    gated mode on ITR1 = TIM2 TRGO.
+ *  - TIM2: external clock mode 1 on ITR0 = TIM1 TRGO, so it counts
+ *    samples. TRGO = OC1REF. While armed OC1REF is forced active and TIM2
+ *    is stopped. At the trigger it starts from 0 in "inactive on match"
+ *    mode with CCR1 = samples after the trigger.
+ *  - DMA2 S5: IDR halfwords, FIFO packs two into a word write, circular
+ *    over the ring. Disabling the stream at the end flushes the FIFO, and
+ *    NDTR is then the write position.
+ *  - lost: samples TIM2 counted after the trigger that the DMA did not
+ *    write; not 0 means the rate is too high for the bus load.
+ ******************************************************************************
+ */
+#include <arm.h>
+#include <rcc.h>
+#include <uart.h>
+#include "la.h"
+
+#define LA_DMA			(&DMA2->S[5])
+#define LA_DMA_SHIFT	6				//stream 5 flags in HISR/HIFCR
+#define LA_VERSION		1
+
+static unsigned short la_ring[LA_SAMPLES] __attribute__((aligned(4)));
+static struct la_cfg la;
+static unsigned int la_port;			//0 = A
+static unsigned int la_arr;
+static volatile unsigned int la_state;
+static volatile unsigned int la_trig_pos;	//write index when the trigger was seen
+static unsigned int la_end;				//write index after the stop = oldest sample
+static unsigned int la_trigger;			//trigger, samples from the oldest
+static unsigned int la_lost;
+
+static const unsigned char exti_irq[16] = { 6, 7, 8, 9, 10, 23, 23, 23, 23, 23, 40, 40, 40, 40, 40, 40 };
+
+int la_Init(const struct la_cfg *cfg)
+{
+	unsigned int tim_clock = rcc_Get_Tim_Clock(2);
+	unsigned int port = ((unsigned long)cfg->port - 0x40020000) / 0x400;
+
+	if(port > 2 || !cfg->rate || cfg->rate > LA_MAX_RATE || cfg->pre >= LA_SAMPLES || cfg->trig_mask > 0xFFFF)
+		return -1;
+	la = *cfg;
+	la_port = port;
+	la_arr = tim_clock / cfg->rate - 1;
+	la_state = LA_IDLE;
+
+	RCC->AHB1ENR |= (1<<22);					/* DMA2 */
+	RCC->APB1ENR |= (1<<0);						/* TIM2 */
+	RCC->APB2ENR |= (1<<14) | (1<<0);			/* SYSCFG, TIM1 */
+
+	TIM1->CR1 = 0;
+	TIM1->PSC = 0;
+	TIM1->ARR = la_arr;
+	TIM1->RCR = 0;
+	TIM1->CR2 = (2<<4);							/* MMS = update */
+	TIM1->SMCR = (1<<4) | (5<<0);				/* TS = ITR1 (TIM2), SMS = gated */
+
+	TIM2->CR1 = 0;
+	TIM2->PSC = 0;
+	TIM2->ARR = 0xFFFFFFFF;
+	TIM2->CR2 = (4<<4);							/* MMS = OC1REF */
+	TIM2->SMCR = (0<<4) | (7<<0);				/* TS = ITR0 (TIM1), SMS = external clock 1 */
+	TIM2->CCMR1 = (5<<4);						/* OC1REF forced active: TIM1 may run */
+	TIM2->EGR = (1<<0);
+	TIM2->SR = 0;
+
+	for(unsigned int pin = 0; pin < 16; pin++)
+	{
+		if(!(cfg->trig_mask & (1u << pin)))
+			continue;
+		SYSCFG->EXTICR[pin >> 2] = (SYSCFG->EXTICR[pin >> 2] & ~(0xF << ((pin & 3)*4))) | (port << ((pin & 3)*4));
+		NVIC->IP[exti_irq[pin]] = (2<<4);
+		NVIC->ISER[exti_irq[pin] >> 5] = (1 << (exti_irq[pin] & 31));
+	}
+	EXTI->IMR &= ~cfg->trig_mask;
+	EXTI->RTSR |= cfg->trig_mask;
+	EXTI->FTSR |= cfg->trig_mask;
+
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);
+	return 0;
+}
+
+unsigned int la_Rate()
+{
+	return rcc_Get_Tim_Clock(2) / (la_arr + 1);
+}
+
+int la_State()
+{
+	volatile struct dma_stream *s = LA_DMA;
+	unsigned int written;
+
+	if(la_state == LA_TRIGGERED && (TIM2->SR & (1<<1)))
+	{
+		/* TIM1 is stopped by now; flush the FIFO and take the write position */
+		TIM1->DIER = 0;
+		TIM1->CR1 = 0;
+		TIM2->CR1 = 0;
+		s->CR &= ~(1<<0);
+		while(s->CR & (1<<0));
+		la_end = (LA_SAMPLES - s->NDTR) % LA_SAMPLES;
+		written = (la_end - la_trig_pos + LA_SAMPLES) % LA_SAMPLES;
+		if(written == 0 && TIM2->CNT >= LA_SAMPLES)
+			written = LA_SAMPLES;				//pre = 0: a full lap, not an empty one
+		la_lost = (TIM2->CNT > written) ? TIM2->CNT - written : 0;
+		la_state = LA_DONE;
+	}
+	return la_state;
+}
+
+void la_Arm()
+{
+	volatile struct dma_stream *s = LA_DMA;
+	unsigned int start, wait;
+
+	EXTI->IMR &= ~la.trig_mask;
+	TIM1->CR1 = 0;
+	TIM1->DIER = 0;
+	TIM2->CR1 = 0;
+	TIM2->CCMR1 = (5<<4);
+	TIM2->SR = 0;
+
+	s->CR = 0;
+	while(s->CR & (1<<0));
+	DMA2->HIFCR = 0x3D << LA_DMA_SHIFT;
+	s->PAR  = (unsigned long)&la.port->IDR;
+	s->M0AR = (unsigned long)la_ring;
+	s->NDTR = LA_SAMPLES;
+	s->FCR  = (1<<2) | (3<<0);					/* FIFO on, full threshold */
+	s->CR   = (6<<25) | (3<<16) | (2<<13) | (1<<11) | (1<<10) | (1<<8);
+			//CH6, PL very high, MSIZE 32 / PSIZE 16 bit, MINC, CIRC, P->M
+	s->CR  |= (1<<0);
+
+	la_state = LA_ARMED;
+	TIM1->CNT = 0;
+	TIM1->DIER = (1<<8);						/* UDE */
+	TIM1->CR1 = (1<<0);
+
+	/* the pre-trigger part first, a trigger before that would leave old samples in the ring */
+	wait = (unsigned int)((unsigned long long)la.pre * rcc_Get_Sysclk() / la_Rate());
+	start = DWT->CYCCNT;
+	while(DWT->CYCCNT - start < wait);
+
+	EXTI->PR = la.trig_mask;
+	EXTI->IMR |= la.trig_mask;
+}
+
+/* from the EXTI handler or la_Force(); interrupts of the same priority do not nest */
+static void la_Trigger(void)
+{
+	la_trig_pos = (LA_SAMPLES - LA_DMA->NDTR) % LA_SAMPLES;
+	EXTI->IMR &= ~la.trig_mask;
+	TIM2->CNT = 0;
+	TIM2->CCR1 = LA_SAMPLES - la.pre;
+	TIM2->SR = 0;
+	TIM2->CCMR1 = (2<<4);						/* OC1REF low on match */
+	TIM2->CR1 = (1<<0);
+	la_state = LA_TRIGGERED;
+}
+
+void la_Force()
+{
+	EXTI->IMR &= ~la.trig_mask;					//no EXTI trigger in between
+	if(la_state == LA_ARMED)
+		la_Trigger();
+}
+
+static void la_Exti(void)
+{
+	unsigned int pr = EXTI->PR & la.trig_mask;
+
+	EXTI->PR = pr;
+	if(pr && la_state == LA_ARMED && (la.port->IDR & la.trig_mask) == la.trig_value)
+		la_Trigger();
+}
+
+void EXTI0_IRQHandler()			{ la_Exti(); }
+void EXTI1_IRQHandler()			{ la_Exti(); }
+void EXTI2_IRQHandler()			{ la_Exti(); }
+void EXTI3_IRQHandler()			{ la_Exti(); }
+void EXTI4_IRQHandler()			{ la_Exti(); }
+void EXTI9_5_IRQHandler()		{ la_Exti(); }
+void EXTI15_10_IRQHandler()		{ la_Exti(); }
+
+static inline int la_Match(unsigned int i)
+{
+	return (la_ring[i % LA_SAMPLES] & la.trig_mask) == la.trig_value;
+}
+
+/* the sample where the pattern became true, at most LA_REFINE before the interrupt saw it */
+static unsigned int la_Refine(void)
+{
+	unsigned int k = la_trig_pos + LA_SAMPLES - 1;
+	unsigned int limit = (la.pre < LA_REFINE) ? la.pre : LA_REFINE;
+
+	if(!la.trig_mask || !la_Match(k))
+		return la_trig_pos;						//forced, or a glitch shorter than a sample
+	for(unsigned int n = 0; n < limit && la_Match(k - 1); n++)
+	{
+		k--;
+	}
+	return k % LA_SAMPLES;
+}
+
+struct la_out
+{
+	int uart;
+	unsigned int len, sum;
+	unsigned int fill;
+	unsigned char buf[64];
+};
+
+static void la_Send(int uart, const unsigned char *p, unsigned int n)
+{
+	while(n)
+	{
+		unsigned int k = uart_Write(uart, p, n);
+
+		p += k;
+		n -= k;
+	}
+}
+
+static void la_Put(struct la_out *o, const unsigned char *p, unsigned int n)
+{
+	for(unsigned int i = 0; i < n; i++)
+	{
+		o->sum += p[i];
+		if(o->uart < 0)
+			continue;
+		o->buf[o->fill++] = p[i];
+		if(o->fill == sizeof(o->buf))
+		{
+			la_Send(o->uart, o->buf, o->fill);
+			o->fill = 0;
+		}
+	}
+	o->len += n;
+}
+
+static void la_Record(struct la_out *o, unsigned int value, unsigned int run)
+{
+	unsigned char rec[2 + 5];
+	unsigned int n = 2;
+
+	rec[0] = (unsigned char)value;
+	rec[1] = (unsigned char)(value >> 8);
+	run--;
+	while(run >= 0x80)
+	{
+		rec[n++] = (unsigned char)(run | 0x80);
+		run >>= 7;
+	}
+	rec[n++] = (unsigned char)run;
+	la_Put(o, rec, n);
+}
+
+/* one pass over the ring from the oldest sample; uart < 0 only counts */
+static void la_Rle(struct la_out *o)
+{
+	unsigned int value = la_ring[la_end], run = 1;
+
+	for(unsigned int i = 1; i < LA_SAMPLES; i++)
+	{
+		unsigned int v = la_ring[(la_end + i) % LA_SAMPLES];
+
+		if(v == value)
+		{
+			run++;
+			continue;
+		}
+		la_Record(o, value, run);
+		value = v;
+		run = 1;
+	}
+	la_Record(o, value, run);
+	if(o->uart >= 0 && o->fill)
+		la_Send(o->uart, o->buf, o->fill);
+}
+
+static void la_Word(unsigned char *p, unsigned int v)
+{
+	p[0] = (unsigned char)v;
+	p[1] = (unsigned char)(v >> 8);
+	p[2] = (unsigned char)(v >> 16);
+	p[3] = (unsigned char)(v >> 24);
+}
+
+unsigned int la_Dump(int uart)
+{
+	struct la_out o = { -1, 0, 0, 0, { 0 } };
+	unsigned char hdr[4 + 6*4];
+	unsigned int start, cycles;
+
+	if(la_State() != LA_DONE)
+		return 0;
+
+	start = DWT->CYCCNT;
+	la_trigger = (la_Refine() - la_end + LA_SAMPLES) % LA_SAMPLES;
+	la_Rle(&o);									/* size pass: the compression cost */
+	cycles = DWT->CYCCNT - start;
+
+	hdr[0] = 'L';
+	hdr[1] = 'A';
+	hdr[2] = LA_VERSION;
+	hdr[3] = (unsigned char)('A' + la_port);
+	la_Word(&hdr[4], la_Rate());
+	la_Word(&hdr[8], LA_SAMPLES);
+	la_Word(&hdr[12], la_trigger);
+	la_Word(&hdr[16], la_lost);
+	la_Word(&hdr[20], cycles);
+	la_Word(&hdr[24], o.len);
+	la_Send(uart, hdr, sizeof(hdr));
+
+	o.uart = uart;
+	o.len = o.sum = o.fill = 0;
+	la_Rle(&o);
+	hdr[0] = (unsigned char)o.sum;
+	la_Send(uart, hdr, 1);
+	return sizeof(hdr) + o.len + 1;
+}
@@ -0,0 +1,57 @@
+/*
+ * la.h
+ *
+ *  Created on: Apr 18, 2025
+ *      Author: moni
+ *
+ *  On-device logic analyzer: TIM1 update events make DMA2 Stream5
+ *  (channel 6) copy the 16 pins of one GPIO port (IDR) into a RAM ring
+ *  at a fixed rate. The ring runs all the time while armed, so it holds
+ *  the samples before the trigger as well as after it.
+ *
+ *  Trigger: the pattern (IDR & trig_mask) == trig_value becoming true.
+ *  EXTI watches both edges of the pins in trig_mask and its handler
+ *  compares the pattern. That handler, la_Arm() and la_Dump() are the
+ *  only CPU work. The exact trigger sample is found again in the
+ *  buffer afterwards, so the interrupt latency does not move it.
+ *
+ *  Stop: TIM2 counts TIM1 updates from the trigger, and its OC1REF
+ *  (TRGO) gates TIM1. When TIM2 reaches LA_SAMPLES - pre, OC1REF goes
+ *  low and TIM1 stops, with no interrupt.
+ *
+ *  The analyzer owns TIM1, TIM2, DMA2 Stream5 and the EXTI lines of
+ *  trig_mask. An EXTI line follows one port only (SYSCFG_EXTICR), so the
+ *  trigger pins cannot also be EXTI inputs of the code being debugged.
+ *
+ *  Dump (la_Dump): 'L' 'A' version port rate32 samples32 trigger32
+ *  lost32 cycles32 len32, then len bytes of run-length records (value16,
+ *  run - 1 as LEB128), then sum8 of the records. la_Vcd.py turns it into
+ *  a VCD file. All fields are little endian.
+ */
+
+#ifndef LA_H_
+#define LA_H_
+
+#define LA_SAMPLES		16384			//16-bit samples in the ring (32 KiB), even
+#define LA_MAX_RATE		10500000		//samples/s, TIM1 clock / 8 at 84 MHz
+#define LA_REFINE		256				//samples searched back for the trigger edge
+
+enum { LA_IDLE, LA_ARMED, LA_TRIGGERED, LA_DONE };
+
+struct la_cfg
+{
+	volatile struct gpio *port;			//GPIOA, GPIOB or GPIOC
+	unsigned int rate;					//samples/s
+	unsigned int pre;					//samples kept before the trigger
+	unsigned int trig_mask;				//pins of the pattern, 0 = la_Force() only
+	unsigned int trig_value;
+};
+
+int  la_Init(const struct la_cfg *cfg);		//-1: rate, pre or port out of range
+void la_Arm(void);							//returns once the pre-trigger part is filled
+void la_Force(void);						//trigger now
+int  la_State(void);
+unsigned int la_Rate(void);					//actual rate, TIM1 clock / (ARR + 1)
+unsigned int la_Dump(int uart);				//LA_DONE only; bytes sent
+
+#endif /* LA_H_ */
@@ -0,0 +1,318 @@
+/**
+ ******************************************************************************
+ * @file    la_Test.c
+ * @author  Monish Kumar.k
+ * @date    18/04/2025
+ * @brief   Host check of the logic analyzer dump: run-length records, the
+ *          trigger search, the lost count and the la_Vcd.py round trip.
+ *
+ * @details
+ * Build and run on the host from logic_Analyzer/ (Linux x86-64, the
+ * register blocks are mapped at their STM32 addresses; python3 runs
+ * la_Vcd.py):
+ *
+ *     gcc -O2 -I../manual_PWM -I../uart_Dma -o la_Test la_Test.c && ./la_Test
+ *
+ * la.c is included unmodified; uart_Write() is a stub that takes 1..7
+ * bytes per call into a buffer. The ring, la_end and la_trig_pos are set
+ * by the test as the DMA and the trigger would leave them.
+ *  - dump: rings of one value, a change every sample, random runs of 1..
+ *    300 and long runs (two-byte LEB128), at random
+ *    la_end. The frame decodes back to the ring from the oldest sample,
+ *    and header, len, sum and the returned size agree.
+ *  - la_Refine(): a pattern (on masked pins, noise on the others) that
+ *    became true d samples before the interrupt saw it is moved back
+ *    min(d, pre, LA_REFINE) samples, across the ring start too; a glitch
+ *    gone by the interrupt and a forced trigger stay where they are.
+ *  - la_State(): lost is 0 for a full lap with pre = 0 and for a full
+ *    post-trigger part with pre > 0, and counts the samples the DMA is
+ *    short; nothing happens before TIM2 CC1IF.
+ *  - la_Vcd.py: the VCD of RANDOM_DUMPS dumps gives every pin of every
+ *    sample, and the trigger wire rises at the trigger sample.
+ * Exits non-zero on a failure.
+ ******************************************************************************
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+unsigned int rcc_Get_Tim_Clock(int bus)			{ (void)bus; return 84000000; }
+unsigned int rcc_Get_Sysclk(void)				{ return 84000000; }
+
+#include "la.c"
+
+#define LA_OUT_MAX		(LA_SAMPLES * 5 + 64)		//a record per sample, 2 + 3 bytes
+#define RANDOM_DUMPS	20
+#define RATE			1000000						//1 us per sample, 1000 VCD ticks
+
+static unsigned char out[LA_OUT_MAX];
+static unsigned int out_len, failures;
+
+static void fail(const char *what, long long a, long long b)
+{
+	if(failures++ < 20)
+		printf("FAIL %s (%lld, %lld)\n", what, a, b);
+}
+
+unsigned int uart_Write(int port, const void *data, unsigned int len)
+{
+	unsigned int n = 1 + rand() % 7;
+
+	(void)port;
+	if(n > len)
+		n = len;
+	if(out_len + n > sizeof(out))
+	{
+		fail("dump larger than the buffer", out_len + n, sizeof(out));
+		exit(1);
+	}
+	memcpy(&out[out_len], data, n);
+	out_len += n;
+	return n;
+}
+
+static void map(unsigned long addr, unsigned long len)
+{
+	if(mmap((void *)addr, len, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED)
+	{
+		perror("mmap");
+		exit(2);
+	}
+}
+
+static void init(unsigned int pre, unsigned int mask, unsigned int value)
+{
+	struct la_cfg cfg = { GPIOA, RATE, pre, mask, value };
+
+	if(la_Init(&cfg))
+		fail("la_Init", pre, mask);
+}
+
+static unsigned int word(const unsigned char *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+/* la_Dump() into out[], decoded back against the ring */
+static void dump_Check(const char *what)
+{
+	unsigned int size, len, sum = 0, i = 28, sample = 0, expect_trig;
+
+	expect_trig = (la_Refine() - la_end + LA_SAMPLES) % LA_SAMPLES;
+	out_len = 0;
+	size = la_Dump(0);
+	len = word(&out[24]);
+	if(size != out_len || size != 28 + len + 1)
+		fail(what, size, out_len);
+	if(memcmp(out, "LA\1A", 4) || word(&out[4]) != RATE || word(&out[8]) != LA_SAMPLES
+		|| word(&out[12]) != expect_trig || word(&out[16]) != la_lost)
+		fail("dump header", word(&out[12]), expect_trig);
+	while(i < 28 + len)
+	{
+		unsigned int value = out[i] | (out[i + 1] << 8), run = 0, shift = 0;
+
+		for(unsigned int k = 0; k < 2; k++)
+			sum += out[i + k];
+		i += 2;
+		do
+		{
+			sum += out[i];
+			run |= (out[i] & 0x7Fu) << shift;
+			shift += 7;
+		} while(out[i++] & 0x80);
+		run++;
+		for(unsigned int k = 0; k < run; k++, sample++)
+		{
+			if(sample >= LA_SAMPLES || la_ring[(la_end + sample) % LA_SAMPLES] != value)
+			{
+				fail(what, sample, value);
+				return;
+			}
+		}
+	}
+	if(sample != LA_SAMPLES || i != 28 + len)
+		fail("records against LA_SAMPLES", sample, i - 28);
+	if((sum & 0xFF) != out[28 + len])
+		fail("dump sum", sum & 0xFF, out[28 + len]);
+}
+
+/* la_Vcd.py on out[]: every pin of every sample and the trigger edge */
+static void vcd_Check(void)
+{
+	char bin[64], vcd[64], cmd[256], line[128];
+	unsigned int trigger = word(&out[12]), level = 0, trig = 0, trig_rise = ~0u, t = 0, sample = 0;
+	FILE *f;
+
+	snprintf(bin, sizeof(bin), "/tmp/la_Test_%d.bin", (int)getpid());
+	snprintf(vcd, sizeof(vcd), "/tmp/la_Test_%d.vcd", (int)getpid());
+	f = fopen(bin, "wb");
+	if(!f || fwrite(out, 1, out_len, f) != out_len)
+	{
+		fail("writing the dump", 0, 0);
+		return;
+	}
+	fclose(f);
+	snprintf(cmd, sizeof(cmd), "python3 la_Vcd.py %s -o %s > /dev/null", bin, vcd);
+	if(system(cmd) != 0 || !(f = fopen(vcd, "r")))
+	{
+		fail("la_Vcd.py", 0, 0);
+		remove(bin);
+		return;
+	}
+
+	/* every sample before the next time stamp has the levels reached so far */
+	while(fgets(line, sizeof(line), f))
+	{
+		if(line[0] == '#')
+		{
+			unsigned int next = (unsigned int)strtoul(line + 1, 0, 10);
+
+			for(; sample < LA_SAMPLES && sample * (1000000000u / RATE) < next; sample++)
+			{
+				if(la_ring[(la_end + sample) % LA_SAMPLES] != level)
+				{
+					fail("VCD levels against the ring", sample, level);
+					sample = LA_SAMPLES;
+				}
+			}
+			t = next;
+		}
+		else if((line[0] == '0' || line[0] == '1') && line[1] == 'T')
+		{
+			if(line[0] == '1' && !trig)
+				trig_rise = t;
+			trig = line[0] - '0';
+		}
+		else if((line[0] == '0' || line[0] == '1') && line[1] >= 'a' && line[1] <= 'p')
+		{
+			unsigned int pin = line[1] - 'a';
+
+			level = (level & ~(1u << pin)) | ((unsigned int)(line[0] - '0') << pin);
+		}
+	}
+	fclose(f);
+	remove(bin);
+	remove(vcd);
+	if(sample != LA_SAMPLES || t != LA_SAMPLES * (1000000000u / RATE))
+		fail("VCD end", sample, t);
+	if(trig_rise != trigger * (1000000000u / RATE))
+		fail("VCD trigger edge", trig_rise, trigger * (1000000000u / RATE));
+}
+
+static void test_Dump(void)
+{
+	init(100, 0x1, 0x1);
+	la_state = LA_DONE;
+	la_lost = 7;
+
+	/* one value: a single record, run - 1 = 16383 in two LEB128 bytes */
+	for(unsigned int i = 0; i < LA_SAMPLES; i++)
+		la_ring[i] = 0xA55A;
+	la_end = 1234;
+	la_trig_pos = 5000;
+	dump_Check("one value");
+	if(word(&out[24]) != 4)
+		fail("one value: record bytes", word(&out[24]), 4);
+
+	/* a change every sample */
+	for(unsigned int i = 0; i < LA_SAMPLES; i++)
+		la_ring[i] = (unsigned short)(i & 1 ? 0xFFFF : 0);
+	la_end = 0;
+	dump_Check("a change every sample");
+
+	for(unsigned int n = 0; n < RANDOM_DUMPS; n++)
+	{
+		unsigned int i = 0;
+
+		while(i < LA_SAMPLES)
+		{
+			unsigned int run = (rand() % 8) ? 1 + rand() % 300 : 1 + rand() % 20000;
+			unsigned short v = (unsigned short)rand();
+
+			while(run-- && i < LA_SAMPLES)
+				la_ring[i++] = v;
+		}
+		la_end = rand() % LA_SAMPLES;
+		la_trig_pos = rand() % LA_SAMPLES;
+		dump_Check("random runs");
+		vcd_Check();
+	}
+}
+
+static void test_Refine(void)
+{
+	static const struct { unsigned int pre, late, pos; } c[] =
+	{
+		{ 1000, 10, 5000 }, { 1000, LA_REFINE, 5000 }, { 1000, LA_REFINE + 1, 5000 }, { 1000, 3000, 5000 },
+		{ 5, 10, 5000 }, { 0, 10, 5000 }, { 1000, 40, 3 }, { 1000, 300, 0 },
+	};
+
+	for(unsigned int n = 0; n < sizeof(c) / sizeof(c[0]); n++)
+	{
+		unsigned int k0 = (c[n].pos + LA_SAMPLES - 1) % LA_SAMPLES;
+		unsigned int edge = (k0 + LA_SAMPLES - c[n].late) % LA_SAMPLES;
+		unsigned int limit = (c[n].pre < LA_REFINE) ? c[n].pre : LA_REFINE;
+		unsigned int expect = (k0 + LA_SAMPLES - ((c[n].late < limit) ? c[n].late : limit)) % LA_SAMPLES;
+
+		init(c[n].pre, 0x5, 0x4);
+		for(unsigned int i = 0; i < LA_SAMPLES; i++)
+			la_ring[i] = (unsigned short)((rand() & ~0x5) | 0x1);			//no match
+		for(unsigned int i = 0; i <= c[n].late; i++)
+			la_ring[(edge + i) % LA_SAMPLES] = (unsigned short)((rand() & ~0x5) | 0x4);
+		la_trig_pos = c[n].pos;
+		if(la_Refine() != expect)
+			fail("la_Refine", la_Refine(), expect);
+
+		la_ring[k0] ^= 0x5;												//gone by the interrupt
+		if(la_Refine() != c[n].pos)
+			fail("la_Refine on a glitch", la_Refine(), c[n].pos);
+		la_ring[k0] ^= 0x5;
+		init(c[n].pre, 0, 0);
+		if(la_Refine() != c[n].pos)
+			fail("la_Refine on a forced trigger", la_Refine(), c[n].pos);
+	}
+}
+
+/* trigger at trig_pos, TIM2 counted cnt, the DMA stopped at end */
+static int state(unsigned int pre, unsigned int trig_pos, unsigned int cnt, unsigned int end, unsigned int cc1if)
+{
+	init(pre, 0x1, 0x1);
+	la_state = LA_TRIGGERED;
+	la_trig_pos = trig_pos;
+	TIM2->CNT = cnt;
+	TIM2->SR = cc1if ? (1<<1) : 0;
+	LA_DMA->CR = 1;
+	LA_DMA->NDTR = LA_SAMPLES - end;
+	return la_State();
+}
+
+static void test_State(void)
+{
+	if(state(0, 100, LA_SAMPLES, 100, 1) != LA_DONE || la_lost != 0 || la_end != 100)
+		fail("pre = 0, full lap: lost", la_lost, 0);
+	if(state(0, 0, LA_SAMPLES, 0, 1) != LA_DONE || la_lost != 0)
+		fail("pre = 0, full lap from 0: lost", la_lost, 0);
+	if(state(0, 100, LA_SAMPLES, 95, 1) != LA_DONE || la_lost != 5)
+		fail("pre = 0, DMA 5 short: lost", la_lost, 5);
+	if(state(1000, 100, LA_SAMPLES - 1000, 100 + LA_SAMPLES - 1000, 1) != LA_DONE || la_lost != 0)
+		fail("pre = 1000: lost", la_lost, 0);
+	if(state(1000, 16000, LA_SAMPLES - 1000, (16000 + LA_SAMPLES - 1000 - 3) % LA_SAMPLES, 1) != LA_DONE || la_lost != 3)
+		fail("pre = 1000, DMA 3 short across the ring end: lost", la_lost, 3);
+	if(state(1000, 100, 500, 600, 0) != LA_TRIGGERED || !(LA_DMA->CR & 1))
+		fail("stopped before TIM2 CC1IF", la_state, LA_DMA->CR);
+}
+
+int main(void)
+{
+	map(0x40000000, 0x30000);
+	map(0xE0000000, 0x10000);
+	srand(1);
+
+	test_Dump();
+	test_Refine();
+	test_State();
+	printf("la: %u dumps decoded, %u through la_Vcd.py, %u failures\n", RANDOM_DUMPS + 2, RANDOM_DUMPS, failures);
+	return failures != 0;
+}
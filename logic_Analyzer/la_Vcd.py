@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+"""
+la_Vcd.py - converts a logic analyzer dump (la.h) to a VCD file.
+
+Frame, little endian:
+    'L' 'A' version port rate32 samples32 trigger32 lost32 cycles32 len32
+    len bytes of records: value16, run - 1 as LEB128
+    sum8 of the record bytes
+
+The sixteen pins become wires P<port>0..P<port>15, plus a 'trigger' wire
+that goes high at the trigger sample. Time 0 is the oldest sample (VCD
+times are unsigned), the $comment line gives the trigger time; the
+timescale is 1 ns.
+
+Usage:
+    la_Vcd.py capture.bin -o capture.vcd        # saved dump
+    la_Vcd.py /dev/ttyUSB0 -o capture.vcd       # next dump from the board
+    la_Vcd.py capture.bin -o out.vcd --pins 0,6 # only PA0 and PA6
+
+The serial port must already be set to 921600 8N1 raw, e.g.
+    stty -F /dev/ttyUSB0 921600 raw
+
+Author: Monish Kumar.k
+Date  : 18/04/2025
+"""
+
+import argparse
+import struct
+import sys
+
+HEADER = struct.Struct("<2sBBIIIIII")
+
+
+class DumpError(Exception):
+    pass
+
+
+def read_exact(f, n):
+    data = b""
+    while len(data) < n:
+        chunk = f.read(n - len(data))
+        if not chunk:
+            raise DumpError("end of input inside a frame")
+        data += chunk
+    return data
+
+
+def read_frame(f):
+    # resynchronise on 'L' 'A' in case the port held older bytes
+    prev = b""
+    while True:
+        c = f.read(1)
+        if not c:
+            raise DumpError("no 'LA' frame in the input")
+        if prev + c == b"LA":
+            break
+        prev = c
+    hdr = HEADER.unpack(b"LA" + read_exact(f, HEADER.size - 2))
+    _, version, port, rate, samples, trigger, lost, cycles, length = hdr
+    if version != 1:
+        raise DumpError("unknown dump version %d" % version)
+    data = read_exact(f, length)
+    if (sum(data) & 0xFF) != read_exact(f, 1)[0]:
+        raise DumpError("checksum error")
+    return {"port": chr(port), "rate": rate, "samples": samples, "trigger": trigger,
+            "lost": lost, "cycles": cycles, "data": data}
+
+
+def runs(data):
+    i = 0
+    while i < len(data):
+        if i + 2 > len(data):
+            raise DumpError("truncated record")
+        value = data[i] | (data[i + 1] << 8)
+        i += 2
+        run, shift = 0, 0
+        while True:
+            if i >= len(data):
+                raise DumpError("truncated run length")
+            b = data[i]
+            i += 1
+            run |= (b & 0x7F) << shift
+            shift += 7
+            if not b & 0x80:
+                break
+        yield value, run + 1
+
+
+def write_vcd(out, frame, pins):
+    ids = {pin: chr(ord("a") + pin) for pin in pins}
+    trig_id = "T"
+    ns = 1e9 / frame["rate"]
+    trigger = frame["trigger"]
+
+    def stamp(sample):
+        return int(round(sample * ns))
+
+    out.write("$comment la_Vcd.py: %u samples at %u S/s, trigger at %u (#%d), %u lost $end\n"
+              % (frame["samples"], frame["rate"], trigger, stamp(trigger), frame["lost"]))
+    out.write("$timescale 1 ns $end\n$scope module la $end\n")
+    for pin in pins:
+        out.write("$var wire 1 %s P%s%d $end\n" % (ids[pin], frame["port"], pin))
+    out.write("$var wire 1 %s trigger $end\n$upscope $end\n$enddefinitions $end\n" % trig_id)
+
+    last = None
+    sample = 0
+    trig_done = False
+    for value, run in runs(frame["data"]):
+        if not trig_done and sample > trigger:
+            out.write("#%d\n1%s\n" % (stamp(trigger), trig_id))
+            trig_done = True
+        at_trigger = not trig_done and sample == trigger
+        changes = [pin for pin in pins if last is None or ((value ^ last) >> pin) & 1]
+        if changes or last is None or at_trigger:
+            out.write("#%d\n" % stamp(sample))
+            if last is None or at_trigger:
+                out.write("%d%s\n" % (at_trigger, trig_id))
+                trig_done = trig_done or at_trigger
+            for pin in changes:
+                out.write("%d%s\n" % ((value >> pin) & 1, ids[pin]))
+        last = value
+        sample += run
+    if not trig_done:
+        out.write("#%d\n1%s\n" % (stamp(trigger), trig_id))
+    out.write("#%d\n" % stamp(sample))
+    if sample != frame["samples"]:
+        raise DumpError("records give %d samples, header %d" % (sample, frame["samples"]))
+
+
+def main():
+    ap = argparse.ArgumentParser(description="logic analyzer dump to VCD")
+    ap.add_argument("input", help="dump file or serial port")
+    ap.add_argument("-o", "--output", required=True, help="VCD file to write")
+    ap.add_argument("--pins", help="comma separated pin numbers, default all 16")
+    args = ap.parse_args()
+
+    pins = list(range(16))
+    if args.pins:
+        pins = sorted({int(p) for p in args.pins.split(",")})
+        if any(p < 0 or p > 15 for p in pins):
+            sys.exit("pins are 0..15")
+
+    try:
+        with open(args.input, "rb", buffering=0) as f:
+            frame = read_frame(f)
+        with open(args.output, "w") as out:
+            write_vcd(out, frame, pins)
+    except (DumpError, OSError) as e:
+        sys.exit("%s: %s" % (args.input, e))
+
+    print("port %s, %u samples at %u S/s, trigger at sample %u, %u lost" %
+          (frame["port"], frame["samples"], frame["rate"], frame["trigger"], frame["lost"]))
+    print("%u bytes of runs for %u raw, compressed in %u cycles" %
+          (len(frame["data"]), 2 * frame["samples"], frame["cycles"]))
+
+
+if __name__ == "__main__":
+    main()
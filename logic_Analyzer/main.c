@@ -0,0 +1,110 @@
+/**
+ ******************************************************************************
+ * @file    logic_Analyzer.c
+ * @author  Monish Kumar.k
+ * @date    18/04/2025
+ * @brief   Logic analyzer on GPIOA: 4.2 MS/s capture of PA0..PA15 around an
+ *          IR sensor edge, dumped over USART1 for la_Vcd.py.
+ *
+ * @details
+ * Hardware Connections: IR sensor output on PA0 (internal pull-up, as in
+ * Interfaceing_Ir_Sensor_By_External_Interrupt). Test signal from TIM3_CH1
+ * on PA6, 100 kHz 30 %. USART1 TX on PA9 at 921600 baud for the dump.
+ *
+ * Instead of blinking LEDs to see what the sensor line did:
+ *  - la_Arm() starts sampling, a quarter of the ring is kept before the
+ *    trigger,
+ *  - trigger: PA0 goes low (an object in front of the IR sensor). With no
+ *    edge for FORCE_MS the capture is forced, so the PA6 signal still
+ *    shows that the analyzer works,
+ *  - the capture is dumped and the analyzer re-armed.
+ *
+ * On the host:
+ *     stty -F /dev/ttyUSB0 921600 raw
+ *     la_Vcd.py /dev/ttyUSB0 -o ir.vcd
+ * la_Vcd.py prints the header: rate, trigger position, lost samples and
+ * the compression cycles, and the size against the raw 32 KiB.
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 18/04/2025
+  File : logic_Analyzer
+ ******************************************************************************/
+#include <arm.h>
+#include <rcc.h>
+#include <uart.h>
+#include "la.h"
+
+#define DUMP_PORT		UART_1
+#define FORCE_MS		5000
+
+void rcc_Config(void);
+void gpio_Moder(void);
+void signal_Config(void);
+
+int main(void)
+{
+	static const struct la_cfg cfg = { GPIOA, 4200000, LA_SAMPLES / 4, (1<<0), 0 };
+	unsigned int start;
+
+	rcc_Config();
+	gpio_Moder();
+	signal_Config();
+	uart_Init(DUMP_PORT, 921600);
+	la_Init(&cfg);
+	while(1)
+	{
+		la_Arm();
+		start = DWT->CYCCNT;
+		while(la_State() != LA_DONE)
+		{
+			if(la_State() == LA_ARMED && DWT->CYCCNT - start >= rcc_Get_Sysclk() / 1000 * FORCE_MS)
+				la_Force();
+		}
+		la_Dump(DUMP_PORT);
+		uart_Flush(DUMP_PORT);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* APB1 /2 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+void gpio_Moder()
+{
+	RCC->AHB1ENR |= (1<<0);
+	GPIOA->MODER &= ~(0x3<<0);
+	GPIOA->PUPDR = (GPIOA->PUPDR & ~(0x3<<0)) | (1<<0);		/* PA0 pull-up */
+}
+
+/* TIM3 CH1 on PA6 (AF2): 84 MHz / 840 = 100 kHz, 30 % */
+void signal_Config()
+{
+	RCC->APB1ENR |= (1<<1);
+	GPIOA->AFRL  = (GPIOA->AFRL & ~(0xF<<24)) | (2<<24);
+	GPIOA->MODER = (GPIOA->MODER & ~(0x3<<12)) | (2<<12);
+
+	TIM3->PSC = 0;
+	TIM3->ARR = 840 - 1;
+	TIM3->CCR1 = 252;
+	TIM3->CCMR1 = (6<<4) | (1<<3);			/* OC1M = PWM 1, OC1PE */
+	TIM3->CCER = (1<<0);
+	TIM3->EGR = (1<<0);
+	TIM3->CR1 = (1<<7) | (1<<0);
+}
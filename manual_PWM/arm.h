@@ -8,6 +8,14 @@
 #ifndef ARM_H_
 #define ARM_H_
 
+/*
+ * Peripheral pointers are macros so that this header can be included from
+ * more than one .c file of the same project without duplicate symbols.
+ */
+
+#define HSE_VALUE	25000000	//on-board crystal of the F401CCU6 board
+#define HSI_VALUE	16000000
+
 struct rcc
 {
 	unsigned int CR;
@@ -29,7 +37,13 @@ struct rcc
 	unsigned int APB1ENR;
 	unsigned int APB2ENR;
 };
-volatile struct rcc *RCC = (volatile struct rcc*)0x40023800;
+#define RCC		((volatile struct rcc*)0x40023800)
+
+struct flash
+{
+	unsigned int ACR;		//ACR   0x00
+};
+#define FLASH	((volatile struct flash*)0x40023C00)
 
 struct timer
 {
@@ -40,23 +54,30 @@ struct timer
 	unsigned int SR;		//SR    0X10
 	unsigned int EGR;		//ECGR  0X14
 	unsigned int CCMR1;     //CCMR1 0X18
-	unsigned int res5;		//res5  0X1c
+	unsigned int CCMR2;		//CCMR2 0X1c
 	unsigned int CCER;      //CCER  0X20
 	unsigned int CNT;       //CNT 	0X24
 	unsigned int PSC;       //PSC   0X28
 	unsigned int ARR;		//ARR   0X2C
-	unsigned int res6;		//res6  0x30
+	unsigned int RCR;		//RCR   0x30
 	unsigned int CCR1;		//CCR1  0x34
-	unsigned int res7;		//res7  0x38
-	unsigned int res8;      //res8  0x3c
-	unsigned int res9;		//res9  0x40
-	unsigned int res10;		//res10 0x44
-	unsigned int res11;		//res11 0x48
-	unsigned int res12;     //res12 0x4c
+	unsigned int CCR2;		//CCR2  0x38
+	unsigned int CCR3;      //CCR3  0x3c
+	unsigned int CCR4;		//CCR4  0x40
+	unsigned int BDTR;		//BDTR  0x44
+	unsigned int DCR;		//DCR   0x48
+	unsigned int DMAR;      //DMAR  0x4c
 	unsigned int OR;		//OR    0x50
 };
 
-volatile struct timer *TIM10 = (volatile struct timer*)0x40014400;
+#define TIM1	((volatile struct timer*)0x40010000)
+#define TIM2	((volatile struct timer*)0x40000000)
+#define TIM3	((volatile struct timer*)0x40000400)
+#define TIM4	((volatile struct timer*)0x40000800)
+#define TIM5	((volatile struct timer*)0x40000C00)
+#define TIM9	((volatile struct timer*)0x40014000)
+#define TIM10	((volatile struct timer*)0x40014400)
+#define TIM11	((volatile struct timer*)0x40014800)
 
 struct gpio
 {
@@ -72,6 +93,136 @@ struct gpio
 	unsigned int AFRH;
 };
 
-volatile struct gpio *GPIOC = (volatile struct gpio*)0x40020800;
+#define GPIOA	((volatile struct gpio*)0x40020000)
+#define GPIOB	((volatile struct gpio*)0x40020400)
+#define GPIOC	((volatile struct gpio*)0x40020800)
+
+struct usart
+{
+	unsigned int SR;		//SR    0x00
+	unsigned int DR;		//DR    0x04
+	unsigned int BRR;		//BRR   0x08
+	unsigned int CR1;		//CR1   0x0C
+	unsigned int CR2;		//CR2   0x10
+	unsigned int CR3;		//CR3   0x14
+	unsigned int GTPR;		//GTPR  0x18
+};
+
+#define USART1	((volatile struct usart*)0x40011000)
+#define USART2	((volatile struct usart*)0x40004400)
+
+struct spi
+{
+	unsigned int CR1;		//CR1     0x00
+	unsigned int CR2;		//CR2     0x04
+	unsigned int SR;		//SR      0x08
+	unsigned int DR;		//DR      0x0C
+	unsigned int CRCPR;		//CRCPR   0x10
+	unsigned int RXCRCR;	//RXCRCR  0x14
+	unsigned int TXCRCR;	//TXCRCR  0x18
+	unsigned int I2SCFGR;	//I2SCFGR 0x1C
+	unsigned int I2SPR;		//I2SPR   0x20
+};
+
+#define SPI1	((volatile struct spi*)0x40013000)
+
+struct adc
+{
+	unsigned int SR;		//SR    0x00
+	unsigned int CR1;		//CR1   0x04
+	unsigned int CR2;		//CR2   0x08
+	unsigned int SMPR1;		//SMPR1 0x0C
+	unsigned int SMPR2;		//SMPR2 0x10
+	unsigned int JOFR[4];	//JOFRx 0x14
+	unsigned int HTR;		//HTR   0x24
+	unsigned int LTR;		//LTR   0x28
+	unsigned int SQR1;		//SQR1  0x2C
+	unsigned int SQR2;		//SQR2  0x30
+	unsigned int SQR3;		//SQR3  0x34
+	unsigned int JSQR;		//JSQR  0x38
+	unsigned int JDR[4];	//JDRx  0x3C
+	unsigned int DR;		//DR    0x4C
+};
+
+struct adc_common
+{
+	unsigned int CSR;		//CSR   0x00
+	unsigned int CCR;		//CCR   0x04
+	unsigned int CDR;		//CDR   0x08
+};
+
+#define ADC1		((volatile struct adc*)0x40012000)
+#define ADC_COMMON	((volatile struct adc_common*)0x40012300)
+
+struct dma_stream
+{
+	unsigned int CR;		//SxCR   0x00
+	unsigned int NDTR;		//SxNDTR 0x04
+	unsigned int PAR;		//SxPAR  0x08
+	unsigned int M0AR;		//SxM0AR 0x0C
+	unsigned int M1AR;		//SxM1AR 0x10
+	unsigned int FCR;		//SxFCR  0x14
+};
+
+struct dma
+{
+	unsigned int LISR;		//LISR   0x00
+	unsigned int HISR;		//HISR   0x04
+	unsigned int LIFCR;		//LIFCR  0x08
+	unsigned int HIFCR;		//HIFCR  0x0C
+	struct dma_stream S[8];	//S0..S7 0x10 + 0x18 * n
+};
+
+#define DMA1	((volatile struct dma*)0x40026000)
+#define DMA2	((volatile struct dma*)0x40026400)
+
+struct exti
+{
+	unsigned int IMR;		//IMR   0x00
+	unsigned int EMR;		//EMR   0x04
+	unsigned int RTSR;		//RTSR  0x08
+	unsigned int FTSR;		//FTSR  0x0C
+	unsigned int SWIER;		//SWIER 0x10
+	unsigned int PR;		//PR    0x14
+};
+
+#define EXTI	((volatile struct exti*)0x40013C00)
+
+struct syscfg
+{
+	unsigned int MEMRMP;	//MEMRMP    0x00
+	unsigned int PMC;		//PMC       0x04
+	unsigned int EXTICR[4];	//EXTICR1-4 0x08
+	unsigned int res1[2];
+	unsigned int CMPCR;		//CMPCR     0x20
+};
+
+#define SYSCFG	((volatile struct syscfg*)0x40013800)
+
+struct nvic
+{
+	unsigned int ISER[8];	//ISER  0x000
+	unsigned int res1[24];
+	unsigned int ICER[8];	//ICER  0x080
+	unsigned int res2[24];
+	unsigned int ISPR[8];	//ISPR  0x100
+	unsigned int res3[24];
+	unsigned int ICPR[8];	//ICPR  0x180
+	unsigned int res4[24];
+	unsigned int IABR[8];	//IABR  0x200
+	unsigned int res5[56];
+	unsigned char IP[240];	//IPR   0x300
+};
+
+#define NVIC	((volatile struct nvic*)0xE000E100)
+
+struct dwt
+{
+	unsigned int CTRL;		//CTRL   0x00
+	unsigned int CYCCNT;	//CYCCNT 0x04
+};
+
+#define DWT		((volatile struct dwt*)0xE0001000)
+#define DEMCR	(*(volatile unsigned int*)0xE000EDFC)
 
 #endif /* ARM_H_ */
@@ -32,6 +32,7 @@
   File : Manual_PWM
  ******************************************************************************/
  #include <arm.h>
+#include <bitband.h>
 
 void rcc_Config(void);
 void choose_Port_C(void);
@@ -94,11 +95,11 @@ void delay(int delay)
 
 	TIM10->ARR = delay;               //auto-reload register
 
-	TIM10->CR1 |= (1<<0);   //CEN: Counter enable
+	BITBAND(&TIM10->CR1, 0) = 1;   //CEN: Counter enable
 
-	while(!(TIM10->SR & (1<<0)));
+	while(!BITBAND(&TIM10->SR, 0));
 
-	TIM10->SR &= ~(1<<0);
+	TIM10->SR = ~(1<<0);   //UIF is rc_w0: a plain store clears it and leaves other flags alone
 }
 
 void led_Blink_C13()
@@ -106,17 +107,17 @@ void led_Blink_C13()
 	int i=25,j=490;
 	for(i=25; i<=475; i=i+25)
 	{
-		GPIOC->ODR = GPIOC->ODR | (1<<15); // LED on
+		BITBAND(&GPIOC->ODR, 15) = 1; // LED on
 		delay(i);
-		GPIOC->ODR = GPIOC->ODR & ~(1<<15); // LED off
+		BITBAND(&GPIOC->ODR, 15) = 0; // LED off
 		delay(j);
 		j=j-25;
 	}
 	for(j=25; j<=475; j=j+25)
 	{
-		GPIOC->ODR = GPIOC->ODR | (1<<15); // LED on
+		BITBAND(&GPIOC->ODR, 15) = 1; // LED on
 		delay(i);
-		GPIOC->ODR = GPIOC->ODR & ~(1<<15); // LED off
+		BITBAND(&GPIOC->ODR, 15) = 0; // LED off
 		delay(j);
 		i=i-25;
 	}
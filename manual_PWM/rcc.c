@@ -0,0 +1,54 @@
+/**
+ ******************************************************************************
+ * @file    rcc.c
+ * @author  Monish Kumar.k
+ * @date    03/02/2025
+ * @brief   SYSCLK, APB and timer clocks read back from the RCC registers.
+ *
+ * @details
+ *  - SYSCLK follows SWS: HSI, HSE, or the PLL (HSE_VALUE / HSI_VALUE from
+ *    arm.h as its source, / M * N / P).
+ *  - HCLK applies the AHB prescaler, PCLKx the APBx prescaler.
+ *  - Timers on a divided APB bus run at twice the bus clock.
+ ******************************************************************************
+ */
+#include <arm.h>
+#include "rcc.h"
+
+unsigned int rcc_Get_Sysclk()
+{
+	unsigned int cfgr = RCC->CFGR;
+	unsigned int pll  = RCC->PLLCFGR;
+	unsigned int src;
+
+	switch((cfgr >> 2) & 0x3)		//SWS
+	{
+	case 1:
+		return HSE_VALUE;
+	case 2:
+		src = (pll & (1<<22)) ? HSE_VALUE : HSI_VALUE;
+		return (src / (pll & 0x3F)) * ((pll >> 6) & 0x1FF) / ((((pll >> 16) & 0x3) + 1) * 2);
+	default:
+		return HSI_VALUE;
+	}
+}
+
+unsigned int rcc_Get_Pclk(int apb)
+{
+	static const unsigned char ahb_shift[16] = { 0,0,0,0,0,0,0,0,1,2,3,4,6,7,8,9 };
+	unsigned int cfgr = RCC->CFGR;
+	unsigned int hclk = rcc_Get_Sysclk() >> ahb_shift[(cfgr >> 4) & 0xF];
+	unsigned int ppre = (apb == 1) ? ((cfgr >> 10) & 0x7) : ((cfgr >> 13) & 0x7);
+
+	return (ppre < 4) ? hclk : (hclk >> (ppre - 3));
+}
+
+/* Timers on a divided APB bus run at twice the bus clock. */
+unsigned int rcc_Get_Tim_Clock(int apb)
+{
+	unsigned int cfgr = RCC->CFGR;
+	unsigned int ppre = (apb == 1) ? ((cfgr >> 10) & 0x7) : ((cfgr >> 13) & 0x7);
+	unsigned int pclk = rcc_Get_Pclk(apb);
+
+	return (ppre < 4) ? pclk : pclk * 2;
+}
@@ -0,0 +1,21 @@
+/*
+ * rcc.h
+ *
+ *  Created on: Feb 03, 2025
+ *      Author: moni
+ *
+ *  Clock tree read back from RCC: SYSCLK from SWS and PLLCFGR, the APB
+ *  clocks from the CFGR prescalers. Drivers use these instead of a fixed
+ *  frequency, so they keep working when rcc_Config() changes.
+ *
+ *  Needs rcc.c on the source path; no other driver is pulled in.
+ */
+
+#ifndef RCC_H_
+#define RCC_H_
+
+unsigned int rcc_Get_Sysclk(void);
+unsigned int rcc_Get_Pclk(int apb);				//apb: 1 or 2
+unsigned int rcc_Get_Tim_Clock(int apb);		//timers on that bus
+
+#endif /* RCC_H_ */
@@ -0,0 +1,130 @@
+/**
+ ******************************************************************************
+ * @file    max7219_Spi.c
+ * @author  Monish Kumar.k
+ * @date    10/03/2025
+ * @brief   8x8_Led_Display patterns on a chain of MAX7219 modules, with a
+ *          frame push benchmark for 1, 4 and 16 modules.
+ *
+ * @details
+ * Hardware Connections:
+ *  - PA5 SCK  -> CLK of the first module
+ *  - PA7 MOSI -> DIN of the first module
+ *  - PA4      -> CS/LOAD of all modules
+ *  - DOUT of every module -> DIN of the next one
+ *
+ * Benchmark (84 MHz SYSCLK, SPI1 at 5.25 MHz):
+ *  - full  : all 8 rows dirty, time from matrix_Show() to the last latch
+ *  - row   : one row dirty
+ *  - cpu   : cycles spent inside matrix_Show() itself, the rest of the
+ *            push runs on DMA
+ *  The SPI side does not care how many modules are really connected, so
+ *  all three chain lengths can be measured on one board. Results are
+ *  logged with LOG() (binary_Log) on USART2 and kept in bench[].
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 10/03/2025
+  File : max7219_Spi
+ ******************************************************************************/
+#include <arm.h>
+#include <uart.h>
+#include <log.h>
+#include <matrix.h>
+#include <patterns.h>
+#include "max7219.h"
+
+#define PANELS			4
+
+struct bench_result
+{
+	unsigned int panels;
+	unsigned int full_cycles;
+	unsigned int row_cycles;
+	unsigned int cpu_cycles;
+};
+
+static const unsigned int bench_panels[] = { 1, 4, 16 };
+volatile struct bench_result bench[sizeof(bench_panels) / sizeof(bench_panels[0])];
+
+static struct matrix led;
+
+void rcc_Config(void);
+void bench_Run(void);
+unsigned int bench_Push(struct matrix *m, unsigned int *cpu);
+
+int main(void)
+{
+	rcc_Config();
+	uart_Init(UART_CONSOLE, 921600);
+	log_Init();
+
+	bench_Run();
+
+	matrix_Init(&led, &max7219_backend, PANELS);
+	while(1)
+	{
+		patterns(&led);
+		log_Drain(UART_CONSOLE);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* APB1 /2 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+unsigned int bench_Push(struct matrix *m, unsigned int *cpu)
+{
+	unsigned int start = DWT->CYCCNT;
+
+	matrix_Show(m);
+	*cpu = DWT->CYCCNT - start;
+	max7219_Wait();
+	return DWT->CYCCNT - start;
+}
+
+void bench_Run()
+{
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);		/* CYCCNTENA */
+
+	for(unsigned int i = 0; i < sizeof(bench_panels) / sizeof(bench_panels[0]); i++)
+	{
+		unsigned int cpu;
+
+		bench[i].panels = bench_panels[i];
+		matrix_Init(&led, &max7219_backend, bench_panels[i]);
+
+		/* every byte differs from the cleared display: 8 dirty rows */
+		for(unsigned int p = 0; p < led.panels; p++)
+		{
+			led.fb[p] = 0xA5A5A5A5A5A5A5A5ULL ^ ((unsigned long long)p * 0x0101010101010101ULL);
+		}
+		bench[i].full_cycles = bench_Push(&led, &cpu);
+		bench[i].cpu_cycles = cpu;
+
+		/* one pixel in the last panel: one dirty row */
+		led.fb[led.panels - 1] ^= 1ULL << 27;
+		bench[i].row_cycles = bench_Push(&led, &cpu);
+
+		LOG("%u modules: full frame %u cycles, one row %u cycles, show() %u cycles", bench[i].panels,
+			bench[i].full_cycles, bench[i].row_cycles, bench[i].cpu_cycles);
+		log_Drain(UART_CONSOLE);
+	}
+}
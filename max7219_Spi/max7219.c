@@ -0,0 +1,239 @@
+/**
+ ******************************************************************************
+ * @file    max7219.c
+ * @author  Monish Kumar.k
+ * @date    10/03/2025
+ * @brief   Daisy-chained MAX7219 matrix modules on SPI1 + DMA2 Stream3 with
+ *          dirty-row updates.
+ *
+ * @details
+ *  - A row update is one 16-bit word (digit register row+1, column byte)
+ *    per module, all shifted in one DMA transfer, then one rising edge on
+ *    CS latches the word sitting in every module at the same time.
+ *  - The first word shifted out ends up in the farthest module, so the
+ *    row buffer is filled from the last panel down to panel 0.
+ *  - matrix_Show() XORs the framebuffer with the copy the modules show and
+ *    folds every panel into one 8-bit mask of dirty rows. The rows are then
+ *    sent back to back: the DMA transfer-complete interrupt waits for the
+ *    last frame to leave the shift register, latches, and starts the next
+ *    dirty row. A full refresh is one matrix_Show() and eight transfers.
+ *  - Show() while a refresh is running only marks it pending; the ISR
+ *    starts one more refresh with the newest framebuffer when it is done.
+ *
+ * Note:
+ *  - CS has to rise between rows and the F401 SPI cannot pulse NSS by
+ *    itself, which is why a refresh is one transfer per dirty row and not
+ *    one transfer for the whole frame.
+ ******************************************************************************
+ */
+#include <arm.h>
+#include <rcc.h>
+#include "max7219.h"
+
+#define DMA2_S3_IRQ		59
+#define SPI_DMA			(&DMA2->S[3])
+#define SPI_DMA_SHIFT	22			//stream 3 flags in LISR/LIFCR
+#define CS_PIN			4
+
+#define REG_NOOP		0x00
+#define REG_DECODE		0x09
+#define REG_INTENSITY	0x0A
+#define REG_SCAN_LIMIT	0x0B
+#define REG_SHUTDOWN	0x0C
+#define REG_TEST		0x0F
+
+static struct matrix *max_m;
+static unsigned long long shown[MATRIX_MAX_PANELS];
+static unsigned short tx_row[MATRIX_MAX_PANELS];
+static volatile unsigned int dirty;			//rows still to send, bit r = row r
+static volatile unsigned int busy;
+static volatile unsigned int pending;
+static volatile unsigned int rows_sent;
+
+static unsigned char col_Bits(unsigned char b)
+{
+#if MAX7219_REVERSE_COLS
+	b = (unsigned char)((b >> 4) | (b << 4));
+	b = (unsigned char)(((b & 0xCC) >> 2) | ((b & 0x33) << 2));
+	b = (unsigned char)(((b & 0xAA) >> 1) | ((b & 0x55) << 1));
+#endif
+	return b;
+}
+
+/* bit r set when any bit of byte r is set */
+static unsigned int row_Mask(unsigned long long d)
+{
+	d |= d >> 4;
+	d |= d >> 2;
+	d |= d >> 1;
+	d &= 0x0101010101010101ULL;
+	return (unsigned int)((d * 0x0102040810204080ULL) >> 56);
+}
+
+static void row_Start(unsigned int row)
+{
+	volatile struct dma_stream *s = SPI_DMA;
+	unsigned int n = max_m->panels;
+
+	for(unsigned int k = 0; k < n; k++)
+	{
+		unsigned int p = n - 1 - k;
+		tx_row[k] = (unsigned short)(((row + 1) << 8) | col_Bits((unsigned char)(shown[p] >> (row*8))));
+	}
+	GPIOA->BSRR = 1 << (CS_PIN + 16);
+	s->M0AR = (unsigned int)tx_row;
+	s->NDTR = n;
+	s->CR  |= (1<<0);
+}
+
+/* call with DMA2 Stream3 interrupt unable to run (masked or from inside it) */
+static void refresh_Start()
+{
+	unsigned int rows = 0;
+
+	for(unsigned int p = 0; p < max_m->panels; p++)
+	{
+		unsigned long long fb = max_m->fb[p];
+		rows |= row_Mask(fb ^ shown[p]);
+		shown[p] = fb;
+	}
+	if(rows == 0)
+		return;
+	dirty = rows;
+	busy = 1;
+	row_Start(__builtin_ctz(rows));
+}
+
+static void spi_Idle()
+{
+	while(!(SPI1->SR & (1<<1)));	//TXE
+	while(SPI1->SR & (1<<7));		//BSY
+}
+
+/* polled broadcast of one register to all modules, used before DMA starts */
+static void command(unsigned int reg, unsigned int val)
+{
+	GPIOA->BSRR = 1 << (CS_PIN + 16);
+	for(unsigned int k = 0; k < max_m->panels; k++)
+	{
+		while(!(SPI1->SR & (1<<1)));
+		SPI1->DR = (reg << 8) | val;
+	}
+	spi_Idle();
+	GPIOA->BSRR = 1 << CS_PIN;
+}
+
+static void max7219_Init(struct matrix *m)
+{
+	volatile struct dma_stream *s = SPI_DMA;
+	unsigned int pclk = rcc_Get_Pclk(2), br = 0;
+
+	max_m = m;
+	busy = 0;
+	pending = 0;
+
+	RCC->AHB1ENR |= (1<<0) | (1<<22);		//GPIOA, DMA2
+	RCC->APB2ENR |= (1<<12);				//SPI1
+
+	GPIOA->BSRR   = 1 << CS_PIN;
+	GPIOA->MODER  = (GPIOA->MODER & ~((0x3<<8) | (0x3<<10) | (0x3<<14))) | (0x1<<8) | (0x2<<10) | (0x2<<14);
+	GPIOA->OSPEEDR |= (0x3<<8) | (0x3<<10) | (0x3<<14);
+	GPIOA->AFRL   = (GPIOA->AFRL & ~((0xF<<20) | (0xF<<28))) | (5<<20) | (5<<28);
+
+	while(br < 7 && (pclk >> (br + 1)) > MAX7219_SPI_HZ)
+	{
+		br++;
+	}
+	SPI1->CR1 = 0;
+	SPI1->CR2 = (1<<1);						//TXDMAEN
+	SPI1->CR1 = (1<<11) | (1<<9) | (1<<8) | (br<<3) | (1<<2) | (1<<6);	//DFF 16 bit, SSM, SSI, BR, master, SPE
+
+	s->CR = 0;
+	while(s->CR & (1<<0));
+	DMA2->LIFCR = 0x3D << SPI_DMA_SHIFT;
+	s->PAR = (unsigned int)&SPI1->DR;
+	s->FCR = 0;
+	s->CR  = (3<<25) | (1<<16) | (1<<13) | (1<<11) | (1<<10) | (1<<6) | (1<<4) | (1<<2);
+			//CH3, PL medium, MSIZE/PSIZE 16 bit, MINC, M->P, TCIE, TEIE
+
+	NVIC->IP[DMA2_S3_IRQ] = (4<<4);
+	NVIC->ISER[DMA2_S3_IRQ >> 5] = (1 << (DMA2_S3_IRQ & 31));
+
+	command(REG_TEST, 0);
+	command(REG_SHUTDOWN, 0);
+	command(REG_DECODE, 0);
+	command(REG_SCAN_LIMIT, 7);
+	command(REG_INTENSITY, MAX7219_INTENSITY);
+	for(unsigned int r = 0; r < 8; r++)
+	{
+		command(r + 1, 0);
+	}
+	for(unsigned int p = 0; p < MATRIX_MAX_PANELS; p++)
+	{
+		shown[p] = 0;
+	}
+	command(REG_SHUTDOWN, 1);
+}
+
+static void max7219_Show(struct matrix *m)
+{
+	(void)m;
+	NVIC->ICER[DMA2_S3_IRQ >> 5] = (1 << (DMA2_S3_IRQ & 31));
+	__asm volatile("dsb\n\tisb" : : : "memory");
+	if(busy)
+		pending = 1;
+	else
+		refresh_Start();
+	NVIC->ISER[DMA2_S3_IRQ >> 5] = (1 << (DMA2_S3_IRQ & 31));
+}
+
+const struct matrix_backend max7219_backend = { max7219_Init, max7219_Show };
+
+int max7219_Busy()
+{
+	return busy || pending;
+}
+
+void max7219_Wait()
+{
+	while(max7219_Busy());
+}
+
+unsigned int max7219_Rows_Sent()
+{
+	return rows_sent;
+}
+
+void max7219_Set_Intensity(unsigned int level)
+{
+	max7219_Wait();
+	command(REG_INTENSITY, level & 0xF);
+}
+
+void DMA2_Stream3_IRQHandler()
+{
+	unsigned int flags = (DMA2->LISR >> SPI_DMA_SHIFT) & 0x3D;
+	unsigned int rows;
+
+	DMA2->LIFCR = flags << SPI_DMA_SHIFT;
+	if(!(flags & ((1<<5) | (1<<3))))		//TCIF or TEIF
+		return;
+
+	spi_Idle();
+	GPIOA->BSRR = 1 << CS_PIN;				//latch the row in every module
+	rows_sent++;
+
+	rows = dirty & (dirty - 1);
+	dirty = rows;
+	if(rows)
+	{
+		row_Start(__builtin_ctz(rows));
+		return;
+	}
+	busy = 0;
+	if(pending)
+	{
+		pending = 0;
+		refresh_Start();
+	}
+}
@@ -0,0 +1,37 @@
+/*
+ * max7219.h
+ *
+ *  Created on: Mar 10, 2025
+ *      Author: moni
+ *
+ *  MAX7219 backend for the led_Matrix framebuffer API, any number of
+ *  daisy-chained 8x8 modules (up to MATRIX_MAX_PANELS).
+ *
+ *  SPI1 : PA5 SCK, PA7 MOSI (AF5), PA4 CS/LOAD as GPIO
+ *  DMA2 Stream3 channel 3 (SPI1_TX), 16 bit frames
+ *
+ *  Panel 0 is the module wired to the MCU, panel p is p modules further
+ *  down the chain. matrix_Show() compares the framebuffer with what the
+ *  modules show and sends only the rows that changed; it returns at once,
+ *  the transfer finishes in the DMA interrupt.
+ */
+
+#ifndef MAX7219_H_
+#define MAX7219_H_
+
+#include <matrix.h>
+
+#define MAX7219_SPI_HZ		5000000		//upper limit, the chip takes 10 MHz
+#define MAX7219_INTENSITY	7			//0..15
+
+/* set to 1 when D7 is the leftmost column of the module instead of D0 */
+#define MAX7219_REVERSE_COLS	0
+
+extern const struct matrix_backend max7219_backend;
+
+int  max7219_Busy(void);
+void max7219_Wait(void);
+unsigned int max7219_Rows_Sent(void);
+void max7219_Set_Intensity(unsigned int level);
+
+#endif /* MAX7219_H_ */
@@ -0,0 +1,146 @@
+/**
+ ******************************************************************************
+ * @file    counter.c
+ * @author  Monish Kumar.k
+ * @date    14/04/2025
+ * @brief   64-bit hardware edge counter on TIM2 in external clock mode.
+ *
+ * @details
+ *  - TIM2 counts 0..0xFFFFFFFF and wraps; the update interrupt adds one
+ *    to the upper word, at most once every 2^32 edges.
+ *  - counter_Count() reads CNT with interrupts masked and checks UIF: a
+ *    wrap that is pending but not yet taken by the interrupt is added
+ *    here, with CNT read again so that low and high words match.
+ *  - With the ETR prescaler the counter sees one clock per 2^prescaler
+ *    edges; the count is scaled back, so it is exact to 2^prescaler.
+ *  - counter_Rate() takes the time between calls from CYCCNT, which wraps
+ *    after 51 s at 84 MHz: call it more often than that.
+ ******************************************************************************
+ */
+#include <arm.h>
+#include <rcc.h>
+#include "counter.h"
+
+#define TIM2_IRQ		28
+
+static volatile unsigned int counter_high;
+static unsigned int counter_shift;
+static unsigned long long rate_count;
+static unsigned int rate_time;
+
+static inline unsigned int irq_Save(void)
+{
+	unsigned int primask;
+
+	__asm volatile("mrs %0, primask\n\tcpsid i" : "=r"(primask) :: "memory");
+	return primask;
+}
+
+static inline void irq_Restore(unsigned int primask)
+{
+	__asm volatile("msr primask, %0" :: "r"(primask) : "memory");
+}
+
+int counter_Init(const struct counter_cfg *cfg)
+{
+	unsigned int smcr;
+
+	if(cfg->edge > COUNTER_BOTH || cfg->filter > 15 || cfg->prescaler > 3)
+		return -1;
+	if(cfg->input == COUNTER_ETR && cfg->edge == COUNTER_BOTH)
+		return -1;							//ETR has one polarity bit only
+	if(cfg->input == COUNTER_TI1 && cfg->prescaler)
+		return -1;							//no prescaler on the TI1 path
+	if(cfg->input > COUNTER_TI1)
+		return -1;
+
+	RCC->AHB1ENR |= (1<<0);
+	RCC->APB1ENR |= (1<<0);
+	GPIOA->PUPDR = (GPIOA->PUPDR & ~(0x3<<0)) | (1<<0);		/* PA0 pull-up */
+	GPIOA->AFRL  = (GPIOA->AFRL & ~(0xF<<0)) | (1<<0);		/* AF1, TIM2_CH1_ETR */
+	GPIOA->MODER = (GPIOA->MODER & ~(0x3<<0)) | (2<<0);
+
+	TIM2->CR1 = 0;
+	TIM2->PSC = 0;
+	TIM2->ARR = 0xFFFFFFFF;
+	if(cfg->input == COUNTER_ETR)
+	{
+		TIM2->CCMR1 = 0;
+		TIM2->CCER = 0;
+		smcr = (1<<14) | (cfg->prescaler << 12) | (cfg->filter << 8);	/* ECE, ETPS, ETF */
+		if(cfg->edge == COUNTER_FALLING)
+			smcr |= (1<<15);											/* ETP, inverted */
+		counter_shift = cfg->prescaler;
+	}
+	else
+	{
+		TIM2->CCMR1 = (cfg->filter << 4) | (1<<0);						/* IC1F, CC1S = TI1 */
+		TIM2->CCER = (cfg->edge == COUNTER_FALLING) ? (1<<1) : 0;		/* CC1P */
+		if(cfg->edge == COUNTER_BOTH)
+			smcr = (4<<4) | (7<<0);										/* TS = TI1F_ED, SMS = external clock 1 */
+		else
+			smcr = (5<<4) | (7<<0);										/* TS = TI1FP1 */
+		counter_shift = 0;
+	}
+	TIM2->SMCR = smcr;
+	TIM2->EGR = (1<<0);
+	TIM2->SR = 0;
+	TIM2->CNT = 0;
+	counter_high = 0;
+	TIM2->DIER = (1<<0);												/* UIE, overflow only */
+	NVIC->IP[TIM2_IRQ] = (6<<4);
+	NVIC->ISER[TIM2_IRQ >> 5] = (1 << (TIM2_IRQ & 31));
+
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);
+	rate_count = 0;
+	rate_time = DWT->CYCCNT;
+	TIM2->CR1 = (1<<0);
+	return 0;
+}
+
+void TIM2_IRQHandler()
+{
+	TIM2->SR = ~(1<<0);						//rc_w0
+	counter_high++;
+}
+
+unsigned long long counter_Count()
+{
+	unsigned int primask = irq_Save();
+	unsigned int low = TIM2->CNT;
+	unsigned int high = counter_high;
+
+	if(TIM2->SR & (1<<0))
+	{
+		low = TIM2->CNT;					//wrapped, interrupt not taken yet
+		high++;
+	}
+	irq_Restore(primask);
+	return (((unsigned long long)high << 32) | low) << counter_shift;
+}
+
+unsigned int counter_Rate()
+{
+	unsigned long long count = counter_Count();
+	unsigned int now = DWT->CYCCNT;
+	unsigned int cycles = now - rate_time;
+	unsigned long long edges = count - rate_count;
+
+	rate_count = count;
+	rate_time = now;
+	if(!cycles)
+		return 0;
+	return (unsigned int)(edges * rcc_Get_Sysclk() / cycles);
+}
+
+void counter_Clear()
+{
+	unsigned int primask = irq_Save();
+
+	TIM2->CNT = 0;
+	TIM2->SR = ~(1<<0);
+	counter_high = 0;
+	rate_count = 0;
+	irq_Restore(primask);
+}
@@ -0,0 +1,45 @@
+/*
+ * counter.h
+ *
+ *  Created on: Apr 14, 2025
+ *      Author: moni
+ *
+ *  Edge counter on TIM2 in external clock mode: the sensor output on PA0
+ *  (TIM2_CH1_ETR, AF1) clocks the counter itself, so edges are counted
+ *  with no CPU time and no interrupt per edge. The only interrupt is the
+ *  32-bit overflow, which extends the count to 64 bits.
+ *
+ *  COUNTER_ETR : external clock mode 2 (SMCR.ECE). Rising or falling
+ *                edges, optional /2, /4, /8 prescaler before the counter.
+ *                The edge rate after the prescaler must stay below a
+ *                quarter of the timer clock (21 MHz at 84 MHz).
+ *  COUNTER_TI1 : external clock mode 1 from TI1 (SMS = 111). Rising,
+ *                falling or both edges, no prescaler.
+ *
+ *  filter is the ETF / IC1F code of RM0368 (0 = off, 15 = 8 samples at
+ *  fDTS/32); it rejects glitches shorter than the filter window, not the
+ *  millisecond bounce of a mechanical contact.
+ *
+ *  PA0 gets the internal pull-up, as in interfacing_PIR_Sensor.
+ */
+
+#ifndef COUNTER_H_
+#define COUNTER_H_
+
+enum { COUNTER_ETR, COUNTER_TI1 };
+enum { COUNTER_RISING, COUNTER_FALLING, COUNTER_BOTH };
+
+struct counter_cfg
+{
+	unsigned char input;			//COUNTER_ETR / COUNTER_TI1
+	unsigned char edge;				//COUNTER_BOTH with COUNTER_TI1 only
+	unsigned char prescaler;		//COUNTER_ETR only: 0..3 = /1, /2, /4, /8
+	unsigned char filter;			//0..15
+};
+
+int counter_Init(const struct counter_cfg *cfg);	//-1: invalid combination
+unsigned long long counter_Count(void);				//edges since counter_Init
+unsigned int counter_Rate(void);					//edges per second since the last call
+void counter_Clear(void);
+
+#endif /* COUNTER_H_ */
@@ -0,0 +1,212 @@
+/**
+ ******************************************************************************
+ * @file    pulse_Count.c
+ * @author  Monish Kumar.k
+ * @date    14/04/2025
+ * @brief   PIR / IR sensor events counted by TIM2 in external clock mode,
+ *          with a benchmark of the highest countable rate against EXTI.
+ *
+ * @details
+ * Hardware Connections: sensor output on PA0 (as interfacing_PIR_Sensor).
+ * For the benchmark, a jumper from PA6 (TIM3_CH1, test signal) to PA0 and
+ * to PA1 (EXTI1). USART2 TX on PA2 for the log. Clock is 84 MHz.
+ *
+ * interfacing_PIR_Sensor and interfaceing_Ir_Sensor poll IDR, and the
+ * EXTI variants take an interrupt per edge, so fast edges are missed and
+ * every edge costs CPU time. counter.c lets TIM2 count them.
+ *
+ * Benchmark, for each frequency of bench_hz[]:
+ *  - TIM3 outputs a square wave on PA6 for BENCH_MS,
+ *  - TIM2 counts it on PA0 (ETR, rising, no prescaler and no filter),
+ *  - the EXTI1 handler counts it on PA1, one interrupt per rising edge,
+ *  - the main loop counts its own iterations for the same time; against
+ *    an idle run this gives the CPU time left to the application.
+ * The EXTI handler masks itself at the end of the window, so a rate it
+ * cannot keep up with still ends. Logged with LOG() and kept in bench[]:
+ * expected edges, TIM2 count, EXTI count, CPU left in %.
+ * At 21 MHz the ETR input is at its fCK_INT/4 limit; set the prescaler to
+ * /2 or more to count above it.
+ *
+ * Then TIM2 is set up for the sensor (rising edges, filter 15) and the
+ * count and rate are logged once per second.
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 14/04/2025
+  File : pulse_Count
+ ******************************************************************************/
+#include <arm.h>
+#include <rcc.h>
+#include <uart.h>
+#include <log.h>
+#include "counter.h"
+
+#define LOG_PORT		UART_2
+#define EXTI1_IRQ		7
+#define BENCH_MS		100
+
+struct bench_result
+{
+	unsigned int hz;
+	unsigned int expected;
+	unsigned int timer_count;
+	unsigned int exti_count;
+	unsigned int cpu_left;			//% of the idle main loop
+};
+
+static const unsigned int bench_hz[] =
+{
+	1000, 10000, 100000, 200000, 500000, 1000000, 2100000, 4200000, 10500000, 21000000,
+};
+#define BENCH_N		(sizeof(bench_hz) / sizeof(bench_hz[0]))
+
+static volatile unsigned int exti_count;
+static volatile unsigned int exti_start, exti_window;
+
+volatile struct bench_result bench[BENCH_N];
+
+void rcc_Config(void);
+void signal_Config(void);
+void exti_Config(void);
+unsigned int bench_Window(unsigned int hz);
+void bench_Run(void);
+
+int main(void)
+{
+	static const struct counter_cfg bench_cfg = { COUNTER_ETR, COUNTER_RISING, 0, 0 };
+	static const struct counter_cfg pir_cfg = { COUNTER_ETR, COUNTER_RISING, 0, 15 };
+	unsigned int last;
+
+	rcc_Config();
+	uart_Init(LOG_PORT, 921600);
+	log_Init();
+
+	counter_Init(&bench_cfg);
+	signal_Config();
+	exti_Config();
+	bench_Run();
+
+	counter_Init(&pir_cfg);
+	last = DWT->CYCCNT;
+	while(1)
+	{
+		if(DWT->CYCCNT - last >= rcc_Get_Sysclk())
+		{
+			unsigned long long count = counter_Count();
+
+			last += rcc_Get_Sysclk();
+			LOG("PA0: %u events, %u/s", (unsigned int)count, counter_Rate());
+		}
+		log_Drain(LOG_PORT);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* APB1 /2 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+/* TIM3 CH1 on PA6 (AF2), PWM mode 1, stopped; the frequency is set per run */
+void signal_Config()
+{
+	RCC->APB1ENR |= (1<<1);
+	GPIOA->AFRL  = (GPIOA->AFRL & ~(0xF<<24)) | (2<<24);
+	GPIOA->OSPEEDR |= (0x3<<12);
+	GPIOA->MODER = (GPIOA->MODER & ~(0x3<<12)) | (2<<12);
+
+	TIM3->CR1 = 0;
+	TIM3->PSC = 0;
+	TIM3->CCMR1 = (6<<4) | (1<<3);			/* OC1M = PWM 1, OC1PE */
+	TIM3->CCER = (1<<0);
+}
+
+/* PA1 rising edge on EXTI1, masked until a run starts */
+void exti_Config()
+{
+	RCC->APB2ENR |= (1<<14);
+	GPIOA->MODER &= ~(0x3<<2);
+	GPIOA->PUPDR &= ~(0x3<<2);
+	SYSCFG->EXTICR[0] &= ~(0xF<<4);
+	EXTI->RTSR |= (1<<1);
+	EXTI->IMR &= ~(1<<1);
+	EXTI->PR = (1<<1);
+	NVIC->IP[EXTI1_IRQ] = (6<<4);
+	NVIC->ISER[EXTI1_IRQ >> 5] = (1 << (EXTI1_IRQ & 31));
+}
+
+void EXTI1_IRQHandler()
+{
+	EXTI->PR = (1<<1);
+	exti_count++;
+	if(DWT->CYCCNT - exti_start >= exti_window)
+		EXTI->IMR &= ~(1<<1);				/* window over, let main() run */
+}
+
+/* one window of BENCH_MS; hz = 0 is the idle reference. Returns main loop spins */
+unsigned int bench_Window(unsigned int hz)
+{
+	unsigned int tim_clock = rcc_Get_Tim_Clock(1);
+	unsigned int window = rcc_Get_Sysclk() / 1000 * BENCH_MS;
+	unsigned int spins = 0, start;
+
+	if(hz)
+	{
+		TIM3->ARR = tim_clock / hz - 1;
+		TIM3->CCR1 = tim_clock / hz / 2;
+		TIM3->CNT = 0;
+		TIM3->EGR = (1<<0);
+	}
+	counter_Clear();
+	exti_count = 0;
+	exti_window = window;
+	start = DWT->CYCCNT;
+	exti_start = start;
+	if(hz)
+	{
+		EXTI->PR = (1<<1);
+		EXTI->IMR |= (1<<1);
+		TIM3->CR1 = (1<<0);
+	}
+	while(DWT->CYCCNT - start < window)
+	{
+		spins++;
+	}
+	TIM3->CR1 = 0;
+	EXTI->IMR &= ~(1<<1);
+	return spins;
+}
+
+void bench_Run()
+{
+	unsigned int idle = bench_Window(0);
+
+	for(unsigned int i = 0; i < BENCH_N; i++)
+	{
+		volatile struct bench_result *r = &bench[i];
+		unsigned int spins = bench_Window(bench_hz[i]);
+
+		r->hz = bench_hz[i];
+		r->expected = bench_hz[i] / 1000 * BENCH_MS;
+		r->timer_count = (unsigned int)counter_Count();
+		r->exti_count = exti_count;
+		r->cpu_left = idle ? (unsigned int)((unsigned long long)spins * 100 / idle) : 0;
+		LOG("%u Hz: expected %u, TIM2 %u, EXTI %u, CPU left %u%%",
+			r->hz, r->expected, r->timer_count, r->exti_count, r->cpu_left);
+		log_Drain(LOG_PORT);
+	}
+}
@@ -0,0 +1,204 @@
+/**
+ ******************************************************************************
+ * @file    pwm_Input.c
+ * @author  Monish Kumar.k
+ * @date    16/04/2025
+ * @brief   Frequency and duty of an external signal from TIM5 PWM input
+ *          mode, checked against a TIM3 reference from 1 Hz to 4.2 MHz.
+ *
+ * @details
+ * Hardware Connections: signal to measure on PA0. For the accuracy run a
+ * jumper from PA6 (TIM3_CH1, reference) to PA0. The PC15 output of
+ * manual_PWM on a second board can be measured the same way. USART2 TX on
+ * PA2 for the log. Clock is 84 MHz.
+ *
+ * Accuracy run, for each entry of ref[]:
+ *  - TIM3 makes the reference. Its frequency is exactly
+ *    timer clock / ((PSC+1) * (ARR+1)) and its duty CCR1 / (ARR+1),
+ *  - the third pwmin result after the change is taken, so the ranging
+ *    has settled,
+ *  - logged and kept in bench[]: measured frequency in mHz, error against
+ *    the reference in ppm, measured duty and error in 1/10000, capture
+ *    prescaler and captures per result, and the CPU cycles of the DMA
+ *    interrupt for that result, which is the whole CPU cost of one
+ *    measurement.
+ * After that the reference is left at 1 kHz 25 % and every result is
+ * logged.
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 16/04/2025
+  File : pwm_Input
+ ******************************************************************************/
+#include <arm.h>
+#include <rcc.h>
+#include <uart.h>
+#include <log.h>
+#include "pwmin.h"
+
+#define LOG_PORT		UART_2
+#define WAIT_MS			6000			//longest wait for one result: 1 Hz, third result
+
+struct ref_signal
+{
+	unsigned int hz;
+	unsigned int duty;					//%
+};
+
+struct bench_result
+{
+	unsigned int ref_mhz;				//reference, mHz (0 above 4.29 MHz)
+	unsigned int freq_mhz;
+	int freq_ppm;
+	unsigned int duty;					//1/10000
+	int duty_err;
+	unsigned int capture_psc;
+	unsigned int n;
+	unsigned int cycles;
+};
+
+static const struct ref_signal ref[] =
+{
+	{ 1, 50 }, { 10, 25 }, { 100, 75 }, { 1000, 25 }, { 10000, 50 },
+	{ 100000, 10 }, { 1000000, 50 }, { 2000000, 25 }, { 4200000, 50 },
+};
+#define REF_N		(sizeof(ref) / sizeof(ref[0]))
+
+volatile struct bench_result bench[REF_N];
+
+void rcc_Config(void);
+void ref_Config(void);
+unsigned long long ref_Set(const struct ref_signal *r, unsigned int *duty);
+int result_Wait(struct pwmin_result *r, unsigned int count);
+void bench_Run(void);
+
+int main(void)
+{
+	static const struct ref_signal idle = { 1000, 25 };
+	struct pwmin_result r;
+	unsigned int duty;
+
+	rcc_Config();
+	uart_Init(LOG_PORT, 921600);
+	log_Init();
+	ref_Config();
+	pwmin_Init();
+	bench_Run();
+
+	ref_Set(&idle, &duty);
+	while(1)
+	{
+		if(pwmin_Get(&r))
+		{
+			unsigned long long mhz = pwmin_Freq_mHz(&r);
+
+			LOG("PA0: %u.%03u Hz, duty %u/10000, %u captures", (unsigned int)(mhz / 1000),
+				(unsigned int)(mhz % 1000), pwmin_Duty(&r), r.n);
+		}
+		log_Drain(LOG_PORT);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* APB1 /2 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+/* TIM3 CH1 on PA6 (AF2), PWM mode 1 */
+void ref_Config()
+{
+	RCC->AHB1ENR |= (1<<0);
+	RCC->APB1ENR |= (1<<1);
+	GPIOA->AFRL  = (GPIOA->AFRL & ~(0xF<<24)) | (2<<24);
+	GPIOA->OSPEEDR |= (0x3<<12);
+	GPIOA->MODER = (GPIOA->MODER & ~(0x3<<12)) | (2<<12);
+
+	TIM3->CR1 = 0;
+	TIM3->CCMR1 = (6<<4) | (1<<3);			/* OC1M = PWM 1, OC1PE */
+	TIM3->CCER = (1<<0);
+}
+
+/* smallest PSC that fits the 16-bit ARR; returns the exact frequency in mHz */
+unsigned long long ref_Set(const struct ref_signal *r, unsigned int *duty)
+{
+	unsigned int tim_clock = rcc_Get_Tim_Clock(1);
+	unsigned int ticks = tim_clock / r->hz;
+	unsigned int psc = (ticks - 1) / 65536;
+	unsigned int arr = tim_clock / (psc + 1) / r->hz;
+	unsigned int ccr = arr * r->duty / 100;
+
+	TIM3->CR1 = 0;
+	TIM3->PSC = psc;
+	TIM3->ARR = arr - 1;
+	TIM3->CCR1 = ccr;
+	TIM3->CNT = 0;
+	TIM3->EGR = (1<<0);
+	TIM3->CR1 = (1<<7) | (1<<0);			/* ARPE, CEN */
+
+	*duty = (unsigned int)((unsigned long long)ccr * 10000 / arr);
+	return (unsigned long long)tim_clock * 1000 / ((unsigned long long)(psc + 1) * arr);
+}
+
+/* the count-th result from now, 0 on time-out */
+int result_Wait(struct pwmin_result *r, unsigned int count)
+{
+	unsigned int start = DWT->CYCCNT;
+	unsigned int limit = rcc_Get_Sysclk() / 1000 * WAIT_MS;
+
+	while(count)
+	{
+		if(DWT->CYCCNT - start >= limit)
+			return 0;
+		if(pwmin_Get(r))
+			count--;
+	}
+	return 1;
+}
+
+void bench_Run()
+{
+	struct pwmin_result r;
+
+	for(unsigned int i = 0; i < REF_N; i++)
+	{
+		volatile struct bench_result *b = &bench[i];
+		unsigned int ref_duty;
+		unsigned long long ref_mhz = ref_Set(&ref[i], &ref_duty);
+		unsigned long long mhz;
+
+		if(!result_Wait(&r, 3))
+		{
+			LOG("%u Hz: no result", ref[i].hz);
+			log_Drain(LOG_PORT);
+			continue;
+		}
+		mhz = pwmin_Freq_mHz(&r);
+		b->ref_mhz = (ref_mhz > 0xFFFFFFFF) ? 0 : (unsigned int)ref_mhz;
+		b->freq_mhz = (mhz > 0xFFFFFFFF) ? 0 : (unsigned int)mhz;
+		b->freq_ppm = (int)(((long long)mhz - (long long)ref_mhz) * 1000000 / (long long)ref_mhz);
+		b->duty = pwmin_Duty(&r);
+		b->duty_err = (int)b->duty - (int)ref_duty;
+		b->capture_psc = r.capture_psc;
+		b->n = r.n;
+		b->cycles = r.cycles;
+		LOG("%u Hz: measured %u.%03u Hz (%d ppm), duty %u/10000 (%d), capture /%u, %u per result, %u cycles",
+			ref[i].hz, (unsigned int)(mhz / 1000), (unsigned int)(mhz % 1000), b->freq_ppm,
+			b->duty, b->duty_err, b->capture_psc, b->n, b->cycles);
+		log_Drain(LOG_PORT);
+	}
+}
@@ -0,0 +1,206 @@
+/**
+ ******************************************************************************
+ * @file    pwmin.c
+ * @author  Monish Kumar.k
+ * @date    16/04/2025
+ * @brief   PWM input measurement on TIM5 CH1/CH2 with DMA burst reads of
+ *          CCR1/CCR2 and block averaging in the DMA interrupt.
+ *
+ * @details
+ *  - DCR: DBA = CCR1, DBL = 2 transfers. Each CC1 capture (CC1DE) makes
+ *    DMA1 Stream2 channel 6 read DMAR twice, which gives CCR1 then CCR2.
+ *    CCR2 (falling edge, IC2 prescaler /1) always holds the high time of
+ *    the period that CCR1 just closed.
+ *  - The capture prescaler only thins out the captures: the slave reset
+ *    takes TI1FP1 before the prescaler, so CCR1 is still one period.
+ *  - When the range changes, the block length changes too; TIM5 is put
+ *    through its RCC reset and set up again, which also resets the DMA
+ *    burst position of the timer. The first capture after that is
+ *    measured from the counter enable, not from an edge, and is dropped.
+ *  - URS = 1: the slave reset does not set UIF, so an update interrupt
+ *    means the counter reached ARR (PWMIN_TIMEOUT_MS) without an edge.
+ ******************************************************************************
+ */
+#include <arm.h>
+#include <rcc.h>
+#include "pwmin.h"
+
+#define TIM5_IRQ		50
+#define DMA1_S2_IRQ		13
+#define IN_DMA			(&DMA1->S[2])
+#define IN_DMA_SHIFT	16				//stream 2 flags in LISR/LIFCR
+#define TIM_DBA_CCR1	13				//0x34 / 4
+
+static unsigned int dma_buf[2 * PWMIN_BLOCK][2];		//two halves of block_n [CCR1, CCR2]
+static unsigned int block_n;
+static unsigned int capture_psc;
+static unsigned int skip;
+
+static struct pwmin_result result;
+static volatile unsigned int result_seq;
+static unsigned int read_seq;
+
+static void pwmin_Start(unsigned int psc, unsigned int n)
+{
+	volatile struct dma_stream *s = IN_DMA;
+	unsigned int tick_hz = rcc_Get_Tim_Clock(1);
+	unsigned int icpsc = (psc == 8) ? 3 : (psc == 4) ? 2 : (psc == 2) ? 1 : 0;
+
+	s->CR = 0;
+	while(s->CR & (1<<0));
+	DMA1->LIFCR = 0x3D << IN_DMA_SHIFT;
+
+	RCC->APB1RSTR |= (1<<3);			//TIM5, clears the burst state too
+	RCC->APB1RSTR &= ~(1<<3);
+
+	block_n = n;
+	capture_psc = psc;
+	skip = 1;
+
+	TIM5->PSC = 0;
+	TIM5->ARR = tick_hz / 1000 * PWMIN_TIMEOUT_MS;
+	TIM5->CR1 = (1<<2);								/* URS */
+	TIM5->CCMR1 = (2<<8) | (icpsc<<2) | (1<<0);		/* CC2S = TI1, IC1PSC, CC1S = TI1 */
+	TIM5->CCER = (1<<5) | (1<<4) | (1<<0);			/* CC2P falling, CC2E, CC1E rising */
+	TIM5->SMCR = (5<<4) | (4<<0);					/* TS = TI1FP1, SMS = reset */
+	TIM5->DCR = (1<<8) | TIM_DBA_CCR1;				/* DBL = 2 transfers, DBA = CCR1 */
+	TIM5->EGR = (1<<0);
+	TIM5->SR = 0;
+
+	s->PAR  = (unsigned int)&TIM5->DMAR;
+	s->M0AR = (unsigned int)dma_buf;
+	s->NDTR = 2 * n * 2;							/* two halves of n captures */
+	s->FCR  = 0;
+	s->CR   = (6<<25) | (2<<16) | (2<<13) | (2<<11) | (1<<10) | (1<<8) | (1<<4) | (1<<3) | (1<<2);
+			//CH6, PL high, MSIZE/PSIZE 32 bit, MINC, CIRC, P->M, TCIE, HTIE, TEIE
+	s->CR  |= (1<<0);
+
+	TIM5->DIER = (1<<9) | (1<<0);					/* CC1DE, UIE */
+	TIM5->CR1 |= (1<<0);
+}
+
+void pwmin_Init()
+{
+	RCC->AHB1ENR |= (1<<0) | (1<<21);				/* GPIOA, DMA1 */
+	RCC->APB1ENR |= (1<<3);
+	GPIOA->PUPDR &= ~(0x3<<0);
+	GPIOA->AFRL  = (GPIOA->AFRL & ~(0xF<<0)) | (2<<0);	/* AF2, TIM5_CH1 */
+	GPIOA->MODER = (GPIOA->MODER & ~(0x3<<0)) | (2<<0);
+
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);
+
+	NVIC->IP[DMA1_S2_IRQ] = (5<<4);
+	NVIC->IP[TIM5_IRQ] = (5<<4);					//same level: never nest with each other
+	NVIC->ISER[DMA1_S2_IRQ >> 5] = (1 << (DMA1_S2_IRQ & 31));
+	NVIC->ISER[TIM5_IRQ >> 5] = (1 << (TIM5_IRQ & 31));
+
+	pwmin_Start(1, 1);
+}
+
+static void pwmin_Publish(unsigned long long period, unsigned long long width,
+						  unsigned int n, unsigned int start)
+{
+	result.period_sum = period;
+	result.width_sum = width;
+	result.n = n;
+	result.level = n ? 0 : (GPIOA->IDR & 1);
+	result.tick_hz = rcc_Get_Tim_Clock(1);
+	result.capture_psc = capture_psc;
+	result.cycles = DWT->CYCCNT - start;
+	result.seq = result_seq + 1;
+	result_seq = result.seq;
+}
+
+/* new capture prescaler and block length for a signal of period 'ticks' */
+static void pwmin_Range(unsigned int ticks)
+{
+	unsigned int tick_hz = rcc_Get_Tim_Clock(1);
+	unsigned int psc = 1, n;
+
+	while(psc < 8 && (unsigned long long)ticks * psc * PWMIN_CAPTURE_HZ < tick_hz)
+		psc <<= 1;
+	n = (unsigned int)((unsigned long long)tick_hz / 1000 * PWMIN_BLOCK_MS / ((unsigned long long)ticks * psc));
+	if(n < 1)
+		n = 1;
+	if(n > PWMIN_BLOCK)
+		n = PWMIN_BLOCK;
+
+	/* keep the block length unless it is off by more than a factor 2 */
+	if(psc != capture_psc || n > 2 * block_n || 2 * n < block_n)
+		pwmin_Start(psc, n);
+}
+
+void DMA1_Stream2_IRQHandler()
+{
+	unsigned int start = DWT->CYCCNT;
+	unsigned int flags = (DMA1->LISR >> IN_DMA_SHIFT) & 0x3D;
+	unsigned long long period = 0, width = 0;
+	unsigned int (*half)[2];
+	unsigned int i, n;
+
+	DMA1->LIFCR = flags << IN_DMA_SHIFT;
+	if(flags & (1<<3))
+	{
+		pwmin_Start(1, 1);							/* transfer error */
+		return;
+	}
+	if(!(flags & ((1<<5) | (1<<4))))
+		return;
+
+	n = block_n;
+	half = &dma_buf[(flags & (1<<5)) ? n : 0];		/* TC: second half done, HT: first */
+	for(i = skip; i < n; i++)
+	{
+		period += half[i][0];
+		width  += half[i][1];
+	}
+	n -= skip;
+	skip = 0;
+	if(!n || !period)
+		return;
+
+	pwmin_Publish(period, width, n, start);
+	pwmin_Range((unsigned int)(period / n));
+}
+
+/* no rising edge for PWMIN_TIMEOUT_MS */
+void TIM5_IRQHandler()
+{
+	unsigned int start = DWT->CYCCNT;
+
+	TIM5->SR = ~(1<<0);								//rc_w0
+	pwmin_Publish(0, 0, 0, start);
+	skip = 1;										//the next CCR1 counts from the wrap
+	if(capture_psc != 1 || block_n != 1)
+		pwmin_Start(1, 1);
+}
+
+int pwmin_Get(struct pwmin_result *r)
+{
+	unsigned int seq;
+
+	do
+	{
+		seq = result_seq;
+		*r = result;
+	} while(seq != result_seq || r->seq != seq);	//copied while the interrupt wrote it
+	if(seq == read_seq)
+		return 0;
+	read_seq = seq;
+	return 1;
+}
+
+unsigned long long pwmin_Freq_mHz(const struct pwmin_result *r)
+{
+	if(!r->n || !r->period_sum)
+		return 0;
+	return (unsigned long long)r->tick_hz * 1000 * r->n / r->period_sum;
+}
+
+unsigned int pwmin_Duty(const struct pwmin_result *r)
+{
+	if(!r->n || !r->period_sum)
+		return r->level ? 10000 : 0;
+	return (unsigned int)(r->width_sum * 10000 / r->period_sum);
+}
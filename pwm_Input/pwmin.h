@@ -0,0 +1,52 @@
+/*
+ * pwmin.h
+ *
+ *  Created on: Apr 16, 2025
+ *      Author: moni
+ *
+ *  Frequency and duty of the signal on PA0 (TIM5_CH1, AF2) in PWM input
+ *  mode: TI1 rising edges capture the period into CCR1 and reset the
+ *  counter (slave reset mode), TI1 falling edges capture the high time
+ *  into CCR2. Every CC1 capture starts a two-word DMA burst (DMAR,
+ *  CCR1 then CCR2) into a circular buffer; the half/complete interrupt
+ *  adds up one block of captures and publishes the result.
+ *
+ *  Ranging: TIM5 is 32 bits wide and runs at the timer clock (84 MHz), so
+ *  one period of 1 Hz still fits without a prescaler and the resolution
+ *  stays at one timer clock. What is ranged is the load: the capture
+ *  prescaler keeps the capture rate below PWMIN_CAPTURE_HZ, and the block
+ *  length gives about one result per PWMIN_BLOCK_MS. Below 0.5 Hz (no
+ *  rising edge for PWMIN_TIMEOUT_MS) the result has n = 0 and the duty of
+ *  the static level.
+ *
+ *  Resolution is one timer clock per period: 1/84 of a period at 1 MHz,
+ *  averaged down over the block when the signal is not locked to the
+ *  timer clock.
+ */
+
+#ifndef PWMIN_H_
+#define PWMIN_H_
+
+#define PWMIN_BLOCK			64			//captures per block, most
+#define PWMIN_CAPTURE_HZ	250000		//captures per second, most
+#define PWMIN_BLOCK_MS		100
+#define PWMIN_TIMEOUT_MS	2000
+
+struct pwmin_result
+{
+	unsigned long long period_sum;		//timer clocks over n periods
+	unsigned long long width_sum;		//timer clocks high over the same periods
+	unsigned int n;						//0: no edge for PWMIN_TIMEOUT_MS
+	unsigned int level;					//n = 0: static level of the input
+	unsigned int tick_hz;
+	unsigned int capture_psc;			//1, 2, 4 or 8: periods per capture
+	unsigned int cycles;				//CPU cycles of the interrupt that made it
+	unsigned int seq;
+};
+
+void pwmin_Init(void);
+int  pwmin_Get(struct pwmin_result *r);		//1: a result newer than the last one read
+unsigned long long pwmin_Freq_mHz(const struct pwmin_result *r);
+unsigned int pwmin_Duty(const struct pwmin_result *r);		//1/10000
+
+#endif /* PWMIN_H_ */
@@ -0,0 +1,335 @@
+/**
+ ******************************************************************************
+ * @file    encoder.c
+ * @author  Monish Kumar.k
+ * @date    24/04/2025
+ * @brief   Quadrature encoder in timer encoder mode, with an EXTI-per-edge
+ *          fallback, overflow extension, velocity and index.
+ *
+ * @details
+ *  - Timer backends: CC1S = CC2S = 01 (TI1FP1, TI2FP2), IC1F = IC2F =
+ *    filter, SMS = 011 (x4) or 001 (x2, edges of A), ARR at the maximum.
+ *    The counter runs free; nothing happens per edge.
+ *  - The TIM10 sample tick reads CNT, adds the signed difference to the
+ *    last reading (16 or 32 bits) to the 64-bit position and stores the
+ *    position in the history. encoder_Position() does the same step with
+ *    interrupts masked, so it is exact between ticks too.
+ *  - Velocity: the shortest window of 1, 2, 4, .. ENC_VEL_DEPTH - 1 ticks
+ *    that has moved ENC_VEL_COUNTS, so a fast encoder is reported with a
+ *    short delay and a slow one still gets a few counts of resolution.
+ *  - EXTI backend: both edges of A and B interrupt; the handler reads
+ *    both pins from IDR and looks the old and new state up in enc_step[].
+ ******************************************************************************
+ */
+#include <arm.h>
+#include <rcc.h>
+#include "encoder.h"
+
+#define TIM10_IRQ		25
+#define GPIO(port)		((volatile struct gpio*)(0x40020000UL + (port) * 0x400))
+#define ENC_BAD			2
+#define VEL_MASK		(ENC_VEL_DEPTH - 1)
+
+struct enc_timer
+{
+	volatile struct timer *tim;
+	unsigned char port, pin_a, pin_b, af, apb1_bit, wide;
+};
+
+static const struct enc_timer enc_timers[3] =
+{
+	{ TIM2, 0, 0, 1, 1, 0, 1 },				/* PA0, PA1 */
+	{ TIM3, 0, 6, 7, 2, 1, 0 },				/* PA6, PA7 */
+	{ TIM4, 1, 6, 7, 2, 2, 0 },				/* PB6, PB7 */
+};
+
+/* [old << 2 | new], state = B << 1 | A: +1 when A leads B, ENC_BAD when both changed */
+static const signed char enc_step[16] =
+{
+	0,       +1,      -1,      ENC_BAD,
+	-1,      0,       ENC_BAD, +1,
+	+1,      ENC_BAD, 0,       -1,
+	ENC_BAD, -1,      +1,      0,
+};
+
+static const unsigned char exti_irq[16] = { 6, 7, 8, 9, 10, 23, 23, 23, 23, 23, 40, 40, 40, 40, 40, 40 };
+
+static struct encoder *enc_list[ENC_MAX];
+static unsigned int enc_count;
+static struct encoder *enc_exti[16];		//owner of each EXTI line
+static unsigned int enc_lines;				//EXTI lines in use
+static unsigned int enc_index_lines;		//of those, index inputs
+
+#if defined(__arm__)
+static inline unsigned int irq_Save(void)
+{
+	unsigned int primask;
+
+	__asm volatile("mrs %0, primask\n\tcpsid i" : "=r"(primask) : : "memory");
+	return primask;
+}
+
+static inline void irq_Restore(unsigned int primask)
+{
+	__asm volatile("msr primask, %0" : : "r"(primask) : "memory");
+}
+#else
+/* host build (encoder_Test.c): the simulated interrupts only run between calls */
+static inline unsigned int irq_Save(void)			{ return 0; }
+static inline void irq_Restore(unsigned int primask)	{ (void)primask; }
+#endif
+
+static void gpio_Input(unsigned int port, unsigned int pin)
+{
+	volatile struct gpio *g = GPIO(port);
+
+	RCC->AHB1ENR |= (1 << port);
+	g->MODER &= ~(0x3 << (pin*2));
+	g->PUPDR = (g->PUPDR & ~(0x3 << (pin*2))) | (1 << (pin*2));		/* pull-up, for open contacts */
+}
+
+static void gpio_Af(unsigned int port, unsigned int pin, unsigned int af)
+{
+	volatile struct gpio *g = GPIO(port);
+	volatile unsigned int *afr = (pin < 8) ? &g->AFRL : &g->AFRH;
+
+	gpio_Input(port, pin);
+	*afr = (*afr & ~(0xF << ((pin & 7)*4))) | (af << ((pin & 7)*4));
+	g->MODER |= (2 << (pin*2));
+}
+
+static void exti_Line(struct encoder *e, unsigned int line, unsigned int port, unsigned int both)
+{
+	unsigned int bit = 1u << line;
+
+	SYSCFG->EXTICR[line >> 2] = (SYSCFG->EXTICR[line >> 2] & ~(0xF << ((line & 3)*4))) | (port << ((line & 3)*4));
+	EXTI->RTSR |= bit;
+	EXTI->FTSR = both ? (EXTI->FTSR | bit) : (EXTI->FTSR & ~bit);
+	EXTI->PR = bit;
+	enc_exti[line] = e;
+	enc_lines |= bit;
+	EXTI->IMR |= bit;
+	NVIC->IP[exti_irq[line]] = (ENC_PRIORITY<<4);
+	NVIC->ISER[exti_irq[line] >> 5] = (1 << (exti_irq[line] & 31));
+}
+
+static void tick_Start(void)
+{
+	RCC->APB2ENR |= (1<<17);
+	TIM10->CR1 = 0;
+	TIM10->PSC = rcc_Get_Tim_Clock(2) / 1000000 - 1;		/* 1 MHz */
+	TIM10->ARR = 1000000 / ENC_SAMPLE_HZ - 1;
+	TIM10->EGR = (1<<0);
+	TIM10->SR = 0;
+	TIM10->DIER = (1<<0);
+	NVIC->IP[TIM10_IRQ] = (ENC_PRIORITY<<4);
+	NVIC->ISER[TIM10_IRQ >> 5] = (1 << (TIM10_IRQ & 31));
+	TIM10->CR1 = (1<<0);
+}
+
+static int cfg_Check(const struct enc_cfg *cfg)
+{
+	if(cfg->backend > ENC_EXTI || cfg->mode > ENC_X2 || cfg->filter > 15)
+		return -1;
+	if(cfg->index_pin > 15 || (cfg->index_pin >= 0 && cfg->index_port > 2))
+		return -1;
+	if(cfg->backend == ENC_EXTI)
+	{
+		if(cfg->port > 2 || cfg->pin_a > 15 || cfg->pin_b > 15 || cfg->pin_a == cfg->pin_b)
+			return -1;
+		if(enc_lines & ((1u << cfg->pin_a) | (1u << cfg->pin_b)))
+			return -1;
+		if(cfg->index_pin == cfg->pin_a || cfg->index_pin == cfg->pin_b)
+			return -1;
+	}
+	else
+	{
+		for(unsigned int i = 0; i < enc_count; i++)
+		{
+			if(enc_list[i]->cfg.backend == cfg->backend)
+				return -1;
+		}
+	}
+	if(cfg->index_pin >= 0 && (enc_lines & (1u << cfg->index_pin)))
+		return -1;
+	return 0;
+}
+
+int encoder_Init(struct encoder *e, const struct enc_cfg *cfg)
+{
+	unsigned int primask;
+
+	if(enc_count >= ENC_MAX || cfg_Check(cfg))
+		return -1;
+	*e = (struct encoder){ 0 };
+	e->cfg = *cfg;
+	RCC->APB2ENR |= (1<<14);				/* SYSCFG */
+
+	if(cfg->backend == ENC_EXTI)
+	{
+		volatile struct gpio *g = GPIO(cfg->port);
+
+		gpio_Input(cfg->port, cfg->pin_a);
+		gpio_Input(cfg->port, cfg->pin_b);
+		e->state = (((g->IDR >> cfg->pin_b) & 1) << 1) | ((g->IDR >> cfg->pin_a) & 1);
+		exti_Line(e, cfg->pin_a, cfg->port, 1);
+		exti_Line(e, cfg->pin_b, cfg->port, 1);
+	}
+	else
+	{
+		const struct enc_timer *t = &enc_timers[cfg->backend];
+		volatile struct timer *tim = t->tim;
+
+		RCC->APB1ENR |= (1 << t->apb1_bit);
+		gpio_Af(t->port, t->pin_a, t->af);
+		gpio_Af(t->port, t->pin_b, t->af);
+		tim->CR1 = 0;
+		tim->SMCR = 0;
+		tim->CCER = 0;
+		tim->CCMR1 = (cfg->filter<<12) | (1<<8) | (cfg->filter<<4) | (1<<0);	/* IC2F, CC2S = TI2, IC1F, CC1S = TI1 */
+		tim->CCER = cfg->invert ? (1<<1) : 0;							/* CC1P inverts TI1, the direction */
+		tim->SMCR = (cfg->mode == ENC_X4) ? (3<<0) : (1<<0);
+		tim->PSC = 0;
+		tim->ARR = t->wide ? 0xFFFFFFFF : 0xFFFF;
+		tim->CNT = 0;
+		tim->CR1 = (1<<0);
+		e->tim = tim;
+		e->wide = t->wide;
+	}
+	if(cfg->index_pin >= 0)
+	{
+		gpio_Input(cfg->index_port, cfg->index_pin);
+		enc_index_lines |= (1u << cfg->index_pin);
+		exti_Line(e, cfg->index_pin, cfg->index_port, 0);
+	}
+
+	primask = irq_Save();
+	enc_list[enc_count++] = e;
+	irq_Restore(primask);
+	if(enc_count == 1)
+		tick_Start();
+	return 0;
+}
+
+/* raw position, interrupts masked or in a handler of ENC_PRIORITY */
+static long long enc_Read(struct encoder *e)
+{
+	unsigned int cnt, diff;
+
+	if(!e->tim)
+		return e->base;
+	cnt = e->tim->CNT;
+	diff = cnt - e->last_cnt;
+	e->last_cnt = cnt;
+	e->base += e->wide ? (int)diff : (short)diff;
+	return e->base;
+}
+
+long long encoder_Position(struct encoder *e)
+{
+	unsigned int primask = irq_Save();
+	long long pos = enc_Read(e) - e->offset;
+
+	irq_Restore(primask);
+	return pos;
+}
+
+int encoder_Velocity(struct encoder *e)
+{
+	return e->velocity;
+}
+
+unsigned int encoder_Index(struct encoder *e, long long *pos)
+{
+	unsigned int primask = irq_Save();
+	unsigned int count = e->index_count;
+
+	if(pos)
+		*pos = e->index_pos;
+	irq_Restore(primask);
+	return count;
+}
+
+unsigned int encoder_Errors(struct encoder *e)
+{
+	return e->errors;
+}
+
+static void enc_Sample(struct encoder *e)
+{
+	unsigned int n = e->samples;
+	unsigned int span = (n < ENC_VEL_DEPTH) ? n : ENC_VEL_DEPTH - 1;
+	long long now = enc_Read(e), d = 0;
+	unsigned int w = 1;
+
+	e->hist[n & VEL_MASK] = now;
+	e->samples = n + 1;
+	if(!span)
+		return;
+	while(1)
+	{
+		d = now - e->hist[(n - w) & VEL_MASK];
+		if(w == span || d >= ENC_VEL_COUNTS || d <= -ENC_VEL_COUNTS)
+			break;
+		w = (w*2 < span) ? w*2 : span;
+	}
+	e->velocity = (int)(d * ENC_SAMPLE_HZ / w);
+}
+
+void TIM1_UP_TIM10_IRQHandler()
+{
+	TIM10->SR = ~(1<<0);					//rc_w0
+	for(unsigned int i = 0; i < enc_count; i++)
+	{
+		enc_Sample(enc_list[i]);
+	}
+}
+
+static void enc_Edge(struct encoder *e)
+{
+	unsigned int idr = GPIO(e->cfg.port)->IDR;
+	unsigned int s = (((idr >> e->cfg.pin_b) & 1) << 1) | ((idr >> e->cfg.pin_a) & 1);
+	int d = enc_step[(e->state << 2) | s];
+
+	e->state = s;
+	if(d == ENC_BAD)
+		e->errors++;
+	else
+		e->base += e->cfg.invert ? -d : d;
+}
+
+static void enc_Index(struct encoder *e)
+{
+	long long pos = enc_Read(e);
+
+	e->index_pos = pos - e->offset;
+	e->index_count++;
+	if(e->cfg.flags & ENC_INDEX_ZERO)
+		e->offset = pos;
+}
+
+/* lines: the EXTI lines of the vector that was taken */
+static void enc_Exti(unsigned int lines)
+{
+	unsigned int pr = EXTI->PR & lines & enc_lines;
+
+	EXTI->PR = pr;
+	while(pr)
+	{
+		unsigned int line = __builtin_ctz(pr);
+
+		pr &= pr - 1;
+		if(enc_index_lines & (1u << line))
+			enc_Index(enc_exti[line]);
+		else
+			enc_Edge(enc_exti[line]);
+	}
+}
+
+void EXTI0_IRQHandler()			{ enc_Exti(1<<0); }
+void EXTI1_IRQHandler()			{ enc_Exti(1<<1); }
+void EXTI2_IRQHandler()			{ enc_Exti(1<<2); }
+void EXTI3_IRQHandler()			{ enc_Exti(1<<3); }
+void EXTI4_IRQHandler()			{ enc_Exti(1<<4); }
+void EXTI9_5_IRQHandler()		{ enc_Exti(0x03E0); }
+void EXTI15_10_IRQHandler()		{ enc_Exti(0xFC00); }
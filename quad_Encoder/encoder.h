@@ -0,0 +1,84 @@
+/*
+ * encoder.h
+ *
+ *  Created on: Apr 24, 2025
+ *      Author: moni
+ *
+ *  Quadrature encoder input.
+ *
+ *  Timer backends count in hardware, in encoder interface mode
+ *  (SMCR.SMS = 011 for x4, 001 for x2), with the IC1F/IC2F input filter:
+ *    ENC_TIM2 : A = PA0, B = PA1 (AF1), 32-bit counter
+ *    ENC_TIM3 : A = PA6, B = PA7 (AF2), 16-bit counter
+ *    ENC_TIM4 : A = PB6, B = PB7 (AF2), 16-bit counter
+ *  No interrupt per edge. A sample tick (TIM10, ENC_SAMPLE_HZ) adds the
+ *  signed counter difference to a 64-bit position, which extends a 16-bit
+ *  counter as long as fewer than 32768 edges arrive per tick (32 MHz at
+ *  1 kHz). The same tick keeps the position history for the velocity.
+ *
+ *  ENC_EXTI is the fallback for any two pins of one port: one interrupt
+ *  per edge on both lines, a 16-entry transition table, x4 only.
+ *  Transitions with both inputs changed (a missed edge) are counted in
+ *  errors and not in the position.
+ *
+ *  Direction: position goes up when A leads B, the same for every
+ *  backend; 'invert' swaps it.
+ *
+ *  Index: optional EXTI rising edge on index_pin, latches the position
+ *  and, with ENC_INDEX_ZERO, makes that point position 0.
+ *
+ *  The driver owns TIM10 and the EXTI lines it is given. Its interrupts
+ *  share ENC_PRIORITY.
+ */
+
+#ifndef ENCODER_H_
+#define ENCODER_H_
+
+#define ENC_MAX				4
+#define ENC_SAMPLE_HZ		1000
+#define ENC_VEL_DEPTH		64			//samples of history, power of two
+#define ENC_VEL_COUNTS		64			//shortest window with at least this many counts
+#define ENC_PRIORITY		5
+
+enum { ENC_TIM2, ENC_TIM3, ENC_TIM4, ENC_EXTI };
+enum { ENC_X4, ENC_X2 };
+
+#define ENC_INDEX_ZERO		(1<<0)
+
+struct enc_cfg
+{
+	unsigned char backend;
+	unsigned char mode;					//timer backends only
+	unsigned char filter;				//timer backends: IC1F/IC2F, 0..15
+	unsigned char invert;
+	unsigned char port;					//ENC_EXTI: port of A and B, 0 = A
+	unsigned char pin_a, pin_b;			//ENC_EXTI
+	signed char index_pin;				//-1: no index
+	unsigned char index_port;
+	unsigned char flags;
+};
+
+struct encoder
+{
+	struct enc_cfg cfg;
+	volatile struct timer *tim;
+	unsigned int wide;					//32-bit counter
+	long long base;						//position at last_cnt
+	unsigned int last_cnt;
+	long long offset;					//subtracted, set by ENC_INDEX_ZERO
+	long long hist[ENC_VEL_DEPTH];
+	unsigned int samples;
+	int velocity;						//counts/s
+	unsigned int state;					//ENC_EXTI: B << 1 | A
+	unsigned int errors;
+	long long index_pos;
+	unsigned int index_count;
+};
+
+int  encoder_Init(struct encoder *e, const struct enc_cfg *cfg);	//-1: bad config or no room
+long long encoder_Position(struct encoder *e);
+int  encoder_Velocity(struct encoder *e);							//counts/s
+unsigned int encoder_Index(struct encoder *e, long long *pos);		//index pulses, last latched position
+unsigned int encoder_Errors(struct encoder *e);
+
+#endif /* ENCODER_H_ */
@@ -0,0 +1,295 @@
+/**
+ ******************************************************************************
+ * @file    encoder_Test.c
+ * @author  Monish Kumar.k
+ * @date    24/04/2025
+ * @brief   Host check of the quadrature encoder driver on fake registers:
+ *          transition table, counter extension, index and velocity.
+ *
+ * @details
+ * Build and run on the host (Linux x86-64, the register blocks are mapped
+ * at their STM32 addresses):
+ *
+ *     gcc -O2 -I../manual_PWM -o encoder_Test encoder_Test.c && ./encoder_Test
+ *
+ * encoder.c is included unmodified. Four encoders: TIM3 (16 bit), TIM2
+ * (32 bit), EXTI on PA2/PA3 with an ENC_INDEX_ZERO index on PB0, and EXTI
+ * on PC4/PC5 inverted.
+ *  - enc_step[] against the Gray code walk 00 -> 01 -> 11 -> 10 (A leads
+ *    B): +1 forward, -1 backward, 0 unchanged, ENC_BAD for both changed.
+ *  - EXTI: a random walk of single steps in both directions and double
+ *    steps on the pins, one vector per changed line as on the chip. The
+ *    position follows the single steps (negated when inverted) and every
+ *    double step is one error.
+ *  - TIM3/TIM2: CNT moves by random steps below 32768 (16 bit) or 2^31
+ *    (32 bit) in both directions, across 0xFFFF -> 0, 0 -> 0xFFFF and the
+ *    32-bit wrap, with encoder_Position() or a sample tick in between: the
+ *    64-bit position is the sum of the steps.
+ *  - index: the latched position, the count, and with ENC_INDEX_ZERO the
+ *    position counted from the index.
+ *  - velocity: constant rates from 1 count per 10 ticks to 5000 per tick
+ *    and both directions give the count over the shortest power-of-two
+ *    window (up to ENC_VEL_DEPTH - 1 ticks, fewer right after the start)
+ *    with at least ENC_VEL_COUNTS, in counts/s.
+ * Exits non-zero on a failure.
+ ******************************************************************************
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+unsigned int rcc_Get_Tim_Clock(int bus)			{ (void)bus; return 84000000; }
+
+#include "encoder.c"
+
+#define WALK_STEPS		200000
+#define WRAP_STEPS		200000
+
+static struct encoder enc_tim3, enc_tim2, enc_a, enc_c;
+static unsigned int failures;
+
+static void fail(const char *what, long long a, long long b)
+{
+	if(failures++ < 20)
+		printf("FAIL %s (%lld, %lld)\n", what, a, b);
+}
+
+static void map(unsigned long addr, unsigned long len)
+{
+	if(mmap((void *)addr, len, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED)
+	{
+		perror("mmap");
+		exit(2);
+	}
+}
+
+/* one EXTI line pending, its vector taken */
+static void exti(unsigned int line)
+{
+	EXTI->PR = 1u << line;
+	switch(line)
+	{
+	case 0:		EXTI0_IRQHandler();			break;
+	case 1:		EXTI1_IRQHandler();			break;
+	case 2:		EXTI2_IRQHandler();			break;
+	case 3:		EXTI3_IRQHandler();			break;
+	case 4:		EXTI4_IRQHandler();			break;
+	default:	(line < 10) ? EXTI9_5_IRQHandler() : EXTI15_10_IRQHandler();	break;
+	}
+	EXTI->PR = 0;
+}
+
+static void tick(void)
+{
+	TIM10->SR |= 1;
+	TIM1_UP_TIM10_IRQHandler();
+}
+
+static void test_Table(void)
+{
+	static const unsigned int gray[4] = { 0, 1, 3, 2 };		//B << 1 | A, A leads B
+
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		for(unsigned int j = 0; j < 4; j++)
+		{
+			unsigned int from = gray[i], to = gray[j];
+			int expect = (i == j) ? 0 : (j == ((i + 1) & 3)) ? +1 : (i == ((j + 1) & 3)) ? -1 : ENC_BAD;
+
+			if(enc_step[(from << 2) | to] != expect)
+				fail("enc_step[] against the Gray walk", (from << 2) | to, expect);
+		}
+	}
+}
+
+/* EXTI walk on port, pins pa/pb: single steps both ways and double steps */
+static void walk(struct encoder *e, volatile struct gpio *g, unsigned int pa, unsigned int pb, int sign)
+{
+	static const unsigned int gray[4] = { 0, 1, 3, 2 };
+	unsigned int phase = 0, doubles = 0, errors0 = encoder_Errors(e);
+	long long pos = encoder_Position(e);
+
+	g->IDR &= ~((1u << pa) | (1u << pb));
+	exti(pa);											//state 00 whatever it was
+	errors0 = encoder_Errors(e);
+	pos = encoder_Position(e);
+	for(unsigned int n = 0; n < WALK_STEPS; n++)
+	{
+		unsigned int r = rand() % 16, old = gray[phase], s;
+
+		if(r == 0)
+		{
+			phase = (phase + 2) & 3;					//both pins change
+			doubles++;
+		}
+		else if(r < 9)
+		{
+			phase = (phase + 1) & 3;
+			pos += sign;
+		}
+		else
+		{
+			phase = (phase + 3) & 3;
+			pos -= sign;
+		}
+		s = gray[phase];
+		g->IDR = (g->IDR & ~((1u << pa) | (1u << pb))) | ((s & 1) << pa) | ((s >> 1) << pb);
+		if((old ^ s) & 1)
+			exti(pa);
+		if((old ^ s) & 2)
+			exti(pb);
+	}
+	if(encoder_Position(e) != pos)
+		fail("EXTI position after the walk", encoder_Position(e), pos);
+	if(encoder_Errors(e) - errors0 != doubles)
+		fail("EXTI errors against double steps", encoder_Errors(e) - errors0, doubles);
+}
+
+/* CNT by random steps, both directions, position against the sum */
+static void wrap(struct encoder *e, unsigned int range, unsigned int *crossings)
+{
+	long long start = encoder_Position(e), sum = 0;
+	unsigned int mask = e->wide ? 0xFFFFFFFFu : 0xFFFFu;
+
+	for(unsigned int n = 0; n < WRAP_STEPS; n++)
+	{
+		int step = (int)((unsigned int)rand() % range) - (int)(range / 2);
+		unsigned int cnt = e->tim->CNT;
+		unsigned int next = (cnt + (unsigned int)step) & mask;
+
+		*crossings += (step > 0 && next < cnt) || (step < 0 && next > cnt);
+		e->tim->CNT = next;
+		sum += step;
+		if(rand() % 2)
+			tick();
+		else if(encoder_Position(e) != start + sum)
+			fail(e->wide ? "TIM2 position across the wrap" : "TIM3 position across the wrap", encoder_Position(e), start + sum);
+	}
+	if(encoder_Position(e) != start + sum)
+		fail(e->wide ? "TIM2 position after the walk" : "TIM3 position after the walk", encoder_Position(e), start + sum);
+}
+
+static void test_Wrap(void)
+{
+	unsigned int crossings = 0;
+	long long p;
+
+	/* 0xFFF0 + 0x20 -> 0x10 and back */
+	TIM3->CNT = 0xFFF0;
+	p = encoder_Position(&enc_tim3);
+	TIM3->CNT = 0x0010;
+	if(encoder_Position(&enc_tim3) != p + 0x20)
+		fail("TIM3 0xFFFF -> 0", encoder_Position(&enc_tim3) - p, 0x20);
+	TIM3->CNT = 0xFFF0;
+	if(encoder_Position(&enc_tim3) != p)
+		fail("TIM3 0 -> 0xFFFF", encoder_Position(&enc_tim3) - p, 0);
+
+	wrap(&enc_tim3, 65535, &crossings);
+	printf("TIM3: %u wraps in %u steps\n", crossings, WRAP_STEPS);
+	crossings = 0;
+	wrap(&enc_tim2, 0xFFFFFFFEu, &crossings);
+	printf("TIM2: %u wraps in %u steps\n", crossings, WRAP_STEPS);
+	if(!crossings)
+		fail("TIM2 never wrapped", 0, 0);
+}
+
+static void test_Index(void)
+{
+	long long latched, before, at, moved;
+
+	before = encoder_Position(&enc_a);
+	GPIOA->IDR ^= (1<<2);									//one step
+	exti(2);
+	at = encoder_Position(&enc_a);
+	if(at == before)
+		fail("index: no step", at, before);
+	GPIOB->IDR |= 1;
+	exti(0);
+	if(encoder_Index(&enc_a, &latched) != 1 || latched != at)
+		fail("index: latched position", latched, at);
+	if(encoder_Position(&enc_a) != 0)
+		fail("ENC_INDEX_ZERO: position at the index", encoder_Position(&enc_a), 0);
+	walk(&enc_a, GPIOA, 2, 3, 1);
+	moved = encoder_Position(&enc_a);
+	exti(0);
+	if(encoder_Index(&enc_a, &latched) != 2 || latched != moved || encoder_Position(&enc_a) != 0)
+		fail("second index: latched against moved", latched, moved);
+	if(encoder_Index(&enc_c, 0) != 0)
+		fail("index counted on an encoder without one", encoder_Index(&enc_c, 0), 0);
+}
+
+static void test_Velocity(void)
+{
+	static const struct { int num, den; } rate[] =		//counts per tick: num / den
+	{
+		{ 1, 10 }, { 1, 1 }, { 3, 1 }, { 5, 2 }, { 63, 1 }, { 64, 1 }, { 5000, 1 }, { -7, 1 }, { -13, 5 }, { -1, 3 },
+	};
+	static long long history[2000];
+
+	for(unsigned int k = 0; k < sizeof(rate) / sizeof(rate[0]); k++)
+	{
+		long long count = 0;
+
+		enc_tim3.samples = 0;
+		for(unsigned int n = 0; n < 2000; n++)
+		{
+			long long next = (long long)(n + 1) * rate[k].num / rate[k].den, d = 0, expect;
+			unsigned int span = (n < ENC_VEL_DEPTH) ? n : ENC_VEL_DEPTH - 1, w;
+
+			TIM3->CNT = (TIM3->CNT + (unsigned int)(next - count)) & 0xFFFF;
+			count = next;
+			history[n] = count;
+			tick();
+
+			/* shortest window of 1, 2, 4, .. with ENC_VEL_COUNTS, at most span ticks */
+			if(!span)
+				continue;
+			for(w = 1; ; w = (w*2 < span) ? w*2 : span)
+			{
+				d = count - history[n - w];
+				if(w == span || d >= ENC_VEL_COUNTS || d <= -ENC_VEL_COUNTS)
+					break;
+			}
+			expect = d * ENC_SAMPLE_HZ / w;
+			if(encoder_Velocity(&enc_tim3) != expect)
+			{
+				fail("velocity", encoder_Velocity(&enc_tim3), expect);
+				break;
+			}
+		}
+		printf("velocity %d/%d counts per tick: %d counts/s\n", rate[k].num, rate[k].den, encoder_Velocity(&enc_tim3));
+		if(rate[k].den == 1 && encoder_Velocity(&enc_tim3) != rate[k].num * ENC_SAMPLE_HZ)
+			fail("velocity at a whole rate", encoder_Velocity(&enc_tim3), rate[k].num * ENC_SAMPLE_HZ);
+	}
+}
+
+int main(void)
+{
+	static const struct enc_cfg cfg_tim3 = { ENC_TIM3, ENC_X4, 3, 0, 0, 0, 0, -1, 0, 0 };
+	static const struct enc_cfg cfg_tim2 = { ENC_TIM2, ENC_X4, 0, 0, 0, 0, 0, -1, 0, 0 };
+	static const struct enc_cfg cfg_a = { ENC_EXTI, ENC_X4, 0, 0, 0, 2, 3, 0, 1, ENC_INDEX_ZERO };
+	static const struct enc_cfg cfg_c = { ENC_EXTI, ENC_X4, 0, 1, 2, 4, 5, -1, 0, 0 };
+	static const struct enc_cfg cfg_clash = { ENC_EXTI, ENC_X4, 0, 0, 1, 3, 6, -1, 0, 0 };
+
+	map(0x40000000, 0x30000);
+	map(0xE0000000, 0x10000);
+	srand(1);
+
+	if(encoder_Init(&enc_tim3, &cfg_tim3) || encoder_Init(&enc_tim2, &cfg_tim2) || encoder_Init(&enc_a, &cfg_a))
+		fail("encoder_Init", 0, 0);
+	if(encoder_Init(&enc_c, &cfg_clash) != -1 || encoder_Init(&enc_c, &cfg_tim3) != -1)
+		fail("encoder_Init accepted a used EXTI line or timer", 0, 0);
+	if(encoder_Init(&enc_c, &cfg_c))
+		fail("encoder_Init", 0, 0);
+	if(TIM3->SMCR != 3 || TIM3->CCMR1 != 0x3131 || TIM3->ARR != 0xFFFF || TIM2->ARR != 0xFFFFFFFF)
+		fail("timer encoder mode", TIM3->SMCR, TIM3->CCMR1);
+
+	test_Table();
+	walk(&enc_c, GPIOC, 4, 5, -1);
+	test_Wrap();
+	test_Index();
+	test_Velocity();
+	printf("encoder: EXTI %lld / %lld after the walks, %u / %u errors, %u failures\n",
+		encoder_Position(&enc_a), encoder_Position(&enc_c), encoder_Errors(&enc_a), encoder_Errors(&enc_c), failures);
+	return failures != 0;
+}
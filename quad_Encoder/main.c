@@ -0,0 +1,227 @@
+/**
+ ******************************************************************************
+ * @file    quad_Encoder.c
+ * @author  Monish Kumar.k
+ * @date    24/04/2025
+ * @brief   Rotary encoder input counted in timer encoder mode, benchmarked
+ *          against the EXTI-per-edge fallback of the same driver.
+ *
+ * @details
+ * Hardware Connections: for the benchmark, a quadrature generator on PB6
+ * (TIM4_CH1, A) and PB7 (TIM4_CH2, B), jumpered to
+ *   - PA0 / PA1 : TIM2 encoder, 32-bit counter,
+ *   - PA6 / PA7 : TIM3 encoder, 16-bit counter + sample-tick extension,
+ *   - PB0 / PB1 : EXTI0 / EXTI1, the per-edge fallback.
+ * Afterwards TIM4 is an encoder input: a real encoder on PB6/PB7 (A, B,
+ * to GND when closed) with the index, if there is one, on PA8. USART2 TX
+ * on PA2 for the log. Clock is 84 MHz.
+ *
+ * The External_Interrupt examples take one interrupt per button edge;
+ * for an encoder that does not scale, every detent is four edges.
+ *
+ * Benchmark, for each edge rate of bench_rate[]:
+ *  - TIM4 toggles CH1 at CNT = 0 and CH2 half a period later, so A and B
+ *    are in quadrature with A leading: one edge per half period,
+ *  - TIM5 is a one-shot of BENCH_MS at priority 0; its handler stops the
+ *    generator, so an EXTI rate the CPU cannot keep up with still ends,
+ *  - the main loop counts its iterations until then; against an idle run
+ *    this is the CPU time left to the application.
+ * Logged with LOG() and kept in bench[]: expected edges, TIM2, TIM3 and
+ * EXTI counts, EXTI invalid transitions, CPU left in %. The timer columns
+ * cost no CPU time at any rate; they stop following the generator at
+ * the input synchroniser limit near fCK_INT / 4, and TIM3 also above
+ * 32767 edges per sample tick.
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 24/04/2025
+  File : quad_Encoder
+ ******************************************************************************/
+#include <arm.h>
+#include <rcc.h>
+#include <uart.h>
+#include <log.h>
+#include "encoder.h"
+
+#define LOG_PORT		UART_2
+#define TIM5_IRQ		50
+#define BENCH_MS		100
+
+struct bench_result
+{
+	unsigned int rate;					//edges/s
+	unsigned int expected;
+	unsigned int tim2_count;
+	unsigned int tim3_count;
+	unsigned int exti_count;
+	unsigned int exti_errors;
+	unsigned int cpu_left;				//% of the idle main loop
+};
+
+static const unsigned int bench_rate[] =
+{
+	1000, 10000, 50000, 100000, 200000, 500000, 1000000, 2000000,
+	4200000, 10500000, 21000000, 42000000,
+};
+#define BENCH_N		(sizeof(bench_rate) / sizeof(bench_rate[0]))
+
+static struct encoder enc_tim2, enc_tim3, enc_exti, enc_knob;
+static volatile unsigned int bench_done;
+
+volatile struct bench_result bench[BENCH_N];
+
+void rcc_Config(void);
+void generator_Config(void);
+void stop_Config(void);
+unsigned int bench_Window(unsigned int rate);
+void bench_Run(void);
+
+int main(void)
+{
+	static const struct enc_cfg tim2_cfg = { ENC_TIM2, ENC_X4, 0, 0, 0, 0, 0, -1, 0, 0 };
+	static const struct enc_cfg tim3_cfg = { ENC_TIM3, ENC_X4, 0, 0, 0, 0, 0, -1, 0, 0 };
+	static const struct enc_cfg exti_cfg = { ENC_EXTI, ENC_X4, 0, 0, 1, 0, 1, -1, 0, 0 };
+	static const struct enc_cfg knob_cfg = { ENC_TIM4, ENC_X4, 15, 0, 0, 0, 0, 8, 0, ENC_INDEX_ZERO };
+	unsigned int last;
+
+	rcc_Config();
+	uart_Init(LOG_PORT, 921600);
+	log_Init();
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);
+
+	encoder_Init(&enc_tim2, &tim2_cfg);
+	encoder_Init(&enc_tim3, &tim3_cfg);
+	encoder_Init(&enc_exti, &exti_cfg);
+	generator_Config();
+	stop_Config();
+	bench_Run();
+
+	/* the generator timer as a knob input, filtered for contact bounce, index on PA8 */
+	encoder_Init(&enc_knob, &knob_cfg);
+	last = DWT->CYCCNT;
+	while(1)
+	{
+		if(DWT->CYCCNT - last >= rcc_Get_Sysclk() / 5)
+		{
+			long long index_pos;
+			unsigned int index = encoder_Index(&enc_knob, &index_pos);
+
+			last += rcc_Get_Sysclk() / 5;
+			LOG("knob: position %d, %d counts/s, index %u at %d",
+				(int)encoder_Position(&enc_knob), encoder_Velocity(&enc_knob), index, (int)index_pos);
+		}
+		log_Drain(LOG_PORT);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* APB1 /2 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+/* TIM4 CH1/CH2 on PB6/PB7 (AF2), toggle mode, stopped; the rate is set per run */
+void generator_Config()
+{
+	RCC->AHB1ENR |= (1<<1);
+	RCC->APB1ENR |= (1<<2);
+	GPIOB->AFRL = (GPIOB->AFRL & ~(0xFF<<24)) | (2<<28) | (2<<24);
+	GPIOB->OSPEEDR |= (0xF<<12);
+	GPIOB->MODER = (GPIOB->MODER & ~(0xF<<12)) | (0xA<<12);
+
+	TIM4->CR1 = 0;
+	TIM4->CCMR1 = (3<<12) | (3<<4);			/* OC2M = OC1M = toggle */
+	TIM4->CCR1 = 0;
+	TIM4->CCER = (1<<4) | (1<<0);
+}
+
+/* TIM5: one-shot at 1 MHz, priority 0 so it runs through an EXTI storm */
+void stop_Config()
+{
+	RCC->APB1ENR |= (1<<3);
+	TIM5->CR1 = (1<<3);						/* OPM */
+	TIM5->PSC = rcc_Get_Tim_Clock(1) / 1000000 - 1;
+	TIM5->ARR = BENCH_MS * 1000 - 1;
+	TIM5->EGR = (1<<0);
+	TIM5->SR = 0;
+	TIM5->DIER = (1<<0);
+	NVIC->IP[TIM5_IRQ] = (0<<4);
+	NVIC->ISER[TIM5_IRQ >> 5] = (1 << (TIM5_IRQ & 31));
+}
+
+void TIM5_IRQHandler()
+{
+	TIM5->SR = ~(1<<0);						//rc_w0
+	TIM4->CR1 = 0;
+	bench_done = 1;
+}
+
+/* one window of BENCH_MS; rate = 0 is the idle reference. Returns main loop spins */
+unsigned int bench_Window(unsigned int rate)
+{
+	unsigned int spins = 0;
+
+	if(rate)
+	{
+		unsigned int ticks = 2 * (unsigned long long)rcc_Get_Tim_Clock(1) / rate;	/* timer period, two edges */
+		unsigned int psc = (ticks - 1) >> 16;
+		unsigned int half = ticks / (psc + 1) / 2;
+
+		TIM4->PSC = psc;
+		TIM4->ARR = 2*half - 1;
+		TIM4->CCR2 = half;
+		TIM4->CNT = 0;
+		TIM4->EGR = (1<<0);
+	}
+	bench_done = 0;
+	TIM5->CNT = 0;
+	TIM5->CR1 |= (1<<0);
+	if(rate)
+		TIM4->CR1 = (1<<0);
+	while(!bench_done)
+	{
+		spins++;
+	}
+	return spins;
+}
+
+void bench_Run()
+{
+	unsigned int idle = bench_Window(0);
+
+	for(unsigned int i = 0; i < BENCH_N; i++)
+	{
+		volatile struct bench_result *r = &bench[i];
+		long long p2 = encoder_Position(&enc_tim2);
+		long long p3 = encoder_Position(&enc_tim3);
+		long long pe = encoder_Position(&enc_exti);
+		unsigned int errors = encoder_Errors(&enc_exti);
+		unsigned int spins = bench_Window(bench_rate[i]);
+
+		r->rate = bench_rate[i];
+		r->expected = bench_rate[i] / 1000 * BENCH_MS;
+		r->tim2_count = (unsigned int)(encoder_Position(&enc_tim2) - p2);
+		r->tim3_count = (unsigned int)(encoder_Position(&enc_tim3) - p3);
+		r->exti_count = (unsigned int)(encoder_Position(&enc_exti) - pe);
+		r->exti_errors = encoder_Errors(&enc_exti) - errors;
+		r->cpu_left = idle ? (unsigned int)((unsigned long long)spins * 100 / idle) : 0;
+		LOG("%u edges/s: expected %u, TIM2 %d, TIM3 %d, EXTI %d, %u invalid, CPU left %u%%",
+			r->rate, r->expected, r->tim2_count, r->tim3_count, r->exti_count, r->exti_errors, r->cpu_left);
+		log_Drain(LOG_PORT);
+	}
+}
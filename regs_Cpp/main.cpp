@@ -0,0 +1,133 @@
+/**
+ ******************************************************************************
+ * @file    regs_Cpp.cpp
+ * @author  Monish Kumar.k
+ * @date    10/04/2025
+ * @brief   External_interrupt_with_falling_edge and manual_PWM rewritten on
+ *          the C++17 register templates of regs.hpp / stm32f401.hpp.
+ *
+ * @details
+ * Hardware Connections: button on PA0 to GND (internal pull-up), LED on PA6
+ * (TIM3_CH1, AF2). Clock is the HSI (16 MHz) reset default.
+ *
+ *  - Each falling edge on PA0 raises the TIM3 CH1 duty by 1/8, wrapping
+ *    to 0, so the LED steps through nine brightness levels.
+ *  - The GPIO setup of both pins is one modify() per register; CCMR1
+ *    (OC1M + OC1PE) and the CR1 start bits are merged the same way.
+ *  - EXTI_PR is W1C and TIM3_SR is rc_w0 in the type: the handlers can
+ *    only clear() them, a |= does not compile.
+ *  - The static_asserts below compare every arm.h struct member with the
+ *    offset written out in stm32f401.hpp, so a missing or extra padding
+ *    word in arm.h stops the build.
+ *
+ * Build: arm-none-eabi-g++ -std=c++17 -O2 -mcpu=cortex-m4 -mthumb
+ *        -fno-exceptions -fno-rtti, with manual_PWM on the include path.
+ * Size check: python3 regs_Size.py compares regs_Size.cpp (these sequences
+ *        on the templates) with the hand-written C of regs_Size.c.
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 10/04/2025
+  File : regs_Cpp
+ ******************************************************************************/
+#include <cstddef>
+#include <arm.h>
+#include "stm32f401.hpp"
+
+using namespace stm32;
+
+using BUTTON = Pin<GPIO_A, 0>;
+using LED    = Pin<GPIO_A, 6>;
+
+constexpr unsigned EXTI0_IRQ = 6;
+constexpr std::uint32_t PWM_STEPS = 8;
+constexpr std::uint32_t PWM_PERIOD = 1000;			//16 MHz / 16 / 1000 = 1 kHz
+
+/* arm.h against the offsets of stm32f401.hpp */
+using TIMER = Timer<0>;
+static_assert(offsetof(struct timer, CR1)   == TIMER::CR1::address,   "timer.CR1");
+static_assert(offsetof(struct timer, SR)    == TIMER::SR::address,    "timer.SR");
+static_assert(offsetof(struct timer, CCMR1) == TIMER::CCMR1::address, "timer.CCMR1");
+static_assert(offsetof(struct timer, CCMR2) == TIMER::CCMR2::address, "timer.CCMR2");
+static_assert(offsetof(struct timer, CCER)  == TIMER::CCER::address,  "timer.CCER");
+static_assert(offsetof(struct timer, CNT)   == TIMER::CNT::address,   "timer.CNT");
+static_assert(offsetof(struct timer, PSC)   == TIMER::PSC::address,   "timer.PSC");
+static_assert(offsetof(struct timer, ARR)   == TIMER::ARR::address,   "timer.ARR");
+static_assert(offsetof(struct timer, RCR)   == TIMER::RCR::address,   "timer.RCR");
+static_assert(offsetof(struct timer, CCR1)  == TIMER::CCR1::address,  "timer.CCR1");
+static_assert(offsetof(struct timer, CCR4)  == TIMER::CCR4::address,  "timer.CCR4");
+static_assert(offsetof(struct timer, BDTR)  == TIMER::BDTR::address,  "timer.BDTR");
+static_assert(offsetof(struct timer, DMAR)  == TIMER::DMAR::address,  "timer.DMAR");
+static_assert(offsetof(struct timer, OR)    == TIMER::OR::address,    "timer.OR");
+
+using PORT = Gpio<0, 0>;
+static_assert(offsetof(struct gpio, MODER)   == PORT::MODER::address,   "gpio.MODER");
+static_assert(offsetof(struct gpio, PUPDR)   == PORT::PUPDR::address,   "gpio.PUPDR");
+static_assert(offsetof(struct gpio, IDR)     == PORT::IDR::address,     "gpio.IDR");
+static_assert(offsetof(struct gpio, ODR)     == PORT::ODR::address,     "gpio.ODR");
+static_assert(offsetof(struct gpio, BSRR)    == PORT::BSRR::address,    "gpio.BSRR");
+static_assert(offsetof(struct gpio, AFRH)    == PORT::AFRH::address,    "gpio.AFRH");
+
+static_assert(offsetof(struct rcc, AHB1ENR) == RCC_::AHB1ENR::address - RCC_::base, "rcc.AHB1ENR");
+static_assert(offsetof(struct rcc, APB1ENR) == RCC_::APB1ENR::address - RCC_::base, "rcc.APB1ENR");
+static_assert(offsetof(struct rcc, APB2ENR) == RCC_::APB2ENR::address - RCC_::base, "rcc.APB2ENR");
+static_assert(offsetof(struct exti, PR)     == EXTI_::PR::address - EXTI_::base,    "exti.PR");
+static_assert(offsetof(struct syscfg, EXTICR) == SYSCFG_::EXTICR<0>::address - SYSCFG_::base, "syscfg.EXTICR");
+
+static volatile std::uint32_t level;
+
+static void gpio_Config()
+{
+	reg::modify(RCC_::AHB1ENR::GPIOAEN::value<1>{});
+	reg::modify(RCC_::APB1ENR::TIM3EN::value<1>{});
+	reg::modify(RCC_::APB2ENR::SYSCFGEN::value<1>{});
+
+	reg::modify(BUTTON::pull<pull_up>{});
+	reg::modify(LED::af<2>{});
+	reg::modify(BUTTON::mode<input>{}, LED::mode<alternate>{});		//one store for both pins
+}
+
+static void pwm_Config()
+{
+	TIM3_::PSC::write(16 - 1);
+	TIM3_::ARR::write(PWM_PERIOD - 1);
+	TIM3_::CCR1::write(0);
+	reg::modify(TIM3_::CCMR1::OC1M::value<6>{}, TIM3_::CCMR1::OC1PE::value<1>{});	//PWM mode 1, preload
+	reg::modify(TIM3_::CCER::CC1E::value<1>{});
+	TIM3_::EGR::write(TIM3_::EGR::UG);
+	TIM3_::SR::clear(TIM3_::SR::UIF);
+	reg::modify(TIM3_::CR1::ARPE::value<1>{}, TIM3_::CR1::CEN::value<1>{});
+}
+
+static void exti_Config()
+{
+	reg::modify(SYSCFG_::exti<BUTTON::pin, GPIO_A>{});
+	EXTI_::FTSR::modify(BUTTON::bit, BUTTON::bit);
+	EXTI_::PR::clear(BUTTON::bit);
+	EXTI_::IMR::modify(BUTTON::bit, BUTTON::bit);
+	NVIC_::priority<EXTI0_IRQ>(5 << 4);
+	NVIC_::enable<EXTI0_IRQ>();
+}
+
+extern "C" void EXTI0_IRQHandler()
+{
+	if(EXTI_::PR::read() & BUTTON::bit)
+	{
+		EXTI_::PR::clear(BUTTON::bit);
+		level = (level + 1) % (PWM_STEPS + 1);
+		TIM3_::CCR1::write(level * PWM_PERIOD / PWM_STEPS);
+	}
+}
+
+int main()
+{
+	gpio_Config();
+	pwm_Config();
+	exti_Config();
+	while(1)
+	{
+	}
+}
@@ -0,0 +1,138 @@
+/*
+ * regs.hpp
+ *
+ *  Created on: Apr 10, 2025
+ *      Author: moni
+ *
+ *  C++17 header-only register access. Every register is a type carrying
+ *  its address and access kind, every bit field a type carrying its
+ *  register, offset and width, so a wrong offset or a write to a read-only
+ *  register is a compile error instead of a silent write elsewhere.
+ *
+ *    using LED = Pin<GPIO_A, 5>;
+ *    reg::write(GPIO_A::MODER::pin<5>::value<1>{}, GPIO_A::PUPDR::pin<0>::value<1>{});  // error: two registers
+ *    reg::modify(GPIO_A::MODER::pin<5>::value<1>{}, GPIO_A::MODER::pin<6>::value<1>{});  // one LDR/AND/ORR/STR
+ *    EXTI_::PR::clear(1u << 0);                                                      // W1C: plain STR
+ *    EXTI_::PR::write(0);                                                             // error: W1C
+ *
+ *  Access kinds:
+ *    rw  : read(), write(), modify()
+ *    ro  : read() only
+ *    wo  : write() only (BSRR); modify() would read back garbage
+ *    w1c : read() and clear(mask); a read-modify-write would clear every
+ *          pending bit it read back, so modify()/write() do not exist
+ *    w0c : same for rc_w0 flags (TIMx_SR): clear(mask) stores ~mask
+ *
+ *  Everything is constexpr; with -O1 or more a field write with a constant
+ *  is one load, one AND/ORR (or BFI) and one store, and modify() of several
+ *  fields of one register folds them into the same single store.
+ */
+
+#ifndef REGS_HPP_
+#define REGS_HPP_
+
+#include <cstdint>
+#include <type_traits>
+
+namespace reg
+{
+
+struct rw  {};
+struct ro  {};
+struct wo  {};
+struct w1c {};
+struct w0c {};
+
+template<class A> constexpr bool readable  = !std::is_same_v<A, wo>;
+template<class A> constexpr bool writable  = std::is_same_v<A, rw> || std::is_same_v<A, wo>;
+template<class A> constexpr bool modifiable = std::is_same_v<A, rw>;
+
+template<std::uint32_t Addr, class Access = rw>
+struct Register
+{
+	using access = Access;
+	static constexpr std::uint32_t address = Addr;
+
+	static volatile std::uint32_t &ref()
+	{
+		return *reinterpret_cast<volatile std::uint32_t *>(Addr);
+	}
+
+	static std::uint32_t read()
+	{
+		static_assert(readable<Access>, "register is write-only");
+		return ref();
+	}
+
+	static void write(std::uint32_t v)
+	{
+		static_assert(writable<Access>, "register is read-only or write-1-to-clear");
+		ref() = v;
+	}
+
+	static void modify(std::uint32_t mask, std::uint32_t value)
+	{
+		static_assert(modifiable<Access>, "read-modify-write not allowed on this register");
+		ref() = (ref() & ~mask) | value;
+	}
+
+	static void clear(std::uint32_t mask)
+	{
+		static_assert(std::is_same_v<Access, w1c> || std::is_same_v<Access, w0c>,
+			"clear() is for write-1/write-0-to-clear registers");
+		ref() = std::is_same_v<Access, w1c> ? mask : ~mask;
+	}
+};
+
+template<class Reg, unsigned Offset, unsigned Width>
+struct Field
+{
+	static_assert(Width > 0 && Offset + Width <= 32, "field outside the register");
+
+	using reg = Reg;
+	static constexpr std::uint32_t mask = (Width == 32 ? 0xFFFFFFFFu : ((1u << Width) - 1)) << Offset;
+
+	/* a constant for this field, to pass to reg::modify() */
+	template<std::uint32_t V>
+	struct value
+	{
+		using reg = Reg;
+		static constexpr std::uint32_t mask = Field::mask;
+		static constexpr std::uint32_t bits = V << Offset;
+		static_assert((bits >> Offset) == V && (bits & ~mask) == 0, "value does not fit the field");
+	};
+
+	static std::uint32_t read()
+	{
+		return (Reg::read() & mask) >> Offset;
+	}
+
+	static void write(std::uint32_t v)
+	{
+		Reg::modify(mask, (v << Offset) & mask);
+	}
+};
+
+/* several field values of one register: one read, one store */
+template<class First, class... Rest>
+inline void modify(First, Rest...)
+{
+	using R = typename First::reg;
+	static_assert((std::is_same_v<R, typename Rest::reg> && ...), "fields of different registers");
+	static_assert((std::uint64_t(First::mask) + ... + Rest::mask) == (First::mask | ... | Rest::mask),
+		"field given twice");
+	R::modify((First::mask | ... | Rest::mask), (First::bits | ... | Rest::bits));
+}
+
+/* same, but the other fields are written as 0: one store, no read */
+template<class First, class... Rest>
+inline void write(First, Rest...)
+{
+	using R = typename First::reg;
+	static_assert((std::is_same_v<R, typename Rest::reg> && ...), "fields of different registers");
+	R::write((First::bits | ... | Rest::bits));
+}
+
+} /* namespace reg */
+
+#endif /* REGS_HPP_ */
@@ -0,0 +1,92 @@
+/**
+ ******************************************************************************
+ * @file    regs_Size.c
+ * @author  Monish Kumar.k
+ * @date    10/04/2025
+ * @brief   Hand-written arm.h version of the register sequences of
+ *          regs_Cpp/main.cpp, the reference for regs_Size.py.
+ *
+ * @details
+ * Every function here has a twin of the same name in regs_Size.cpp written
+ * with the templates of stm32f401.hpp. regs_Size.py compiles both units
+ * with the same flags and fails if a template function is larger:
+ *
+ *     python3 regs_Size.py            (arm-none-eabi- if installed, else the host gcc/g++)
+ *
+ * The C is written the way the rest of the repo does it by hand: one
+ * read-modify-write per register, several pins of one register merged
+ * into one mask, plain stores for W1C / rc_w0 flags and write-only
+ * registers.
+ ******************************************************************************
+ */
+#include <arm.h>
+
+volatile unsigned int level;
+
+void gpio_Config(void)
+{
+	RCC->AHB1ENR |= (1<<0);					//GPIOA
+	RCC->APB1ENR |= (1<<1);					//TIM3
+	RCC->APB2ENR |= (1<<14);				//SYSCFG
+
+	GPIOA->PUPDR = (GPIOA->PUPDR & ~(3<<0)) | (1<<0);			//PA0 pull-up
+	GPIOA->AFRL = (GPIOA->AFRL & ~(0xF<<24)) | (2<<24);		//PA6 AF2
+	GPIOA->MODER = (GPIOA->MODER & ~((3<<0) | (3<<12))) | (2<<12);	//PA0 in, PA6 AF
+}
+
+void pwm_Config(void)
+{
+	TIM3->PSC = 16 - 1;
+	TIM3->ARR = 1000 - 1;
+	TIM3->CCR1 = 0;
+	TIM3->CCMR1 = (TIM3->CCMR1 & ~((7<<4) | (1<<3))) | (6<<4) | (1<<3);	//PWM mode 1, preload
+	TIM3->CCER |= (1<<0);
+	TIM3->EGR = (1<<0);
+	TIM3->SR = ~(1<<0);
+	TIM3->CR1 |= (1<<7) | (1<<0);
+}
+
+void exti_Config(void)
+{
+	SYSCFG->EXTICR[0] &= ~(0xF<<0);			//EXTI0 = PA0
+	EXTI->FTSR |= (1<<0);
+	EXTI->PR = (1<<0);
+	EXTI->IMR |= (1<<0);
+	NVIC->IP[6] = 5 << 4;
+	NVIC->ISER[0] = (1<<6);
+}
+
+void EXTI0_IRQHandler(void)
+{
+	if(EXTI->PR & (1<<0))
+	{
+		EXTI->PR = (1<<0);
+		level = (level + 1) % 9;
+		TIM3->CCR1 = level * 1000 / 8;
+	}
+}
+
+void TIM3_IRQHandler(void)
+{
+	if(TIM3->SR & (1<<0))
+	{
+		TIM3->SR = ~(1<<0);
+		level = 0;
+	}
+}
+
+void led_Write(int on)
+{
+	GPIOA->BSRR = on ? (1<<6) : (1<<(6 + 16));
+}
+
+int button_Read(void)
+{
+	return (GPIOA->IDR & (1<<0)) != 0;
+}
+
+/* the field written with a run-time value: one RMW */
+void oc1_Mode(unsigned int mode)
+{
+	TIM3->CCMR1 = (TIM3->CCMR1 & ~(7<<4)) | ((mode << 4) & (7<<4));
+}
@@ -0,0 +1,95 @@
+/**
+ ******************************************************************************
+ * @file    regs_Size.cpp
+ * @author  Monish Kumar.k
+ * @date    10/04/2025
+ * @brief   The register sequences of regs_Size.c written with the templates
+ *          of stm32f401.hpp, for the size comparison of regs_Size.py.
+ *
+ * @details
+ * Same functions, same names (extern "C"), same register accesses in the
+ * same order as regs_Size.c. regs_Size.py compiles both and fails if any
+ * function here is larger than its hand-written twin.
+ ******************************************************************************
+ */
+#include <arm.h>
+#include "stm32f401.hpp"
+
+using namespace stm32;
+
+using BUTTON = Pin<GPIO_A, 0>;
+using LED    = Pin<GPIO_A, 6>;
+
+extern "C"
+{
+
+volatile std::uint32_t level;
+
+void gpio_Config()
+{
+	reg::modify(RCC_::AHB1ENR::GPIOAEN::value<1>{});
+	reg::modify(RCC_::APB1ENR::TIM3EN::value<1>{});
+	reg::modify(RCC_::APB2ENR::SYSCFGEN::value<1>{});
+
+	reg::modify(BUTTON::pull<pull_up>{});
+	reg::modify(LED::af<2>{});
+	reg::modify(BUTTON::mode<input>{}, LED::mode<alternate>{});
+}
+
+void pwm_Config()
+{
+	TIM3_::PSC::write(16 - 1);
+	TIM3_::ARR::write(1000 - 1);
+	TIM3_::CCR1::write(0);
+	reg::modify(TIM3_::CCMR1::OC1M::value<6>{}, TIM3_::CCMR1::OC1PE::value<1>{});
+	reg::modify(TIM3_::CCER::CC1E::value<1>{});
+	TIM3_::EGR::write(TIM3_::EGR::UG);
+	TIM3_::SR::clear(TIM3_::SR::UIF);
+	reg::modify(TIM3_::CR1::ARPE::value<1>{}, TIM3_::CR1::CEN::value<1>{});
+}
+
+void exti_Config()
+{
+	reg::modify(SYSCFG_::exti<BUTTON::pin, GPIO_A>{});
+	EXTI_::FTSR::modify(BUTTON::bit, BUTTON::bit);
+	EXTI_::PR::clear(BUTTON::bit);
+	EXTI_::IMR::modify(BUTTON::bit, BUTTON::bit);
+	NVIC_::priority<6>(5 << 4);
+	NVIC_::enable<6>();
+}
+
+void EXTI0_IRQHandler()
+{
+	if(EXTI_::PR::read() & BUTTON::bit)
+	{
+		EXTI_::PR::clear(BUTTON::bit);
+		level = (level + 1) % 9;
+		TIM3_::CCR1::write(level * 1000 / 8);
+	}
+}
+
+void TIM3_IRQHandler()
+{
+	if(TIM3_::SR::read() & TIM3_::SR::UIF)
+	{
+		TIM3_::SR::clear(TIM3_::SR::UIF);
+		level = 0;
+	}
+}
+
+void led_Write(int on)
+{
+	LED::write(on);
+}
+
+int button_Read()
+{
+	return BUTTON::read();
+}
+
+void oc1_Mode(unsigned int mode)
+{
+	TIM3_::CCMR1::OC1M::write(mode);
+}
+
+}
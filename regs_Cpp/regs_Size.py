@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""
+regs_Size.py - code size and access checks for the C++ register templates.
+
+1. Compiles regs_Size.c (hand-written arm.h C) and regs_Size.cpp (the same
+   register sequences on stm32f401.hpp) with the same optimisation flags
+   and compares, function by function, the size nm reports and the number
+   of instructions objdump disassembles. A template function larger than
+   its C twin fails the check.
+2. Compiles the snippets in MUST_FAIL, each a misuse the templates are
+   meant to reject (a write to W1C EXTI_PR, a read of BSRR, fields of two
+   registers in one modify(), ...). Each must fail to compile with its
+   static_assert message.
+
+Usage, from regs_Cpp/:
+    python3 regs_Size.py                       # arm-none-eabi- if installed, else host gcc/g++
+    python3 regs_Size.py --prefix arm-none-eabi-
+    python3 regs_Size.py -d                    # also print both disassemblies
+
+The Cortex-M4 numbers are the ones that count; on the host the check
+still shows whether the templates fold to the same loads and stores.
+Exits non-zero on a failure.
+
+Author: Monish Kumar.k
+Date  : 10/04/2025
+"""
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+INC = ["-I" + os.path.join(HERE, "..", "manual_PWM"), "-I" + HERE]
+ARM_FLAGS = ["-mcpu=cortex-m4", "-mthumb"]
+FLAGS = ["-O2", "-ffunction-sections", "-fno-asynchronous-unwind-tables"]
+CXX_FLAGS = ["-std=c++17", "-fno-exceptions", "-fno-rtti"]
+
+FUNCTIONS = ["gpio_Config", "pwm_Config", "exti_Config", "EXTI0_IRQHandler",
+             "TIM3_IRQHandler", "led_Write", "button_Read", "oc1_Mode"]
+
+# misuse that must not compile: (what, body, static_assert message)
+MUST_FAIL = [
+    ("write to W1C EXTI_PR", "EXTI_::PR::write(1);", "read-only or write-1-to-clear"),
+    ("RMW of W1C EXTI_PR", "EXTI_::PR::modify(1, 1);", "read-modify-write not allowed"),
+    ("RMW of rc_w0 TIM3_SR", "TIM3_::SR::modify(1, 0);", "read-modify-write not allowed"),
+    ("read of write-only BSRR", "(void)GPIO_A::BSRR::read();", "write-only"),
+    ("RMW of write-only BSRR", "GPIO_A::BSRR::modify(1, 1);", "read-modify-write not allowed"),
+    ("write to read-only IDR", "GPIO_A::IDR::write(1);", "read-only"),
+    ("clear() of a rw register", "GPIO_A::ODR::clear(1);", "write-1/write-0-to-clear"),
+    ("fields of two registers", "reg::modify(Pin<GPIO_A, 0>::mode<input>{}, Pin<GPIO_A, 0>::pull<pull_up>{});",
+     "fields of different registers"),
+    ("same field twice", "reg::modify(Pin<GPIO_A, 5>::mode<input>{}, Pin<GPIO_A, 5>::mode<output>{});",
+     "field given twice"),
+    ("value too wide", "reg::modify(TIM3_::CCMR1::OC1M::value<8>{});", "does not fit"),
+    ("pin 16", "Pin<GPIO_A, 16>::set();", "pin 0..15"),
+]
+
+
+def run(cmd):
+    p = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    return p.returncode, p.stdout
+
+
+def compile_unit(tool, flags, src, obj):
+    rc, out = run([tool] + flags + INC + ["-c", src, "-o", obj])
+    if rc:
+        sys.exit("%s failed:\n%s" % (os.path.basename(src), out))
+
+
+def sizes(prefix, obj):
+    """function -> (bytes, instructions, disassembly)"""
+    rc, out = run([prefix + "nm", "-S", obj])
+    if rc:
+        sys.exit(out)
+    res = {}
+    for line in out.splitlines():
+        f = line.split()
+        if len(f) == 4 and f[2] in "Tt" and f[3] in FUNCTIONS:
+            res[f[3]] = [int(f[1], 16), 0, ""]
+    rc, out = run([prefix + "objdump", "-d", "--no-show-raw-insn", obj])
+    name = None
+    for line in out.splitlines():
+        m = re.match(r"[0-9a-f]+ <(\w+)>:", line)
+        if m:
+            name = m.group(1) if m.group(1) in res else None
+        elif name and re.match(r"\s+[0-9a-f]+:\s", line):
+            res[name][1] += 1
+            res[name][2] += line + "\n"
+    return res
+
+
+def check_Sizes(prefix, arm, disasm, tmp):
+    c_obj, cpp_obj = os.path.join(tmp, "c.o"), os.path.join(tmp, "cpp.o")
+    target = ARM_FLAGS if arm else []
+    compile_unit(prefix + "gcc", target + FLAGS, os.path.join(HERE, "regs_Size.c"), c_obj)
+    compile_unit(prefix + "g++", target + FLAGS + CXX_FLAGS, os.path.join(HERE, "regs_Size.cpp"), cpp_obj)
+    c, cpp = sizes(prefix, c_obj), sizes(prefix, cpp_obj)
+
+    bad = 0
+    total = [0, 0]
+    print("%-18s %13s %13s" % ("bytes / insns", "C", "template"))
+    for fn in FUNCTIONS:
+        if fn not in c or fn not in cpp:
+            print("%-18s missing from %s" % (fn, "regs_Size.c" if fn not in c else "regs_Size.cpp"))
+            bad += 1
+            continue
+        larger = cpp[fn][0] > c[fn][0] or cpp[fn][1] > c[fn][1]
+        bad += larger
+        total[0] += c[fn][0]
+        total[1] += cpp[fn][0]
+        print("%-18s %8d / %-3d %8d / %-3d%s" % (fn, c[fn][0], c[fn][1], cpp[fn][0], cpp[fn][1],
+                                                "  LARGER" if larger else ""))
+        if disasm or larger:
+            print("  C:\n" + c[fn][2] + "  template:\n" + cpp[fn][2])
+    print("%-18s %8d       %8d" % (".text total", total[0], total[1]))
+    return bad
+
+
+def check_Misuse(prefix, arm, tmp):
+    bad = 0
+    src = os.path.join(tmp, "misuse.cpp")
+    target = ARM_FLAGS if arm else []
+    for what, body, msg in MUST_FAIL:
+        with open(src, "w") as f:
+            f.write('#include "stm32f401.hpp"\nusing namespace stm32;\nvoid f() { %s }\n' % body)
+        rc, out = run([prefix + "g++"] + target + CXX_FLAGS + INC + ["-fsyntax-only", src])
+        if rc == 0 or msg not in out:
+            print("FAIL %s: %s" % (what, "compiles" if rc == 0 else "rejected without \"%s\"" % msg))
+            bad += 1
+    print("%d misuse snippets, %d accepted" % (len(MUST_FAIL), bad))
+    return bad
+
+
+def main():
+    ap = argparse.ArgumentParser(description="compare regs_Size.c and regs_Size.cpp code size")
+    ap.add_argument("--prefix", help="toolchain prefix (default arm-none-eabi- if installed, else none)")
+    ap.add_argument("-d", action="store_true", help="print the disassembly of every function")
+    args = ap.parse_args()
+
+    prefix = args.prefix
+    if prefix is None:
+        prefix = "arm-none-eabi-" if shutil.which("arm-none-eabi-gcc") else ""
+    arm = prefix.startswith("arm")
+    print("toolchain: %s" % ((prefix + "gcc") if prefix else "host gcc/g++ (no arm-none-eabi-gcc)"))
+
+    with tempfile.TemporaryDirectory() as tmp:
+        bad = check_Sizes(prefix, arm, args.d, tmp)
+        bad += check_Misuse(prefix, arm, tmp)
+    sys.exit(1 if bad else 0)
+
+
+if __name__ == "__main__":
+    main()
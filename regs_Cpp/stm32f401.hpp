@@ -0,0 +1,235 @@
+/*
+ * stm32f401.hpp
+ *
+ *  Created on: Apr 10, 2025
+ *      Author: moni
+ *
+ *  Register maps for regs.hpp: the peripherals of arm.h with every register
+ *  at its RM0368 offset, written out instead of implied by struct padding,
+ *  and the bit fields the examples use.
+ */
+
+#ifndef STM32F401_HPP_
+#define STM32F401_HPP_
+
+#include "regs.hpp"
+
+namespace stm32
+{
+
+using reg::Register;
+using reg::Field;
+
+struct RCC_
+{
+	static constexpr std::uint32_t base = 0x40023800;
+
+	using CR      = Register<base + 0x00>;
+	using PLLCFGR = Register<base + 0x04>;
+	using CFGR    = Register<base + 0x08>;
+
+	struct AHB1ENR : Register<base + 0x30>
+	{
+		using GPIOAEN = Field<AHB1ENR, 0, 1>;
+		using GPIOBEN = Field<AHB1ENR, 1, 1>;
+		using GPIOCEN = Field<AHB1ENR, 2, 1>;
+		using DMA1EN  = Field<AHB1ENR, 21, 1>;
+		using DMA2EN  = Field<AHB1ENR, 22, 1>;
+	};
+	struct APB1ENR : Register<base + 0x40>
+	{
+		using TIM2EN = Field<APB1ENR, 0, 1>;
+		using TIM3EN = Field<APB1ENR, 1, 1>;
+		using TIM4EN = Field<APB1ENR, 2, 1>;
+		using TIM5EN = Field<APB1ENR, 3, 1>;
+	};
+	struct APB2ENR : Register<base + 0x44>
+	{
+		using SYSCFGEN = Field<APB2ENR, 14, 1>;
+		using TIM10EN  = Field<APB2ENR, 17, 1>;
+	};
+};
+
+enum Mode  : std::uint32_t { input = 0, output = 1, alternate = 2, analog = 3 };
+enum Pull  : std::uint32_t { no_pull = 0, pull_up = 1, pull_down = 2 };
+enum Speed : std::uint32_t { low = 0, medium = 1, fast = 2, high = 3 };
+
+template<std::uint32_t Base, unsigned Index>
+struct Gpio
+{
+	static constexpr std::uint32_t base = Base;
+	static constexpr unsigned index = Index;		//EXTICR / AHB1ENR position
+
+	struct MODER : Register<Base + 0x00>
+	{
+		template<unsigned N> using pin = Field<MODER, N*2, 2>;
+	};
+	struct OTYPER : Register<Base + 0x04>
+	{
+		template<unsigned N> using pin = Field<OTYPER, N, 1>;
+	};
+	struct OSPEEDR : Register<Base + 0x08>
+	{
+		template<unsigned N> using pin = Field<OSPEEDR, N*2, 2>;
+	};
+	struct PUPDR : Register<Base + 0x0C>
+	{
+		template<unsigned N> using pin = Field<PUPDR, N*2, 2>;
+	};
+	using IDR  = Register<Base + 0x10, reg::ro>;
+	using ODR  = Register<Base + 0x14>;
+	using BSRR = Register<Base + 0x18, reg::wo>;
+	using LCKR = Register<Base + 0x1C>;
+	struct AFRL : Register<Base + 0x20>
+	{
+		template<unsigned N> using pin = Field<AFRL, N*4, 4>;
+	};
+	struct AFRH : Register<Base + 0x24>
+	{
+		template<unsigned N> using pin = Field<AFRH, (N-8)*4, 4>;
+	};
+};
+
+using GPIO_A = Gpio<0x40020000, 0>;
+using GPIO_B = Gpio<0x40020400, 1>;
+using GPIO_C = Gpio<0x40020800, 2>;
+
+template<class Port, unsigned N>
+struct Pin
+{
+	static_assert(N < 16, "pin 0..15");
+	using port = Port;
+	static constexpr unsigned pin = N;
+	static constexpr std::uint32_t bit = 1u << N;
+
+	/* field constants for reg::modify(), so several pins merge into one store */
+	template<Mode M>  using mode  = typename Port::MODER::template pin<N>::template value<M>;
+	template<Pull P>  using pull  = typename Port::PUPDR::template pin<N>::template value<P>;
+	template<Speed S> using speed = typename Port::OSPEEDR::template pin<N>::template value<S>;
+	template<unsigned A>
+	using af = typename std::conditional_t<(N < 8), typename Port::AFRL, typename Port::AFRH>
+		::template pin<N>::template value<A>;
+
+	static void set()		{ Port::BSRR::write(bit); }
+	static void reset()		{ Port::BSRR::write(bit << 16); }
+	static void write(bool on)	{ Port::BSRR::write(on ? bit : bit << 16); }
+	static bool read()		{ return Port::IDR::read() & bit; }
+};
+
+template<std::uint32_t Base>
+struct Timer
+{
+	static constexpr std::uint32_t base = Base;
+
+	struct CR1 : Register<Base + 0x00>
+	{
+		using CEN  = Field<CR1, 0, 1>;
+		using URS  = Field<CR1, 2, 1>;
+		using OPM  = Field<CR1, 3, 1>;
+		using DIR  = Field<CR1, 4, 1>;
+		using ARPE = Field<CR1, 7, 1>;
+	};
+	struct CR2 : Register<Base + 0x04>
+	{
+		using MMS = Field<CR2, 4, 3>;
+	};
+	struct SMCR : Register<Base + 0x08>
+	{
+		using SMS = Field<SMCR, 0, 3>;
+		using TS  = Field<SMCR, 4, 3>;
+		using ECE = Field<SMCR, 14, 1>;
+	};
+	struct DIER : Register<Base + 0x0C>
+	{
+		using UIE   = Field<DIER, 0, 1>;
+		using CC1IE = Field<DIER, 1, 1>;
+		using UDE   = Field<DIER, 8, 1>;
+	};
+	struct SR : Register<Base + 0x10, reg::w0c>
+	{
+		static constexpr std::uint32_t UIF = 1u << 0;
+		static constexpr std::uint32_t CC1IF = 1u << 1;
+	};
+	struct EGR : Register<Base + 0x14, reg::wo>
+	{
+		static constexpr std::uint32_t UG = 1u << 0;
+	};
+	struct CCMR1 : Register<Base + 0x18>
+	{
+		using CC1S  = Field<CCMR1, 0, 2>;
+		using OC1PE = Field<CCMR1, 3, 1>;
+		using OC1M  = Field<CCMR1, 4, 3>;
+		using CC2S  = Field<CCMR1, 8, 2>;
+		using OC2PE = Field<CCMR1, 11, 1>;
+		using OC2M  = Field<CCMR1, 12, 3>;
+	};
+	using CCMR2 = Register<Base + 0x1C>;
+	struct CCER : Register<Base + 0x20>
+	{
+		using CC1E = Field<CCER, 0, 1>;
+		using CC1P = Field<CCER, 1, 1>;
+		using CC2E = Field<CCER, 4, 1>;
+		using CC2P = Field<CCER, 5, 1>;
+	};
+	using CNT  = Register<Base + 0x24>;
+	using PSC  = Register<Base + 0x28>;
+	using ARR  = Register<Base + 0x2C>;
+	using RCR  = Register<Base + 0x30>;
+	using CCR1 = Register<Base + 0x34>;
+	using CCR2 = Register<Base + 0x38>;
+	using CCR3 = Register<Base + 0x3C>;
+	using CCR4 = Register<Base + 0x40>;
+	using BDTR = Register<Base + 0x44>;
+	using DCR  = Register<Base + 0x48>;
+	using DMAR = Register<Base + 0x4C>;
+	using OR   = Register<Base + 0x50>;
+};
+
+using TIM3_ = Timer<0x40000400>;
+using TIM4_ = Timer<0x40000800>;
+using TIM10_ = Timer<0x40014400>;
+
+struct EXTI_
+{
+	static constexpr std::uint32_t base = 0x40013C00;
+
+	using IMR   = Register<base + 0x00>;
+	using EMR   = Register<base + 0x04>;
+	using RTSR  = Register<base + 0x08>;
+	using FTSR  = Register<base + 0x0C>;
+	using SWIER = Register<base + 0x10>;
+	using PR    = Register<base + 0x14, reg::w1c>;
+};
+
+struct SYSCFG_
+{
+	static constexpr std::uint32_t base = 0x40013800;
+
+	template<unsigned I>
+	struct EXTICR : Register<base + 0x08 + 4*I> {};
+
+	/* EXTI line N taken from Port */
+	template<unsigned N, class Port>
+	using exti = typename Field<EXTICR<N/4>, (N%4)*4, 4>::template value<Port::index>;
+};
+
+struct NVIC_
+{
+	/* write 1 to enable, 0 has no effect: no read needed */
+	template<unsigned Irq>
+	static void enable()
+	{
+		Register<0xE000E100 + 4*(Irq/32), reg::wo>::write(1u << (Irq%32));
+	}
+
+	/* IPR is byte-accessible: one STRB, no read-modify-write */
+	template<unsigned Irq>
+	static void priority(std::uint8_t p)
+	{
+		*reinterpret_cast<volatile std::uint8_t *>(0xE000E400 + Irq) = p;
+	}
+};
+
+} /* namespace stm32 */
+
+#endif /* STM32F401_HPP_ */
@@ -0,0 +1,255 @@
+/**
+ ******************************************************************************
+ * @file    soft_Pwm.c
+ * @author  Monish Kumar.k
+ * @date    22/04/2025
+ * @brief   led_Blinking_Column with 8-bit brightness on PA0..PA7 from the
+ *          sorted-edge software PWM, and its interrupt load against a
+ *          tick-driven PWM.
+ *
+ * @details
+ * Hardware Connections: LEDs on PA0..PA7 as led_Blinking_Column, USART1 TX
+ * on PA9 for the log. Clock is 84 MHz.
+ *
+ * Benchmark, BENCH_MS per run, load from the main loop iterations against
+ * a run with no PWM interrupts (in 1/100 %):
+ *  - spwm with 1, 2, 4, 8 and 16 channels, all duties distinct (worst
+ *    case, one compare interrupt per channel) and all equal (one),
+ *  - a tick PWM: TIM3 at 256 x SPWM_HZ, every tick compares 16 duties,
+ *  - the cycles of spwm_Commit() for 16 distinct duties.
+ * The 16-channel runs drive all of GPIOA. BSRR only reaches pins in output
+ * mode, so PA9/PA10 (USART1) and PA13/PA14 (SWD) are not disturbed.
+ * Results are logged with LOG() and kept in bench[].
+ *
+ * Then PA0..PA7 run a breathing wave, one LED after the other.
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 22/04/2025
+  File : soft_Pwm
+ ******************************************************************************/
+#include <arm.h>
+#include <rcc.h>
+#include <uart.h>
+#include <log.h>
+#include "spwm.h"
+
+#define LOG_PORT		UART_1
+#define TIM3_IRQ		29
+#define BENCH_MS		500
+#define WAVE_MS			10
+
+struct bench_result
+{
+	unsigned int channels;
+	unsigned int distinct_load;		//1/100 %
+	unsigned int distinct_irqs;		//per second
+	unsigned int equal_load;
+	unsigned int equal_irqs;
+};
+
+static const unsigned char bench_channels[] = { 1, 2, 4, 8, 16 };
+#define BENCH_N		sizeof(bench_channels)
+
+static volatile unsigned char tick_duty[16];
+static volatile unsigned int tick_count;
+
+volatile struct bench_result bench[BENCH_N];
+volatile unsigned int tick_load, commit_cycles;
+
+void rcc_Config(void);
+void gpio_Moder(void);
+unsigned int bench_Spins(void);
+unsigned int bench_Load(unsigned int spins, unsigned int idle);
+void bench_Duties(unsigned int channels, unsigned int distinct);
+void bench_Run(void);
+void tick_Run(unsigned int idle);
+void wave_Step(unsigned int phase);
+
+int main(void)
+{
+	unsigned int last, phase = 0;
+
+	rcc_Config();
+	gpio_Moder();
+	uart_Init(LOG_PORT, 921600);
+	log_Init();
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);		/* CYCCNTENA */
+
+	bench_Run();
+
+	spwm_Init(GPIOA, 0x00FF);
+	last = DWT->CYCCNT;
+	while(1)
+	{
+		if(DWT->CYCCNT - last >= rcc_Get_Sysclk() / 1000 * WAVE_MS)
+		{
+			last += rcc_Get_Sysclk() / 1000 * WAVE_MS;
+			wave_Step(phase++);
+		}
+		log_Drain(LOG_PORT);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* APB1 /2 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+void gpio_Moder()
+{
+	RCC->AHB1ENR |= (1<<0);
+	GPIOA->BSRR = (0xFF<<16);
+	GPIOA->MODER = (GPIOA->MODER & ~0xFFFF) | 0x5555;		/* PA0..PA7 output */
+}
+
+/* main loop iterations in BENCH_MS */
+unsigned int bench_Spins()
+{
+	unsigned int window = rcc_Get_Sysclk() / 1000 * BENCH_MS;
+	unsigned int start = DWT->CYCCNT, spins = 0;
+
+	while(DWT->CYCCNT - start < window)
+	{
+		spins++;
+	}
+	return spins;
+}
+
+unsigned int bench_Load(unsigned int spins, unsigned int idle)
+{
+	if(!idle || spins >= idle)
+		return 0;
+	return (unsigned int)(10000 - (unsigned long long)spins * 10000 / idle);
+}
+
+/* distinct: 8, 23, 38, ... ; otherwise all 128 */
+void bench_Duties(unsigned int channels, unsigned int distinct)
+{
+	for(unsigned int pin = 0; pin < SPWM_CHANNELS; pin++)
+	{
+		spwm_Set(pin, pin < channels ? (distinct ? 8 + pin * 15 : 128) : 0);
+	}
+	spwm_Commit();
+}
+
+void bench_Run()
+{
+	unsigned int idle = bench_Spins();
+	unsigned int start, irqs;
+
+	spwm_Init(GPIOA, 0xFFFF);
+	for(unsigned int i = 0; i < BENCH_N; i++)
+	{
+		volatile struct bench_result *r = &bench[i];
+
+		r->channels = bench_channels[i];
+
+		bench_Duties(r->channels, 1);
+		bench_Spins();						//let the new list start
+		irqs = spwm_Irqs();
+		r->distinct_load = bench_Load(bench_Spins(), idle);
+		r->distinct_irqs = (spwm_Irqs() - irqs) * 1000 / BENCH_MS;
+
+		bench_Duties(r->channels, 0);
+		bench_Spins();
+		irqs = spwm_Irqs();
+		r->equal_load = bench_Load(bench_Spins(), idle);
+		r->equal_irqs = (spwm_Irqs() - irqs) * 1000 / BENCH_MS;
+
+		LOG("spwm %u channels: distinct %u irq/s load %u/10000, equal %u irq/s load %u/10000",
+			r->channels, r->distinct_irqs, r->distinct_load, r->equal_irqs, r->equal_load);
+		log_Drain(LOG_PORT);
+	}
+
+	for(unsigned int pin = 0; pin < SPWM_CHANNELS; pin++)
+	{
+		spwm_Set(pin, 8 + pin * 15);
+	}
+	start = DWT->CYCCNT;
+	spwm_Commit();
+	commit_cycles = DWT->CYCCNT - start;
+
+	bench_Duties(0, 0);
+	bench_Spins();
+	TIM2->CR1 = 0;
+	TIM2->DIER = 0;
+
+	tick_Run(idle);
+	LOG("tick PWM 16 channels: %u irq/s load %u/10000; spwm_Commit 16 distinct: %u cycles",
+		256 * SPWM_HZ, tick_load, commit_cycles);
+	log_Drain(LOG_PORT);
+}
+
+/* the usual software PWM: one interrupt per duty step, compare every channel */
+void TIM3_IRQHandler()
+{
+	unsigned int t, bsrr = 0;
+
+	TIM3->SR = ~(1<<0);
+	t = tick_count = (tick_count + 1) & 255;
+	if(t == 0)
+	{
+		bsrr = 0xFFFF;
+	}
+	for(unsigned int pin = 0; pin < 16; pin++)
+	{
+		if(tick_duty[pin] == t)
+			bsrr |= (1u << (pin + 16));
+	}
+	GPIOA->BSRR = bsrr;
+}
+
+void tick_Run(unsigned int idle)
+{
+	for(unsigned int pin = 0; pin < 16; pin++)
+	{
+		tick_duty[pin] = (unsigned char)(8 + pin * 15);
+	}
+	RCC->APB1ENR |= (1<<1);
+	TIM3->CR1 = 0;
+	TIM3->PSC = 0;
+	TIM3->ARR = rcc_Get_Tim_Clock(1) / (256 * SPWM_HZ) - 1;
+	TIM3->EGR = (1<<0);
+	TIM3->SR = 0;
+	TIM3->DIER = (1<<0);
+	NVIC->IP[TIM3_IRQ] = (2<<4);
+	NVIC->ISER[TIM3_IRQ >> 5] = (1 << (TIM3_IRQ & 31));
+	TIM3->CR1 = (1<<0);
+
+	tick_load = bench_Load(bench_Spins(), idle);
+
+	TIM3->CR1 = 0;
+	TIM3->DIER = 0;
+	NVIC->ICER[TIM3_IRQ >> 5] = (1 << (TIM3_IRQ & 31));
+	GPIOA->BSRR = (0xFF<<16);
+}
+
+/* triangle per LED, 32 steps apart, squared for a more even fade */
+void wave_Step(unsigned int phase)
+{
+	for(unsigned int pin = 0; pin < 8; pin++)
+	{
+		unsigned int p = (phase * 4 + pin * 32) & 511;
+		unsigned int tri = (p < 256) ? p : 511 - p;
+
+		spwm_Set(pin, tri * tri / 255);
+	}
+	spwm_Commit();
+}
@@ -0,0 +1,186 @@
+/**
+ ******************************************************************************
+ * @file    spwm.c
+ * @author  Monish Kumar.k
+ * @date    22/04/2025
+ * @brief   Sorted-edge software PWM on the TIM2 update and CC1 interrupts.
+ *
+ * @details
+ *  - Two edge lists: the interrupt plays 'cur', spwm_Commit() builds the
+ *    other one and marks it pending; the update interrupt swaps them at
+ *    the start of a period.
+ *  - Sorting is an insertion sort of at most 16 (duty, mask) pairs that
+ *    merges equal duties. It runs when the duties change, in the caller,
+ *    not in the interrupt.
+ *  - Edge time = duty * ARR / 255 timer clocks. At 84 MHz and 250 Hz a
+ *    duty step is 1317 clocks (15.7 us), much longer than the interrupt,
+ *    so edges never crowd; both the CC1 and the update handler still run
+ *    every edge whose time has already passed before they return, so a
+ *    late interrupt delays an edge but never skips it.
+ ******************************************************************************
+ */
+#include <arm.h>
+#include <rcc.h>
+#include "spwm.h"
+
+#define TIM2_IRQ		28
+
+struct spwm_list
+{
+	unsigned int bsrr;						//period start: set duty > 0, reset duty 0
+	unsigned int n;
+	unsigned int time[SPWM_CHANNELS];
+	unsigned int reset[SPWM_CHANNELS];		//BSRR reset half
+};
+
+static struct spwm_list lists[2];
+static struct spwm_list *volatile cur;
+static volatile unsigned int pending;		//1 + index of the list to start with
+static volatile struct gpio *spwm_port;
+static unsigned int spwm_pins;
+static unsigned char duty[SPWM_CHANNELS];
+static unsigned int period;					//timer clocks
+static unsigned int edge;
+static volatile unsigned int irq_count;
+
+static void spwm_Build(struct spwm_list *l)
+{
+	unsigned int on = 0, off = 0;
+
+	l->n = 0;
+	for(unsigned int pin = 0; pin < SPWM_CHANNELS; pin++)
+	{
+		unsigned int bit = 1u << pin, d = duty[pin], i, t;
+
+		if(!(spwm_pins & bit))
+			continue;
+		if(d == 0)
+		{
+			off |= bit;
+			continue;
+		}
+		on |= bit;
+		if(d == 255)
+			continue;
+
+		/* insert by time, merge with an equal duty */
+		t = d * period / 255;
+		for(i = l->n; i > 0 && l->time[i - 1] > t; i--)
+		{
+		}
+		if(i > 0 && l->time[i - 1] == t)
+		{
+			l->reset[i - 1] |= bit << 16;
+			continue;
+		}
+		for(unsigned int j = l->n; j > i; j--)
+		{
+			l->time[j] = l->time[j - 1];
+			l->reset[j] = l->reset[j - 1];
+		}
+		l->time[i] = t;
+		l->reset[i] = bit << 16;
+		l->n++;
+	}
+	l->bsrr = on | (off << 16);
+}
+
+void spwm_Init(volatile struct gpio *port, unsigned int pins)
+{
+	spwm_port = port;
+	spwm_pins = pins & 0xFFFF;
+	period = rcc_Get_Tim_Clock(1) / SPWM_HZ;
+	for(unsigned int i = 0; i < SPWM_CHANNELS; i++)
+	{
+		duty[i] = 0;
+	}
+	spwm_Build(&lists[0]);
+	cur = &lists[0];
+	pending = 0;
+	edge = 0;
+	irq_count = 0;
+
+	RCC->APB1ENR |= (1<<0);
+	TIM2->CR1 = 0;
+	TIM2->PSC = 0;
+	TIM2->ARR = period - 1;
+	TIM2->CCMR1 = 0;						//CH1 frozen, compare only
+	TIM2->EGR = (1<<0);
+	TIM2->SR = 0;
+	TIM2->DIER = (1<<0);					//UIE; CC1IE while edges are left
+	NVIC->IP[TIM2_IRQ] = (2<<4);			//above the UART, a late edge is visible
+	NVIC->ISER[TIM2_IRQ >> 5] = (1 << (TIM2_IRQ & 31));
+	TIM2->CR1 = (1<<0);
+}
+
+void spwm_Set(unsigned int pin, unsigned int d)
+{
+	if(pin < SPWM_CHANNELS)
+		duty[pin] = (unsigned char)((d > 255) ? 255 : d);
+}
+
+void spwm_Commit()
+{
+	struct spwm_list *l;
+
+	while(pending);							//the last commit is not playing yet
+	l = (cur == &lists[0]) ? &lists[1] : &lists[0];
+	spwm_Build(l);
+	pending = 1 + (unsigned int)(l - lists);
+}
+
+unsigned int spwm_Edges()
+{
+	return cur->n;
+}
+
+unsigned int spwm_Irqs()
+{
+	return irq_count;
+}
+
+/*
+ * Arms CC1 for the next edge of l. CCR1 is written before CNT is read, so an
+ * edge is either still ahead (its match raises CC1IF) or already passed and
+ * done here: none is skipped, however late the interrupt runs.
+ */
+static void spwm_Next(struct spwm_list *l)
+{
+	while(edge < l->n)
+	{
+		TIM2->CCR1 = l->time[edge];
+		if(l->time[edge] > TIM2->CNT)
+			return;
+		spwm_port->BSRR = l->reset[edge];
+		edge++;
+	}
+	TIM2->DIER = (1<<0);					//UIE only until the next period
+}
+
+void TIM2_IRQHandler()
+{
+	unsigned int sr = TIM2->SR;
+	struct spwm_list *l = cur;
+
+	irq_count++;
+	if(sr & (1<<1))
+	{
+		TIM2->SR = ~(1<<1);					//rc_w0
+		spwm_Next(l);
+	}
+	if(sr & (1<<0))
+	{
+		TIM2->SR = ~(1<<0);
+		if(pending)
+		{
+			l = &lists[pending - 1];
+			cur = l;
+			pending = 0;
+		}
+		spwm_port->BSRR = l->bsrr;
+		edge = 0;
+		TIM2->SR = ~(1<<1);					//a match before the new CCR1 does not count
+		TIM2->DIER = (1<<1) | (1<<0);
+		spwm_Next(l);						//a late update may already be past time[0]
+	}
+}
@@ -0,0 +1,36 @@
+/*
+ * spwm.h
+ *
+ *  Created on: Apr 22, 2025
+ *      Author: moni
+ *
+ *  Software PWM for up to 16 pins of one GPIO port, 8-bit duty (0 = off,
+ *  255 = on) at SPWM_HZ.
+ *
+ *  TIM2 (32-bit) runs at the timer clock with one PWM period per update.
+ *  spwm_Commit() sorts the duties into an edge list: one BSRR set mask for
+ *  the start of the period, then one (time, BSRR reset mask) entry per
+ *  distinct duty. The update interrupt writes the set mask, and CC1 is
+ *  moved from edge to edge. Each write of the combined mask switches every
+ *  channel that shares that duty.
+ *  Interrupts per period: 1 + the distinct duties between 1 and 254. A
+ *  tick-driven PWM needs 256.
+ *
+ *  Duties are written with spwm_Set() and take effect together at the next
+ *  period after spwm_Commit(), so a change never cuts a period short.
+ *  Pins not in the mask given to spwm_Init() are never written.
+ */
+
+#ifndef SPWM_H_
+#define SPWM_H_
+
+#define SPWM_HZ			250
+#define SPWM_CHANNELS	16
+
+void spwm_Init(volatile struct gpio *port, unsigned int pins);
+void spwm_Set(unsigned int pin, unsigned int duty);
+void spwm_Commit(void);				//the new duties from the next period
+unsigned int spwm_Edges(void);		//compare interrupts per period of the running list
+unsigned int spwm_Irqs(void);		//interrupts since spwm_Init
+
+#endif /* SPWM_H_ */
@@ -0,0 +1,277 @@
+/**
+ ******************************************************************************
+ * @file    spwm_Test.c
+ * @author  Monish Kumar.k
+ * @date    22/04/2025
+ * @brief   Host model of the sorted-edge software PWM with late interrupts:
+ *          every channel edge lands, however late TIM2_IRQHandler runs.
+ *
+ * @details
+ * Build and run on the host (Linux x86-64, the register blocks are mapped
+ * at their STM32 addresses):
+ *
+ *     gcc -O2 -I../manual_PWM -o spwm_Test spwm_Test.c && ./spwm_Test
+ *
+ * spwm.c is included unmodified. TIM2 is modelled in timer clocks: CNT
+ * wraps at ARR with UIF, passing CCR1 going up sets CC1IF, and an enabled
+ * flag runs TIM2_IRQHandler() a random latency later (mostly < 200
+ * clocks, one in three up to 20000, i.e. 15 duty steps). TIM2_SR (rc_w0)
+ * and GPIOA_BSRR behave as on the chip: their pages are read-only while
+ * the driver runs, each store traps, is single-stepped and applied, and a
+ * BSRR store switches the pins at the handler's time.
+ *
+ * PERIODS periods with random pin masks and random duties (0, 1, 254,
+ * 255, repeats and distinct values), recommitted every few periods. For
+ * every period and every channel of the playing duties:
+ *  - 0 stays low, 255 stays high,
+ *  - 1..254 goes high in the update handler and low exactly once, at
+ *    least at d * period / 255 and at most MAX_LATENCY after it. A reset
+ *    due less than MAX_LATENCY before the period end may instead run into
+ *    the next period (the pin then stays high); these are counted.
+ * Exits non-zero on a failure.
+ ******************************************************************************
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <ucontext.h>
+#include <sys/mman.h>
+
+unsigned int rcc_Get_Tim_Clock(int bus)			{ (void)bus; return 84000000; }
+
+#include "spwm.c"
+
+#define PERIODS			4000
+#define MAX_LATENCY		20000
+#define TIM2_PAGE		0x40000000UL
+#define GPIOA_PAGE		0x40020000UL
+#define TF				0x100				//x86 trap flag
+
+static unsigned long long now;				//timer clocks since spwm_Init
+static unsigned long long period_start;		//of the running period
+static unsigned char playing[SPWM_CHANNELS], next_duty[SPWM_CHANNELS];
+static unsigned int merged;				//resets due too close to the period end
+static unsigned long long fall[SPWM_CHANNELS];
+static unsigned int falls[SPWM_CHANNELS], level[SPWM_CHANNELS];
+static unsigned int failures, edges_checked, late_updates;
+
+/* ---- TIM2_SR rc_w0 and GPIOA_BSRR ---- */
+
+static volatile unsigned int *trap_addr;
+static unsigned int trap_old;
+
+static void protect(int on)
+{
+	mprotect((void *)TIM2_PAGE, 0x1000, on ? PROT_READ : PROT_READ | PROT_WRITE);
+	mprotect((void *)GPIOA_PAGE, 0x1000, on ? PROT_READ : PROT_READ | PROT_WRITE);
+}
+
+static void on_Segv(int sig, siginfo_t *si, void *ctx)
+{
+	ucontext_t *uc = ctx;
+	unsigned long a = (unsigned long)si->si_addr;
+
+	(void)sig;
+	if((a & ~0xFFFUL) != TIM2_PAGE && (a & ~0xFFFUL) != GPIOA_PAGE)
+		abort();
+	trap_addr = (volatile unsigned int *)a;
+	trap_old = *trap_addr;
+	mprotect((void *)(a & ~0xFFFUL), 0x1000, PROT_READ | PROT_WRITE);
+	uc->uc_mcontext.gregs[REG_EFL] |= TF;			//one instruction, then SIGTRAP
+}
+
+static void pin_Write(unsigned int bsrr);
+
+static void on_Trap(int sig, siginfo_t *si, void *ctx)
+{
+	ucontext_t *uc = ctx;
+
+	(void)sig;
+	(void)si;
+	if(trap_addr == &TIM2->SR)
+		TIM2->SR = trap_old & TIM2->SR;
+	else if(trap_addr == &GPIOA->BSRR)
+		pin_Write(GPIOA->BSRR);
+	protect(1);
+	uc->uc_mcontext.gregs[REG_EFL] &= ~TF;
+}
+
+static void map(unsigned long addr, unsigned long len)
+{
+	if(mmap((void *)addr, len, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED)
+	{
+		perror("mmap");
+		exit(2);
+	}
+}
+
+/* ---- checks ---- */
+
+static void fail(const char *what, unsigned int ch, unsigned long long a, unsigned long long b)
+{
+	if(failures++ < 10)
+		printf("FAIL period %llu, channel %u: %s (%llu, %llu)\n", period_start / period, ch, what, a, b);
+}
+
+static void pin_Write(unsigned int bsrr)
+{
+	for(unsigned int ch = 0; ch < SPWM_CHANNELS; ch++)
+	{
+		if(bsrr & (1u << ch))
+			level[ch] = 1;
+		else if(bsrr & (1u << (ch + 16)))
+		{
+			if(level[ch])
+			{
+				fall[ch] = now;
+				falls[ch]++;
+			}
+			level[ch] = 0;
+		}
+	}
+	if(bsrr & ~(spwm_pins | (spwm_pins << 16)))
+		fail("pin outside the mask written", 0, bsrr, spwm_pins);
+}
+
+/* in the update handler: what the playing duties made of the period that just ended */
+static void period_Check(void)
+{
+	unsigned long long base = period_start - period;
+
+	for(unsigned int ch = 0; ch < SPWM_CHANNELS; ch++)
+	{
+		unsigned int d = playing[ch];
+		unsigned long long e = base + d * period / 255;
+
+		if(!(spwm_pins & (1u << ch)))
+			continue;
+		if(d == 0 && (level[ch] || (falls[ch] && fall[ch] > base + MAX_LATENCY)))
+			fail("duty 0 high after the update", ch, falls[ch], 0);
+		else if(d == 255 && (!level[ch] || falls[ch]))
+			fail("duty 255 went low", ch, falls[ch], 0);
+		else if(d > 0 && d < 255)
+		{
+			edges_checked++;
+			if(falls[ch] == 0 && level[ch] && e + MAX_LATENCY >= period_start)
+				merged++;					//the interrupt ran past the end: one longer pulse
+			else if(falls[ch] != 1)
+				fail("reset edges in the period", ch, falls[ch], d);
+			else if(fall[ch] < e || fall[ch] > e + MAX_LATENCY)
+				fail("reset edge time against d * period / 255", ch, fall[ch] - base, e - base);
+		}
+		falls[ch] = 0;
+	}
+}
+
+/* ---- model ---- */
+
+static unsigned int latency(void)
+{
+	return (rand() % 3) ? rand() % 200 : rand() % MAX_LATENCY;
+}
+
+static void irq(void)
+{
+	unsigned int update = TIM2->SR & TIM2->DIER & (1<<0), was_pending = pending;
+
+	if(update)
+	{
+		period_Check();
+		if(was_pending)
+			memcpy(playing, next_duty, sizeof(playing));
+		if(now - period_start > period / 255)
+			late_updates++;
+	}
+	TIM2->CNT = (unsigned int)(now - period_start);
+	protect(1);
+	TIM2_IRQHandler();
+	protect(0);
+}
+
+static void commit(void)
+{
+	unsigned int n = 1 + rand() % 4;
+	unsigned int pool[4];
+
+	for(unsigned int i = 0; i < n; i++)
+	{
+		static const unsigned char special[] = { 0, 1, 254, 255 };
+		pool[i] = (rand() % 2) ? special[rand() % 4] : 1 + rand() % 254;
+	}
+	for(unsigned int ch = 0; ch < SPWM_CHANNELS; ch++)
+	{
+		next_duty[ch] = (unsigned char)((rand() % 2) ? pool[rand() % n] : (unsigned int)(rand() % 256));
+		spwm_Set(ch, next_duty[ch]);
+	}
+	spwm_Commit();
+}
+
+static void run(unsigned int mask)
+{
+	unsigned long long irq_at = ~0ULL, end;
+
+	memset((void *)TIM2, 0, sizeof(*TIM2));
+	GPIOA->BSRR = 0;
+	memset(level, 0, sizeof(level));
+	memset(falls, 0, sizeof(falls));
+	memset(playing, 0, sizeof(playing));
+	spwm_Init(GPIOA, mask);
+	now = period_start = 0;
+	end = (unsigned long long)PERIODS / 4 * period;
+	commit();
+
+	while(now < end)
+	{
+		unsigned long long wrap = period_start + period, match = ~0ULL, t;
+		unsigned int cnt = (unsigned int)(now - period_start);
+
+		if(TIM2->CCR1 > cnt && TIM2->CCR1 < period)
+			match = period_start + TIM2->CCR1;
+		if(irq_at == ~0ULL && (TIM2->SR & TIM2->DIER & 3))
+			irq_at = now + latency();
+		t = wrap < match ? wrap : match;
+		if(irq_at <= t)
+		{
+			now = irq_at;
+			irq_at = ~0ULL;
+			irq();
+			if(!pending && rand() % 4 == 0)
+				commit();
+			continue;
+		}
+		now = t;
+		if(t == wrap)
+		{
+			period_start = wrap;
+			TIM2->SR |= (1<<0);
+		}
+		else
+			TIM2->SR |= (1<<1);
+	}
+}
+
+int main(void)
+{
+	struct sigaction sa;
+
+	map(0x40000000, 0x30000);
+	map(0xE0000000, 0x10000);
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_flags = SA_SIGINFO;
+	sa.sa_sigaction = on_Segv;
+	sigaction(SIGSEGV, &sa, NULL);
+	sa.sa_sigaction = on_Trap;
+	sigaction(SIGTRAP, &sa, NULL);
+	srand(1);
+
+	run(0xFFFF);
+	run(0x00FF);
+	run(0xA5A5);
+	run(1u << 15);
+
+	printf("spwm: %u edges checked, %u updates later than duty 1, %u resets past the period end, %u failures\n",
+		edges_checked, late_updates, merged, failures);
+	return failures != 0;
+}
@@ -0,0 +1,178 @@
+/**
+ ******************************************************************************
+ * @file    soft_Timer.c
+ * @author  Monish Kumar.k
+ * @date    12/04/2025
+ * @brief   Timer_10_500ms on tickless software timers: the 500 ms blink of
+ *          PC13 plus more timers, all from one TIM5 compare channel.
+ *
+ * @details
+ * Hardware Connections: LED on PC13 (active low), USART2 TX on PA2 for the
+ * log. Clock is 84 MHz from the PLL.
+ *
+ * Timer_10_500ms waited for each 500 ms in delay(), polling the TIM10
+ * update flag, so the CPU could do nothing else. Here:
+ *  - blink   : periodic 500 ms, toggles PC13 in the TIM5 interrupt,
+ *  - fast    : periodic 100 ms, counts in the interrupt,
+ *  - slow    : periodic 250 ms, counts in the interrupt,
+ *  - report  : periodic 1 s, STIMER_DEFERRED, logs from the main loop,
+ *  - once    : one-shot 3 s after start, stops 'fast'.
+ * The main loop only runs stimer_Poll() and log_Drain().
+ *
+ * Reported with LOG() on USART2:
+ *  - cycles of stimer_Start() and stimer_Stop() with 1, 8 and 32 timers
+ *    in the heap (average of BENCH_REPS, measured before the demo timers
+ *    are started), kept in bench[],
+ *  - every second: TIM5 interrupts in that second against the 1000 of a
+ *    1 kHz tick, and the counts of the timers.
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 12/04/2025
+  File : soft_Timer
+ ******************************************************************************/
+#include <arm.h>
+#include <bitband.h>
+#include <uart.h>
+#include <log.h>
+#include "stimer.h"
+
+#define LOG_PORT		UART_2
+#define BENCH_REPS		16
+
+struct bench_result
+{
+	unsigned int queued;			//timers in the heap, the measured one included
+	unsigned int start_cycles;
+	unsigned int stop_cycles;
+};
+
+static struct stimer blink, fast, slow, report, once;
+static struct stimer filler[STIMER_MAX];
+static volatile unsigned int fast_count, slow_count;
+
+volatile struct bench_result bench[3];
+
+void rcc_Config(void);
+void gpio_Moder(void);
+void bench_Run(volatile struct bench_result *r, unsigned int queued);
+void blink_Cb(struct stimer *t);
+void count_Cb(struct stimer *t);
+void once_Cb(struct stimer *t);
+void report_Cb(struct stimer *t);
+
+int main(void)
+{
+	rcc_Config();
+	gpio_Moder();
+	uart_Init(LOG_PORT, 921600);
+	log_Init();
+	stimer_Init();
+
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);		/* CYCCNTENA */
+	bench_Run(&bench[0], 1);
+	bench_Run(&bench[1], 8);
+	bench_Run(&bench[2], STIMER_MAX);
+	for(unsigned int i = 0; i < 3; i++)
+	{
+		LOG("stimer: %u queued, start %u cycles, stop %u cycles",
+			bench[i].queued, bench[i].start_cycles, bench[i].stop_cycles);
+	}
+
+	stimer_Start(&blink, 500000, 500000, blink_Cb, 0, 0);
+	stimer_Start(&fast, 100000, 100000, count_Cb, (void*)&fast_count, 0);
+	stimer_Start(&slow, 250000, 250000, count_Cb, (void*)&slow_count, 0);
+	stimer_Start(&once, 3000000, 0, once_Cb, 0, 0);
+	stimer_Start(&report, 1000000, 1000000, report_Cb, 0, STIMER_DEFERRED);
+	while(1)
+	{
+		stimer_Poll();
+		log_Drain(LOG_PORT);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* APB1 /2 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+void gpio_Moder()
+{
+	RCC->AHB1ENR = RCC->AHB1ENR | (1<<2);
+	GPIOC->MODER = (GPIOC->MODER & ~(0x3<<26)) | (1<<26);
+	BITBAND(&GPIOC->ODR, 13) = 1; // LED off
+}
+
+/* queued - 1 fillers spread over 10..41 s, then start/stop one timer in the middle */
+void bench_Run(volatile struct bench_result *r, unsigned int queued)
+{
+	unsigned int start, start_sum = 0, stop_sum = 0;
+	struct stimer t;
+
+	for(unsigned int i = 0; i + 1 < queued; i++)
+	{
+		stimer_Start(&filler[i], 10000000 + ((i * 7919) % STIMER_MAX) * 1000000, 0, count_Cb, 0, 0);
+	}
+	for(unsigned int i = 0; i < BENCH_REPS; i++)
+	{
+		start = DWT->CYCCNT;
+		stimer_Start(&t, 25000000, 0, count_Cb, 0, 0);
+		start_sum += DWT->CYCCNT - start;
+
+		start = DWT->CYCCNT;
+		stimer_Stop(&t);
+		stop_sum += DWT->CYCCNT - start;
+	}
+	for(unsigned int i = 0; i + 1 < queued; i++)
+	{
+		stimer_Stop(&filler[i]);
+	}
+	r->queued = queued;
+	r->start_cycles = start_sum / BENCH_REPS;
+	r->stop_cycles = stop_sum / BENCH_REPS;
+}
+
+void blink_Cb(struct stimer *t)
+{
+	(void)t;
+	BITBAND(&GPIOC->ODR, 13) ^= 1;
+}
+
+void count_Cb(struct stimer *t)
+{
+	if(t->arg)
+		(*(volatile unsigned int*)t->arg)++;
+}
+
+void once_Cb(struct stimer *t)
+{
+	(void)t;
+	stimer_Stop(&fast);
+}
+
+/* deferred: runs in stimer_Poll(), so LOG() is called from the main loop only */
+void report_Cb(struct stimer *t)
+{
+	static unsigned int last_irqs;
+	unsigned int irqs = stimer_Irqs();
+
+	LOG("1 s: %u timer interrupts (1 kHz tick: 1000), fast %u, slow %u, report missed %u",
+		irqs - last_irqs, fast_count, slow_count, t->missed);
+	last_irqs = irqs;
+}
@@ -0,0 +1,300 @@
+/**
+ ******************************************************************************
+ * @file    stimer.c
+ * @author  Monish Kumar.k
+ * @date    12/04/2025
+ * @brief   Tickless software timers: a min-heap of expiry times on the
+ *          32-bit TIM5 counter and its CH1 compare.
+ *
+ * @details
+ *  - TIM5 runs free at 1 MHz over 0..0xFFFFFFFF and is never stopped or
+ *    reloaded, so stimer_Now() is a plain read of CNT.
+ *  - heap[0] is the nearest expiry and CCR1 always holds it. After CCR1
+ *    is written the counter is read again; if it has already passed the
+ *    expiry (the match was missed while writing) CC1G forces the event.
+ *  - Each timer keeps its heap index, so stimer_Stop() removes it in
+ *    O(log n) without a search.
+ *  - A periodic timer is re-inserted at expire + period, not at now +
+ *    period, so interrupt latency does not add up into drift. If that
+ *    time has gone by already (a slow callback, a long block by a higher
+ *    priority), it moves on to the first period after CNT and the skipped
+ *    firings go to 'missed', so the interrupt cannot keep chasing it.
+ *  - Heap and deferred ring are changed with interrupts masked (PRIMASK
+ *    saved and restored as in log.c), so any context may start and stop
+ *    timers.
+ ******************************************************************************
+ */
+#include <arm.h>
+#include <rcc.h>
+#include "stimer.h"
+
+#define TIM5_IRQ		50
+#define CC1IF			(1<<1)
+
+static struct stimer *heap[STIMER_MAX];
+static unsigned int heap_n;
+
+static struct stimer *deferred[STIMER_MAX];		//at most every timer once, see 'pending'
+static volatile unsigned int def_head, def_tail;
+
+static volatile unsigned int irq_count;
+
+#if defined(__arm__)
+static inline unsigned int irq_Save(void)
+{
+	unsigned int primask;
+
+	__asm volatile("mrs %0, primask\n\tcpsid i" : "=r"(primask) :: "memory");
+	return primask;
+}
+
+static inline void irq_Restore(unsigned int primask)
+{
+	__asm volatile("msr primask, %0" :: "r"(primask) : "memory");
+}
+#else
+/* host build (stimer_Test.c): the simulated interrupt only runs between calls */
+static inline unsigned int irq_Save(void)			{ return 0; }
+static inline void irq_Restore(unsigned int primask)	{ (void)primask; }
+#endif
+
+/* wrap-safe: a expires before b */
+static inline int stimer_Before(const struct stimer *a, const struct stimer *b)
+{
+	return (int)(a->expire - b->expire) < 0;
+}
+
+static inline void heap_Set(unsigned int i, struct stimer *t)
+{
+	heap[i] = t;
+	t->heap_pos = i + 1;
+}
+
+static void heap_Up(unsigned int i)
+{
+	struct stimer *t = heap[i];
+
+	while(i)
+	{
+		unsigned int parent = (i - 1) >> 1;
+
+		if(!stimer_Before(t, heap[parent]))
+			break;
+		heap_Set(i, heap[parent]);
+		i = parent;
+	}
+	heap_Set(i, t);
+}
+
+static void heap_Down(unsigned int i)
+{
+	struct stimer *t = heap[i];
+
+	while(1)
+	{
+		unsigned int child = 2*i + 1;
+
+		if(child >= heap_n)
+			break;
+		if(child + 1 < heap_n && stimer_Before(heap[child + 1], heap[child]))
+			child++;
+		if(!stimer_Before(heap[child], t))
+			break;
+		heap_Set(i, heap[child]);
+		i = child;
+	}
+	heap_Set(i, t);
+}
+
+static void heap_Remove(struct stimer *t)
+{
+	unsigned int i = t->heap_pos - 1;
+	struct stimer *last = heap[--heap_n];
+
+	t->heap_pos = 0;
+	if(last == t)
+		return;
+	heap_Set(i, last);
+	if(i && stimer_Before(last, heap[(i - 1) >> 1]))
+		heap_Up(i);
+	else
+		heap_Down(i);
+}
+
+/* CCR1 to the nearest expiry; interrupts masked */
+static void stimer_Arm(void)
+{
+	unsigned int expire;
+
+	if(!heap_n)
+	{
+		TIM5->DIER = 0;
+		return;
+	}
+	expire = heap[0]->expire;
+	TIM5->CCR1 = expire;
+	TIM5->DIER = (1<<1);						//CC1IE
+	if((int)(TIM5->CNT - expire) >= 0)
+		TIM5->EGR = (1<<1);						//CC1G, the match went by already
+}
+
+void stimer_Init()
+{
+	RCC->APB1ENR |= (1<<3);
+	TIM5->CR1 = 0;
+	TIM5->PSC = rcc_Get_Tim_Clock(1) / 1000000 - 1;	/* 1 MHz */
+	TIM5->ARR = 0xFFFFFFFF;
+	TIM5->CCMR1 = 0;							//CH1 output compare, frozen
+	TIM5->DIER = 0;
+	TIM5->EGR = (1<<0);							//load PSC
+	TIM5->SR = 0;
+	heap_n = 0;
+	def_head = def_tail = 0;
+	NVIC->IP[TIM5_IRQ] = (5<<4);
+	NVIC->ISER[TIM5_IRQ >> 5] = (1 << (TIM5_IRQ & 31));
+	TIM5->CR1 = (1<<0);
+}
+
+unsigned int stimer_Now()
+{
+	return TIM5->CNT;
+}
+
+int stimer_Start(struct stimer *t, unsigned int delay_us, unsigned int period_us,
+				 stimer_callback cb, void *arg, unsigned int flags)
+{
+	unsigned int primask;
+	int was_first;
+
+	if(delay_us >= 0x80000000u || period_us >= 0x80000000u || (period_us && period_us < STIMER_MIN_PERIOD))
+		return -1;
+
+	primask = irq_Save();
+	was_first = t->heap_pos && heap[0] == t;
+	if(t->heap_pos)
+	{
+		heap_Remove(t);							//restart
+	}
+	else if(heap_n == STIMER_MAX)
+	{
+		irq_Restore(primask);
+		return -1;
+	}
+	t->expire = TIM5->CNT + delay_us;
+	t->period = period_us;
+	t->cb = cb;
+	t->arg = arg;
+	t->flags = flags;
+	t->pending = 0;
+	heap_n++;
+	heap_Set(heap_n - 1, t);
+	heap_Up(heap_n - 1);
+	if(was_first || heap[0] == t)
+		stimer_Arm();
+	irq_Restore(primask);
+	return 0;
+}
+
+void stimer_Stop(struct stimer *t)
+{
+	unsigned int primask = irq_Save();
+	int was_first;
+
+	t->pending = 0;								//a queued deferred call is dropped too
+	if(t->heap_pos)
+	{
+		was_first = (heap[0] == t);
+		heap_Remove(t);
+		if(was_first)
+			stimer_Arm();
+	}
+	irq_Restore(primask);
+}
+
+int stimer_Active(const struct stimer *t)
+{
+	return t->heap_pos != 0;
+}
+
+unsigned int stimer_Irqs()
+{
+	return irq_count;
+}
+
+void stimer_Poll()
+{
+	while(def_tail != def_head)
+	{
+		unsigned int primask = irq_Save();
+		struct stimer *t = deferred[def_tail % STIMER_MAX];
+		unsigned int run = t->pending;
+
+		t->pending = 0;
+		def_tail++;
+		irq_Restore(primask);
+
+		if(run)
+			t->cb(t);
+	}
+}
+
+/* interrupts masked */
+static void stimer_Queue(struct stimer *t)
+{
+	if(t->pending || def_head - def_tail >= STIMER_MAX)
+	{
+		t->missed++;
+		return;
+	}
+	t->pending = 1;
+	deferred[def_head % STIMER_MAX] = t;
+	def_head++;
+}
+
+/* next expiry of a periodic timer, past the ones already gone by; interrupts masked */
+static void stimer_Advance(struct stimer *t)
+{
+	unsigned int late;
+
+	t->expire += t->period;
+	late = TIM5->CNT - t->expire;
+	if((int)late >= 0)
+	{
+		late = late / t->period + 1;
+		t->expire += late * t->period;
+		t->missed += late;
+	}
+}
+
+void TIM5_IRQHandler()
+{
+	unsigned int primask;
+
+	TIM5->SR = ~CC1IF;							//rc_w0
+	irq_count++;
+
+	primask = irq_Save();						//against stimer_Start() from a higher priority
+	while(heap_n && (int)(TIM5->CNT - heap[0]->expire) >= 0)
+	{
+		struct stimer *t = heap[0];
+
+		heap_Remove(t);
+		if(t->period)
+		{
+			stimer_Advance(t);
+			heap_n++;
+			heap_Set(heap_n - 1, t);
+			heap_Up(heap_n - 1);
+		}
+		if(t->flags & STIMER_DEFERRED)
+		{
+			stimer_Queue(t);
+			continue;
+		}
+		irq_Restore(primask);
+		t->cb(t);								//may start or stop timers
+		primask = irq_Save();
+	}
+	stimer_Arm();
+	irq_Restore(primask);
+}
@@ -0,0 +1,59 @@
+/*
+ * stimer.h
+ *
+ *  Created on: Apr 12, 2025
+ *      Author: moni
+ *
+ *  Software timers on one compare channel. TIM5 counts microseconds
+ *  freely over its full 32 bits; the timers wait in a binary min-heap on
+ *  their expiry time and CCR1 always holds the nearest one. There is no
+ *  periodic tick: the only interrupts are expiries, and timers that
+ *  expire together are handled in the same interrupt.
+ *
+ *  Times are 32-bit microseconds compared with signed differences, so a
+ *  delay or period must stay below 2^31 us (35 minutes). A period must be
+ *  at least STIMER_MIN_PERIOD, a few times the cost of the interrupt.
+ *
+ *  Callbacks run in the TIM5 interrupt, or from stimer_Poll() in the main
+ *  loop when the timer was started with STIMER_DEFERRED. A deferred timer
+ *  that fires again before stimer_Poll() got to it runs once; 'missed'
+ *  counts the lost calls. A periodic timer found more than one period late
+ *  (one slow callback, interrupts blocked) runs once and moves to the next
+ *  period after now; 'missed' counts the skipped ones. A callback that is
+ *  always longer than its period still takes the whole CPU.
+ *  stimer_Start()/stimer_Stop() may be called from callbacks and from
+ *  other interrupts.
+ */
+
+#ifndef STIMER_H_
+#define STIMER_H_
+
+#define STIMER_MAX			32				//timers running at the same time
+#define STIMER_DEFERRED		(1<<0)
+#define STIMER_MIN_PERIOD	20				//us, shortest period stimer_Start() accepts
+
+struct stimer;
+typedef void (*stimer_callback)(struct stimer *t);
+
+struct stimer
+{
+	unsigned int expire;					//TIM5 count of the next expiry
+	unsigned int period;					//0 = one-shot
+	stimer_callback cb;
+	void *arg;
+	unsigned int flags;
+	unsigned int heap_pos;					//index + 1 in the heap, 0 = stopped
+	volatile unsigned int pending;			//deferred: fired, not run yet
+	unsigned int missed;					//calls lost: deferred not run, periods skipped
+};
+
+void stimer_Init(void);
+unsigned int stimer_Now(void);				//microseconds, wraps every 71 minutes
+int  stimer_Start(struct stimer *t, unsigned int delay_us, unsigned int period_us,
+				  stimer_callback cb, void *arg, unsigned int flags);
+void stimer_Stop(struct stimer *t);
+int  stimer_Active(const struct stimer *t);
+void stimer_Poll(void);						//runs the deferred callbacks
+unsigned int stimer_Irqs(void);				//TIM5 interrupts so far
+
+#endif /* STIMER_H_ */
@@ -0,0 +1,351 @@
+/**
+ ******************************************************************************
+ * @file    stimer_Test.c
+ * @author  Monish Kumar.k
+ * @date    12/04/2025
+ * @brief   Host model of the tickless software timers on a fake TIM5: heap
+ *          order, CNT wrap, deferred calls and late periodic timers.
+ *
+ * @details
+ * Build and run on the host (Linux x86-64, the register blocks are mapped
+ * at their STM32 addresses):
+ *
+ *     gcc -O2 -I../manual_PWM -o stimer_Test stimer_Test.c && ./stimer_Test
+ *
+ * stimer.c is included unmodified. TIM5->CNT is the model time in us:
+ * run_To() moves it forward, stopping at CCR1 while CC1IE is set to run
+ * TIM5_IRQHandler(), and a CC1G write to EGR runs the handler at once.
+ * A callback sees CNT at its expiry and may add a cost to it.
+ *  - random: RANDOM_OPS starts (one-shot and periodic), restarts, stops
+ *    and time steps on TIMERS timers, CNT passing 2^32 on the way. After
+ *    each step the heap is a min-heap on wrap-safe expiry, heap_pos and
+ *    stimer_Active() agree with it and CCR1 holds heap[0]. Every call
+ *    comes exactly at its expiry and a stopped timer is never called.
+ *  - wrap: timers due just before and just after 0xFFFFFFFF -> 0 run in
+ *    expiry order.
+ *  - deferred: a one-shot stopped while its call is queued is not called
+ *    by stimer_Poll(), not even after a restart; a periodic one that fires
+ *    three times before stimer_Poll() runs once with 2 missed.
+ *  - late: a 20 us period whose interrupt comes 107 us late runs once and
+ *    counts 5 missed, one 200 us callback does not keep the handler
+ *    chasing the timer, and periods below STIMER_MIN_PERIOD are refused.
+ *    In all cases the expiry stays on the period grid.
+ * Exits non-zero on a failure.
+ ******************************************************************************
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+unsigned int rcc_Get_Tim_Clock(int bus)			{ (void)bus; return 84000000; }
+
+#include "stimer.c"
+
+#define TIMERS			STIMER_MAX
+#define RANDOM_OPS		200000
+#define MAX_CALLS		1000			//in one interrupt: the handler is chasing a timer
+
+struct shadow
+{
+	int active;
+	unsigned int next;				//expected CNT of the next call
+	unsigned int period;
+	unsigned int calls;
+	unsigned int cost;				//us the next call adds to CNT
+};
+
+static struct stimer timers[TIMERS];
+static struct shadow shadows[TIMERS];
+static unsigned int failures, calls_in_irq, total_calls;
+static int order[8], n_order;
+
+static void fail(const char *what, unsigned int a, unsigned int b)
+{
+	if(failures++ < 20)
+		printf("FAIL %s (%u, %u) at CNT %u\n", what, a, b, TIM5->CNT);
+}
+
+static void irq(void)
+{
+	calls_in_irq = 0;
+	TIM5->SR |= CC1IF;
+	TIM5_IRQHandler();
+}
+
+/* CNT forward by us, with every compare match and forced event on the way */
+static void run_To(unsigned int us)
+{
+	unsigned int end = TIM5->CNT + us;
+
+	while(1)
+	{
+		if(TIM5->EGR & (1<<1))
+		{
+			TIM5->EGR = 0;
+			irq();
+			continue;
+		}
+		if((TIM5->DIER & (1<<1)) && (int)(TIM5->CCR1 - TIM5->CNT) > 0 && (int)(TIM5->CCR1 - end) <= 0)
+		{
+			TIM5->CNT = TIM5->CCR1;
+			irq();
+			continue;
+		}
+		break;
+	}
+	if((int)(end - TIM5->CNT) > 0)
+		TIM5->CNT = end;
+}
+
+static void shadow_Cb(struct stimer *t)
+{
+	struct shadow *s = t->arg;
+
+	total_calls++;
+	if(++calls_in_irq > MAX_CALLS)
+	{
+		fail("handler keeps chasing a timer", calls_in_irq, t->period);
+		exit(1);
+	}
+	if(!s->active)
+		fail("stopped timer called", (unsigned int)(s - shadows), 0);
+	else if(TIM5->CNT != s->next)
+		fail("call away from its expiry", TIM5->CNT, s->next);
+	s->calls++;
+	if(s->period)
+		s->next += s->period;
+	else
+		s->active = 0;
+	TIM5->CNT += s->cost;
+	s->cost = 0;
+}
+
+static void heap_Order(void)
+{
+	for(unsigned int i = 0; i < heap_n; i++)
+	{
+		if(heap[i]->heap_pos != i + 1)
+			fail("heap_pos", heap[i]->heap_pos, i + 1);
+		if(i && stimer_Before(heap[i], heap[(i - 1) >> 1]))
+			fail("heap order", i, heap[i]->expire);
+	}
+}
+
+static void heap_Check(void)
+{
+	unsigned int active = 0;
+
+	heap_Order();
+	for(unsigned int i = 0; i < TIMERS; i++)
+	{
+		active += shadows[i].active;
+		if(stimer_Active(&timers[i]) != shadows[i].active)
+			fail("stimer_Active", i, shadows[i].active);
+		else if(shadows[i].active && timers[i].expire != shadows[i].next)
+			fail("expiry", timers[i].expire, shadows[i].next);
+	}
+	if(active != heap_n)
+		fail("timers in the heap", heap_n, active);
+	if(heap_n && (TIM5->CCR1 != heap[0]->expire || !(TIM5->DIER & (1<<1))))
+		fail("CCR1 against heap[0]", TIM5->CCR1, heap[0]->expire);
+	if(!heap_n && TIM5->DIER)
+		fail("CC1IE with no timer", TIM5->DIER, 0);
+}
+
+static void start(unsigned int i, unsigned int delay, unsigned int period)
+{
+	if(stimer_Start(&timers[i], delay, period, shadow_Cb, &shadows[i], 0))
+	{
+		fail("stimer_Start refused", delay, period);
+		return;
+	}
+	shadows[i].active = 1;
+	shadows[i].next = TIM5->CNT + delay;
+	shadows[i].period = period;
+}
+
+static void test_Random(void)
+{
+	unsigned int wraps = 0, last;
+
+	TIM5->CNT = 0xFFFFFFFFu - 50000000u;
+	last = TIM5->CNT;
+	for(unsigned int n = 0; n < RANDOM_OPS; n++)
+	{
+		unsigned int i = rand() % TIMERS, op = rand() % 8;
+
+		if(op < 3)
+			start(i, rand() % 100000, (rand() % 2) ? 0 : STIMER_MIN_PERIOD + rand() % 50000);
+		else if(op < 4)
+		{
+			stimer_Stop(&timers[i]);
+			shadows[i].active = 0;
+		}
+		else
+			run_To(rand() % 20000);
+		wraps += (TIM5->CNT < last);
+		last = TIM5->CNT;
+		heap_Check();
+	}
+	for(unsigned int i = 0; i < TIMERS; i++)
+	{
+		stimer_Stop(&timers[i]);
+		shadows[i].active = 0;
+	}
+	heap_Check();
+	printf("random: %u operations, %u calls, CNT wrapped %u times\n", RANDOM_OPS, total_calls, wraps);
+	if(!wraps)
+		fail("CNT never wrapped", 0, 0);
+}
+
+static void order_Cb(struct stimer *t)
+{
+	if(n_order < 8)
+		order[n_order++] = (int)(long)t->arg;
+}
+
+static void test_Wrap(void)
+{
+	/* from 0xFFFFFF00: expiries 0x10, 0xFFFFFF60, 0x0, 0xFFFFFFFF, 0x100 */
+	static const unsigned int delay[5] = { 0x110, 0x60, 0x100, 0xFF, 0x200 };
+	static const int expect[5] = { 1, 3, 2, 0, 4 };
+
+	TIM5->CNT = 0xFFFFFF00u;
+	n_order = 0;
+	for(int i = 0; i < 5; i++)
+		stimer_Start(&timers[i], delay[i], 0, order_Cb, (void *)(long)i, 0);
+	heap_Order();
+	run_To(0x300);
+	for(int i = 0; i < 5; i++)
+	{
+		if(n_order != 5 || order[i] != expect[i])
+		{
+			fail("order across the wrap", (unsigned int)order[i], (unsigned int)expect[i]);
+			break;
+		}
+	}
+	if(heap_n)
+		fail("timers left after the wrap", heap_n, 0);
+}
+
+static unsigned int def_calls, late_calls, late_cost;
+
+static void late_Cb(struct stimer *t)
+{
+	if(++calls_in_irq > MAX_CALLS)
+	{
+		fail("handler keeps chasing a timer", calls_in_irq, t->period);
+		exit(1);
+	}
+	late_calls++;
+	TIM5->CNT += late_cost;
+	late_cost = 0;
+}
+
+static void def_Cb(struct stimer *t)
+{
+	(void)t;
+	def_calls++;
+}
+
+static void test_Deferred(void)
+{
+	struct stimer *d = &timers[0];
+
+	TIM5->CNT = 1000;
+	def_calls = 0;
+	stimer_Start(d, 100, 0, def_Cb, 0, STIMER_DEFERRED);
+	run_To(150);
+	if(!d->pending || def_calls)
+		fail("deferred one-shot not queued", d->pending, def_calls);
+	stimer_Stop(d);
+	stimer_Poll();
+	if(def_calls)
+		fail("stopped deferred timer called", def_calls, 0);
+
+	/* queued, stopped, restarted: the stale queue entry stays silent, the new expiry runs once */
+	stimer_Start(d, 100, 0, def_Cb, 0, STIMER_DEFERRED);
+	run_To(150);
+	stimer_Stop(d);
+	stimer_Start(d, 100, 0, def_Cb, 0, STIMER_DEFERRED);
+	stimer_Poll();
+	if(def_calls)
+		fail("stale deferred entry called after a restart", def_calls, 0);
+	run_To(150);
+	stimer_Poll();
+	if(def_calls != 1 || def_tail != def_head)
+		fail("restarted deferred timer", def_calls, def_head - def_tail);
+
+	def_calls = 0;
+	d->missed = 0;
+	stimer_Start(d, 100, 100, def_Cb, 0, STIMER_DEFERRED);
+	run_To(350);
+	stimer_Poll();
+	if(def_calls != 1 || d->missed != 2)
+		fail("periodic deferred fired 3 times before the poll", def_calls, d->missed);
+	stimer_Stop(d);
+}
+
+static void test_Late(void)
+{
+	struct stimer *t = &timers[0];
+	unsigned int first, blocked_calls, blocked_missed;
+
+	if(stimer_Start(t, 10, 1, late_Cb, 0, 0) != -1 || stimer_Start(t, 10, STIMER_MIN_PERIOD - 1, late_Cb, 0, 0) != -1
+		|| stimer_Active(t))
+		fail("period below STIMER_MIN_PERIOD accepted", 0, 0);
+	if(stimer_Start(t, 10, 0, late_Cb, 0, 0) || stimer_Start(t, 10, STIMER_MIN_PERIOD, late_Cb, 0, 0))
+		fail("one-shot or STIMER_MIN_PERIOD refused", 0, 0);
+	stimer_Stop(t);
+
+	/* the interrupt blocked 107 us: one call for 1020, 1040..1120 skipped, next 1140 */
+	TIM5->CNT = 1000;
+	t->missed = 0;
+	late_calls = 0;
+	stimer_Start(t, 20, 20, late_Cb, 0, 0);
+	TIM5->CNT = 1127;
+	irq();
+	if(late_calls != 1 || t->missed != 5 || t->expire != 1140 || TIM5->CCR1 != 1140)
+		fail("late interrupt: calls, missed", late_calls, t->missed);
+	blocked_calls = late_calls;
+	blocked_missed = t->missed;
+
+	/* a 200 us callback at 1140: the call due meanwhile comes at once, the rest are skipped */
+	first = t->expire;
+	late_calls = 0;
+	t->missed = 0;
+	late_cost = 200;
+	run_To(1000);
+	if((t->expire - first) % 20 || late_calls + t->missed != (t->expire - first) / 20)
+		fail("slow callback: calls + missed against the period grid", late_calls, t->missed);
+	if(t->missed < 9)
+		fail("slow callback: missed", t->missed, 9);
+	printf("late: blocked 107 us -> %u calls, %u missed; one 200 us callback -> %u calls, %u missed in 1 ms\n",
+		blocked_calls, blocked_missed, late_calls, t->missed);
+	stimer_Stop(t);
+}
+
+static void map(unsigned long addr, unsigned long len)
+{
+	if(mmap((void *)addr, len, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED)
+	{
+		perror("mmap");
+		exit(2);
+	}
+}
+
+int main(void)
+{
+	map(0x40000000, 0x30000);
+	map(0xE0000000, 0x10000);
+	srand(1);
+	stimer_Init();
+
+	test_Random();
+	test_Wrap();
+	test_Deferred();
+	test_Late();
+	printf("stimer: %u failures\n", failures);
+	return failures != 0;
+}
@@ -0,0 +1,135 @@
+/**
+ ******************************************************************************
+ * @file    text_Scroll.c
+ * @author  Monish Kumar.k
+ * @date    24/03/2025
+ * @brief   Scrolling message on the 8x8 matrix, stepped from the refresh
+ *          timer, with a cycles-per-frame benchmark for 1 and 8 panels.
+ *
+ * @details
+ * Hardware Connections: as led_Matrix / 8x8_Led_Display (rows PA0..PA7,
+ * columns PB0, PB1, PB2, PB5..PB9), USART1 TX on PA9 for the log.
+ *
+ * The scroll runs from the TIM4 frame hook: every SCROLL_FRAMES refresh
+ * frames the text moves one pixel, so the speed is exact and the main loop
+ * is free.
+ *
+ * Benchmark:
+ *  - text_Step() on 1 and on 8 panels with a backend whose show() does
+ *    nothing, so only the text engine is measured: average and worst
+ *    cycles per scroll frame over BENCH_STEPS steps (the worst case is the
+ *    step that decodes a new character).
+ *  Results are logged with LOG() on USART1 and kept in bench[].
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 24/03/2025
+  File : text_Scroll
+ ******************************************************************************/
+#include <arm.h>
+#include <uart.h>
+#include <log.h>
+#include <matrix.h>
+#include "text.h"
+
+#define LOG_PORT		UART_1
+#define SCROLL_FRAMES	4				//125 Hz / 4 = 31 pixels per second
+#define BENCH_STEPS		1000
+
+struct bench_result
+{
+	unsigned int panels;
+	unsigned int avg_cycles;
+	unsigned int max_cycles;
+};
+
+static const unsigned int bench_panels[] = { 1, 8 };
+volatile struct bench_result bench[sizeof(bench_panels) / sizeof(bench_panels[0])];
+
+static const char message[] = "Hello STM32F401 \xE2\x99\xA5 25\xC2\xB0" "C \xE2\x86\x92 5\xE2\x82\xAC ";
+
+static struct matrix led;
+static struct text banner;
+
+void rcc_Config(void);
+void scroll_Frame(void);
+void bench_Run(void);
+
+static void null_Init(struct matrix *m) { (void)m; }
+static void null_Show(struct matrix *m) { (void)m; }
+static const struct matrix_backend null_backend = { null_Init, null_Show };
+
+int main(void)
+{
+	rcc_Config();
+	uart_Init(LOG_PORT, 921600);
+	log_Init();
+
+	bench_Run();
+
+	matrix_Init(&led, &matrix_direct, 1);
+	text_Init(&banner, &led, message, SCROLL_FRAMES);
+	matrix_Scan_Hook(scroll_Frame);
+	while(1)
+	{
+		log_Drain(LOG_PORT);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* APB1 /2 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+void scroll_Frame()
+{
+	text_Frame(&banner);
+}
+
+void bench_Run()
+{
+	struct matrix m;
+	struct text t;
+
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);		/* CYCCNTENA */
+
+	for(unsigned int i = 0; i < sizeof(bench_panels) / sizeof(bench_panels[0]); i++)
+	{
+		unsigned int total = 0, worst = 0;
+
+		matrix_Init(&m, &null_backend, bench_panels[i]);
+		text_Init(&t, &m, message, 1);
+		for(unsigned int s = 0; s < BENCH_STEPS; s++)
+		{
+			unsigned int start = DWT->CYCCNT, c;
+
+			text_Step(&t);
+			c = DWT->CYCCNT - start;
+			total += c;
+			if(c > worst)
+				worst = c;
+		}
+		bench[i].panels = bench_panels[i];
+		bench[i].avg_cycles = total / BENCH_STEPS;
+		bench[i].max_cycles = worst;
+		LOG("%u panels: %u cycles/frame average, %u worst", bench[i].panels,
+			bench[i].avg_cycles, bench[i].max_cycles);
+		log_Drain(LOG_PORT);
+	}
+}
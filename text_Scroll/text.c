@@ -0,0 +1,168 @@
+/**
+ ******************************************************************************
+ * @file    text.c
+ * @author  Monish Kumar.k
+ * @date    24/03/2025
+ * @brief   Pixel-smooth scrolling text from a column-major font, UTF-8
+ *          decoding and glyph cache.
+ *
+ * @details
+ *  - text_Step() costs one fb64 shift + one OR per panel and one column
+ *    spread (two multiplies) for the incoming font column.
+ *  - A glyph is only looked up when its first column is needed; the next
+ *    four columns and the spacing column are plain loads.
+ *  - After the message the display scrolls on with blank columns until the
+ *    last character has left, then the message starts again.
+ ******************************************************************************
+ */
+#include <fb64.h>
+#include "text.h"
+
+struct cache_entry
+{
+	unsigned int cp;
+	const unsigned char *glyph;
+};
+
+static struct cache_entry glyph_cache[TEXT_CACHE_SIZE];
+
+/* returns 0 at the end of the string, U+FFFD for a broken sequence */
+static unsigned int utf8_Next(const unsigned char **s)
+{
+	const unsigned char *p = *s;
+	unsigned int c = *p, cp, n;
+
+	if(c == 0)
+		return 0;
+	if(c < 0x80)
+	{
+		*s = p + 1;
+		return c;
+	}
+	if((c & 0xE0) == 0xC0)
+	{
+		cp = c & 0x1F;
+		n = 1;
+	}
+	else if((c & 0xF0) == 0xE0)
+	{
+		cp = c & 0x0F;
+		n = 2;
+	}
+	else if((c & 0xF8) == 0xF0)
+	{
+		cp = c & 0x07;
+		n = 3;
+	}
+	else
+	{
+		*s = p + 1;
+		return 0xFFFD;
+	}
+	for(unsigned int i = 1; i <= n; i++)
+	{
+		if((p[i] & 0xC0) != 0x80)
+		{
+			*s = p + i;
+			return 0xFFFD;
+		}
+		cp = (cp << 6) | (p[i] & 0x3F);
+	}
+	*s = p + n + 1;
+	return cp;
+}
+
+const unsigned char *text_Glyph(unsigned int cp)
+{
+	struct cache_entry *e;
+	unsigned int lo = 0, hi = FONT_EXTRA;
+
+	if(cp >= 0x20 && cp < 0x7F)
+		return font5x7_ascii[cp - 0x20];
+
+	e = &glyph_cache[cp & (TEXT_CACHE_SIZE - 1)];
+	if(e->glyph && e->cp == cp)
+		return e->glyph;
+
+	e->cp = cp;
+	e->glyph = font5x7_missing;
+	while(lo < hi)
+	{
+		unsigned int mid = (lo + hi) / 2;
+
+		if(font5x7_extra[mid].cp < cp)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	if(lo < FONT_EXTRA && font5x7_extra[lo].cp == cp)
+		e->glyph = font5x7_extra[lo].cols;
+	return e->glyph;
+}
+
+void text_Init(struct text *t, struct matrix *m, const char *msg, unsigned int frames_per_step)
+{
+	t->m = m;
+	t->msg = (const unsigned char *)msg;
+	t->next = t->msg;
+	t->glyph = font5x7_ascii[0];
+	t->col = FONT_WIDTH + 1;
+	t->gap = 0;
+	t->frames_per_step = frames_per_step ? frames_per_step : 1;
+	t->frame = 0;
+}
+
+static unsigned char next_Column(struct text *t)
+{
+	unsigned int cp;
+
+	if(t->col < FONT_WIDTH)
+		return t->glyph[t->col++];
+	if(t->col == FONT_WIDTH)
+	{
+		t->col++;
+		return 0;					//spacing between characters
+	}
+	if(t->gap)
+	{
+		t->gap--;
+		return 0;
+	}
+	cp = utf8_Next(&t->next);
+	if(cp == 0)
+	{
+		t->next = t->msg;
+		t->gap = t->m->panels * 8 - 1;
+		return 0;
+	}
+	t->glyph = text_Glyph(cp);
+	t->col = 1;
+	return t->glyph[0];
+}
+
+void text_Step(struct text *t)
+{
+	struct matrix *m = t->m;
+	unsigned int last = m->panels - 1;
+	unsigned char col = next_Column(t);
+
+	for(unsigned int p = 0; p < last; p++)
+	{
+		m->fb[p] = fb64_Shift_Left(m->fb[p], 1) | ((m->fb[p + 1] & FB64_REP(0x01)) << 7);
+	}
+	m->fb[last] = fb64_Shift_Left(m->fb[last], 1) | fb64_Column(col, 7);
+	matrix_Show(m);
+}
+
+void text_Frame(struct text *t)
+{
+	if(++t->frame >= t->frames_per_step)
+	{
+		t->frame = 0;
+		text_Step(t);
+	}
+}
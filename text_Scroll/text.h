@@ -0,0 +1,58 @@
+/*
+ * text.h
+ *
+ *  Created on: Mar 24, 2025
+ *      Author: moni
+ *
+ *  Scrolling text on the led_Matrix framebuffer, one or more chained
+ *  panels.
+ *
+ *  The font is stored column-major (font5x7.c), which is the order the
+ *  text enters the display: every scroll step shifts all panels one pixel
+ *  left (panel p takes column 0 of panel p+1 into its column 7) and ORs the
+ *  next font column into column 7 of the last panel. There is no per-pixel
+ *  work.
+ *
+ *  Messages are UTF-8. ASCII is indexed directly; the few non-ASCII glyphs
+ *  in font5x7_extra are found through a small direct-mapped cache, so a
+ *  repeated symbol costs one compare after its first use.
+ */
+
+#ifndef TEXT_H_
+#define TEXT_H_
+
+#include <matrix.h>
+
+#define FONT_WIDTH			5
+#define FONT_EXTRA			14			//entries in font5x7_extra
+#define TEXT_CACHE_SIZE		8			//power of two
+
+struct font_glyph
+{
+	unsigned short cp;					//Unicode code point, BMP only
+	unsigned char cols[FONT_WIDTH];
+};
+
+extern const unsigned char font5x7_ascii[95][FONT_WIDTH];
+extern const struct font_glyph font5x7_extra[FONT_EXTRA];
+extern const unsigned char font5x7_missing[FONT_WIDTH];
+
+struct text
+{
+	struct matrix *m;
+	const unsigned char *msg;			//UTF-8, 0 terminated
+	const unsigned char *next;			//next byte to decode
+	const unsigned char *glyph;			//columns of the current glyph
+	unsigned int col;					//next column of glyph, FONT_WIDTH = spacing
+	unsigned int gap;					//blank columns left after the message
+	unsigned int frames_per_step;
+	unsigned int frame;
+};
+
+/* frames_per_step: refresh frames per pixel, speed = MATRIX_REFRESH_HZ / frames_per_step px/s */
+void text_Init(struct text *t, struct matrix *m, const char *msg, unsigned int frames_per_step);
+void text_Step(struct text *t);			//one pixel, then matrix_Show()
+void text_Frame(struct text *t);		//call once per refresh frame
+const unsigned char *text_Glyph(unsigned int cp);
+
+#endif /* TEXT_H_ */
@@ -31,6 +31,7 @@
   File : Timer_10_500ms
  ******************************************************************************/
 #include <arm.h>
+#include <bitband.h>
 
 void rcc_Config(void);
 void choose_Port_C(void);
@@ -92,17 +93,17 @@ void delay(int delay)
 
 	TIM10->ARR = delay;               //auto-reload register
 
-	TIM10->CR1 |= (1<<0);   //CEN: Counter enable
+	BITBAND(&TIM10->CR1, 0) = 1;   //CEN: Counter enable
 
-	while(!(TIM10->SR & (1<<0)));
+	while(!BITBAND(&TIM10->SR, 0));
 
-	TIM10->SR &= ~(1<<0);
+	TIM10->SR = ~(1<<0);   //UIF is rc_w0: a plain store clears it and leaves other flags alone
 }
 
 void led_Blink_C13()
 {
-	GPIOC->ODR = GPIOC->ODR & ~(1<<13); // LED on
+	BITBAND(&GPIOC->ODR, 13) = 0; // LED on
 	delay(12500);
-	GPIOC->ODR = GPIOC->ODR | (1<<13); // LED off
+	BITBAND(&GPIOC->ODR, 13) = 1; // LED off
 	delay(12500);
 }
@@ -0,0 +1,157 @@
+/**
+ ******************************************************************************
+ * @file    timer_Manager.c
+ * @author  Monish Kumar.k
+ * @date    28/04/2025
+ * @brief   Timer_10_500ms on the timer manager: long periods from chained
+ *          16-bit timers, with the PSC/ARR choice and its error logged.
+ *
+ * @details
+ * Hardware Connections: LED on PC13 (as Timer_10_500ms). USART2 TX on PA2
+ * for the log. Clock is 84 MHz.
+ *
+ * Timer_10_500ms waits on TIM10 with PSC = 999 and ARR = 12500: a 16-bit
+ * ARR is close to full there, and a longer delay needs a coarser
+ * prescaler, i.e. less resolution and a larger error.
+ *
+ *  - For each period of periods_ns[], the single 16-bit, chained and
+ *    32-bit solutions of tmgr_Solve() are logged with their error in ppb,
+ *    then the choice of tmgr_Period() within TOLERANCE_PPB and with a
+ *    tick of RESOLUTION_NS or less (timers, PSC, ARR, slave ARR, error).
+ *    A single 16-bit timer reaches 1 us ticks up to 65 ms; above that the
+ *    period is chained.
+ *  - Three periods of 1.5 s from tmgr_Period() (a chain, for the 1 us
+ *    resolution) are timed with CYCCNT against the expected cycle count.
+ *  - The LED then blinks with a 500 ms period from the manager; the wait
+ *    is on the update flag as before, the period needs no counting loop.
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 28/04/2025
+  File : timer_Manager
+ ******************************************************************************/
+#include <arm.h>
+#include <rcc.h>
+#include <uart.h>
+#include <log.h>
+#include "tmgr.h"
+
+#define LOG_PORT		UART_2
+#define TOLERANCE_PPB	10
+#define RESOLUTION_NS	1000				//for the report and the measurement
+#define MEASURE_NS		1500000000ull
+
+static const unsigned long long periods_ns[] =
+{
+	25000ull, 500000000ull, 1234567891ull, 10000000000ull,
+	60000000000ull, 3600000000000ull, 86400000000000ull,
+};
+#define PERIODS_N	(sizeof(periods_ns) / sizeof(periods_ns[0]))
+
+void rcc_Config(void);
+void gpio_Config(void);
+void periods_Report(void);
+void period_Measure(void);
+
+int main(void)
+{
+	struct tmgr_period blink;
+
+	rcc_Config();
+	uart_Init(LOG_PORT, 921600);
+	log_Init();
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);
+	gpio_Config();
+
+	periods_Report();
+	period_Measure();
+
+	tmgr_Period(500000000ull, TOLERANCE_PPB, 0, &blink);
+	tmgr_Start(&blink);
+	while(1)
+	{
+		if(tmgr_Expired(&blink))
+			GPIOC->ODR ^= (1<<13);
+		log_Drain(LOG_PORT);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* APB1 /2 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+void gpio_Config()
+{
+	RCC->AHB1ENR |= (1<<2);
+	GPIOC->MODER = (GPIOC->MODER & ~(0x3<<26)) | (1<<26);
+}
+
+void periods_Report()
+{
+	unsigned int clock = rcc_Get_Tim_Clock(1);
+
+	for(unsigned int i = 0; i < PERIODS_N; i++)
+	{
+		unsigned long long ns = periods_ns[i];
+		unsigned long long ticks = ns / 1000000000u * clock + ((ns % 1000000000u) * clock + 500000000u) / 1000000000u;
+		struct tmgr_period single, chain, wide, p;
+		int s, c, w, r;
+
+		s = tmgr_Solve(ticks, 16, 0, &single) ? 0x7FFFFFFF : tmgr_Error_Ppb(&single);
+		c = tmgr_Solve(ticks, 16, 1, &chain) ? 0x7FFFFFFF : tmgr_Error_Ppb(&chain);
+		w = tmgr_Solve(ticks, 32, 0, &wide) ? 0x7FFFFFFF : tmgr_Error_Ppb(&wide);
+		LOG("%u.%09u s: 16-bit %d ppb (PSC %u), chained %d ppb, 32-bit %d ppb",
+			(unsigned int)(ns / 1000000000u), (unsigned int)(ns % 1000000000u), s, single.psc, c, w);
+
+		r = tmgr_Period(ns, TOLERANCE_PPB, RESOLUTION_NS, &p);
+		if(r < 0)
+		{
+			LOG("  no timer");
+		}
+		else
+		{
+			LOG("  %d: TIM%u -> TIM%u (ITR%u), PSC %u, ARR %u, slave ARR %u, %d ppb",
+				r, p.timer, p.slave, p.itr, p.psc, p.arr, p.slave_arr, tmgr_Error_Ppb(&p));
+			tmgr_Release(&p);
+		}
+		log_Drain(LOG_PORT);
+	}
+}
+
+void period_Measure()
+{
+	unsigned long long expected = MEASURE_NS / 1000000u * (rcc_Get_Sysclk() / 1000u);
+	struct tmgr_period p;
+	unsigned int start;
+
+	if(tmgr_Period(MEASURE_NS, TOLERANCE_PPB, RESOLUTION_NS, &p) < 0)
+		return;
+	tmgr_Start(&p);
+	while(!tmgr_Expired(&p));
+	for(unsigned int i = 0; i < 3; i++)
+	{
+		start = DWT->CYCCNT;
+		while(!tmgr_Expired(&p));
+		LOG("TIM%u -> TIM%u: period %u cycles, expected %u",
+			p.timer, p.slave, DWT->CYCCNT - start, (unsigned int)expected);
+	}
+	tmgr_Release(&p);
+	log_Drain(LOG_PORT);
+}
@@ -0,0 +1,369 @@
+/**
+ ******************************************************************************
+ * @file    tmgr.c
+ * @author  Monish Kumar.k
+ * @date    28/04/2025
+ * @brief   Timer allocation by capability, PSC/ARR search and master/slave
+ *          chaining of two 16-bit timers.
+ *
+ * @details
+ *  - tmgr_timers[] is sorted from the least to the most capable timer;
+ *    allocation is first fit in that order.
+ *  - tmgr_links[] are the ITR connections of RM0368 between 16-bit
+ *    timers, with the pairs that keep TIM1 free first.
+ *  - PSC/ARR search: for every prescaler a = PSC + 1 from one below the
+ *    smallest that fits, ARR + 1 = round(ticks / a) up to its maximum;
+ *    the first exact pair or the smallest error wins, so on a tie the
+ *    finest prescaler is kept. Up to 65536 divisions, a few ms at
+ *    84 MHz, only when the period is set.
+ *  - A chain is PSC x master ARR x slave ARR: the prescaler is the
+ *    smallest that brings the rest under 2^32 (and TMGR_PSC_TRIES - 1 more),
+ *    the rest is split by the same search.
+ ******************************************************************************
+ */
+#include <arm.h>
+#include <rcc.h>
+#include "tmgr.h"
+
+#define MAX16			65536ull
+
+struct tmgr_timer
+{
+	volatile struct timer *regs;
+	unsigned char number, apb, enr_bit, bits, channels, caps;
+};
+
+struct tmgr_link
+{
+	unsigned char master, slave, itr;
+};
+
+static const struct tmgr_timer tmgr_timers[] =
+{
+	{ TIM10, 10, 2, 17, 16, 1, 0 },
+	{ TIM11, 11, 2, 18, 16, 1, 0 },
+	{ TIM9,   9, 2, 16, 16, 2, TMGR_MASTER | TMGR_SLAVE },
+	{ TIM3,   3, 1,  1, 16, 4, TMGR_DMA | TMGR_MASTER | TMGR_SLAVE },
+	{ TIM4,   4, 1,  2, 16, 4, TMGR_DMA | TMGR_MASTER | TMGR_SLAVE },
+	{ TIM1,   1, 2,  0, 16, 4, TMGR_DMA | TMGR_MASTER | TMGR_SLAVE | TMGR_ADVANCED },
+	{ TIM2,   2, 1,  0, 32, 4, TMGR_32BIT | TMGR_DMA | TMGR_MASTER | TMGR_SLAVE },
+	{ TIM5,   5, 1,  3, 32, 4, TMGR_32BIT | TMGR_DMA | TMGR_MASTER | TMGR_SLAVE },
+};
+#define TMGR_N		(sizeof(tmgr_timers) / sizeof(tmgr_timers[0]))
+
+static const struct tmgr_link tmgr_links[] =
+{
+	{ 3, 9, 1 }, { 3, 4, 2 }, { 4, 3, 3 },
+	{ 1, 3, 0 }, { 1, 4, 0 }, { 3, 1, 2 }, { 4, 1, 3 },
+};
+#define LINK_N		(sizeof(tmgr_links) / sizeof(tmgr_links[0]))
+
+static unsigned int tmgr_used;			//bit n: TIMn
+
+static const struct tmgr_timer *tmgr_Find(unsigned int timer)
+{
+	for(unsigned int i = 0; i < TMGR_N; i++)
+	{
+		if(tmgr_timers[i].number == timer)
+			return &tmgr_timers[i];
+	}
+	return 0;
+}
+
+static void tmgr_Take(const struct tmgr_timer *t)
+{
+	tmgr_used |= (1u << t->number);
+	if(t->apb == 1)
+		RCC->APB1ENR |= (1u << t->enr_bit);
+	else
+		RCC->APB2ENR |= (1u << t->enr_bit);
+}
+
+int tmgr_Alloc(unsigned int caps, unsigned int channels)
+{
+	for(unsigned int i = 0; i < TMGR_N; i++)
+	{
+		const struct tmgr_timer *t = &tmgr_timers[i];
+
+		if((tmgr_used & (1u << t->number)) || (t->caps & caps) != caps || t->channels < channels)
+			continue;
+		tmgr_Take(t);
+		return t->number;
+	}
+	return -1;
+}
+
+void tmgr_Free(unsigned int timer)
+{
+	const struct tmgr_timer *t = tmgr_Find(timer);
+
+	if(!t || !(tmgr_used & (1u << timer)))
+		return;
+	t->regs->CR1 = 0;
+	t->regs->DIER = 0;
+	if(t->caps & TMGR_SLAVE)
+	{
+		t->regs->SMCR = 0;
+		t->regs->CR2 = 0;
+	}
+	tmgr_used &= ~(1u << timer);
+}
+
+volatile struct timer *tmgr_Regs(unsigned int timer)
+{
+	const struct tmgr_timer *t = tmgr_Find(timer);
+
+	return t ? t->regs : 0;
+}
+
+unsigned int tmgr_Clock(unsigned int timer)
+{
+	const struct tmgr_timer *t = tmgr_Find(timer);
+
+	return t ? rcc_Get_Tim_Clock(t->apb) : 0;
+}
+
+static unsigned long long tmgr_Div(unsigned long long n, unsigned int d)
+{
+	return (n >> 32) ? n / d : (unsigned int)n / d;		/* 32-bit UDIV when it fits */
+}
+
+/* a * b closest to n, 1 <= a <= 65536, 1 <= b <= max_b. Returns a * b, 0 if n is out of reach */
+static unsigned long long tmgr_Split(unsigned long long n, unsigned long long max_b, unsigned int *a_out, unsigned long long *b_out)
+{
+	unsigned long long a_min = (n + max_b - 1) / max_b;
+	unsigned long long best_err = ~0ull, best = 0;
+
+	if(a_min > MAX16)
+		return 0;
+	/* from a_min - 1: b = max_b there can fall short of n by less than a_min gets */
+	for(unsigned int a = (a_min > 1) ? (unsigned int)a_min - 1 : 1; a <= MAX16 && a <= n; a++)
+	{
+		unsigned long long b = tmgr_Div(n + a/2, a);
+		unsigned long long x, err;
+
+		if(b > max_b)
+			b = max_b;
+		x = a * b;
+		err = (x > n) ? x - n : n - x;
+		if(err < best_err)
+		{
+			best_err = err;
+			best = x;
+			*a_out = a;
+			*b_out = b;
+			if(!err)
+				break;
+		}
+	}
+	return best;
+}
+
+int tmgr_Solve(unsigned long long ticks, unsigned int bits, unsigned int chain, struct tmgr_period *p)
+{
+	unsigned long long max_b = (bits >= 32) ? 0x100000000ull : MAX16;
+	unsigned long long psc_min = (ticks + 0xFFFFFFFFull) >> 32;
+	unsigned long long best_err = ~0ull, b, x;
+	unsigned int a;
+
+	p->wanted = ticks;
+	p->ticks = 0;
+	if(!ticks)
+		return -1;
+	if(!chain)
+	{
+		x = tmgr_Split(ticks, max_b, &a, &b);
+		if(!x)
+			return -1;
+		p->psc = a - 1;
+		p->arr = (unsigned int)(b - 1);
+		p->slave_arr = 0;
+		p->ticks = x;
+		return 0;
+	}
+
+	/* PSC x (master ARR x slave ARR), the second factor up to 2^32 */
+	if(psc_min > MAX16)
+		return -1;
+	for(unsigned int psc = psc_min ? (unsigned int)psc_min : 1; psc <= MAX16 && psc < psc_min + TMGR_PSC_TRIES; psc++)
+	{
+		unsigned long long rest = (ticks + psc/2) / psc, err;
+
+		if(rest > 0xFFFFFFFFull)
+			rest = 0xFFFFFFFFull;
+		x = tmgr_Split(rest, MAX16, &a, &b) * psc;
+		if(!x)
+			continue;
+		err = (x > ticks) ? x - ticks : ticks - x;
+		if(err < best_err)
+		{
+			best_err = err;
+			p->psc = psc - 1;
+			p->arr = a - 1;
+			p->slave_arr = (unsigned int)(b - 1);
+			p->ticks = x;
+			if(!err)
+				break;
+		}
+	}
+	return p->ticks ? 0 : -1;
+}
+
+int tmgr_Error_Ppb(const struct tmgr_period *p)
+{
+	long long diff = (long long)(p->ticks - p->wanted);
+	long long ppb;
+
+	if(!p->wanted)
+		return 0;
+	ppb = (diff > -9223372036ll && diff < 9223372036ll) ? diff * 1000000000ll / (long long)p->wanted
+		: diff / (long long)p->wanted * 1000000000ll;
+	if(ppb > 0x7FFFFFFF)
+		return 0x7FFFFFFF;
+	if(ppb < -0x7FFFFFFF)
+		return -0x7FFFFFFF;
+	return (int)ppb;
+}
+
+static unsigned long long tmgr_Ticks(unsigned long long ns, unsigned int clock)
+{
+	return ns / 1000000000u * clock + ((ns % 1000000000u) * clock + 500000000u) / 1000000000u;
+}
+
+static unsigned int abs_Ppb(int ppb)
+{
+	return (ppb < 0) ? -(unsigned int)ppb : (unsigned int)ppb;
+}
+
+int tmgr_Period(unsigned long long ns, unsigned int tolerance_ppb, unsigned int resolution_ns, struct tmgr_period *p)
+{
+	const struct tmgr_timer *single = 0, *wide = 0;
+	const struct tmgr_link *link = 0;
+	struct tmgr_period c, best;
+	unsigned int best_err = ~0u, found = 0;
+
+	for(unsigned int i = 0; i < TMGR_N; i++)
+	{
+		const struct tmgr_timer *t = &tmgr_timers[i];
+
+		if(tmgr_used & (1u << t->number))
+			continue;
+		if(t->bits == 16 && !single)
+			single = t;
+		if(t->bits == 32 && !wide)
+			wide = t;
+	}
+	for(unsigned int i = 0; i < LINK_N; i++)
+	{
+		if(!(tmgr_used & ((1u << tmgr_links[i].master) | (1u << tmgr_links[i].slave))))
+		{
+			link = &tmgr_links[i];
+			break;
+		}
+	}
+
+	/* one 16-bit timer, a chained pair, a 32-bit timer: the first that qualifies */
+	for(unsigned int step = 0; step < 3 && !found; step++)
+	{
+		const struct tmgr_timer *t = (step == 0) ? single : (step == 1) ? (link ? tmgr_Find(link->master) : 0) : wide;
+		unsigned int clock, err;
+
+		if(!t)
+			continue;
+		clock = tmgr_Clock(t->number);
+		if(tmgr_Solve(tmgr_Ticks(ns, clock), t->bits, step == 1, &c))
+			continue;
+		c.timer = t->number;
+		c.slave = (step == 1) ? link->slave : 0;
+		c.itr = (step == 1) ? link->itr : 0;
+		err = abs_Ppb(tmgr_Error_Ppb(&c));
+		found = err <= tolerance_ppb
+			&& (!resolution_ns || (c.psc + 1ull) * 1000000000u <= (unsigned long long)resolution_ns * clock);
+		if(found || err < best_err)
+		{
+			best_err = err;
+			best = c;
+		}
+	}
+	if(best_err == ~0u)
+		return -1;
+	*p = best;
+	tmgr_Take(tmgr_Find(p->timer));
+	if(p->slave)
+		tmgr_Take(tmgr_Find(p->slave));
+	return found ? 0 : 1;
+}
+
+void tmgr_Start(const struct tmgr_period *p)
+{
+	volatile struct timer *m = tmgr_Regs(p->timer);
+
+	/* UG loads PSC; URS keeps it out of UIF, the slave is not counting yet */
+	m->CR1 = 0;
+	m->PSC = p->psc;
+	m->ARR = p->arr;
+	m->CR1 = (1<<2);						/* URS */
+	m->EGR = (1<<0);
+	m->CNT = 0;
+	m->SR = 0;
+	if(p->slave)
+	{
+		volatile struct timer *s = tmgr_Regs(p->slave);
+
+		m->CR2 = (m->CR2 & ~(0x7<<4)) | (2<<4);		/* MMS = update */
+		s->CR1 = 0;
+		s->SMCR = 0;
+		s->PSC = 0;
+		s->ARR = p->slave_arr;
+		s->CR1 = (1<<2);
+		s->EGR = (1<<0);
+		s->CNT = 0;
+		s->SR = 0;
+		s->SMCR = (p->itr<<4) | (7<<0);				/* TS = ITRx, external clock mode 1 */
+		s->CR1 = (1<<2) | (1<<0);
+	}
+	m->CR1 = (1<<2) | (1<<0);
+}
+
+int tmgr_Expired(const struct tmgr_period *p)
+{
+	volatile struct timer *t = tmgr_Regs(p->slave ? p->slave : p->timer);
+
+	if(!(t->SR & (1<<0)))
+		return 0;
+	t->SR = ~(1<<0);						//rc_w0
+	return 1;
+}
+
+unsigned long long tmgr_Elapsed(const struct tmgr_period *p)
+{
+	volatile struct timer *m = tmgr_Regs(p->timer);
+	unsigned long long count;
+
+	if(p->slave)
+	{
+		volatile struct timer *s = tmgr_Regs(p->slave);
+		unsigned int high = s->CNT, low = m->CNT, again = s->CNT;
+
+		if(again != high)					/* the master wrapped in between */
+		{
+			high = again;
+			low = m->CNT;
+		}
+		count = (unsigned long long)high * (p->arr + 1ull) + low;
+	}
+	else
+	{
+		count = m->CNT;
+	}
+	return count * (p->psc + 1ull);
+}
+
+void tmgr_Release(struct tmgr_period *p)
+{
+	tmgr_Free(p->timer);
+	if(p->slave)
+		tmgr_Free(p->slave);
+	p->timer = 0;
+	p->slave = 0;
+}
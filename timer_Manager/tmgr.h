@@ -0,0 +1,69 @@
+/*
+ * tmgr.h
+ *
+ *  Created on: Apr 28, 2025
+ *      Author: moni
+ *
+ *  Hardware timer manager for the STM32F401 timers TIM1..TIM5, TIM9..TIM11
+ *  (there is no TIM6..TIM8 on this part).
+ *
+ *  tmgr_Alloc() hands out the least capable free timer that has the
+ *  capabilities asked for, so TIM10/TIM11 go first and the 32-bit
+ *  TIM2/TIM5 and the advanced TIM1 are kept for those who need them.
+ *
+ *  tmgr_Period() sets up a free-running period with no software overflow
+ *  counting, in this order, the first one within tolerance_ppb and with a
+ *  tick (PSC + 1 clocks) no longer than resolution_ns (0: any) wins:
+ *   - one 16-bit timer, PSC/ARR with the smallest error,
+ *   - two 16-bit timers chained: the master's update is its TRGO
+ *     (CR2.MMS = 010), the slave counts it on ITRx in external clock
+ *     mode 1 (SMCR.SMS = 111), so master ARR x slave ARR is one 32-bit
+ *     counter,
+ *   - a 32-bit timer.
+ *  If none qualifies, the one with the smallest error is used.
+ *  The period ends on the update event of the last timer of the chain.
+ *
+ *  tmgr_Solve() is the PSC/ARR search alone; it touches no register.
+ *  Periods are in timer clock ticks, up to 2^48.
+ */
+
+#ifndef TMGR_H_
+#define TMGR_H_
+
+#define TMGR_32BIT			(1<<0)
+#define TMGR_DMA			(1<<1)			//update and CC DMA requests
+#define TMGR_MASTER			(1<<2)			//TRGO to another timer
+#define TMGR_SLAVE			(1<<3)			//SMCR, counts an ITR input
+#define TMGR_ADVANCED		(1<<4)			//complementary outputs, break, RCR
+
+#define TMGR_PSC_TRIES		4				//prescalers tried for a chain above 2^32 ticks
+
+struct tmgr_period
+{
+	unsigned char timer;				//number of the timer that counts the clock
+	unsigned char slave;				//0: no chain
+	unsigned char itr;					//slave SMCR.TS
+	unsigned int psc;					//register values
+	unsigned int arr;
+	unsigned int slave_arr;
+	unsigned long long ticks;			//period reached, timer clock ticks
+	unsigned long long wanted;
+};
+
+int  tmgr_Alloc(unsigned int caps, unsigned int channels);		//timer number, -1: none free
+void tmgr_Free(unsigned int timer);
+volatile struct timer *tmgr_Regs(unsigned int timer);
+unsigned int tmgr_Clock(unsigned int timer);					//Hz
+
+/* bits: counter width of the (first) timer, chain: two 16-bit timers. Returns 0 or -1 (too long) */
+int  tmgr_Solve(unsigned long long ticks, unsigned int bits, unsigned int chain, struct tmgr_period *p);
+int  tmgr_Error_Ppb(const struct tmgr_period *p);
+
+/* 0: within tolerance and resolution, 1: smallest error found instead, -1: no timer free or too long */
+int  tmgr_Period(unsigned long long ns, unsigned int tolerance_ppb, unsigned int resolution_ns, struct tmgr_period *p);
+void tmgr_Start(const struct tmgr_period *p);
+int  tmgr_Expired(const struct tmgr_period *p);				//1 once per period, clears the flag
+unsigned long long tmgr_Elapsed(const struct tmgr_period *p);	//ticks into the period, to PSC + 1
+void tmgr_Release(struct tmgr_period *p);
+
+#endif /* TMGR_H_ */
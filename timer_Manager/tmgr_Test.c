@@ -0,0 +1,242 @@
+/**
+ ******************************************************************************
+ * @file    tmgr_Test.c
+ * @author  Monish Kumar.k
+ * @date    28/04/2025
+ * @brief   Host check of the timer manager: PSC/ARR search against a brute
+ *          force minimum, error in ppb, allocation order and the chain setup.
+ *
+ * @details
+ * Build and run on the host (Linux x86-64, the register blocks are mapped
+ * at their STM32 addresses):
+ *
+ *     gcc -O2 -I../manual_PWM -o tmgr_Test tmgr_Test.c && ./tmgr_Test
+ *
+ * tmgr.c is included unmodified. 189 tick counts: 150 random below 2^32
+ * (spread over all magnitudes), 30 random in 2^32..2^40 and 9 edge cases.
+ * For each:
+ *  - one 16-bit and one 32-bit timer: tmgr_Solve() fails exactly when
+ *    65536 x 2^bits is too short, otherwise its error equals the smallest
+ *    |a x b - ticks| over every a = 1..65536 and b = 1..2^bits, and its
+ *    prescaler is the smallest a reaching that error,
+ *  - a chain: fails only above 2^48, register values in range,
+ *  - every result: ticks = (PSC + 1)(ARR + 1)(slave ARR + 1) and
+ *    tmgr_Error_Ppb() = (ticks - wanted) x 10^9 / wanted, truncated.
+ * Then with fake registers: allocation order and capability filter, and
+ * tmgr_Period() + tmgr_Start() on a chain (CR2.MMS = update, SMCR = ITRx
+ * with external clock mode 1) and tmgr_Elapsed() on it.
+ * Exits non-zero on a failure.
+ ******************************************************************************
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+unsigned int rcc_Get_Tim_Clock(int bus)			{ (void)bus; return 84000000; }
+
+#include "tmgr.c"
+
+#define RANDOM_32		150
+#define RANDOM_40		30
+
+static unsigned int failures, counts;
+static unsigned long long worst_chain_err;
+
+static void fail(const char *what, unsigned long long ticks, unsigned long long a, unsigned long long b)
+{
+	if(failures++ < 20)
+		printf("FAIL %s: ticks %llu (%llu, %llu)\n", what, ticks, a, b);
+}
+
+static unsigned long long random64(void)
+{
+	return ((unsigned long long)rand() << 62) ^ ((unsigned long long)rand() << 31) ^ (unsigned long long)rand();
+}
+
+static unsigned long long diff(unsigned long long x, unsigned long long y)
+{
+	return (x > y) ? x - y : y - x;
+}
+
+/* smallest |a * b - n| over a = 1..65536, b = 1..max_b, and the smallest a reaching it */
+static unsigned long long brute(unsigned long long n, unsigned long long max_b, unsigned int *a_best)
+{
+	unsigned long long best = ~0ull;
+
+	for(unsigned int a = 1; a <= 65536; a++)
+	{
+		unsigned long long lo = n / a, b[2] = { lo, lo + 1 };
+
+		for(int i = 0; i < 2; i++)
+		{
+			unsigned long long v = b[i] < 1 ? 1 : b[i] > max_b ? max_b : b[i];
+			unsigned long long err = diff(a * v, n);
+
+			if(err < best)
+			{
+				best = err;
+				*a_best = a;
+			}
+		}
+	}
+	return best;
+}
+
+static void check_Ppb(const struct tmgr_period *p)
+{
+	__int128 d = (__int128)p->ticks - (__int128)p->wanted;
+	__int128 ppb = d * 1000000000 / (__int128)p->wanted;
+
+	if(ppb > 0x7FFFFFFF)
+		ppb = 0x7FFFFFFF;
+	if(ppb < -0x7FFFFFFF)
+		ppb = -0x7FFFFFFF;
+	if(tmgr_Error_Ppb(p) != (int)ppb)
+		fail("tmgr_Error_Ppb", p->wanted, (unsigned long long)tmgr_Error_Ppb(p), (unsigned long long)(long long)ppb);
+}
+
+static void check_Single(unsigned long long n, unsigned int bits)
+{
+	unsigned long long max_b = (bits == 32) ? 0x100000000ull : 65536;
+	struct tmgr_period p;
+	unsigned int a = 0;
+	int r = tmgr_Solve(n, bits, 0, &p);
+
+	if(n > 65536 * max_b)
+	{
+		if(r != -1)
+			fail(bits == 32 ? "32-bit: solved past 2^48" : "16-bit: solved past 2^32", n, p.psc, p.arr);
+		return;
+	}
+	if(r)
+	{
+		fail(bits == 32 ? "32-bit: no solution" : "16-bit: no solution", n, 0, 0);
+		return;
+	}
+	if(p.wanted != n || p.slave_arr || p.psc > 65535 || p.arr > max_b - 1
+		|| p.ticks != (p.psc + 1ull) * (p.arr + 1ull))
+		fail(bits == 32 ? "32-bit: registers against ticks" : "16-bit: registers against ticks", n, p.psc, p.arr);
+	if(diff(p.ticks, n) != brute(n, max_b, &a))
+		fail(bits == 32 ? "32-bit: error against brute force" : "16-bit: error against brute force",
+			n, diff(p.ticks, n), brute(n, max_b, &a));
+	else if(p.psc + 1 != a)
+		fail(bits == 32 ? "32-bit: not the finest prescaler" : "16-bit: not the finest prescaler", n, p.psc + 1, a);
+	check_Ppb(&p);
+}
+
+static void check_Chain(unsigned long long n)
+{
+	struct tmgr_period p;
+	int r = tmgr_Solve(n, 16, 1, &p);
+
+	if(r)
+	{
+		if(n <= (1ull << 48))
+			fail("chain: no solution", n, 0, 0);
+		return;
+	}
+	if(p.psc > 65535 || p.arr > 65535 || p.slave_arr > 65535
+		|| p.ticks != (p.psc + 1ull) * (p.arr + 1ull) * (p.slave_arr + 1ull))
+		fail("chain: registers against ticks", n, p.psc, p.ticks);
+	if(diff(p.ticks, n) > worst_chain_err)
+		worst_chain_err = diff(p.ticks, n);
+	check_Ppb(&p);
+}
+
+static void check(unsigned long long n)
+{
+	counts++;
+	check_Single(n, 16);
+	check_Single(n, 32);
+	check_Chain(n);
+}
+
+static void test_Solve(void)
+{
+	static const unsigned long long edge[] =
+	{
+		1, 2, 65536, 65537, 1ull << 32, (1ull << 32) + 1, 4294836225ull, 4294967295ull, 999999937ull,
+	};
+
+	srand(1);
+	for(unsigned int i = 0; i < sizeof(edge) / sizeof(edge[0]); i++)
+		check(edge[i]);
+	for(unsigned int i = 0; i < RANDOM_32; i++)
+		check(1 + (random64() >> (32 + rand() % 32)));
+	for(unsigned int i = 0; i < RANDOM_40; i++)
+		check((1ull << 32) + (random64() >> 24) % ((1ull << 40) - (1ull << 32)));
+	printf("solve: %u tick counts, largest chain error %llu ticks\n", counts, worst_chain_err);
+}
+
+/* ---- fake registers ---- */
+
+static void test_Alloc(void)
+{
+	static const int order[] = { 10, 11, 9, 3, 4, 1, 2, 5, -1 };
+
+	for(unsigned int i = 0; i < sizeof(order) / sizeof(order[0]); i++)
+	{
+		int t = tmgr_Alloc(0, 0);
+
+		if(t != order[i])
+			fail("allocation order", i, (unsigned long long)t, (unsigned long long)order[i]);
+	}
+	for(unsigned int t = 1; t <= 11; t++)
+		tmgr_Free(t);
+	if(tmgr_Alloc(TMGR_DMA, 2) != 3 || tmgr_Alloc(TMGR_32BIT, 0) != 2 || tmgr_Alloc(TMGR_ADVANCED, 0) != 1
+		|| tmgr_Alloc(TMGR_SLAVE, 4) != 4 || tmgr_Alloc(TMGR_ADVANCED, 0) != -1)
+		fail("capability filter", 0, 0, 0);
+	if(!(RCC->APB1ENR & (1<<1)) || !(RCC->APB2ENR & (1<<0)))
+		fail("clock enable of an allocated timer", 0, RCC->APB1ENR, RCC->APB2ENR);
+	for(unsigned int t = 1; t <= 11; t++)
+		tmgr_Free(t);
+	if(tmgr_used)
+		fail("timers left allocated", 0, tmgr_used, 0);
+}
+
+static void test_Chain_Start(void)
+{
+	struct tmgr_period p;
+	volatile struct timer *m, *s;
+	int r;
+
+	/* TIM10 and TIM11 taken: 1.5 s does not fit TIM9 within 10 ppb at 1 us, the chain is 3 -> 9 */
+	tmgr_Alloc(0, 0);
+	tmgr_Alloc(0, 0);
+	r = tmgr_Period(1500000000ull, 10, 1000, &p);
+	if(r != 0 || p.timer != 3 || p.slave != 9 || p.itr != 1 || tmgr_Error_Ppb(&p) != 0)
+		fail("1.5 s on a chain", p.wanted, p.timer * 100ull + p.slave, (unsigned long long)r);
+	tmgr_Start(&p);
+	m = tmgr_Regs(p.timer);
+	s = tmgr_Regs(p.slave);
+	if(m->CR2 != 0x20 || m->PSC != p.psc || m->ARR != p.arr || m->CR1 != 0x5)
+		fail("master registers", 0, m->CR2, m->CR1);
+	if(s->SMCR != 0x17 || s->PSC != 0 || s->ARR != p.slave_arr || s->CR1 != 0x5)
+		fail("slave registers", 0, s->SMCR, s->CR1);
+	m->CNT = 1234;
+	s->CNT = 7;
+	if(tmgr_Elapsed(&p) != (7ull * (p.arr + 1) + 1234) * (p.psc + 1))
+		fail("tmgr_Elapsed", 0, tmgr_Elapsed(&p), 0);
+	printf("chain: TIM%u -> TIM%u, PSC %u ARR %u slave ARR %u, %llu ticks\n",
+		p.timer, p.slave, p.psc, p.arr, p.slave_arr, p.ticks);
+	tmgr_Release(&p);
+}
+
+static void map(unsigned long addr, unsigned long len)
+{
+	if(mmap((void *)addr, len, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED)
+	{
+		perror("mmap");
+		exit(2);
+	}
+}
+
+int main(void)
+{
+	map(0x40000000, 0x30000);
+	test_Solve();
+	test_Alloc();
+	test_Chain_Start();
+	printf("tmgr: %u failures\n", failures);
+	return failures != 0;
+}
@@ -0,0 +1,155 @@
+/**
+ ******************************************************************************
+ * @file    uart_Dma.c
+ * @author  Monish Kumar.k
+ * @date    03/02/2025
+ * @brief   USART1/USART2 DMA driver demo with a loopback throughput benchmark.
+ *
+ * @details
+ * The system clock is raised to 84 MHz from the 25 MHz HSE through the PLL so
+ * that USART1 (APB2 = 84 MHz) can reach 2 Mbaud with an exact divider.
+ * USART2 (APB1 = 42 MHz) is the printf() console at 115200 baud.
+ *
+ * Benchmark:
+ *  - PA9 (USART1 TX) must be wired to PA10 (USART1 RX).
+ *  - For 921600 and 2000000 baud BENCH_BYTES are pushed through uart_Write()
+ *    and counted back by the idle-line RX callback.
+ *  - DWT->CYCCNT gives the wall time of the transfer and the CPU time spent
+ *    inside uart_Write(); results land in bench[] and are printed on USART2.
+ *  - 8N1 framing costs 10 bit times per byte, so the line limit is
+ *    92160 B/s and 200000 B/s respectively.
+ *
+ * Pin usage:
+ *  - PA9/PA10 : USART1 TX/RX (loopback jumper)
+ *  - PA2/PA3  : USART2 TX/RX (console)
+ *
+ * Note:
+ *  - Read bench[] with the debugger if no console is attached.
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 03/02/2025
+  File : uart_Dma
+ ******************************************************************************/
+#include <stdio.h>
+#include <arm.h>
+#include <rcc.h>
+#include "uart.h"
+
+#define BENCH_BYTES		16384
+#define BENCH_CHUNK		64
+
+struct bench_result
+{
+	unsigned int baud;
+	unsigned int cycles;		//first write to last byte received
+	unsigned int cpu_cycles;	//time spent inside uart_Write()
+	unsigned int bytes_per_s;
+	unsigned int received;
+};
+
+volatile struct bench_result bench[2];
+static volatile unsigned int rx_count;
+
+void rcc_Config(void);
+void dwt_Config(void);
+void bench_Rx(const unsigned char *data, unsigned int len);
+void bench_Run(volatile struct bench_result *r, unsigned int baud);
+
+int main(void)
+{
+	rcc_Config();
+	dwt_Config();
+	uart_Init(UART_CONSOLE, 115200);
+	uart_Set_Rx_Callback(UART_1, bench_Rx);
+
+	bench_Run(&bench[0], 921600);
+	bench_Run(&bench[1], 2000000);
+
+	for(int i=0; i<2; i++)
+	{
+		printf("%u baud: %u B/s, %u/%u bytes, cpu %u cycles\r\n",
+			bench[i].baud, bench[i].bytes_per_s, bench[i].received,
+			BENCH_BYTES, bench[i].cpu_cycles);
+	}
+	while(1)
+	{
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, Q7 = 48 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* AHB /1, APB1 /2, APB2 /1 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+void dwt_Config()
+{
+	DEMCR |= (1<<24);			/* TRCENA */
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= (1<<0);		/* CYCCNTENA */
+}
+
+void bench_Rx(const unsigned char *data, unsigned int len)
+{
+	(void)data;
+	rx_count += len;
+}
+
+void bench_Run(volatile struct bench_result *r, unsigned int baud)
+{
+	static unsigned char chunk[BENCH_CHUNK];
+	unsigned int sent = 0, start, t, n, cpu = 0, timeout;
+
+	for(int i=0; i<BENCH_CHUNK; i++)
+	{
+		chunk[i] = (unsigned char)i;
+	}
+	r->baud = baud;
+	if(uart_Init(UART_1, baud) != 0)
+	{
+		return;
+	}
+	rx_count = 0;
+
+	start = DWT->CYCCNT;
+	while(sent < BENCH_BYTES)
+	{
+		n = BENCH_BYTES - sent;
+		if(n > BENCH_CHUNK)
+		{
+			n = BENCH_CHUNK;
+		}
+		t = DWT->CYCCNT;
+		n = uart_Write(UART_1, chunk, n);
+		if(n)
+		{
+			cpu += DWT->CYCCNT - t;		/* only writes that queued data */
+			sent += n;
+		}
+	}
+	uart_Flush(UART_1);
+
+	timeout = rcc_Get_Sysclk() / 100;		/* 10 ms for the last idle event */
+	t = DWT->CYCCNT;
+	while(rx_count < BENCH_BYTES && (DWT->CYCCNT - t) < timeout);
+
+	r->cycles = DWT->CYCCNT - start;
+	r->cpu_cycles = cpu;
+	r->received = rx_count;
+	r->bytes_per_s = (unsigned int)((unsigned long long)rx_count * rcc_Get_Sysclk() / r->cycles);
+}
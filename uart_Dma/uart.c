@@ -0,0 +1,350 @@
+/**
+ ******************************************************************************
+ * @file    uart.c
+ * @author  Monish Kumar.k
+ * @date    03/02/2025
+ * @brief   Interrupt/DMA driven USART1/USART2 driver with ring buffers and
+ *          idle-line frame reception.
+ *
+ * @details
+ * TX path:
+ *  - uart_Write() copies the bytes into a power-of-two ring buffer and
+ *    returns at once. If the TX DMA stream is idle it is started on the
+ *    longest contiguous block of the ring.
+ *  - The DMA transfer-complete interrupt retires that block and starts the
+ *    next one, so the CPU never waits on the TXE flag.
+ *
+ * RX path:
+ *  - The RX DMA stream runs in circular mode over rx_buf, forever.
+ *  - The USART IDLE interrupt (one character time of silence after a frame)
+ *    and the DMA half/complete interrupts hand the bytes written since the
+ *    last event to the registered callback. There is no per-byte interrupt.
+ *
+ * Baud rate:
+ *  - BRR is computed from the real APB clock read back from RCC (rcc.c in
+ *    manual_PWM), so the driver keeps working when rcc_Config() changes HSE/PLL or prescalers.
+ *  - OVER8 is selected automatically when the APB clock is below 16 x baud.
+ *
+ * Note:
+ *  - All interrupts of one port run at the same NVIC priority so the RX
+ *    handlers never preempt each other.
+ *  - A write that does not fit in the ring is truncated, never blocked.
+ ******************************************************************************
+ */
+#include <arm.h>
+#include <rcc.h>
+#include "uart.h"
+
+struct uart_hw
+{
+	volatile struct usart *regs;
+	volatile struct dma *dma;
+	unsigned char apb;			//1 = APB1, 2 = APB2
+	unsigned char en_bit;		//USARTxEN bit in APBxENR
+	unsigned char dma_en_bit;	//DMAxEN bit in AHB1ENR
+	unsigned char tx_pin;
+	unsigned char rx_pin;
+	unsigned char tx_stream;
+	unsigned char rx_stream;
+	unsigned char irq;
+	unsigned char tx_irq;
+	unsigned char rx_irq;
+};
+
+struct uart_port
+{
+	unsigned char tx_buf[UART_TX_SIZE];
+	unsigned char rx_buf[UART_RX_SIZE];
+	volatile unsigned int tx_head;		//free running, written by producers
+	volatile unsigned int tx_tail;		//free running, written by DMA ISR
+	volatile unsigned int tx_busy;		//bytes in flight on the TX stream
+	unsigned int rx_pos;				//last RX index handed to the callback
+	uart_rx_callback rx_cb;
+};
+
+static const struct uart_hw uart_hw[2] =
+{
+	{ USART1, DMA2, 2, 4,  22, 9, 10, 7, 2, 37, 70, 58 },
+	{ USART2, DMA1, 1, 17, 21, 2, 3,  6, 5, 38, 17, 16 },
+};
+
+static struct uart_port uart_port[2];
+
+#define DMA_FLAGS		0x3D		//FEIF | DMEIF | TEIF | HTIF | TCIF
+#define DMA_HTIF		(1<<4)
+#define DMA_TCIF		(1<<5)
+#define UART_PRIO		(5<<4)
+
+static const unsigned char dma_flag_shift[4] = { 0, 6, 16, 22 };
+
+#if defined(__arm__)
+static unsigned int irq_Save(void)
+{
+	unsigned int primask;
+	__asm volatile("mrs %0, primask\n\tcpsid i" : "=r"(primask) : : "memory");
+	return primask;
+}
+
+static void irq_Restore(unsigned int primask)
+{
+	__asm volatile("msr primask, %0" : : "r"(primask) : "memory");
+}
+#else
+/* host build (uart_Test.c): the simulated interrupts only run between calls */
+static unsigned int irq_Save(void)					{ return 0; }
+static void irq_Restore(unsigned int primask)		{ (void)primask; }
+#endif
+
+static unsigned int dma_Flags(volatile struct dma *dma, int stream)
+{
+	unsigned int isr = (stream < 4) ? dma->LISR : dma->HISR;
+	return (isr >> dma_flag_shift[stream & 3]) & DMA_FLAGS;
+}
+
+static void dma_Clear(volatile struct dma *dma, int stream, unsigned int flags)
+{
+	if(stream < 4)
+		dma->LIFCR = flags << dma_flag_shift[stream & 3];
+	else
+		dma->HIFCR = flags << dma_flag_shift[stream & 3];
+}
+
+static void nvic_Enable(int irq)
+{
+	NVIC->IP[irq] = UART_PRIO;
+	NVIC->ISER[irq >> 5] = (1 << (irq & 31));
+}
+
+static void gpio_Config(const struct uart_hw *hw)
+{
+	int tx = hw->tx_pin, rx = hw->rx_pin;
+
+	GPIOA->MODER   = (GPIOA->MODER & ~((0x3 << (tx*2)) | (0x3 << (rx*2))))
+				   | (0x2 << (tx*2)) | (0x2 << (rx*2));			//alternate function
+	GPIOA->OSPEEDR |= (0x3 << (tx*2));								//high speed TX
+	GPIOA->PUPDR   = (GPIOA->PUPDR & ~(0x3 << (rx*2))) | (0x1 << (rx*2));	//idle high RX
+
+	if(tx < 8)
+		GPIOA->AFRL = (GPIOA->AFRL & ~(0xF << (tx*4))) | (7 << (tx*4));
+	else
+		GPIOA->AFRH = (GPIOA->AFRH & ~(0xF << ((tx-8)*4))) | (7 << ((tx-8)*4));
+	if(rx < 8)
+		GPIOA->AFRL = (GPIOA->AFRL & ~(0xF << (rx*4))) | (7 << (rx*4));
+	else
+		GPIOA->AFRH = (GPIOA->AFRH & ~(0xF << ((rx-8)*4))) | (7 << ((rx-8)*4));
+}
+
+int uart_Init(int port, unsigned int baud)
+{
+	const struct uart_hw *hw = &uart_hw[port];
+	struct uart_port *p = &uart_port[port];
+	volatile struct dma_stream *tx = &hw->dma->S[hw->tx_stream];
+	volatile struct dma_stream *rx = &hw->dma->S[hw->rx_stream];
+	unsigned int pclk, div, real, err, brr, over8 = 0;
+
+	RCC->AHB1ENR |= (1<<0) | (1 << hw->dma_en_bit);		//GPIOA + DMAx
+	if(hw->apb == 2)
+		RCC->APB2ENR |= (1 << hw->en_bit);
+	else
+		RCC->APB1ENR |= (1 << hw->en_bit);
+
+	/*
+	 * div = 16 * USARTDIV. With OVER16 BRR is div itself, with OVER8 the
+	 * mantissa is div/8 and the 3 bit fraction sits in BRR[2:0].
+	 */
+	pclk = rcc_Get_Pclk(hw->apb);
+	div  = (pclk + baud/2) / baud;
+	if(div < 8)
+		return -1;
+	real = div * baud;
+	err  = (real > pclk) ? (real - pclk) : (pclk - real);
+	if(err * 40 > pclk)				//more than 2.5 % off
+		return -1;
+	if(div < 16)
+	{
+		over8 = 1;
+		brr = ((div >> 3) << 4) | (div & 0x7);
+	}
+	else
+	{
+		brr = div;
+	}
+
+	gpio_Config(hw);
+
+	hw->regs->CR1 = 0;
+	tx->CR = 0;
+	rx->CR = 0;
+	while((tx->CR & (1<<0)) || (rx->CR & (1<<0)));
+
+	p->tx_head = 0;
+	p->tx_tail = 0;
+	p->tx_busy = 0;
+	p->rx_pos  = 0;
+
+	hw->regs->BRR = brr;
+	hw->regs->CR3 = (1<<7) | (1<<6);			//DMAT | DMAR
+
+	dma_Clear(hw->dma, hw->tx_stream, DMA_FLAGS);
+	tx->PAR = (unsigned int)&hw->regs->DR;
+	tx->FCR = 0;
+	tx->CR  = (4<<25) | (1<<10) | (1<<6) | (1<<4) | (1<<2);	//CH4, MINC, M->P, TCIE, TEIE
+
+	dma_Clear(hw->dma, hw->rx_stream, DMA_FLAGS);
+	rx->PAR  = (unsigned int)&hw->regs->DR;
+	rx->M0AR = (unsigned int)p->rx_buf;
+	rx->NDTR = UART_RX_SIZE;
+	rx->FCR  = 0;
+	rx->CR   = (4<<25) | (1<<10) | (1<<8) | (1<<4) | (1<<3) | (1<<2);	//CH4, MINC, CIRC, TCIE, HTIE, TEIE
+	rx->CR  |= (1<<0);
+
+	nvic_Enable(hw->irq);
+	nvic_Enable(hw->tx_irq);
+	nvic_Enable(hw->rx_irq);
+
+	hw->regs->CR1 = (over8 << 15) | (1<<13) | (1<<4) | (1<<3) | (1<<2);	//UE, IDLEIE, TE, RE
+	return 0;
+}
+
+void uart_Set_Rx_Callback(int port, uart_rx_callback cb)
+{
+	uart_port[port].rx_cb = cb;
+}
+
+/* Must run with interrupts masked or from the TX DMA handler. */
+static void tx_Kick(int port)
+{
+	const struct uart_hw *hw = &uart_hw[port];
+	struct uart_port *p = &uart_port[port];
+	volatile struct dma_stream *s = &hw->dma->S[hw->tx_stream];
+	unsigned int tail, len;
+
+	if(p->tx_busy || p->tx_head == p->tx_tail)
+		return;
+
+	tail = p->tx_tail & (UART_TX_SIZE - 1);
+	len  = p->tx_head - p->tx_tail;
+	if(len > UART_TX_SIZE - tail)
+		len = UART_TX_SIZE - tail;		//stop at the end of the ring
+
+	dma_Clear(hw->dma, hw->tx_stream, DMA_FLAGS);
+	s->M0AR = (unsigned int)&p->tx_buf[tail];
+	s->NDTR = len;
+	p->tx_busy = len;
+	s->CR |= (1<<0);
+}
+
+unsigned int uart_Write(int port, const void *data, unsigned int len)
+{
+	struct uart_port *p = &uart_port[port];
+	const unsigned char *src = data;
+	unsigned int primask, head, free;
+
+	primask = irq_Save();
+	head = p->tx_head;
+	free = UART_TX_SIZE - (head - p->tx_tail);
+	if(len > free)
+		len = free;
+	for(unsigned int i = 0; i < len; i++)
+	{
+		p->tx_buf[(head + i) & (UART_TX_SIZE - 1)] = src[i];
+	}
+	p->tx_head = head + len;
+	tx_Kick(port);
+	irq_Restore(primask);
+
+	return len;
+}
+
+unsigned int uart_Tx_Free(int port)
+{
+	struct uart_port *p = &uart_port[port];
+	return UART_TX_SIZE - (p->tx_head - p->tx_tail);
+}
+
+void uart_Flush(int port)
+{
+	struct uart_port *p = &uart_port[port];
+
+	while(p->tx_head != p->tx_tail);
+	while(!(uart_hw[port].regs->SR & (1<<6)));		//TC: last stop bit out
+}
+
+/* newlib hook: printf() and friends end up here and never block. */
+int _write(int fd, char *ptr, int len)
+{
+	(void)fd;
+	uart_Write(UART_CONSOLE, ptr, len);
+	return len;
+}
+
+static void tx_Dma_Irq(int port)
+{
+	const struct uart_hw *hw = &uart_hw[port];
+	struct uart_port *p = &uart_port[port];
+	unsigned int flags = dma_Flags(hw->dma, hw->tx_stream);
+
+	dma_Clear(hw->dma, hw->tx_stream, flags);
+	if(flags & (DMA_TCIF | (1<<3)))		//complete or transfer error
+	{
+		p->tx_tail += p->tx_busy;
+		p->tx_busy = 0;
+		tx_Kick(port);
+	}
+}
+
+static void rx_Process(int port)
+{
+	const struct uart_hw *hw = &uart_hw[port];
+	struct uart_port *p = &uart_port[port];
+	unsigned int pos = UART_RX_SIZE - hw->dma->S[hw->rx_stream].NDTR;
+
+	if(pos == UART_RX_SIZE)
+		pos = 0;
+	if(pos == p->rx_pos)
+		return;
+
+	if(p->rx_cb)
+	{
+		if(pos > p->rx_pos)
+		{
+			p->rx_cb(&p->rx_buf[p->rx_pos], pos - p->rx_pos);
+		}
+		else
+		{
+			p->rx_cb(&p->rx_buf[p->rx_pos], UART_RX_SIZE - p->rx_pos);
+			if(pos)
+				p->rx_cb(p->rx_buf, pos);
+		}
+	}
+	p->rx_pos = pos;
+}
+
+static void rx_Dma_Irq(int port)
+{
+	const struct uart_hw *hw = &uart_hw[port];
+	unsigned int flags = dma_Flags(hw->dma, hw->rx_stream);
+
+	dma_Clear(hw->dma, hw->rx_stream, flags);
+	if(flags & (DMA_HTIF | DMA_TCIF))
+		rx_Process(port);
+}
+
+static void uart_Irq(int port)
+{
+	volatile struct usart *regs = uart_hw[port].regs;
+	unsigned int sr = regs->SR;
+
+	if(sr & ((1<<4) | (1<<3)))		//IDLE or ORE, cleared by SR then DR read
+	{
+		(void)regs->DR;
+		rx_Process(port);
+	}
+}
+
+void USART1_IRQHandler()		{ uart_Irq(UART_1); }
+void USART2_IRQHandler()		{ uart_Irq(UART_2); }
+void DMA2_Stream7_IRQHandler()	{ tx_Dma_Irq(UART_1); }
+void DMA2_Stream2_IRQHandler()	{ rx_Dma_Irq(UART_1); }
+void DMA1_Stream6_IRQHandler()	{ tx_Dma_Irq(UART_2); }
+void DMA1_Stream5_IRQHandler()	{ rx_Dma_Irq(UART_2); }
@@ -0,0 +1,35 @@
+/*
+ * uart.h
+ *
+ *  Created on: Feb 03, 2025
+ *      Author: moni
+ *
+ *  USART1 / USART2 driver. TX is fed by DMA from a ring buffer so a write
+ *  never waits for the line, RX runs DMA in circular mode and hands out
+ *  whatever arrived when the line goes idle (IDLE flag) or when half of the
+ *  RX buffer fills up.
+ *
+ *  USART1 : PA9  TX, PA10 RX, DMA2 Stream7 / Stream2 channel 4 (APB2 clock)
+ *  USART2 : PA2  TX, PA3  RX, DMA1 Stream6 / Stream5 channel 4 (APB1 clock)
+ */
+
+#ifndef UART_H_
+#define UART_H_
+
+#define UART_1			0
+#define UART_2			1
+
+#define UART_CONSOLE	UART_2		//port used by printf() through _write()
+
+#define UART_TX_SIZE	512			//must be a power of two
+#define UART_RX_SIZE	256			//must be even, HT event splits it in two
+
+typedef void (*uart_rx_callback)(const unsigned char *data, unsigned int len);
+
+int  uart_Init(int port, unsigned int baud);
+void uart_Set_Rx_Callback(int port, uart_rx_callback cb);
+unsigned int uart_Write(int port, const void *data, unsigned int len);
+unsigned int uart_Tx_Free(int port);
+void uart_Flush(int port);
+
+#endif /* UART_H_ */
@@ -0,0 +1,257 @@
+/**
+ ******************************************************************************
+ * @file    uart_Test.c
+ * @author  Monish Kumar.k
+ * @date    03/02/2025
+ * @brief   Host loopback test of uart.c against simulated USART and DMA
+ *          registers.
+ *
+ * @details
+ * Build and run on the host (Linux, the register blocks are mapped at
+ * their STM32 addresses):
+ *
+ *     gcc -O2 -I../manual_PWM -o uart_Test uart_Test.c ../manual_PWM/rcc.c && ./uart_Test
+ *
+ * uart.c is included, so the test sees its ring indices and buffers.
+ * Each step of the simulation moves one byte on the wire:
+ *  - TX DMA: while the stream is enabled, one byte of the block at M0AR
+ *    goes out per step; at NDTR = 0 the stream stops and TCIF is set.
+ *  - the byte loops back into the circular RX stream at
+ *    RX_SIZE - NDTR; HTIF is set at the half, TCIF at the end.
+ *  - a DMA handler runs 0..7 byte times after its flag, so the RX
+ *    position may have wrapped past the end when it looks.
+ *  - after a random gap with no byte, IDLE is set and the USART handler
+ *    runs.
+ * Writes of random length are made between steps; whatever uart_Write()
+ * accepts must come back through the callback in order, with no chunk
+ * outside rx_buf or crossing its end. Flags are cleared the way the
+ * hardware does it:
+ * ISR &= ~IFCR after each handler. Exits non-zero on a failure.
+ ******************************************************************************
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include "uart.c"
+
+#define TEST_BYTES		2000000
+#define SR_IDLE			(1<<4)
+
+static unsigned char sent[TEST_BYTES], got[TEST_BYTES];
+static unsigned int n_sent, n_got;
+static unsigned int chunks, half_events, idle_events, failures;
+static unsigned int rx_latency, tx_latency;		//steps until the pending DMA handler runs
+static int test_port;
+
+static void map(unsigned long addr, unsigned long len)
+{
+	if(mmap((void *)addr, len, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED)
+	{
+		perror("mmap");
+		exit(2);
+	}
+}
+
+static void rx_Callback(const unsigned char *data, unsigned int len)
+{
+	struct uart_port *p = &uart_port[test_port];
+
+	chunks++;
+	if(data < p->rx_buf || data + len > p->rx_buf + UART_RX_SIZE || !len)
+	{
+		printf("chunk out of rx_buf: offset %ld, len %u\n", (long)(data - p->rx_buf), len);
+		failures++;
+		return;
+	}
+	for(unsigned int i = 0; i < len && n_got < TEST_BYTES; i++)
+	{
+		got[n_got++] = data[i];
+	}
+}
+
+/* ISR &= ~IFCR, the write-1-to-clear of LIFCR/HIFCR */
+static void dma_Ack(volatile struct dma *dma)
+{
+	dma->LISR &= ~dma->LIFCR;
+	dma->HISR &= ~dma->HIFCR;
+	dma->LIFCR = 0;
+	dma->HIFCR = 0;
+}
+
+static void dma_Raise(volatile struct dma *dma, int stream, unsigned int flags)
+{
+	if(stream < 4)
+		dma->LISR |= flags << dma_flag_shift[stream & 3];
+	else
+		dma->HISR |= flags << dma_flag_shift[stream & 3];
+}
+
+static void irq_Tx(int port)
+{
+	if(port == UART_1) DMA2_Stream7_IRQHandler(); else DMA1_Stream6_IRQHandler();
+}
+
+static void irq_Rx(int port)
+{
+	if(port == UART_1) DMA2_Stream2_IRQHandler(); else DMA1_Stream5_IRQHandler();
+}
+
+static void irq_Uart(int port)
+{
+	if(port == UART_1) USART1_IRQHandler(); else USART2_IRQHandler();
+}
+
+/* a raised flag runs its handler 0..7 byte times later */
+static void dma_Irqs(int port)
+{
+	const struct uart_hw *hw = &uart_hw[port];
+
+	if(dma_Flags(hw->dma, hw->rx_stream) && (rx_latency ? --rx_latency : (rx_latency = rand() % 8)) == 0)
+	{
+		irq_Rx(port);
+		dma_Ack(hw->dma);
+	}
+	if(dma_Flags(hw->dma, hw->tx_stream) && (tx_latency ? --tx_latency : (tx_latency = rand() % 8)) == 0)
+	{
+		irq_Tx(port);
+		dma_Ack(hw->dma);
+	}
+}
+
+/* one byte time on the wire; returns 1 if a byte was sent */
+static int line_Step(int port)
+{
+	const struct uart_hw *hw = &uart_hw[port];
+	volatile struct dma_stream *tx = &hw->dma->S[hw->tx_stream];
+	volatile struct dma_stream *rx = &hw->dma->S[hw->rx_stream];
+	unsigned char *base, byte;
+	unsigned int pos;
+
+	if(!(tx->CR & (1<<0)) || !tx->NDTR)
+	{
+		dma_Irqs(port);
+		return 0;
+	}
+
+	/* M0AR holds the low 32 bits of the host pointer */
+	base = (unsigned char *)(((uintptr_t)uart_port[port].tx_buf & ~(uintptr_t)0xFFFFFFFF) | tx->M0AR);
+	byte = *base;
+	tx->M0AR++;
+	if(--tx->NDTR == 0)
+	{
+		tx->CR &= ~(1<<0);
+		dma_Raise(hw->dma, hw->tx_stream, DMA_TCIF);
+	}
+
+	pos = UART_RX_SIZE - rx->NDTR;
+	uart_port[port].rx_buf[pos] = byte;
+	rx->NDTR = (rx->NDTR == 1) ? UART_RX_SIZE : rx->NDTR - 1;
+	if(pos + 1 == UART_RX_SIZE / 2)
+	{
+		dma_Raise(hw->dma, hw->rx_stream, DMA_HTIF);
+		half_events++;
+	}
+	if(pos + 1 == UART_RX_SIZE)
+	{
+		dma_Raise(hw->dma, hw->rx_stream, DMA_TCIF);
+		half_events++;
+	}
+
+	dma_Irqs(port);
+	return 1;
+}
+
+static void line_Idle(int port)
+{
+	uart_hw[port].regs->SR |= SR_IDLE;
+	irq_Uart(port);
+	uart_hw[port].regs->SR &= ~SR_IDLE;		/* SR then DR read clears it */
+	idle_events++;
+}
+
+static int test_Port(int port, unsigned int seed)
+{
+	unsigned long steps = 0;
+	unsigned int gap = 0;
+
+	srand(seed);
+	test_port = port;
+	n_sent = n_got = chunks = half_events = idle_events = failures = 0;
+	rx_latency = tx_latency = 0;
+	if(uart_Init(port, 115200))
+	{
+		printf("uart_Init failed\n");
+		return 1;
+	}
+	uart_Set_Rx_Callback(port, rx_Callback);
+
+	while(n_sent < TEST_BYTES || n_got < n_sent)
+	{
+		if(++steps > 40ul * TEST_BYTES)
+		{
+			printf("stuck: %u bytes sent, %u received\n", n_sent, n_got);
+			failures++;
+			break;
+		}
+		if(n_sent < TEST_BYTES && rand() % 8 == 0)
+		{
+			unsigned char block[700];
+			unsigned int len = rand() % sizeof(block), free_before = uart_Tx_Free(port), done;
+
+			if(len > TEST_BYTES - n_sent)
+				len = TEST_BYTES - n_sent;
+			for(unsigned int i = 0; i < len; i++)
+			{
+				block[i] = (unsigned char)rand();
+			}
+			done = uart_Write(port, block, len);
+			if(done != (len < free_before ? len : free_before))
+			{
+				printf("uart_Write took %u of %u with %u free\n", done, len, free_before);
+				failures++;
+			}
+			for(unsigned int i = 0; i < done; i++)
+			{
+				sent[n_sent++] = block[i];
+			}
+		}
+		if(rand() % 64 == 0)
+		{
+			gap = 1 + rand() % 4;			/* the line goes quiet for a while */
+		}
+		if(gap)
+		{
+			if(--gap == 0)
+				line_Idle(port);
+			continue;
+		}
+		if(!line_Step(port) && n_sent == TEST_BYTES)
+			line_Idle(port);
+	}
+
+	for(unsigned int i = 0; i < n_sent; i++)
+	{
+		if(sent[i] != got[i])
+		{
+			printf("byte %u: sent 0x%02x, got 0x%02x\n", i, sent[i], got[i]);
+			failures++;
+			break;
+		}
+	}
+	printf("USART%d: %u bytes looped back in %u chunks, %u half/complete and %u idle events, %u failures\n",
+		port + 1, n_got, chunks, half_events, idle_events, failures);
+	return failures != 0;
+}
+
+int main(void)
+{
+	int fail = 0;
+
+	map(0x40000000, 0x30000);		/* APB1, APB2, AHB1: USART, GPIO, RCC, DMA */
+	map(0xE000E000, 0x1000);		/* NVIC */
+
+	fail |= test_Port(UART_1, 1);
+	fail |= test_Port(UART_2, 2);
+	return fail;
+}
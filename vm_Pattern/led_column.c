@@ -0,0 +1,20 @@
+/* led_column.vas, 184 bytes, generated by vm_Asm.py */
+const unsigned char vm_led_column[184] =
+{
+	0x09, 0x00, 0x08, 0x9E, 0xB4, 0x00, 0x08, 0x1C, 0x73, 0x00, 0x03, 0x01,
+	0x00, 0x04, 0x64, 0x00, 0x03, 0x02, 0x00, 0x04, 0x64, 0x00, 0x03, 0x04,
+	0x00, 0x04, 0x64, 0x00, 0x03, 0x08, 0x00, 0x04, 0x64, 0x00, 0x03, 0x10,
+	0x00, 0x04, 0x64, 0x00, 0x03, 0x20, 0x00, 0x04, 0x64, 0x00, 0x03, 0x40,
+	0x00, 0x04, 0x64, 0x00, 0x03, 0x80, 0x00, 0x04, 0x64, 0x00, 0x03, 0x00,
+	0x00, 0x04, 0x64, 0x00, 0x01, 0xAA, 0x00, 0x04, 0xBC, 0x02, 0x02, 0xAA,
+	0x00, 0x04, 0xBC, 0x02, 0x01, 0x55, 0x00, 0x04, 0xBC, 0x02, 0x02, 0x55,
+	0x00, 0x04, 0xBC, 0x02, 0x01, 0x0F, 0x00, 0x04, 0xBC, 0x02, 0x02, 0x0F,
+	0x00, 0x04, 0xBC, 0x02, 0x01, 0xF0, 0x00, 0x04, 0xBC, 0x02, 0x02, 0xF0,
+	0x00, 0x04, 0xBC, 0x02, 0x07, 0x02, 0x00, 0x05, 0x00, 0x03, 0x00, 0x03,
+	0x01, 0x00, 0x04, 0x64, 0x00, 0x03, 0x03, 0x00, 0x04, 0x64, 0x00, 0x03,
+	0x07, 0x00, 0x04, 0x64, 0x00, 0x03, 0x0F, 0x00, 0x04, 0x64, 0x00, 0x03,
+	0x1F, 0x00, 0x04, 0x64, 0x00, 0x03, 0x3F, 0x00, 0x04, 0x64, 0x00, 0x03,
+	0x7F, 0x00, 0x04, 0x64, 0x00, 0x03, 0xFF, 0x00, 0x04, 0x64, 0x00, 0x03,
+	0x00, 0x00, 0x04, 0x64, 0x00, 0x06, 0x00, 0x77, 0x00, 0x07, 0x02, 0x00,
+	0x03, 0x00, 0x00, 0x00,
+};
@@ -0,0 +1,308 @@
+/**
+ ******************************************************************************
+ * @file    vm_Pattern.c
+ * @author  Monish Kumar.k
+ * @date    01/04/2025
+ * @brief   LED effects as bytecode programs, run from a 1 ms timer tick and
+ *          replaceable over UART, with a dispatch benchmark.
+ *
+ * @details
+ * Hardware Connections: LEDs on PA0..PA7 (as led_Blinking_Column), buttons on
+ * PB12 (pull-up) and PB14 (pull-down) as 8x8_Led_PullUp_PullDown, USART1 on
+ * PA9 (TX) / PA10 (RX) at 921600 baud for uploads and the log.
+ *
+ * - TIM10 interrupts every 1 ms and calls vm_Tick(). A tick runs at most
+ *   VM_STEPS_PER_TICK instructions, so a looping program cannot starve the
+ *   rest of the firmware.
+ * - At power-up the VM runs led_column.vas (led_Blink_C13() of
+ *   led_Blinking_Column). A new program is sent by vm_Asm.py --upload as
+ *   'V' 'M' len16 program sum8; it is checked with vm_Check() before it
+ *   replaces the running one, and the board answers "OK" or "ERR".
+ * - Programs may drive PA0..PA7 only, the UART pins are masked off.
+ *
+ * Benchmark:
+ *  - For every opcode that does not leave the tick, a program of that
+ *    opcode repeated, run through vm_Tick() (computed goto) and
+ *    vm_Tick_Switch(); cycles per instruction x10, tick entry included.
+ *  Results are logged with LOG() on USART1 and kept in bench[].
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 01/04/2025
+  File : vm_Pattern
+ ******************************************************************************/
+#include <arm.h>
+#include <rcc.h>
+#include <uart.h>
+#include <log.h>
+#include "vm.h"
+
+#define LOG_PORT		UART_1
+#define TIM10_IRQ		25
+#define TICK_HZ			1000
+#define BENCH_TICKS		1000
+
+extern const unsigned char vm_led_column[184];
+
+struct bench_result
+{
+	unsigned int op;
+	unsigned int goto_x10;			//cycles per instruction x10
+	unsigned int switch_x10;
+};
+
+/* instructions benchmarked; an address operand is patched to the next instruction */
+static const unsigned char bench_ops[][4] =
+{
+	{ VM_SET,   0xFF, 0x00 },
+	{ VM_CLR,   0xFF, 0x00 },
+	{ VM_WRITE, 0x55, 0x00 },
+	{ VM_LDC,   1, 0x10, 0x00 },
+	{ VM_LOOP,  0, 0, 0 },
+	{ VM_JMP,   0, 0 },
+	{ VM_BIN,   (1<<4) | 12, 0, 0 },
+	{ VM_PORT,  0 },
+};
+#define BENCH_N		(sizeof(bench_ops) / sizeof(bench_ops[0]))
+volatile struct bench_result bench[BENCH_N];
+
+static struct vm vm;
+static unsigned char vm_prog[VM_CODE_MAX];
+
+/* upload receiver, filled from the USART1 RX callback */
+static unsigned char rx_prog[VM_CODE_MAX];
+static unsigned int rx_state, rx_len, rx_pos, rx_sum;
+static volatile int rx_ready;		//1 frame complete, -1 bad frame
+
+void rcc_Config(void);
+void gpio_Moder(void);
+void tim10_Config(void);
+void vm_Rx(const unsigned char *data, unsigned int len);
+void vm_Upload(void);
+void bench_Run(void);
+
+int main(void)
+{
+	rcc_Config();
+	gpio_Moder();
+	uart_Init(LOG_PORT, 921600);
+	log_Init();
+
+	bench_Run();
+
+	vm.pin_mask[0] = 0x00FF;		/* PA0..PA7 */
+	vm.pin_mask[1] = 0;
+	vm.pin_mask[2] = 0;
+	for(unsigned int i = 0; i < sizeof(vm_led_column); i++)
+	{
+		vm_prog[i] = vm_led_column[i];
+	}
+	vm_Load(&vm, vm_prog, sizeof(vm_led_column));
+
+	uart_Set_Rx_Callback(LOG_PORT, vm_Rx);
+	tim10_Config();
+	while(1)
+	{
+		if(rx_ready)
+			vm_Upload();
+		log_Drain(LOG_PORT);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* APB1 /2 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+void gpio_Moder()
+{
+	RCC->AHB1ENR |= (1<<0) | (1<<1);
+	GPIOA->BSRR = (0xFF<<16);
+	GPIOA->MODER = (GPIOA->MODER & ~0xFFFF) | 0x5555;		/* PA0..PA7 output */
+
+	GPIOB->MODER &= ~((0x3<<24) | (0x3<<28));				/* PB12, PB14 input */
+	GPIOB->PUPDR = (GPIOB->PUPDR & ~((0x3<<24) | (0x3<<28))) | (1<<24) | (2<<28);	/* PB12 pull-up, PB14 pull-down */
+}
+
+void tim10_Config()
+{
+	RCC->APB2ENR |= (1<<17);
+	TIM10->CR1 = 0;
+	TIM10->PSC = rcc_Get_Tim_Clock(2) / 1000000 - 1;		/* 1 MHz */
+	TIM10->ARR = 1000000 / TICK_HZ - 1;
+	TIM10->EGR = (1<<0);
+	TIM10->SR = 0;
+	TIM10->DIER = (1<<0);
+	NVIC->IP[TIM10_IRQ] = (6<<4);
+	NVIC->ISER[TIM10_IRQ >> 5] = (1 << (TIM10_IRQ & 31));
+	TIM10->CR1 = (1<<0);
+}
+
+void TIM1_UP_TIM10_IRQHandler()
+{
+	TIM10->SR = 0;
+	vm_Tick(&vm);
+}
+
+/* 'V' 'M' len_lo len_hi program sum8; runs in the USART1 interrupt */
+void vm_Rx(const unsigned char *data, unsigned int len)
+{
+	for(unsigned int i = 0; i < len; i++)
+	{
+		unsigned int b = data[i];
+
+		if(rx_ready)
+			return;					/* previous frame not taken yet */
+		switch(rx_state)
+		{
+		case 0:
+			rx_state = (b == 'V') ? 1 : 0;
+			break;
+		case 1:
+			rx_state = (b == 'M') ? 2 : 0;
+			break;
+		case 2:
+			rx_len = b;
+			rx_state = 3;
+			break;
+		case 3:
+			rx_len |= b << 8;
+			rx_pos = 0;
+			rx_sum = 0;
+			if(rx_len == 0 || rx_len > VM_CODE_MAX)
+			{
+				rx_state = 0;
+				rx_ready = -1;
+			}
+			else
+			{
+				rx_state = 4;
+			}
+			break;
+		case 4:
+			rx_prog[rx_pos++] = b;
+			rx_sum += b;
+			if(rx_pos == rx_len)
+				rx_state = 5;
+			break;
+		case 5:
+			rx_state = 0;
+			rx_ready = ((rx_sum & 0xFF) == b) ? 1 : -1;
+			break;
+		}
+	}
+}
+
+void vm_Upload()
+{
+	int ok = (rx_ready > 0) && vm_Check(rx_prog, rx_len) == 0;
+
+	if(ok)
+	{
+		/* the tick interrupt never runs halfway through this store, so it
+		 * sees either the old program running or the VM halted; the barrier
+		 * keeps the copy below from being moved ahead of the halt */
+		vm.state = VM_HALTED;
+		__asm volatile("" ::: "memory");
+		for(unsigned int i = 0; i < rx_len; i++)
+		{
+			vm_prog[i] = rx_prog[i];
+		}
+		GPIOA->BSRR = (vm.pin_mask[0] << 16);
+		vm_Load(&vm, vm_prog, rx_len);
+		LOG("vm: loaded %u bytes", rx_len);
+		uart_Write(LOG_PORT, "OK\n", 3);
+	}
+	else
+	{
+		LOG("vm: upload rejected");
+		uart_Write(LOG_PORT, "ERR\n", 4);
+	}
+	rx_ready = 0;
+}
+
+static unsigned int bench_Build(unsigned char *code, unsigned int op)
+{
+	const unsigned char *ins = bench_ops[op];
+	unsigned int size = vm_op_size[ins[0]], pc = 0;
+
+	while(pc + size + 3 <= VM_CODE_MAX)
+	{
+		unsigned int next = pc + size;
+
+		for(unsigned int i = 0; i < size; i++)
+		{
+			code[pc + i] = ins[i];
+		}
+		if(ins[0] == VM_JMP)
+		{
+			code[pc + 1] = next & 0xFF;
+			code[pc + 2] = next >> 8;
+		}
+		else if(ins[0] == VM_LOOP || ins[0] == VM_BIN)
+		{
+			code[pc + 2] = next & 0xFF;
+			code[pc + 3] = next >> 8;
+		}
+		pc = next;
+	}
+	code[pc++] = VM_JMP;
+	code[pc++] = 0;
+	code[pc++] = 0;
+	return pc;
+}
+
+static unsigned int bench_Ticks(void (*tick)(struct vm *), unsigned int size)
+{
+	unsigned int start, cycles;
+
+	vm_Load(&vm, vm_prog, size);
+	start = DWT->CYCCNT;
+	for(unsigned int t = 0; t < BENCH_TICKS; t++)
+	{
+		tick(&vm);
+	}
+	cycles = DWT->CYCCNT - start;
+	return (unsigned int)((unsigned long long)cycles * 10 / vm.ops);
+}
+
+void bench_Run()
+{
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);		/* CYCCNTENA */
+
+	/* no pins may move while benchmarking */
+	vm.pin_mask[0] = vm.pin_mask[1] = vm.pin_mask[2] = 0;
+
+	for(unsigned int i = 0; i < BENCH_N; i++)
+	{
+		unsigned int size = bench_Build(vm_prog, i);
+
+		if(vm_Check(vm_prog, size) != 0)
+		{
+			LOG("vm bench %u: program rejected", i);
+			continue;
+		}
+		bench[i].op = bench_ops[i][0];
+		bench[i].goto_x10 = bench_Ticks(vm_Tick, size);
+		bench[i].switch_x10 = bench_Ticks(vm_Tick_Switch, size);
+		LOG("vm op %u: goto %u/10 cycles, switch %u/10 cycles", bench[i].op,
+			bench[i].goto_x10, bench[i].switch_x10);
+		log_Drain(LOG_PORT);
+	}
+}
@@ -0,0 +1,227 @@
+/**
+ ******************************************************************************
+ * @file    vm.c
+ * @author  Monish Kumar.k
+ * @date    01/04/2025
+ * @brief   LED effect bytecode interpreter, computed-goto and switch
+ *          dispatch.
+ *
+ * @details
+ *  - vm_Tick() jumps straight from one handler to the next through a
+ *    label table (GCC "labels as values"); vm_Tick_Switch() is the same
+ *    interpreter written with a switch. Both share the op bodies below.
+ *  - Port writes go through BSRR, masked with the pins the program is
+ *    allowed to drive, so an uploaded effect cannot touch the UART pins.
+ ******************************************************************************
+ */
+#include <arm.h>
+#include "vm.h"
+
+#define U16(p)		((unsigned int)(p)[0] | ((unsigned int)(p)[1] << 8))
+
+const unsigned char vm_op_size[VM_OPS] = { 1, 3, 3, 3, 3, 4, 4, 3, 4, 2 };
+
+static volatile struct gpio *const vm_ports[3] = { GPIOA, GPIOB, GPIOC };
+
+int vm_Check(const unsigned char *code, unsigned int size)
+{
+	static unsigned char starts[VM_CODE_MAX];
+	unsigned int pc = 0;
+
+	if(size == 0 || size > VM_CODE_MAX)
+		return -1;
+	for(unsigned int i = 0; i < size; i++)
+	{
+		starts[i] = 0;
+	}
+	while(pc < size)
+	{
+		unsigned int op = code[pc];
+
+		if(op >= VM_OPS || pc + vm_op_size[op] > size)
+			return -1;
+		starts[pc] = 1;
+		pc += vm_op_size[op];
+	}
+	for(pc = 0; pc < size; pc += vm_op_size[code[pc]])
+	{
+		const unsigned char *p = &code[pc];
+		unsigned int addr;
+
+		switch(p[0])
+		{
+		case VM_WAIT:
+			if(U16(p + 1) == 0)
+				return -1;
+			break;
+		case VM_LDC:
+			if(p[1] >= VM_REGS)
+				return -1;
+			break;
+		case VM_LOOP:
+			if(p[1] >= VM_REGS)
+				return -1;
+			addr = U16(p + 2);
+			if(addr >= size || !starts[addr])
+				return -1;
+			break;
+		case VM_JMP:
+			addr = U16(p + 1);
+			if(addr >= size || !starts[addr])
+				return -1;
+			break;
+		case VM_BIN:
+			if(((p[1] >> 4) & 3) > 2)
+				return -1;
+			addr = U16(p + 2);
+			if(addr >= size || !starts[addr])
+				return -1;
+			break;
+		case VM_PORT:
+			if(p[1] > 2)
+				return -1;
+			break;
+		}
+		/* the last instruction must not run off the end */
+		if(pc + vm_op_size[p[0]] >= size && p[0] != VM_END && p[0] != VM_JMP)
+			return -1;
+	}
+	return 0;
+}
+
+void vm_Load(struct vm *v, const unsigned char *code, unsigned int size)
+{
+	v->state = VM_HALTED;
+	__asm volatile("" ::: "memory");		//program and registers are written after the halt...
+	v->code = code;
+	v->size = size;
+	v->pc = 0;
+	v->wait = 0;
+	v->port = 0;
+	v->ops = 0;
+	for(unsigned int i = 0; i < VM_REGS; i++)
+	{
+		v->r[i] = 0;
+	}
+	__asm volatile("" ::: "memory");		//...and are complete before the tick sees RUNNING
+	v->state = VM_RUNNING;
+}
+
+/*
+ * Op bodies, shared by both dispatchers. Each ends in NEXT (run the
+ * instruction at pc, or yields when the tick budget is used up) or leaves
+ * the tick with 'goto out'.
+ */
+#define OP_BODIES																\
+	OP(VM_END)																	\
+		v->state = VM_HALTED;													\
+		goto out;																\
+	OP(VM_SET)																	\
+		vm_ports[v->port]->BSRR = U16(c + pc + 1) & v->pin_mask[v->port];		\
+		pc += 3;																\
+		NEXT;																	\
+	OP(VM_CLR)																	\
+		vm_ports[v->port]->BSRR = (U16(c + pc + 1) & v->pin_mask[v->port]) << 16;	\
+		pc += 3;																\
+		NEXT;																	\
+	OP(VM_WRITE)																\
+	{																			\
+		unsigned int m = v->pin_mask[v->port], val = U16(c + pc + 1);			\
+		vm_ports[v->port]->BSRR = (val & m) | ((~val & m) << 16);				\
+		pc += 3;																\
+		NEXT;																	\
+	}																			\
+	OP(VM_WAIT)																	\
+		v->wait = U16(c + pc + 1);												\
+		v->state = VM_WAITING;													\
+		pc += 3;																\
+		goto out;																\
+	OP(VM_LDC)																	\
+		v->r[c[pc + 1]] = (unsigned short)U16(c + pc + 2);						\
+		pc += 4;																\
+		NEXT;																	\
+	OP(VM_LOOP)																	\
+		pc = (--v->r[c[pc + 1]] != 0) ? U16(c + pc + 2) : pc + 4;				\
+		NEXT;																	\
+	OP(VM_JMP)																	\
+		pc = U16(c + pc + 1);													\
+		NEXT;																	\
+	OP(VM_BIN)																	\
+	{																			\
+		unsigned int s = c[pc + 1];												\
+		unsigned int in = (vm_ports[(s >> 4) & 3]->IDR >> (s & 0xF)) & 1;		\
+		pc = (in == (s >> 7)) ? U16(c + pc + 2) : pc + 4;						\
+		NEXT;																	\
+	}																			\
+	OP(VM_PORT)																	\
+		v->port = c[pc + 1];													\
+		pc += 2;																\
+		NEXT;
+
+void vm_Tick(struct vm *v)
+{
+	static void *const labels[VM_OPS] =
+	{
+		&&L_VM_END, &&L_VM_SET, &&L_VM_CLR, &&L_VM_WRITE, &&L_VM_WAIT,
+		&&L_VM_LDC, &&L_VM_LOOP, &&L_VM_JMP, &&L_VM_BIN, &&L_VM_PORT
+	};
+	const unsigned char *c = v->code;
+	unsigned int pc = v->pc, budget = VM_STEPS_PER_TICK, start_budget = budget;
+
+	if(v->state == VM_HALTED)
+		return;
+	if(v->state == VM_WAITING)
+	{
+		if(--v->wait)
+			return;
+		v->state = VM_RUNNING;
+	}
+
+#define OP(name)	L_##name:
+#define NEXT		do { if(--budget == 0) goto yield; goto *labels[c[pc]]; } while(0)
+	goto *labels[c[pc]];
+	OP_BODIES
+#undef OP
+#undef NEXT
+
+out:
+	v->pc = pc;
+	v->ops += start_budget - budget + 1;
+	return;
+yield:							//budget used up, carry on next tick
+	v->pc = pc;
+	v->ops += start_budget;
+}
+
+void vm_Tick_Switch(struct vm *v)
+{
+	const unsigned char *c = v->code;
+	unsigned int pc = v->pc, budget = VM_STEPS_PER_TICK, start_budget = budget;
+
+	if(v->state == VM_HALTED)
+		return;
+	if(v->state == VM_WAITING)
+	{
+		if(--v->wait)
+			return;
+		v->state = VM_RUNNING;
+	}
+
+#define OP(name)	case name:
+#define NEXT		do { if(--budget == 0) goto yield; goto dispatch; } while(0)
+dispatch:
+	switch(c[pc])
+	{
+	OP_BODIES
+	}
+#undef OP
+#undef NEXT
+
+out:
+	v->pc = pc;
+	v->ops += start_budget - budget + 1;
+	return;
+yield:							//budget used up, carry on next tick
+	v->pc = pc;
+	v->ops += start_budget;
+}
@@ -0,0 +1,68 @@
+/*
+ * vm.h
+ *
+ *  Created on: Apr 01, 2025
+ *      Author: moni
+ *
+ *  Bytecode sequencer for LED effects. An effect is a small program of
+ *  port writes and waits instead of a C function of ODR writes and
+ *  delay() calls, so it can be uploaded over UART and replaced at runtime.
+ *
+ *  vm_Tick() is called from a 1 ms timer interrupt. It runs instructions
+ *  until the program waits, ends or VM_STEPS_PER_TICK instructions have
+ *  run, so one tick never costs more than a fixed amount of time.
+ *
+ *  Encoding: one opcode byte, operands little endian. Addresses are byte
+ *  offsets into the program.
+ *
+ *  op    name   operands            effect
+ *  0x00  END                        stop
+ *  0x01  SET    mask16              port pins in mask high (BSRR)
+ *  0x02  CLR    mask16              port pins in mask low  (BSRR)
+ *  0x03  WRITE  value16             port pins = value, inside the VM pin mask
+ *  0x04  WAIT   ticks16             resume after ticks (1..65535) ticks
+ *  0x05  LDC    reg8 count16        r[reg] = count
+ *  0x06  LOOP   reg8 addr16         if(--r[reg] != 0) goto addr
+ *  0x07  JMP    addr16              goto addr
+ *  0x08  BIN    pin8 addr16         goto addr if input pin is at the level
+ *                                   pin8: bits 3:0 pin, 5:4 port (A, B, C),
+ *                                   bit 7 level
+ *  0x09  PORT   port8               output port for SET/CLR/WRITE (0 A, 1 B, 2 C)
+ *
+ *  vm_Check() validates a program once (known opcodes, operands inside the
+ *  program, jump targets on instruction starts, registers < VM_REGS), so
+ *  the interpreter itself does no bounds checks.
+ */
+
+#ifndef VM_H_
+#define VM_H_
+
+#define VM_REGS				4
+#define VM_CODE_MAX			1024
+#define VM_STEPS_PER_TICK	32
+
+enum vm_op { VM_END, VM_SET, VM_CLR, VM_WRITE, VM_WAIT, VM_LDC, VM_LOOP, VM_JMP, VM_BIN, VM_PORT, VM_OPS };
+
+enum vm_state { VM_HALTED, VM_RUNNING, VM_WAITING };
+
+struct vm
+{
+	const unsigned char *code;
+	unsigned int size;
+	unsigned int pc;
+	unsigned int wait;					//ticks left in WAIT
+	unsigned short r[VM_REGS];
+	unsigned int port;					//0 A, 1 B, 2 C
+	unsigned int pin_mask[3];			//pins the program may drive, per port
+	volatile unsigned int state;
+	unsigned int ops;					//instructions executed, for benchmarks
+};
+
+extern const unsigned char vm_op_size[VM_OPS];
+
+int  vm_Check(const unsigned char *code, unsigned int size);
+void vm_Load(struct vm *v, const unsigned char *code, unsigned int size);
+void vm_Tick(struct vm *v);				//computed-goto dispatch
+void vm_Tick_Switch(struct vm *v);		//same with switch dispatch
+
+#endif /* VM_H_ */
@@ -0,0 +1,223 @@
+#!/usr/bin/env python3
+"""
+vm_Asm.py - assembler / disassembler / uploader for the LED effect VM (vm.h).
+
+Source syntax, one instruction per line, ';' starts a comment:
+
+    start:  port  A             ; output port A, B or C
+            write 0x0F          ; pins = value (inside the target's pin mask)
+            set   0x80          ; pins high
+            clr   0x80          ; pins low
+            wait  100           ; ticks (ms)
+            ldc   r0, 8         ; r0 = 8
+    again:  loop  r0, again     ; --r0, jump while not zero
+            bin   PB12, 0, start ; jump if PB12 reads 0
+            jmp   start
+            end
+
+Usage:
+    vm_Asm.py effect.vas -o effect.bin          # raw program
+    vm_Asm.py effect.vas -c name                 # C array on stdout
+    vm_Asm.py effect.vas --upload /dev/ttyUSB0   # send to the board (USART1)
+    vm_Asm.py -d effect.bin                      # disassemble
+
+The C array of led_column.vas is kept in led_column.c as the power-up effect:
+    vm_Asm.py led_column.vas -c vm_led_column > led_column.c
+
+Upload frame: 'V' 'M' len16 program sum8, where sum8 is the low byte of the
+sum of the program bytes. The board answers "OK" or "ERR".
+
+Author: Monish Kumar.k
+Date  : 01/04/2025
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+OPS = {
+    # name: (opcode, operand kinds)
+    "end":   (0x00, ()),
+    "set":   (0x01, ("u16",)),
+    "clr":   (0x02, ("u16",)),
+    "write": (0x03, ("u16",)),
+    "wait":  (0x04, ("ticks",)),
+    "ldc":   (0x05, ("reg", "u16")),
+    "loop":  (0x06, ("reg", "addr")),
+    "jmp":   (0x07, ("addr",)),
+    "bin":   (0x08, ("pin", "level", "addr")),
+    "port":  (0x09, ("port",)),
+}
+SIZE = {"u16": 2, "ticks": 2, "reg": 1, "addr": 2, "pin": 1, "level": 0, "port": 1}
+NAMES = {v[0]: k for k, v in OPS.items()}
+
+
+class AsmError(Exception):
+    pass
+
+
+def number(tok):
+    try:
+        return int(tok, 0)
+    except ValueError:
+        raise AsmError("bad number '%s'" % tok)
+
+
+def parse(path):
+    """Return [(line_no, label_or_None, op, [args])]."""
+    out = []
+    with open(path) as fh:
+        for n, line in enumerate(fh, 1):
+            line = line.split(";", 1)[0].strip()
+            label = None
+            m = re.match(r"^([A-Za-z_]\w*):\s*(.*)$", line)
+            if m:
+                label, line = m.group(1), m.group(2)
+            if not line:
+                out.append((n, label, None, []))
+                continue
+            parts = line.split(None, 1)
+            args = [a.strip() for a in parts[1].split(",")] if len(parts) > 1 else []
+            out.append((n, label, parts[0].lower(), args))
+    return out
+
+
+def assemble(path):
+    lines = parse(path)
+    labels, pc = {}, 0
+    for n, label, op, args in lines:
+        if label:
+            if label in labels:
+                raise AsmError("%d: label '%s' defined twice" % (n, label))
+            labels[label] = pc
+        if op:
+            if op not in OPS:
+                raise AsmError("%d: unknown instruction '%s'" % (n, op))
+            pc += 1 + sum(SIZE[k] for k in OPS[op][1])
+
+    code = bytearray()
+    for n, label, op, args in lines:
+        if not op:
+            continue
+        opcode, kinds = OPS[op]
+        if len(args) != len(kinds):
+            raise AsmError("%d: '%s' takes %d operands" % (n, op, len(kinds)))
+        code.append(opcode)
+        pin = 0
+        for kind, a in zip(kinds, args):
+            if kind in ("u16", "ticks"):
+                v = number(a)
+                if not 0 <= v <= 0xFFFF or (kind == "ticks" and v == 0):
+                    raise AsmError("%d: value out of range" % n)
+                code += struct.pack("<H", v)
+            elif kind == "reg":
+                m = re.match(r"^r([0-3])$", a.lower())
+                if not m:
+                    raise AsmError("%d: register must be r0..r3" % n)
+                code.append(int(m.group(1)))
+            elif kind == "addr":
+                if a not in labels:
+                    raise AsmError("%d: unknown label '%s'" % (n, a))
+                code += struct.pack("<H", labels[a])
+            elif kind == "pin":
+                m = re.match(r"^P([ABC])(\d+)$", a.upper())
+                if not m or int(m.group(2)) > 15:
+                    raise AsmError("%d: pin must look like PB12" % n)
+                pin = ("ABC".index(m.group(1)) << 4) | int(m.group(2))
+            elif kind == "level":
+                if a not in ("0", "1"):
+                    raise AsmError("%d: level must be 0 or 1" % n)
+                code.append(pin | (int(a) << 7))
+            elif kind == "port":
+                if a.upper() not in ("A", "B", "C"):
+                    raise AsmError("%d: port must be A, B or C" % n)
+                code.append("ABC".index(a.upper()))
+    if not code:
+        raise AsmError("empty program")
+    return bytes(code)
+
+
+def disassemble(code):
+    targets, pc, out = set(), 0, []
+    while pc < len(code):
+        op = code[pc]
+        if op not in NAMES:
+            raise AsmError("%04x: bad opcode %02x" % (pc, op))
+        kinds = OPS[NAMES[op]][1]
+        size = 1 + sum(SIZE[k] for k in kinds)
+        if pc + size > len(code):
+            raise AsmError("%04x: truncated instruction" % pc)
+        args, p = [], pc + 1
+        for kind in kinds:
+            if kind in ("u16", "ticks"):
+                v, = struct.unpack_from("<H", code, p)
+                args.append("0x%04X" % v if kind == "u16" else str(v))
+                p += 2
+            elif kind == "reg":
+                args.append("r%d" % code[p])
+                p += 1
+            elif kind == "addr":
+                v, = struct.unpack_from("<H", code, p)
+                targets.add(v)
+                args.append("L%04x" % v)
+                p += 2
+            elif kind == "pin":
+                s = code[p]
+                args.append("P%s%d" % ("ABC"[(s >> 4) & 3], s & 0xF))
+                args.append(str(s >> 7))
+                p += 1
+            elif kind == "port":
+                args.append("ABC"[code[p]])
+                p += 1
+        out.append((pc, NAMES[op], args))
+        pc += size
+    text = []
+    for pc, name, args in out:
+        label = ("L%04x:" % pc) if pc in targets else ""
+        text.append("%-8s%-6s%s" % (label, name, ", ".join(args)))
+    return "\n".join(text) + "\n"
+
+
+def frame(code):
+    return b"VM" + struct.pack("<H", len(code)) + code + bytes([sum(code) & 0xFF])
+
+
+def main():
+    ap = argparse.ArgumentParser(description="LED effect VM assembler")
+    ap.add_argument("input")
+    ap.add_argument("-o", "--output", help="write the raw program")
+    ap.add_argument("-c", "--c-array", metavar="NAME", help="print a C array")
+    ap.add_argument("-d", "--disassemble", action="store_true", help="input is a program, print source")
+    ap.add_argument("--upload", metavar="TTY", help="send to the board over a serial port")
+    args = ap.parse_args()
+
+    try:
+        if args.disassemble:
+            with open(args.input, "rb") as fh:
+                sys.stdout.write(disassemble(fh.read()))
+            return
+        code = assemble(args.input)
+    except AsmError as e:
+        sys.exit("%s:%s" % (args.input, e))
+
+    if args.output:
+        with open(args.output, "wb") as fh:
+            fh.write(code)
+    if args.c_array:
+        print("/* %s, %d bytes, generated by vm_Asm.py */" % (args.input, len(code)))
+        print("const unsigned char %s[%d] =\n{" % (args.c_array, len(code)))
+        for i in range(0, len(code), 12):
+            print("\t" + " ".join("0x%02X," % b for b in code[i:i + 12]))
+        print("};")
+    if args.upload:
+        # the port must already be set to 921600 8N1 raw, e.g. stty -F TTY 921600 raw
+        with open(args.upload, "r+b", buffering=0) as tty:
+            tty.write(frame(code))
+            print(tty.readline().decode(errors="replace").strip())
+    if not (args.output or args.c_array or args.upload):
+        sys.stdout.write(disassemble(code))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,298 @@
+/**
+ ******************************************************************************
+ * @file    vm_Test.c
+ * @author  Monish Kumar.k
+ * @date    01/04/2025
+ * @brief   Host test of the LED effect VM: vm_Check() against the rules in
+ *          vm.h, and both dispatchers against a plain reference interpreter.
+ *
+ * @details
+ * Build and run on the host (Linux, GPIOA..C are mapped at their STM32
+ * addresses):
+ *
+ *     gcc -O2 -I../manual_PWM -o vm_Test vm_Test.c vm.c led_column.c && ./vm_Test
+ *
+ *  - Random programs are built from valid instructions with random
+ *    operands, some of them out of range (register >= VM_REGS, WAIT 0,
+ *    port 3, jump into the middle of an instruction or past the end, a
+ *    last instruction that falls off the end), and some get a random byte
+ *    overwritten. vm_Check() must accept exactly the ones ref_Valid()
+ *    accepts.
+ *  - Every accepted program runs for TICKS ticks in vm_Tick(),
+ *    vm_Tick_Switch() and ref_Tick(), with random input levels on the IDR
+ *    of each port. After every tick the three must agree on state, pc,
+ *    wait, registers, port, ops and the last BSRR value written to each
+ *    port. ref_Tick() checks each fetch against the program size, so an
+ *    accepted program that runs off its end is reported.
+ *  - led_column.c (the power-up effect) must pass vm_Check().
+ * Exits non-zero on a failure.
+ ******************************************************************************
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <arm.h>
+#include "vm.h"
+
+#define PROGRAMS		200000
+#define TICKS			300
+#define NO_WRITE		0xA5A5A5A5u			//BSRR left alone this tick
+
+extern const unsigned char vm_led_column[184];
+
+static volatile struct gpio *const ports[3] = { GPIOA, GPIOB, GPIOC };
+static unsigned int failures, accepted, ticks_run;
+
+static void map(unsigned long addr, unsigned long len)
+{
+	if(mmap((void *)addr, len, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED)
+	{
+		perror("mmap");
+		exit(2);
+	}
+}
+
+static unsigned int u16(const unsigned char *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+/* the rules of vm.h, written out instruction by instruction */
+static int ref_Valid(const unsigned char *c, unsigned int size)
+{
+	unsigned char start[VM_CODE_MAX] = { 0 };
+	unsigned int pc, last = 0;
+
+	if(size == 0 || size > VM_CODE_MAX)
+		return 0;
+	for(pc = 0; pc < size; pc += vm_op_size[c[pc]])
+	{
+		if(c[pc] >= VM_OPS || pc + vm_op_size[c[pc]] > size)
+			return 0;
+		start[pc] = 1;
+		last = pc;
+	}
+	for(pc = 0; pc < size; pc += vm_op_size[c[pc]])
+	{
+		switch(c[pc])
+		{
+		case VM_WAIT:	if(u16(c + pc + 1) == 0) return 0;										break;
+		case VM_LDC:	if(c[pc + 1] >= VM_REGS) return 0;										break;
+		case VM_LOOP:	if(c[pc + 1] >= VM_REGS || u16(c + pc + 2) >= size || !start[u16(c + pc + 2)]) return 0;	break;
+		case VM_JMP:	if(u16(c + pc + 1) >= size || !start[u16(c + pc + 1)]) return 0;		break;
+		case VM_BIN:	if(((c[pc + 1] >> 4) & 3) == 3 || u16(c + pc + 2) >= size || !start[u16(c + pc + 2)]) return 0;	break;
+		case VM_PORT:	if(c[pc + 1] > 2) return 0;												break;
+		}
+	}
+	return c[last] == VM_END || c[last] == VM_JMP;
+}
+
+/*
+ * Reference interpreter: one instruction at a time, the same budget rule
+ * (VM_STEPS_PER_TICK instructions, then carry on next tick). bsrr[] gets
+ * the last value written to each port.
+ */
+static int ref_Tick(struct vm *v, unsigned int *bsrr)
+{
+	const unsigned char *c = v->code;
+	unsigned int n = 0;
+
+	if(v->state == VM_HALTED)
+		return 0;
+	if(v->state == VM_WAITING)
+	{
+		if(--v->wait)
+			return 0;
+		v->state = VM_RUNNING;
+	}
+	while(n < VM_STEPS_PER_TICK)
+	{
+		unsigned int pc = v->pc, op, m = v->pin_mask[v->port];
+
+		if(pc >= v->size || c[pc] >= VM_OPS || pc + vm_op_size[c[pc]] > v->size)
+			return -1;
+		op = c[pc];
+		n++;
+		v->pc = pc + vm_op_size[op];
+		switch(op)
+		{
+		case VM_END:	v->state = VM_HALTED; v->pc = pc;				break;	//pc stays on END
+		case VM_SET:	bsrr[v->port] = u16(c + pc + 1) & m;			break;
+		case VM_CLR:	bsrr[v->port] = (u16(c + pc + 1) & m) << 16;	break;
+		case VM_WRITE:	bsrr[v->port] = (u16(c + pc + 1) & m) | ((~u16(c + pc + 1) & m) << 16);	break;
+		case VM_WAIT:	v->wait = u16(c + pc + 1); v->state = VM_WAITING;	break;
+		case VM_LDC:	v->r[c[pc + 1]] = u16(c + pc + 2);				break;
+		case VM_LOOP:
+			if(--v->r[c[pc + 1]] != 0)
+				v->pc = u16(c + pc + 2);
+			break;
+		case VM_JMP:	v->pc = u16(c + pc + 1);						break;
+		case VM_BIN:
+			if(((ports[(c[pc + 1] >> 4) & 3]->IDR >> (c[pc + 1] & 0xF)) & 1) == (unsigned int)(c[pc + 1] >> 7))
+				v->pc = u16(c + pc + 2);
+			break;
+		case VM_PORT:	v->port = c[pc + 1];							break;
+		}
+		if(op == VM_END || op == VM_WAIT)
+			break;
+	}
+	v->ops += n;
+	return 0;
+}
+
+static void bsrr_Clear(void)
+{
+	for(int p = 0; p < 3; p++)
+		ports[p]->BSRR = NO_WRITE;
+}
+
+static void bsrr_Read(unsigned int *bsrr)
+{
+	for(int p = 0; p < 3; p++)
+		bsrr[p] = ports[p]->BSRR;
+}
+
+static int vm_Same(const struct vm *a, const struct vm *b)
+{
+	return a->state == b->state && a->pc == b->pc && a->wait == b->wait && a->port == b->port
+		&& a->ops == b->ops && !memcmp(a->r, b->r, sizeof(a->r));
+}
+
+static void run(const unsigned char *code, unsigned int size, unsigned int prog)
+{
+	struct vm v_goto, v_switch, v_ref;
+	unsigned int b_goto[3], b_switch[3], b_ref[3];
+
+	memset(&v_goto, 0, sizeof(v_goto));
+	for(int p = 0; p < 3; p++)
+		v_goto.pin_mask[p] = rand() & 0xFFFF;
+	vm_Load(&v_goto, code, size);
+	v_switch = v_goto;
+	v_ref = v_goto;
+
+	for(unsigned int t = 0; t < TICKS && v_ref.state != VM_HALTED; t++)
+	{
+		for(int p = 0; p < 3; p++)
+			ports[p]->IDR = rand() & 0xFFFF;
+		ticks_run++;
+
+		bsrr_Clear();
+		vm_Tick(&v_goto);
+		bsrr_Read(b_goto);
+		bsrr_Clear();
+		vm_Tick_Switch(&v_switch);
+		bsrr_Read(b_switch);
+		b_ref[0] = b_ref[1] = b_ref[2] = NO_WRITE;
+		if(ref_Tick(&v_ref, b_ref) < 0)
+		{
+			if(failures++ < 10)
+				printf("FAIL program %u: accepted but runs off the end at pc %u\n", prog, v_ref.pc);
+			return;
+		}
+		if(!vm_Same(&v_goto, &v_ref) || !vm_Same(&v_switch, &v_ref)
+				|| memcmp(b_goto, b_ref, sizeof(b_ref)) || memcmp(b_switch, b_ref, sizeof(b_ref)))
+		{
+			if(failures++ < 10)
+				printf("FAIL program %u tick %u: pc goto %u switch %u ref %u, ops %u %u %u\n", prog, t,
+						v_goto.pc, v_switch.pc, v_ref.pc, v_goto.ops, v_switch.ops, v_ref.ops);
+			return;
+		}
+	}
+}
+
+/* a target: usually an instruction start, sometimes anywhere */
+static unsigned int target(const unsigned int *starts, unsigned int n, unsigned int size)
+{
+	return (rand() % 16) ? starts[rand() % n] : (unsigned int)(rand() % (size + 4));
+}
+
+static unsigned int program(unsigned char *c)
+{
+	unsigned char ops[64];
+	unsigned int starts[64], n = 1 + rand() % 40, size = 0;
+
+	for(unsigned int i = 0; i < n; i++)
+	{
+		ops[i] = (unsigned char)(rand() % VM_OPS);
+		if(i == n - 1 && rand() % 8)
+			ops[i] = (rand() & 1) ? VM_END : VM_JMP;
+		starts[i] = size;
+		size += vm_op_size[ops[i]];
+	}
+	for(unsigned int i = 0; i < n; i++)
+	{
+		unsigned char *p = c + starts[i];
+		unsigned int a = target(starts, n, size);
+
+		p[0] = ops[i];
+		switch(ops[i])
+		{
+		case VM_SET: case VM_CLR: case VM_WRITE:
+			p[1] = (unsigned char)rand(); p[2] = (unsigned char)rand();
+			break;
+		case VM_WAIT:
+			p[1] = (unsigned char)((rand() % 16) ? 1 + rand() % 4 : 0); p[2] = 0;
+			break;
+		case VM_LDC:
+			p[1] = (unsigned char)((rand() % 16) ? rand() % VM_REGS : rand());
+			p[2] = (unsigned char)(rand() % 6); p[3] = (rand() % 64) ? 0 : 1;
+			break;
+		case VM_LOOP:
+			p[1] = (unsigned char)((rand() % 16) ? rand() % VM_REGS : rand());
+			p[2] = (unsigned char)a; p[3] = (unsigned char)(a >> 8);
+			break;
+		case VM_JMP:
+			p[1] = (unsigned char)a; p[2] = (unsigned char)(a >> 8);
+			break;
+		case VM_BIN:
+			p[1] = (unsigned char)((rand() & 0x8F) | ((rand() % ((rand() % 16) ? 3 : 4)) << 4));
+			p[2] = (unsigned char)a; p[3] = (unsigned char)(a >> 8);
+			break;
+		case VM_PORT:
+			p[1] = (unsigned char)((rand() % 16) ? rand() % 3 : 3);
+			break;
+		}
+	}
+	if(rand() % 8 == 0)
+		c[rand() % size] = (unsigned char)rand();
+	return size;
+}
+
+int main(void)
+{
+	static unsigned char code[VM_CODE_MAX];
+
+	map(0x40000000, 0x30000);
+	srand(1);
+
+	if(vm_Check(vm_led_column, sizeof(vm_led_column)) != 0)
+	{
+		printf("FAIL led_column rejected\n");
+		failures++;
+	}
+	run(vm_led_column, sizeof(vm_led_column), 0);
+
+	for(unsigned int prog = 1; prog <= PROGRAMS; prog++)
+	{
+		unsigned int size = program(code);
+		int ok = (vm_Check(code, size) == 0);
+
+		if(ok != ref_Valid(code, size))
+		{
+			if(failures++ < 10)
+				printf("FAIL program %u: vm_Check %s, ref %s\n", prog, ok ? "accepts" : "rejects",
+						ok ? "rejects" : "accepts");
+			continue;
+		}
+		if(ok)
+		{
+			accepted++;
+			run(code, size, prog);
+		}
+	}
+
+	printf("vm: %u programs, %u accepted, %u ticks compared, %u failures\n",
+			PROGRAMS, accepted, ticks_run, failures);
+	return failures != 0;
+}
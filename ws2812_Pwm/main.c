@@ -0,0 +1,161 @@
+/**
+ ******************************************************************************
+ * @file    ws2812_Pwm.c
+ * @author  Monish Kumar.k
+ * @date    17/03/2025
+ * @brief   Rainbow on a WS2812 strip driven by TIM3 PWM + DMA, with a CPU
+ *          load measurement per 100 LEDs at 60 fps.
+ *
+ * @details
+ * Hardware Connections:
+ *  - PA6 (TIM3_CH1) -> DIN of the strip (through a 5 V level shifter or a
+ *    series resistor for short runs)
+ *  - Strip 5 V supply, common ground with the board
+ *
+ * Benchmark (84 MHz SYSCLK):
+ *  - ws2812_Show() is called at 60 fps for BENCH_FRAMES frames of 100
+ *    LEDs; the main loop counts its own idle cycles, everything else went
+ *    to the start call and the half/complete interrupts.
+ *  - The encoder alone is timed on 100 LEDs as well.
+ *  Results are logged with LOG() (binary_Log) on USART2 and kept in bench.
+ ******************************************************************************
+ */
+
+/**
+ ******************************************************************************
+  Name : Monish Kumar.k
+  Date : 17/03/2025
+  File : ws2812_Pwm
+ ******************************************************************************/
+#include <arm.h>
+#include <rcc.h>
+#include <uart.h>
+#include <log.h>
+#include "ws2812.h"
+
+#define LEDS			100
+#define FPS				60
+#define BENCH_FRAMES	60
+
+struct bench_result
+{
+	unsigned int encode_cycles;		//ws2812_Encode() for LEDS
+	unsigned int frame_cycles;		//CPU per frame, start + interrupts
+	unsigned int load_permille;		//at FPS
+};
+
+volatile struct bench_result bench;
+
+static unsigned char grb[LEDS * 3];
+static unsigned int enc_buf[LEDS * 12];
+
+void rcc_Config(void);
+void rainbow(unsigned int step);
+void bench_Run(void);
+
+int main(void)
+{
+	unsigned int frame_cycles, last, step = 0;
+
+	rcc_Config();
+	uart_Init(UART_CONSOLE, 921600);
+	log_Init();
+	ws2812_Init();
+
+	bench_Run();
+
+	frame_cycles = rcc_Get_Sysclk() / FPS;
+	last = DWT->CYCCNT;
+	while(1)
+	{
+		if(DWT->CYCCNT - last >= frame_cycles)
+		{
+			last += frame_cycles;
+			ws2812_Wait();
+			rainbow(step++);
+			ws2812_Show(grb, LEDS);
+		}
+		log_Drain(UART_CONSOLE);
+	}
+}
+
+void rcc_Config()
+{
+	RCC->CR = RCC->CR | (1<<16); /*HES is Enable*/
+	while(!(RCC->CR & (1<<17)));
+
+	FLASH->ACR = (1<<10) | (1<<9) | (1<<8) | (2<<0);	/* DCEN, ICEN, PRFTEN, 2 wait states */
+
+	/* PLL: 25 MHz / M25 * N336 / P4 = 84 MHz, source HSE */
+	RCC->PLLCFGR = (7<<24) | (1<<22) | (1<<16) | (336<<6) | (25<<0);
+	RCC->CR = RCC->CR | (1<<24);
+	while(!(RCC->CR & (1<<25)));
+
+	RCC->CFGR = (RCC->CFGR & ~((0xF<<4) | (0x7<<10) | (0x7<<13))) | (4<<10);	/* APB1 /2 */
+	RCC->CFGR = (RCC->CFGR & ~(0x3<<0)) | (2<<0);
+	while(((RCC->CFGR >> 2) & 0x3) != 2);
+}
+
+/* hue wheel in 6 segments of 43 steps, 1/8 brightness to keep current low */
+void rainbow(unsigned int step)
+{
+	for(unsigned int i = 0; i < LEDS; i++)
+	{
+		unsigned int h = (i * 256 / LEDS + step) & 0xFF;
+		unsigned int seg = h / 43, f = (h % 43) * 6;
+		unsigned int r, g, b;
+
+		switch(seg)
+		{
+		case 0:  r = 255;     g = f;       b = 0;       break;
+		case 1:  r = 255 - f; g = 255;     b = 0;       break;
+		case 2:  r = 0;       g = 255;     b = f;       break;
+		case 3:  r = 0;       g = 255 - f; b = 255;     break;
+		case 4:  r = f;       g = 0;       b = 255;     break;
+		default: r = 255;     g = 0;       b = 255 - f; break;
+		}
+		grb[i*3 + 0] = (unsigned char)(g >> 3);
+		grb[i*3 + 1] = (unsigned char)(r >> 3);
+		grb[i*3 + 2] = (unsigned char)(b >> 3);
+	}
+}
+
+void bench_Run()
+{
+	unsigned int period = rcc_Get_Sysclk() / FPS;
+	unsigned int start, t, idle = 0, busy;
+
+	DEMCR |= (1<<24);
+	DWT->CTRL |= (1<<0);		/* CYCCNTENA */
+
+	rainbow(0);
+	start = DWT->CYCCNT;
+	ws2812_Encode(grb, LEDS, enc_buf);
+	bench.encode_cycles = DWT->CYCCNT - start;
+
+	/* idle-loop counting: cycles the main loop did not get went to the driver */
+	start = DWT->CYCCNT;
+	t = start;
+	for(unsigned int f = 0; f < BENCH_FRAMES; f++)
+	{
+		unsigned int frame_start = start + f * period;
+
+		ws2812_Show(grb, LEDS);
+		while(DWT->CYCCNT - frame_start < period)
+		{
+			unsigned int now = DWT->CYCCNT;
+			if(now - t < 64)
+			{
+				idle += now - t;
+			}
+			t = now;
+		}
+	}
+	busy = BENCH_FRAMES * period - idle;
+
+	bench.frame_cycles = busy / BENCH_FRAMES;
+	bench.load_permille = (unsigned int)((unsigned long long)busy * 1000 / (BENCH_FRAMES * period));
+	LOG("%u LEDs: encode %u cycles, %u cycles/frame, load at %u fps %u/1000", LEDS,
+		bench.encode_cycles, bench.frame_cycles, FPS, bench.load_permille);
+	log_Drain(UART_CONSOLE);
+}
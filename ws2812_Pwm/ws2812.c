@@ -0,0 +1,200 @@
+/**
+ ******************************************************************************
+ * @file    ws2812.c
+ * @author  Monish Kumar.k
+ * @date    17/03/2025
+ * @brief   WS2812 bit stream from TIM3 CH1 PWM with DMA-fed CCR1 and
+ *          incremental bit expansion in the half/complete interrupts.
+ *
+ * @details
+ *  - ARR gives the 1.25 us bit period; a 0 bit is high for 0.32 of it, a 1
+ *    bit for 0.64 (0.4 / 0.8 us). CCR1 is preloaded, so the value DMA
+ *    writes on an update event is used for the following period.
+ *  - Expansion uses a 16 entry table: one nibble -> two words holding four
+ *    CCR values, so an LED is 6 table loads and 12 word stores.
+ *  - After the last LED the buffer is filled with 0 duties for
+ *    WS2812_RESET_US (the line stays low), then the DMA is stopped at the
+ *    next half boundary. CCR1 = 0 keeps the output low until the next
+ *    ws2812_Show().
+ *  - An interrupt late by more than a half ends the frame early and counts
+ *    an underrun (ws2812_Underruns()).
+ ******************************************************************************
+ */
+#include <arm.h>
+#include <rcc.h>
+#include "ws2812.h"
+
+#define DMA1_S2_IRQ		13
+#define WS_DMA			(&DMA1->S[2])
+#define WS_DMA_SHIFT	16				//stream 2 flags in LISR/LIFCR
+#define WS_PIN			6
+
+#define HALF_WORDS		(WS2812_HALF_LEDS * 12)
+#define RESET_LEDS		((WS2812_RESET_US * 10 + 299) / 300)	//one LED slot = 30 us
+
+static unsigned int nib_lut[16][2];
+static unsigned int dma_buf[2][HALF_WORDS];
+
+static const unsigned char *px;
+static unsigned int px_n;
+static unsigned int fill_led;			//next LED slot to expand
+static unsigned int halves_left;		//halves still to be sent
+static volatile unsigned int busy;
+static unsigned int underruns;
+
+void ws2812_Lut_Init(unsigned int t0, unsigned int t1)
+{
+	for(unsigned int n = 0; n < 16; n++)
+	{
+		unsigned int b3 = (n & 8) ? t1 : t0, b2 = (n & 4) ? t1 : t0;
+		unsigned int b1 = (n & 2) ? t1 : t0, b0 = (n & 1) ? t1 : t0;
+
+		nib_lut[n][0] = b3 | (b2 << 16);	//lower halfword goes out first
+		nib_lut[n][1] = b1 | (b0 << 16);
+	}
+}
+
+void ws2812_Encode(const unsigned char *grb, unsigned int n, unsigned int *out)
+{
+	for(unsigned int i = 0; i < n * 3; i++)
+	{
+		const unsigned int *hi = nib_lut[grb[i] >> 4];
+		const unsigned int *lo = nib_lut[grb[i] & 0xF];
+
+		out[0] = hi[0];
+		out[1] = hi[1];
+		out[2] = lo[0];
+		out[3] = lo[1];
+		out += 4;
+	}
+}
+
+static void fill_Half(unsigned int *half)
+{
+	unsigned int k = 0;
+
+	if(fill_led < px_n)
+	{
+		unsigned int n = px_n - fill_led;
+
+		if(n > WS2812_HALF_LEDS)
+			n = WS2812_HALF_LEDS;
+		ws2812_Encode(px + fill_led * 3, n, half);
+		k = n * 12;
+	}
+	for(; k < HALF_WORDS; k++)
+	{
+		half[k] = 0;
+	}
+	fill_led += WS2812_HALF_LEDS;
+}
+
+int ws2812_Init()
+{
+	volatile struct dma_stream *s = WS_DMA;
+	unsigned int clk = rcc_Get_Tim_Clock(1);
+	unsigned int period = (clk + 400000) / 800000;
+
+	if(period < 10 || period > 0x10000)
+		return -1;
+	ws2812_Lut_Init(period * 8 / 25, period * 16 / 25);
+
+	RCC->AHB1ENR |= (1<<0) | (1<<21);		//GPIOA, DMA1
+	RCC->APB1ENR |= (1<<1);					//TIM3
+
+	GPIOA->MODER  = (GPIOA->MODER & ~(0x3 << (WS_PIN*2))) | (0x2 << (WS_PIN*2));
+	GPIOA->OSPEEDR |= (0x3 << (WS_PIN*2));
+	GPIOA->AFRL   = (GPIOA->AFRL & ~(0xF << (WS_PIN*4))) | (2 << (WS_PIN*4));
+
+	TIM3->CR1   = (1<<7);					//ARPE
+	TIM3->PSC   = 0;
+	TIM3->ARR   = period - 1;
+	TIM3->CCR1  = 0;
+	TIM3->CCMR1 = (6<<4) | (1<<3);			//PWM mode 1, OC1PE
+	TIM3->CCER  = (1<<0);					//CC1E
+	TIM3->EGR   = (1<<0);
+	TIM3->DIER  = 0;
+
+	s->CR = 0;
+	while(s->CR & (1<<0));
+	DMA1->LIFCR = 0x3D << WS_DMA_SHIFT;
+	s->PAR = (unsigned long)&TIM3->CCR1;
+	s->FCR = 0;
+	s->CR  = (5<<25) | (3<<16) | (1<<13) | (1<<11) | (1<<10) | (1<<8) | (1<<6) | (1<<4) | (1<<3) | (1<<2);
+			//CH5, PL very high, MSIZE/PSIZE 16 bit, MINC, CIRC, M->P, TCIE, HTIE, TEIE
+
+	NVIC->IP[DMA1_S2_IRQ] = (3<<4);
+	NVIC->ISER[DMA1_S2_IRQ >> 5] = (1 << (DMA1_S2_IRQ & 31));
+
+	busy = 0;
+	TIM3->CR1 |= (1<<0);
+	return 0;
+}
+
+void ws2812_Show(const unsigned char *grb, unsigned int n)
+{
+	volatile struct dma_stream *s = WS_DMA;
+
+	ws2812_Wait();
+	px = grb;
+	px_n = n;
+	fill_led = 0;
+	halves_left = (n + RESET_LEDS + WS2812_HALF_LEDS - 1) / WS2812_HALF_LEDS;
+	fill_Half(dma_buf[0]);
+	fill_Half(dma_buf[1]);
+
+	busy = 1;
+	DMA1->LIFCR = 0x3D << WS_DMA_SHIFT;
+	s->M0AR = (unsigned long)dma_buf;
+	s->NDTR = 2 * HALF_WORDS * 2;			//in halfwords
+	s->CR  |= (1<<0);
+	TIM3->DIER = (1<<8);					//UDE
+}
+
+unsigned int ws2812_Underruns()
+{
+	return underruns;
+}
+
+int ws2812_Busy()
+{
+	return busy;
+}
+
+void ws2812_Wait()
+{
+	while(busy);
+}
+
+void DMA1_Stream2_IRQHandler()
+{
+	unsigned int flags = (DMA1->LISR >> WS_DMA_SHIFT) & 0x3D;
+
+	DMA1->LIFCR = flags << WS_DMA_SHIFT;
+	if(!(flags & ((1<<5) | (1<<4) | (1<<3))))
+		return;
+
+	/*
+	 * HT and TC together: the handler is more than a half late and the DMA
+	 * is already re-sending half 0, which still holds the slots it sent
+	 * before. Refilling now cannot take those bits back, so the frame is
+	 * ended (the strip latches what it got) and counted as an underrun.
+	 * When these were the last two halves the frame is complete.
+	 */
+	if((flags & ((1<<5) | (1<<4))) == ((1<<5) | (1<<4)))
+	{
+		if(halves_left > 2)
+			underruns++;
+		halves_left = 1;
+	}
+	if(--halves_left == 0 || (flags & (1<<3)))
+	{
+		TIM3->DIER = 0;
+		WS_DMA->CR &= ~(1<<0);
+		TIM3->CCR1 = 0;
+		busy = 0;
+		return;
+	}
+	/* HT: first half was sent, TC: second half was sent */
+	fill_Half((flags & (1<<5)) ? dma_buf[1] : dma_buf[0]);
+}
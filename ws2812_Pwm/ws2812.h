@@ -0,0 +1,41 @@
+/*
+ * ws2812.h
+ *
+ *  Created on: Mar 17, 2025
+ *      Author: moni
+ *
+ *  WS2812 / WS2812B strip on TIM3 channel 1 (PA6, AF2). Every bit is one
+ *  800 kHz PWM period; DMA1 Stream2 channel 5 (TIM3_UP) writes the next
+ *  duty into CCR1 on each update event.
+ *
+ *  The DMA buffer holds only 2 x WS2812_HALF_LEDS LEDs worth of duties and
+ *  runs in circular mode. The half-transfer and transfer-complete
+ *  interrupts expand the next WS2812_HALF_LEDS LEDs from the GRB array
+ *  into the half that was just sent, so the strip length only costs
+ *  3 bytes of RAM per LED. The interrupt must come within a half (about
+ *  WS2812_HALF_LEDS x 30 us); later than that the frame is cut short.
+ *
+ *  Pixels are 3 bytes per LED in wire order: G, R, B.
+ */
+
+#ifndef WS2812_H_
+#define WS2812_H_
+
+#define WS2812_HALF_LEDS	4			//LEDs expanded per interrupt
+#define WS2812_RESET_US		300			//low time after the data, WS2812B needs > 280 us
+
+int  ws2812_Init(void);
+void ws2812_Show(const unsigned char *grb, unsigned int n);
+int  ws2812_Busy(void);
+void ws2812_Wait(void);
+unsigned int ws2812_Underruns(void);	//frames ended early, an interrupt late by a half
+
+/*
+ * Bit expansion, usable on its own: ws2812_Lut_Init() builds the nibble
+ * table for the given 0 / 1 high times (timer ticks), ws2812_Encode()
+ * writes 12 words (24 CCR values, MSB first) per LED.
+ */
+void ws2812_Lut_Init(unsigned int t0, unsigned int t1);
+void ws2812_Encode(const unsigned char *grb, unsigned int n, unsigned int *out);
+
+#endif /* WS2812_H_ */
@@ -0,0 +1,223 @@
+/**
+ ******************************************************************************
+ * @file    ws2812_Test.c
+ * @author  Monish Kumar.k
+ * @date    17/03/2025
+ * @brief   Host test of the WS2812 bit encoder and of the half-buffer
+ *          refill against a simulated TIM3 update DMA.
+ *
+ * @details
+ * Build and run on the host (Linux, the register blocks are mapped at
+ * their STM32 addresses):
+ *
+ *     gcc -O2 -I../manual_PWM -o ws2812_Test ws2812_Test.c ../manual_PWM/rcc.c && ./ws2812_Test
+ *
+ * ws2812.c is included, so the test sees nib_lut, dma_buf and the fill
+ * state.
+ *  - Encoder: for random 0 / 1 high times, ws2812_Encode() of every byte
+ *    value and of random strips must give, halfword by halfword, one CCR
+ *    value per bit, MSB first, G R B order (compared with a per-bit loop).
+ *  - Stream: ws2812_Show() runs against a DMA model that moves one
+ *    halfword from the circular buffer into CCR1 per update event, raises
+ *    HTIF/TCIF at the half and the end, and runs the stream 2 handler
+ *    0..23 update events later. The CCR1 sequence must be the strip's bits
+ *    followed by at least WS2812_RESET_US of 0 duty, then the stream stops
+ *    with CCR1 = 0 and ws2812_Busy() = 0.
+ *  - Late: the same with one random interrupt a half to a full buffer
+ *    late, so the handler sees HTIF and TCIF together. The bits of the two
+ *    halves sent before must be right; if more than those two halves were
+ *    left the stream stops in that handler with one underrun counted, else the
+ *    frame is complete with none.
+ * Exits non-zero on a failure.
+ ******************************************************************************
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include "ws2812.c"
+
+#define MAX_LEDS		300
+#define MAX_STEPS		((MAX_LEDS + RESET_LEDS + 4 * WS2812_HALF_LEDS) * 24)
+#define HTIF			(1<<4)
+#define TCIF			(1<<5)
+
+static unsigned int failures;
+static unsigned short wire[MAX_STEPS];
+
+static void map(unsigned long addr, unsigned long len)
+{
+	if(mmap((void *)addr, len, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED)
+	{
+		perror("mmap");
+		exit(2);
+	}
+}
+
+static void fail(const char *what, unsigned int a, unsigned int b)
+{
+	if(failures++ < 10)
+		printf("FAIL %s (%u, %u)\n", what, a, b);
+}
+
+/* per-bit reference: 24 CCR values per LED, MSB of G first */
+static unsigned short ref_Bit(const unsigned char *grb, unsigned int bit, unsigned int t0, unsigned int t1)
+{
+	return (grb[bit / 8] & (0x80 >> (bit % 8))) ? t1 : t0;
+}
+
+static void test_Encode(void)
+{
+	static unsigned char grb[MAX_LEDS * 3];
+	static unsigned int out[MAX_LEDS * 12];
+
+	for(int round = 0; round < 200; round++)
+	{
+		unsigned int t1 = 1 + rand() % 0xFFFF, t0 = rand() % t1;
+		unsigned int n = (round == 0) ? 86 : 1 + rand() % MAX_LEDS;
+
+		ws2812_Lut_Init(t0, t1);
+		for(unsigned int i = 0; i < n * 3; i++)
+		{
+			grb[i] = (round == 0) ? (unsigned char)i : (unsigned char)rand();	//round 0: bytes 0..255
+		}
+		ws2812_Encode(grb, n, out);
+
+		for(unsigned int bit = 0; bit < n * 24; bit++)
+		{
+			unsigned short ccr = (unsigned short)(out[bit / 2] >> ((bit & 1) * 16));
+			if(ccr != ref_Bit(grb, bit, t0, t1))
+			{
+				fail("encode: round, bit", round, bit);
+				break;
+			}
+		}
+	}
+}
+
+/* late: index of the interrupt that comes a half or more late, ~0u for none */
+static void test_Stream(unsigned int n, unsigned int late)
+{
+	static unsigned char grb[MAX_LEDS * 3];
+	volatile struct dma_stream *s = WS_DMA;
+	unsigned int t0 = nib_lut[0][0] & 0xFFFF, t1 = nib_lut[15][0] & 0xFFFF;
+	unsigned int steps = 0, latency = 0, zeros = 0, irq = 0;
+	unsigned int halves = (n + RESET_LEDS + WS2812_HALF_LEDS - 1) / WS2812_HALF_LEDS;
+	unsigned int underruns = ws2812_Underruns(), bits = n * 24;
+	unsigned short *buf;
+
+	for(unsigned int i = 0; i < n * 3; i++)
+	{
+		grb[i] = (unsigned char)rand();
+	}
+	ws2812_Show(grb, n);
+	DMA1->LISR &= ~DMA1->LIFCR;
+	DMA1->LIFCR = 0;
+
+	/* one update event per step while the stream runs with UDE set */
+	while((s->CR & (1<<0)) && (TIM3->DIER & (1<<8)) && steps < MAX_STEPS)
+	{
+		buf = (unsigned short *)(((uintptr_t)dma_buf & ~(uintptr_t)0xFFFFFFFF) | s->M0AR);
+		TIM3->CCR1 = buf[2 * HALF_WORDS * 2 - s->NDTR];
+		wire[steps++] = (unsigned short)TIM3->CCR1;
+		if(--s->NDTR == HALF_WORDS * 2 || s->NDTR == 0)
+		{
+			unsigned int flag = s->NDTR ? HTIF : TCIF;
+
+			if(!s->NDTR)
+				s->NDTR = 2 * HALF_WORDS * 2;
+			if(!((DMA1->LISR >> WS_DMA_SHIFT) & (HTIF | TCIF)))
+				latency = (irq == late) ? HALF_WORDS * 2 + rand() % (HALF_WORDS * 2) : rand() % 24;
+			DMA1->LISR |= flag << WS_DMA_SHIFT;
+			irq++;
+		}
+		if((DMA1->LISR >> WS_DMA_SHIFT) & (HTIF | TCIF))
+		{
+			if(latency-- == 0)
+			{
+				DMA1_Stream2_IRQHandler();
+				DMA1->LISR &= ~DMA1->LIFCR;
+				DMA1->LIFCR = 0;
+			}
+		}
+	}
+
+	if(steps >= MAX_STEPS)
+		fail("stream did not stop: leds, steps", n, steps);
+	if(late < halves && halves - late > 2)
+	{
+		/* half 0 went out again with old slots: stopped, only the halves before are checked */
+		if(ws2812_Underruns() != underruns + 1 || TIM3->CCR1 != 0 || ws2812_Busy())
+			fail("late interrupt: no underrun, or not stopped: leds, halves", n, halves - late);
+		if(steps > (late + 3) * HALF_WORDS * 2)					//in the late handler, before half 1 again
+			fail("late interrupt: stream went on: leds, steps", n, steps);
+		if((late + 2) * WS2812_HALF_LEDS * 24 < bits)
+			bits = (late + 2) * WS2812_HALF_LEDS * 24;
+		for(unsigned int bit = 0; bit < bits; bit++)
+		{
+			if(bit >= steps || wire[bit] != ref_Bit(grb, bit, t0, t1))
+			{
+				fail("late interrupt: bits before it: leds, bit", n, bit);
+				return;
+			}
+		}
+		return;
+	}
+	if(ws2812_Underruns() != underruns)
+		fail("underrun counted: leds, late", n, late);
+	if(steps < n * 24)
+	{
+		fail("stream too short: leds, steps", n, steps);
+		return;
+	}
+	for(unsigned int bit = 0; bit < n * 24; bit++)
+	{
+		if(wire[bit] != ref_Bit(grb, bit, t0, t1))
+		{
+			fail("stream: leds, bit", n, bit);
+			return;
+		}
+	}
+	for(unsigned int i = n * 24; i < steps; i++)
+	{
+		if(wire[i] != 0)
+		{
+			fail("non-zero duty after the data: leds, step", n, i);
+			return;
+		}
+		zeros++;
+	}
+	if(zeros * 125 < WS2812_RESET_US * 100)
+		fail("reset too short: leds, 0 duty bits", n, zeros);
+	if(TIM3->CCR1 != 0 || ws2812_Busy())
+		fail("not idle after the stream: leds, busy", n, ws2812_Busy());
+}
+
+int main(void)
+{
+	map(0x40000000, 0x30000);
+	map(0xE000E000, 0x1000);
+	srand(1);
+
+	test_Encode();
+
+	if(ws2812_Init() != 0)
+	{
+		printf("ws2812_Init failed\n");
+		return 1;
+	}
+	for(unsigned int n = 0; n <= 3 * WS2812_HALF_LEDS; n++)
+	{
+		test_Stream(n, ~0u);
+		for(unsigned int late = 0; late < (n + RESET_LEDS + WS2812_HALF_LEDS - 1) / WS2812_HALF_LEDS; late++)
+			test_Stream(n, late);
+	}
+	for(int round = 0; round < 200; round++)
+	{
+		test_Stream(1 + rand() % MAX_LEDS, ~0u);
+		test_Stream(1 + rand() % MAX_LEDS, rand() % 80);
+	}
+
+	printf("ws2812: %u underruns from late interrupts, %u failures\n", ws2812_Underruns(), failures);
+	return failures != 0;
+}